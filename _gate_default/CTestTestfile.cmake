@@ -0,0 +1,12 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo
+# Build directory: /root/repo/_gate_default
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+subdirs("heifio")
+subdirs("examples")
+subdirs("tests")
+subdirs("libheif")
+subdirs("gdk-pixbuf")
+subdirs("gnome")
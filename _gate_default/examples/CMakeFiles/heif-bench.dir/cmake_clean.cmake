@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/heif-bench.dir/common.cc.o"
+  "CMakeFiles/heif-bench.dir/common.cc.o.d"
+  "CMakeFiles/heif-bench.dir/heif_bench.cc.o"
+  "CMakeFiles/heif-bench.dir/heif_bench.cc.o.d"
+  "heif-bench"
+  "heif-bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/heif-bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/heif-dec.dir/common.cc.o"
+  "CMakeFiles/heif-dec.dir/common.cc.o.d"
+  "CMakeFiles/heif-dec.dir/heif_dec.cc.o"
+  "CMakeFiles/heif-dec.dir/heif_dec.cc.o.d"
+  "heif-dec"
+  "heif-dec.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/heif-dec.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/heif-enc.dir/benchmark.cc.o"
+  "CMakeFiles/heif-enc.dir/benchmark.cc.o.d"
+  "CMakeFiles/heif-enc.dir/common.cc.o"
+  "CMakeFiles/heif-enc.dir/common.cc.o.d"
+  "CMakeFiles/heif-enc.dir/heif_enc.cc.o"
+  "CMakeFiles/heif-enc.dir/heif_enc.cc.o.d"
+  "heif-enc"
+  "heif-enc.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/heif-enc.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/heif-info.dir/common.cc.o"
+  "CMakeFiles/heif-info.dir/common.cc.o.d"
+  "CMakeFiles/heif-info.dir/heif_info.cc.o"
+  "CMakeFiles/heif-info.dir/heif_info.cc.o.d"
+  "heif-info"
+  "heif-info.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/heif-info.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/heif-test.dir/common.cc.o"
+  "CMakeFiles/heif-test.dir/common.cc.o.d"
+  "CMakeFiles/heif-test.dir/heif_test.cc.o"
+  "CMakeFiles/heif-test.dir/heif_test.cc.o.d"
+  "heif-test"
+  "heif-test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/heif-test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
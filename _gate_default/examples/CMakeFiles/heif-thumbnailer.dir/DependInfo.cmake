@@ -0,0 +1,22 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/examples/common.cc" "examples/CMakeFiles/heif-thumbnailer.dir/common.cc.o" "gcc" "examples/CMakeFiles/heif-thumbnailer.dir/common.cc.o.d"
+  "/root/repo/examples/heif_thumbnailer.cc" "examples/CMakeFiles/heif-thumbnailer.dir/heif_thumbnailer.cc.o" "gcc" "examples/CMakeFiles/heif-thumbnailer.dir/heif_thumbnailer.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_gate_default/heifio/CMakeFiles/heifio.dir/DependInfo.cmake"
+  "/root/repo/_gate_default/libheif/CMakeFiles/heif.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
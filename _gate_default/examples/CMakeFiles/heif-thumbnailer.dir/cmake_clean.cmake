@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/heif-thumbnailer.dir/common.cc.o"
+  "CMakeFiles/heif-thumbnailer.dir/common.cc.o.d"
+  "CMakeFiles/heif-thumbnailer.dir/heif_thumbnailer.cc.o"
+  "CMakeFiles/heif-thumbnailer.dir/heif_thumbnailer.cc.o.d"
+  "heif-thumbnailer"
+  "heif-thumbnailer.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/heif-thumbnailer.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
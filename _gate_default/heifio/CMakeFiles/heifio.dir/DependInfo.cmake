@@ -0,0 +1,28 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/heifio/decoder_jpeg.cc" "heifio/CMakeFiles/heifio.dir/decoder_jpeg.cc.o" "gcc" "heifio/CMakeFiles/heifio.dir/decoder_jpeg.cc.o.d"
+  "/root/repo/heifio/decoder_png.cc" "heifio/CMakeFiles/heifio.dir/decoder_png.cc.o" "gcc" "heifio/CMakeFiles/heifio.dir/decoder_png.cc.o.d"
+  "/root/repo/heifio/decoder_y4m.cc" "heifio/CMakeFiles/heifio.dir/decoder_y4m.cc.o" "gcc" "heifio/CMakeFiles/heifio.dir/decoder_y4m.cc.o.d"
+  "/root/repo/heifio/encoder.cc" "heifio/CMakeFiles/heifio.dir/encoder.cc.o" "gcc" "heifio/CMakeFiles/heifio.dir/encoder.cc.o.d"
+  "/root/repo/heifio/encoder_jpeg.cc" "heifio/CMakeFiles/heifio.dir/encoder_jpeg.cc.o" "gcc" "heifio/CMakeFiles/heifio.dir/encoder_jpeg.cc.o.d"
+  "/root/repo/heifio/encoder_png.cc" "heifio/CMakeFiles/heifio.dir/encoder_png.cc.o" "gcc" "heifio/CMakeFiles/heifio.dir/encoder_png.cc.o.d"
+  "/root/repo/heifio/encoder_y4m.cc" "heifio/CMakeFiles/heifio.dir/encoder_y4m.cc.o" "gcc" "heifio/CMakeFiles/heifio.dir/encoder_y4m.cc.o.d"
+  "/root/repo/heifio/exif.cc" "heifio/CMakeFiles/heifio.dir/exif.cc.o" "gcc" "heifio/CMakeFiles/heifio.dir/exif.cc.o.d"
+  "/root/repo/heifio/stubs.cc" "heifio/CMakeFiles/heifio.dir/stubs.cc.o" "gcc" "heifio/CMakeFiles/heifio.dir/stubs.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_gate_default/libheif/CMakeFiles/heif.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,27 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/heifio.dir/decoder_jpeg.cc.o"
+  "CMakeFiles/heifio.dir/decoder_jpeg.cc.o.d"
+  "CMakeFiles/heifio.dir/decoder_png.cc.o"
+  "CMakeFiles/heifio.dir/decoder_png.cc.o.d"
+  "CMakeFiles/heifio.dir/decoder_y4m.cc.o"
+  "CMakeFiles/heifio.dir/decoder_y4m.cc.o.d"
+  "CMakeFiles/heifio.dir/encoder.cc.o"
+  "CMakeFiles/heifio.dir/encoder.cc.o.d"
+  "CMakeFiles/heifio.dir/encoder_jpeg.cc.o"
+  "CMakeFiles/heifio.dir/encoder_jpeg.cc.o.d"
+  "CMakeFiles/heifio.dir/encoder_png.cc.o"
+  "CMakeFiles/heifio.dir/encoder_png.cc.o.d"
+  "CMakeFiles/heifio.dir/encoder_y4m.cc.o"
+  "CMakeFiles/heifio.dir/encoder_y4m.cc.o.d"
+  "CMakeFiles/heifio.dir/exif.cc.o"
+  "CMakeFiles/heifio.dir/exif.cc.o.d"
+  "CMakeFiles/heifio.dir/stubs.cc.o"
+  "CMakeFiles/heifio.dir/stubs.cc.o.d"
+  "libheifio.a"
+  "libheifio.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/heifio.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
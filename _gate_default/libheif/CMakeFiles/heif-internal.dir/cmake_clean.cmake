@@ -0,0 +1,201 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/heif-internal.dir/api/libheif/heif.cc.o"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif.cc.o.d"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_aux_images.cc.o"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_aux_images.cc.o.d"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_brands.cc.o"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_brands.cc.o.d"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_color.cc.o"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_color.cc.o.d"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_context.cc.o"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_context.cc.o.d"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_decoding.cc.o"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_decoding.cc.o.d"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_encoding.cc.o"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_encoding.cc.o.d"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_entity_groups.cc.o"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_entity_groups.cc.o.d"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_image.cc.o"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_image.cc.o.d"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_image_handle.cc.o"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_image_handle.cc.o.d"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_items.cc.o"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_items.cc.o.d"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_library.cc.o"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_library.cc.o.d"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_metadata.cc.o"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_metadata.cc.o.d"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_plugin.cc.o"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_plugin.cc.o.d"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_probe.cc.o"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_probe.cc.o.d"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_properties.cc.o"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_properties.cc.o.d"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_regions.cc.o"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_regions.cc.o.d"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_security.cc.o"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_security.cc.o.d"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_sequences.cc.o"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_sequences.cc.o.d"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_tai_timestamps.cc.o"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_tai_timestamps.cc.o.d"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_text.cc.o"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_text.cc.o.d"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_tiling.cc.o"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_tiling.cc.o.d"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_tracing.cc.o"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_tracing.cc.o.d"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_uncompressed.cc.o"
+  "CMakeFiles/heif-internal.dir/api/libheif/heif_uncompressed.cc.o.d"
+  "CMakeFiles/heif-internal.dir/bitstream.cc.o"
+  "CMakeFiles/heif-internal.dir/bitstream.cc.o.d"
+  "CMakeFiles/heif-internal.dir/box.cc.o"
+  "CMakeFiles/heif-internal.dir/box.cc.o.d"
+  "CMakeFiles/heif-internal.dir/brands.cc.o"
+  "CMakeFiles/heif-internal.dir/brands.cc.o.d"
+  "CMakeFiles/heif-internal.dir/codecs/avc_boxes.cc.o"
+  "CMakeFiles/heif-internal.dir/codecs/avc_boxes.cc.o.d"
+  "CMakeFiles/heif-internal.dir/codecs/avc_dec.cc.o"
+  "CMakeFiles/heif-internal.dir/codecs/avc_dec.cc.o.d"
+  "CMakeFiles/heif-internal.dir/codecs/avif_boxes.cc.o"
+  "CMakeFiles/heif-internal.dir/codecs/avif_boxes.cc.o.d"
+  "CMakeFiles/heif-internal.dir/codecs/avif_dec.cc.o"
+  "CMakeFiles/heif-internal.dir/codecs/avif_dec.cc.o.d"
+  "CMakeFiles/heif-internal.dir/codecs/avif_enc.cc.o"
+  "CMakeFiles/heif-internal.dir/codecs/avif_enc.cc.o.d"
+  "CMakeFiles/heif-internal.dir/codecs/decoder.cc.o"
+  "CMakeFiles/heif-internal.dir/codecs/decoder.cc.o.d"
+  "CMakeFiles/heif-internal.dir/codecs/encoder.cc.o"
+  "CMakeFiles/heif-internal.dir/codecs/encoder.cc.o.d"
+  "CMakeFiles/heif-internal.dir/codecs/hevc_boxes.cc.o"
+  "CMakeFiles/heif-internal.dir/codecs/hevc_boxes.cc.o.d"
+  "CMakeFiles/heif-internal.dir/codecs/hevc_dec.cc.o"
+  "CMakeFiles/heif-internal.dir/codecs/hevc_dec.cc.o.d"
+  "CMakeFiles/heif-internal.dir/codecs/hevc_enc.cc.o"
+  "CMakeFiles/heif-internal.dir/codecs/hevc_enc.cc.o.d"
+  "CMakeFiles/heif-internal.dir/codecs/jpeg2000_boxes.cc.o"
+  "CMakeFiles/heif-internal.dir/codecs/jpeg2000_boxes.cc.o.d"
+  "CMakeFiles/heif-internal.dir/codecs/jpeg2000_dec.cc.o"
+  "CMakeFiles/heif-internal.dir/codecs/jpeg2000_dec.cc.o.d"
+  "CMakeFiles/heif-internal.dir/codecs/jpeg2000_enc.cc.o"
+  "CMakeFiles/heif-internal.dir/codecs/jpeg2000_enc.cc.o.d"
+  "CMakeFiles/heif-internal.dir/codecs/jpeg_boxes.cc.o"
+  "CMakeFiles/heif-internal.dir/codecs/jpeg_boxes.cc.o.d"
+  "CMakeFiles/heif-internal.dir/codecs/jpeg_dec.cc.o"
+  "CMakeFiles/heif-internal.dir/codecs/jpeg_dec.cc.o.d"
+  "CMakeFiles/heif-internal.dir/codecs/jpeg_enc.cc.o"
+  "CMakeFiles/heif-internal.dir/codecs/jpeg_enc.cc.o.d"
+  "CMakeFiles/heif-internal.dir/codecs/vvc_boxes.cc.o"
+  "CMakeFiles/heif-internal.dir/codecs/vvc_boxes.cc.o.d"
+  "CMakeFiles/heif-internal.dir/codecs/vvc_dec.cc.o"
+  "CMakeFiles/heif-internal.dir/codecs/vvc_dec.cc.o.d"
+  "CMakeFiles/heif-internal.dir/codecs/vvc_enc.cc.o"
+  "CMakeFiles/heif-internal.dir/codecs/vvc_enc.cc.o.d"
+  "CMakeFiles/heif-internal.dir/color-conversion/alpha.cc.o"
+  "CMakeFiles/heif-internal.dir/color-conversion/alpha.cc.o.d"
+  "CMakeFiles/heif-internal.dir/color-conversion/chroma_sampling.cc.o"
+  "CMakeFiles/heif-internal.dir/color-conversion/chroma_sampling.cc.o.d"
+  "CMakeFiles/heif-internal.dir/color-conversion/colorconversion.cc.o"
+  "CMakeFiles/heif-internal.dir/color-conversion/colorconversion.cc.o.d"
+  "CMakeFiles/heif-internal.dir/color-conversion/hdr_sdr.cc.o"
+  "CMakeFiles/heif-internal.dir/color-conversion/hdr_sdr.cc.o.d"
+  "CMakeFiles/heif-internal.dir/color-conversion/monochrome.cc.o"
+  "CMakeFiles/heif-internal.dir/color-conversion/monochrome.cc.o.d"
+  "CMakeFiles/heif-internal.dir/color-conversion/rgb2rgb.cc.o"
+  "CMakeFiles/heif-internal.dir/color-conversion/rgb2rgb.cc.o.d"
+  "CMakeFiles/heif-internal.dir/color-conversion/rgb2yuv.cc.o"
+  "CMakeFiles/heif-internal.dir/color-conversion/rgb2yuv.cc.o.d"
+  "CMakeFiles/heif-internal.dir/color-conversion/rgb2yuv_sharp.cc.o"
+  "CMakeFiles/heif-internal.dir/color-conversion/rgb2yuv_sharp.cc.o.d"
+  "CMakeFiles/heif-internal.dir/color-conversion/simd.cc.o"
+  "CMakeFiles/heif-internal.dir/color-conversion/simd.cc.o.d"
+  "CMakeFiles/heif-internal.dir/color-conversion/yuv2rgb.cc.o"
+  "CMakeFiles/heif-internal.dir/color-conversion/yuv2rgb.cc.o.d"
+  "CMakeFiles/heif-internal.dir/common_utils.cc.o"
+  "CMakeFiles/heif-internal.dir/common_utils.cc.o.d"
+  "CMakeFiles/heif-internal.dir/compression.cc.o"
+  "CMakeFiles/heif-internal.dir/compression.cc.o.d"
+  "CMakeFiles/heif-internal.dir/compression_brotli.cc.o"
+  "CMakeFiles/heif-internal.dir/compression_brotli.cc.o.d"
+  "CMakeFiles/heif-internal.dir/compression_zlib.cc.o"
+  "CMakeFiles/heif-internal.dir/compression_zlib.cc.o.d"
+  "CMakeFiles/heif-internal.dir/compression_zstd.cc.o"
+  "CMakeFiles/heif-internal.dir/compression_zstd.cc.o.d"
+  "CMakeFiles/heif-internal.dir/context.cc.o"
+  "CMakeFiles/heif-internal.dir/context.cc.o.d"
+  "CMakeFiles/heif-internal.dir/error.cc.o"
+  "CMakeFiles/heif-internal.dir/error.cc.o.d"
+  "CMakeFiles/heif-internal.dir/file.cc.o"
+  "CMakeFiles/heif-internal.dir/file.cc.o.d"
+  "CMakeFiles/heif-internal.dir/file_layout.cc.o"
+  "CMakeFiles/heif-internal.dir/file_layout.cc.o.d"
+  "CMakeFiles/heif-internal.dir/image-items/avc.cc.o"
+  "CMakeFiles/heif-internal.dir/image-items/avc.cc.o.d"
+  "CMakeFiles/heif-internal.dir/image-items/avif.cc.o"
+  "CMakeFiles/heif-internal.dir/image-items/avif.cc.o.d"
+  "CMakeFiles/heif-internal.dir/image-items/grid.cc.o"
+  "CMakeFiles/heif-internal.dir/image-items/grid.cc.o.d"
+  "CMakeFiles/heif-internal.dir/image-items/hevc.cc.o"
+  "CMakeFiles/heif-internal.dir/image-items/hevc.cc.o.d"
+  "CMakeFiles/heif-internal.dir/image-items/iden.cc.o"
+  "CMakeFiles/heif-internal.dir/image-items/iden.cc.o.d"
+  "CMakeFiles/heif-internal.dir/image-items/image_item.cc.o"
+  "CMakeFiles/heif-internal.dir/image-items/image_item.cc.o.d"
+  "CMakeFiles/heif-internal.dir/image-items/jpeg.cc.o"
+  "CMakeFiles/heif-internal.dir/image-items/jpeg.cc.o.d"
+  "CMakeFiles/heif-internal.dir/image-items/jpeg2000.cc.o"
+  "CMakeFiles/heif-internal.dir/image-items/jpeg2000.cc.o.d"
+  "CMakeFiles/heif-internal.dir/image-items/mask_image.cc.o"
+  "CMakeFiles/heif-internal.dir/image-items/mask_image.cc.o.d"
+  "CMakeFiles/heif-internal.dir/image-items/overlay.cc.o"
+  "CMakeFiles/heif-internal.dir/image-items/overlay.cc.o.d"
+  "CMakeFiles/heif-internal.dir/image-items/tiled.cc.o"
+  "CMakeFiles/heif-internal.dir/image-items/tiled.cc.o.d"
+  "CMakeFiles/heif-internal.dir/image-items/vvc.cc.o"
+  "CMakeFiles/heif-internal.dir/image-items/vvc.cc.o.d"
+  "CMakeFiles/heif-internal.dir/init.cc.o"
+  "CMakeFiles/heif-internal.dir/init.cc.o.d"
+  "CMakeFiles/heif-internal.dir/logging.cc.o"
+  "CMakeFiles/heif-internal.dir/logging.cc.o.d"
+  "CMakeFiles/heif-internal.dir/nclx.cc.o"
+  "CMakeFiles/heif-internal.dir/nclx.cc.o.d"
+  "CMakeFiles/heif-internal.dir/pixelimage.cc.o"
+  "CMakeFiles/heif-internal.dir/pixelimage.cc.o.d"
+  "CMakeFiles/heif-internal.dir/plugin_registry.cc.o"
+  "CMakeFiles/heif-internal.dir/plugin_registry.cc.o.d"
+  "CMakeFiles/heif-internal.dir/plugins/encoder_mask.cc.o"
+  "CMakeFiles/heif-internal.dir/plugins/encoder_mask.cc.o.d"
+  "CMakeFiles/heif-internal.dir/plugins/nalu_utils.cc.o"
+  "CMakeFiles/heif-internal.dir/plugins/nalu_utils.cc.o.d"
+  "CMakeFiles/heif-internal.dir/plugins_unix.cc.o"
+  "CMakeFiles/heif-internal.dir/plugins_unix.cc.o.d"
+  "CMakeFiles/heif-internal.dir/region.cc.o"
+  "CMakeFiles/heif-internal.dir/region.cc.o.d"
+  "CMakeFiles/heif-internal.dir/security_limits.cc.o"
+  "CMakeFiles/heif-internal.dir/security_limits.cc.o.d"
+  "CMakeFiles/heif-internal.dir/sequences/chunk.cc.o"
+  "CMakeFiles/heif-internal.dir/sequences/chunk.cc.o.d"
+  "CMakeFiles/heif-internal.dir/sequences/seq_boxes.cc.o"
+  "CMakeFiles/heif-internal.dir/sequences/seq_boxes.cc.o.d"
+  "CMakeFiles/heif-internal.dir/sequences/track.cc.o"
+  "CMakeFiles/heif-internal.dir/sequences/track.cc.o.d"
+  "CMakeFiles/heif-internal.dir/sequences/track_metadata.cc.o"
+  "CMakeFiles/heif-internal.dir/sequences/track_metadata.cc.o.d"
+  "CMakeFiles/heif-internal.dir/sequences/track_visual.cc.o"
+  "CMakeFiles/heif-internal.dir/sequences/track_visual.cc.o.d"
+  "CMakeFiles/heif-internal.dir/text.cc.o"
+  "CMakeFiles/heif-internal.dir/text.cc.o.d"
+  "CMakeFiles/heif-internal.dir/thread_pool.cc.o"
+  "CMakeFiles/heif-internal.dir/thread_pool.cc.o.d"
+  "CMakeFiles/heif-internal.dir/tile_cache.cc.o"
+  "CMakeFiles/heif-internal.dir/tile_cache.cc.o.d"
+  "CMakeFiles/heif-internal.dir/trace.cc.o"
+  "CMakeFiles/heif-internal.dir/trace.cc.o.d"
+  "libheif-internal.a"
+  "libheif-internal.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/heif-internal.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,121 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/libheif/api/libheif/heif.cc" "libheif/CMakeFiles/heif.dir/api/libheif/heif.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/api/libheif/heif.cc.o.d"
+  "/root/repo/libheif/api/libheif/heif_aux_images.cc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_aux_images.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_aux_images.cc.o.d"
+  "/root/repo/libheif/api/libheif/heif_brands.cc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_brands.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_brands.cc.o.d"
+  "/root/repo/libheif/api/libheif/heif_color.cc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_color.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_color.cc.o.d"
+  "/root/repo/libheif/api/libheif/heif_context.cc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_context.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_context.cc.o.d"
+  "/root/repo/libheif/api/libheif/heif_decoding.cc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_decoding.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_decoding.cc.o.d"
+  "/root/repo/libheif/api/libheif/heif_encoding.cc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_encoding.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_encoding.cc.o.d"
+  "/root/repo/libheif/api/libheif/heif_entity_groups.cc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_entity_groups.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_entity_groups.cc.o.d"
+  "/root/repo/libheif/api/libheif/heif_image.cc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_image.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_image.cc.o.d"
+  "/root/repo/libheif/api/libheif/heif_image_handle.cc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_image_handle.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_image_handle.cc.o.d"
+  "/root/repo/libheif/api/libheif/heif_items.cc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_items.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_items.cc.o.d"
+  "/root/repo/libheif/api/libheif/heif_library.cc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_library.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_library.cc.o.d"
+  "/root/repo/libheif/api/libheif/heif_metadata.cc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_metadata.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_metadata.cc.o.d"
+  "/root/repo/libheif/api/libheif/heif_plugin.cc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_plugin.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_plugin.cc.o.d"
+  "/root/repo/libheif/api/libheif/heif_probe.cc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_probe.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_probe.cc.o.d"
+  "/root/repo/libheif/api/libheif/heif_properties.cc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_properties.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_properties.cc.o.d"
+  "/root/repo/libheif/api/libheif/heif_regions.cc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_regions.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_regions.cc.o.d"
+  "/root/repo/libheif/api/libheif/heif_security.cc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_security.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_security.cc.o.d"
+  "/root/repo/libheif/api/libheif/heif_sequences.cc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_sequences.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_sequences.cc.o.d"
+  "/root/repo/libheif/api/libheif/heif_tai_timestamps.cc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_tai_timestamps.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_tai_timestamps.cc.o.d"
+  "/root/repo/libheif/api/libheif/heif_text.cc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_text.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_text.cc.o.d"
+  "/root/repo/libheif/api/libheif/heif_tiling.cc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_tiling.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_tiling.cc.o.d"
+  "/root/repo/libheif/api/libheif/heif_tracing.cc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_tracing.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_tracing.cc.o.d"
+  "/root/repo/libheif/api/libheif/heif_uncompressed.cc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_uncompressed.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/api/libheif/heif_uncompressed.cc.o.d"
+  "/root/repo/libheif/bitstream.cc" "libheif/CMakeFiles/heif.dir/bitstream.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/bitstream.cc.o.d"
+  "/root/repo/libheif/box.cc" "libheif/CMakeFiles/heif.dir/box.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/box.cc.o.d"
+  "/root/repo/libheif/brands.cc" "libheif/CMakeFiles/heif.dir/brands.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/brands.cc.o.d"
+  "/root/repo/libheif/codecs/avc_boxes.cc" "libheif/CMakeFiles/heif.dir/codecs/avc_boxes.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/codecs/avc_boxes.cc.o.d"
+  "/root/repo/libheif/codecs/avc_dec.cc" "libheif/CMakeFiles/heif.dir/codecs/avc_dec.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/codecs/avc_dec.cc.o.d"
+  "/root/repo/libheif/codecs/avif_boxes.cc" "libheif/CMakeFiles/heif.dir/codecs/avif_boxes.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/codecs/avif_boxes.cc.o.d"
+  "/root/repo/libheif/codecs/avif_dec.cc" "libheif/CMakeFiles/heif.dir/codecs/avif_dec.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/codecs/avif_dec.cc.o.d"
+  "/root/repo/libheif/codecs/avif_enc.cc" "libheif/CMakeFiles/heif.dir/codecs/avif_enc.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/codecs/avif_enc.cc.o.d"
+  "/root/repo/libheif/codecs/decoder.cc" "libheif/CMakeFiles/heif.dir/codecs/decoder.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/codecs/decoder.cc.o.d"
+  "/root/repo/libheif/codecs/encoder.cc" "libheif/CMakeFiles/heif.dir/codecs/encoder.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/codecs/encoder.cc.o.d"
+  "/root/repo/libheif/codecs/hevc_boxes.cc" "libheif/CMakeFiles/heif.dir/codecs/hevc_boxes.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/codecs/hevc_boxes.cc.o.d"
+  "/root/repo/libheif/codecs/hevc_dec.cc" "libheif/CMakeFiles/heif.dir/codecs/hevc_dec.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/codecs/hevc_dec.cc.o.d"
+  "/root/repo/libheif/codecs/hevc_enc.cc" "libheif/CMakeFiles/heif.dir/codecs/hevc_enc.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/codecs/hevc_enc.cc.o.d"
+  "/root/repo/libheif/codecs/jpeg2000_boxes.cc" "libheif/CMakeFiles/heif.dir/codecs/jpeg2000_boxes.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/codecs/jpeg2000_boxes.cc.o.d"
+  "/root/repo/libheif/codecs/jpeg2000_dec.cc" "libheif/CMakeFiles/heif.dir/codecs/jpeg2000_dec.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/codecs/jpeg2000_dec.cc.o.d"
+  "/root/repo/libheif/codecs/jpeg2000_enc.cc" "libheif/CMakeFiles/heif.dir/codecs/jpeg2000_enc.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/codecs/jpeg2000_enc.cc.o.d"
+  "/root/repo/libheif/codecs/jpeg_boxes.cc" "libheif/CMakeFiles/heif.dir/codecs/jpeg_boxes.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/codecs/jpeg_boxes.cc.o.d"
+  "/root/repo/libheif/codecs/jpeg_dec.cc" "libheif/CMakeFiles/heif.dir/codecs/jpeg_dec.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/codecs/jpeg_dec.cc.o.d"
+  "/root/repo/libheif/codecs/jpeg_enc.cc" "libheif/CMakeFiles/heif.dir/codecs/jpeg_enc.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/codecs/jpeg_enc.cc.o.d"
+  "/root/repo/libheif/codecs/vvc_boxes.cc" "libheif/CMakeFiles/heif.dir/codecs/vvc_boxes.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/codecs/vvc_boxes.cc.o.d"
+  "/root/repo/libheif/codecs/vvc_dec.cc" "libheif/CMakeFiles/heif.dir/codecs/vvc_dec.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/codecs/vvc_dec.cc.o.d"
+  "/root/repo/libheif/codecs/vvc_enc.cc" "libheif/CMakeFiles/heif.dir/codecs/vvc_enc.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/codecs/vvc_enc.cc.o.d"
+  "/root/repo/libheif/color-conversion/alpha.cc" "libheif/CMakeFiles/heif.dir/color-conversion/alpha.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/color-conversion/alpha.cc.o.d"
+  "/root/repo/libheif/color-conversion/chroma_sampling.cc" "libheif/CMakeFiles/heif.dir/color-conversion/chroma_sampling.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/color-conversion/chroma_sampling.cc.o.d"
+  "/root/repo/libheif/color-conversion/colorconversion.cc" "libheif/CMakeFiles/heif.dir/color-conversion/colorconversion.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/color-conversion/colorconversion.cc.o.d"
+  "/root/repo/libheif/color-conversion/hdr_sdr.cc" "libheif/CMakeFiles/heif.dir/color-conversion/hdr_sdr.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/color-conversion/hdr_sdr.cc.o.d"
+  "/root/repo/libheif/color-conversion/monochrome.cc" "libheif/CMakeFiles/heif.dir/color-conversion/monochrome.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/color-conversion/monochrome.cc.o.d"
+  "/root/repo/libheif/color-conversion/rgb2rgb.cc" "libheif/CMakeFiles/heif.dir/color-conversion/rgb2rgb.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/color-conversion/rgb2rgb.cc.o.d"
+  "/root/repo/libheif/color-conversion/rgb2yuv.cc" "libheif/CMakeFiles/heif.dir/color-conversion/rgb2yuv.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/color-conversion/rgb2yuv.cc.o.d"
+  "/root/repo/libheif/color-conversion/rgb2yuv_sharp.cc" "libheif/CMakeFiles/heif.dir/color-conversion/rgb2yuv_sharp.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/color-conversion/rgb2yuv_sharp.cc.o.d"
+  "/root/repo/libheif/color-conversion/simd.cc" "libheif/CMakeFiles/heif.dir/color-conversion/simd.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/color-conversion/simd.cc.o.d"
+  "/root/repo/libheif/color-conversion/yuv2rgb.cc" "libheif/CMakeFiles/heif.dir/color-conversion/yuv2rgb.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/color-conversion/yuv2rgb.cc.o.d"
+  "/root/repo/libheif/common_utils.cc" "libheif/CMakeFiles/heif.dir/common_utils.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/common_utils.cc.o.d"
+  "/root/repo/libheif/compression.cc" "libheif/CMakeFiles/heif.dir/compression.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/compression.cc.o.d"
+  "/root/repo/libheif/compression_brotli.cc" "libheif/CMakeFiles/heif.dir/compression_brotli.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/compression_brotli.cc.o.d"
+  "/root/repo/libheif/compression_zlib.cc" "libheif/CMakeFiles/heif.dir/compression_zlib.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/compression_zlib.cc.o.d"
+  "/root/repo/libheif/compression_zstd.cc" "libheif/CMakeFiles/heif.dir/compression_zstd.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/compression_zstd.cc.o.d"
+  "/root/repo/libheif/context.cc" "libheif/CMakeFiles/heif.dir/context.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/context.cc.o.d"
+  "/root/repo/libheif/error.cc" "libheif/CMakeFiles/heif.dir/error.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/error.cc.o.d"
+  "/root/repo/libheif/file.cc" "libheif/CMakeFiles/heif.dir/file.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/file.cc.o.d"
+  "/root/repo/libheif/file_layout.cc" "libheif/CMakeFiles/heif.dir/file_layout.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/file_layout.cc.o.d"
+  "/root/repo/libheif/image-items/avc.cc" "libheif/CMakeFiles/heif.dir/image-items/avc.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/image-items/avc.cc.o.d"
+  "/root/repo/libheif/image-items/avif.cc" "libheif/CMakeFiles/heif.dir/image-items/avif.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/image-items/avif.cc.o.d"
+  "/root/repo/libheif/image-items/grid.cc" "libheif/CMakeFiles/heif.dir/image-items/grid.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/image-items/grid.cc.o.d"
+  "/root/repo/libheif/image-items/hevc.cc" "libheif/CMakeFiles/heif.dir/image-items/hevc.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/image-items/hevc.cc.o.d"
+  "/root/repo/libheif/image-items/iden.cc" "libheif/CMakeFiles/heif.dir/image-items/iden.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/image-items/iden.cc.o.d"
+  "/root/repo/libheif/image-items/image_item.cc" "libheif/CMakeFiles/heif.dir/image-items/image_item.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/image-items/image_item.cc.o.d"
+  "/root/repo/libheif/image-items/jpeg.cc" "libheif/CMakeFiles/heif.dir/image-items/jpeg.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/image-items/jpeg.cc.o.d"
+  "/root/repo/libheif/image-items/jpeg2000.cc" "libheif/CMakeFiles/heif.dir/image-items/jpeg2000.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/image-items/jpeg2000.cc.o.d"
+  "/root/repo/libheif/image-items/mask_image.cc" "libheif/CMakeFiles/heif.dir/image-items/mask_image.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/image-items/mask_image.cc.o.d"
+  "/root/repo/libheif/image-items/overlay.cc" "libheif/CMakeFiles/heif.dir/image-items/overlay.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/image-items/overlay.cc.o.d"
+  "/root/repo/libheif/image-items/tiled.cc" "libheif/CMakeFiles/heif.dir/image-items/tiled.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/image-items/tiled.cc.o.d"
+  "/root/repo/libheif/image-items/vvc.cc" "libheif/CMakeFiles/heif.dir/image-items/vvc.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/image-items/vvc.cc.o.d"
+  "/root/repo/libheif/init.cc" "libheif/CMakeFiles/heif.dir/init.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/init.cc.o.d"
+  "/root/repo/libheif/logging.cc" "libheif/CMakeFiles/heif.dir/logging.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/logging.cc.o.d"
+  "/root/repo/libheif/nclx.cc" "libheif/CMakeFiles/heif.dir/nclx.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/nclx.cc.o.d"
+  "/root/repo/libheif/pixelimage.cc" "libheif/CMakeFiles/heif.dir/pixelimage.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/pixelimage.cc.o.d"
+  "/root/repo/libheif/plugin_registry.cc" "libheif/CMakeFiles/heif.dir/plugin_registry.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/plugin_registry.cc.o.d"
+  "/root/repo/libheif/plugins/encoder_mask.cc" "libheif/CMakeFiles/heif.dir/plugins/encoder_mask.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/plugins/encoder_mask.cc.o.d"
+  "/root/repo/libheif/plugins/nalu_utils.cc" "libheif/CMakeFiles/heif.dir/plugins/nalu_utils.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/plugins/nalu_utils.cc.o.d"
+  "/root/repo/libheif/plugins_unix.cc" "libheif/CMakeFiles/heif.dir/plugins_unix.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/plugins_unix.cc.o.d"
+  "/root/repo/libheif/region.cc" "libheif/CMakeFiles/heif.dir/region.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/region.cc.o.d"
+  "/root/repo/libheif/security_limits.cc" "libheif/CMakeFiles/heif.dir/security_limits.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/security_limits.cc.o.d"
+  "/root/repo/libheif/sequences/chunk.cc" "libheif/CMakeFiles/heif.dir/sequences/chunk.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/sequences/chunk.cc.o.d"
+  "/root/repo/libheif/sequences/seq_boxes.cc" "libheif/CMakeFiles/heif.dir/sequences/seq_boxes.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/sequences/seq_boxes.cc.o.d"
+  "/root/repo/libheif/sequences/track.cc" "libheif/CMakeFiles/heif.dir/sequences/track.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/sequences/track.cc.o.d"
+  "/root/repo/libheif/sequences/track_metadata.cc" "libheif/CMakeFiles/heif.dir/sequences/track_metadata.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/sequences/track_metadata.cc.o.d"
+  "/root/repo/libheif/sequences/track_visual.cc" "libheif/CMakeFiles/heif.dir/sequences/track_visual.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/sequences/track_visual.cc.o.d"
+  "/root/repo/libheif/text.cc" "libheif/CMakeFiles/heif.dir/text.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/text.cc.o.d"
+  "/root/repo/libheif/thread_pool.cc" "libheif/CMakeFiles/heif.dir/thread_pool.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/thread_pool.cc.o.d"
+  "/root/repo/libheif/tile_cache.cc" "libheif/CMakeFiles/heif.dir/tile_cache.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/tile_cache.cc.o.d"
+  "/root/repo/libheif/trace.cc" "libheif/CMakeFiles/heif.dir/trace.cc.o" "gcc" "libheif/CMakeFiles/heif.dir/trace.cc.o.d"
+  )
+
+# Pairs of files generated by the same build rule.
+set(CMAKE_MULTIPLE_OUTPUT_PAIRS
+  "/root/repo/_gate_default/libheif/libheif.so" "/root/repo/_gate_default/libheif/libheif.so.1.21.0"
+  "/root/repo/_gate_default/libheif/libheif.so.1" "/root/repo/_gate_default/libheif/libheif.so.1.21.0"
+  )
+
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,7 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/libheif
+# Build directory: /root/repo/_gate_default/libheif
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+subdirs("plugins")
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/encode.dir/encode.cc.o"
+  "CMakeFiles/encode.dir/encode.cc.o.d"
+  "encode"
+  "encode.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/encode.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
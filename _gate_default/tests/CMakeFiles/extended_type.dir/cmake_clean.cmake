@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/extended_type.dir/extended_type.cc.o"
+  "CMakeFiles/extended_type.dir/extended_type.cc.o.d"
+  "extended_type"
+  "extended_type.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/extended_type.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/heif-test-plugin.dir/test_decoder_plugin.cc.o"
+  "CMakeFiles/heif-test-plugin.dir/test_decoder_plugin.cc.o.d"
+  "libheif-test-plugin.pdb"
+  "libheif-test-plugin.so"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/heif-test-plugin.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/plugin_loading.dir/plugin_loading.cc.o"
+  "CMakeFiles/plugin_loading.dir/plugin_loading.cc.o.d"
+  "plugin_loading"
+  "plugin_loading.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/plugin_loading.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
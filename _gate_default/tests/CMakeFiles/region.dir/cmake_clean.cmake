@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/region.dir/region.cc.o"
+  "CMakeFiles/region.dir/region.cc.o.d"
+  "region"
+  "region.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/region.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
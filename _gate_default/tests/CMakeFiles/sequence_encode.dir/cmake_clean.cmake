@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/sequence_encode.dir/sequence_encode.cc.o"
+  "CMakeFiles/sequence_encode.dir/sequence_encode.cc.o.d"
+  "sequence_encode"
+  "sequence_encode.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/sequence_encode.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/sequence_encoder_plugin.dir/sequence_encoder_plugin.cc.o"
+  "CMakeFiles/sequence_encoder_plugin.dir/sequence_encoder_plugin.cc.o.d"
+  "sequence_encoder_plugin"
+  "sequence_encoder_plugin.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/sequence_encoder_plugin.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
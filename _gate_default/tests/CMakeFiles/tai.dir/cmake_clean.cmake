@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/tai.dir/tai.cc.o"
+  "CMakeFiles/tai.dir/tai.cc.o.d"
+  "tai"
+  "tai.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/tai.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
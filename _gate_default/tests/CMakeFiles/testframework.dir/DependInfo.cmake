@@ -0,0 +1,22 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/_gate_default/generated/test-config.cc" "tests/CMakeFiles/testframework.dir/__/generated/test-config.cc.o" "gcc" "tests/CMakeFiles/testframework.dir/__/generated/test-config.cc.o.d"
+  "/root/repo/tests/catch_amalgamated.cpp" "tests/CMakeFiles/testframework.dir/catch_amalgamated.cpp.o" "gcc" "tests/CMakeFiles/testframework.dir/catch_amalgamated.cpp.o.d"
+  "/root/repo/tests/test_utils.cc" "tests/CMakeFiles/testframework.dir/test_utils.cc.o" "gcc" "tests/CMakeFiles/testframework.dir/test_utils.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_gate_default/libheif/CMakeFiles/heif.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
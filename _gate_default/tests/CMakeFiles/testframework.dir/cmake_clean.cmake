@@ -0,0 +1,15 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/testframework.dir/__/generated/test-config.cc.o"
+  "CMakeFiles/testframework.dir/__/generated/test-config.cc.o.d"
+  "CMakeFiles/testframework.dir/catch_amalgamated.cpp.o"
+  "CMakeFiles/testframework.dir/catch_amalgamated.cpp.o.d"
+  "CMakeFiles/testframework.dir/test_utils.cc.o"
+  "CMakeFiles/testframework.dir/test_utils.cc.o.d"
+  "libtestframework.a"
+  "libtestframework.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/testframework.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/text.dir/text.cc.o"
+  "CMakeFiles/text.dir/text.cc.o.d"
+  "text"
+  "text.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/text.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
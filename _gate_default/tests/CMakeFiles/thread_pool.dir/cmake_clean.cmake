@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/thread_pool.dir/thread_pool.cc.o"
+  "CMakeFiles/thread_pool.dir/thread_pool.cc.o.d"
+  "thread_pool"
+  "thread_pool.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/thread_pool.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
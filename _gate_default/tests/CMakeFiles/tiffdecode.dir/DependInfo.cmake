@@ -0,0 +1,23 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/tests/main.cc" "tests/CMakeFiles/tiffdecode.dir/main.cc.o" "gcc" "tests/CMakeFiles/tiffdecode.dir/main.cc.o.d"
+  "/root/repo/tests/tiffdecode.cc" "tests/CMakeFiles/tiffdecode.dir/tiffdecode.cc.o" "gcc" "tests/CMakeFiles/tiffdecode.dir/tiffdecode.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  "/root/repo/_gate_default/heifio/CMakeFiles/heifio.dir/DependInfo.cmake"
+  "/root/repo/_gate_default/tests/CMakeFiles/testframework.dir/DependInfo.cmake"
+  "/root/repo/_gate_default/libheif/CMakeFiles/heif.dir/DependInfo.cmake"
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
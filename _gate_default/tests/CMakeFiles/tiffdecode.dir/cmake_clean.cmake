@@ -0,0 +1,13 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/tiffdecode.dir/main.cc.o"
+  "CMakeFiles/tiffdecode.dir/main.cc.o.d"
+  "CMakeFiles/tiffdecode.dir/tiffdecode.cc.o"
+  "CMakeFiles/tiffdecode.dir/tiffdecode.cc.o.d"
+  "tiffdecode"
+  "tiffdecode.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/tiffdecode.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
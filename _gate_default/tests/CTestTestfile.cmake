@@ -0,0 +1,26 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/tests
+# Build directory: /root/repo/_gate_default/tests
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test([=[encode]=] "./encode")
+set_tests_properties([=[encode]=] PROPERTIES  ENVIRONMENT "LIBHEIF_PLUGIN_PATH=/root/repo/_gate_default/libheif/plugins" SKIP_REGULAR_EXPRESSION "[1-9][0-9]* skipped" _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;21;add_test;/root/repo/tests/CMakeLists.txt;59;add_libheif_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test([=[extended_type]=] "./extended_type")
+set_tests_properties([=[extended_type]=] PROPERTIES  ENVIRONMENT "LIBHEIF_PLUGIN_PATH=/root/repo/_gate_default/libheif/plugins" SKIP_REGULAR_EXPRESSION "[1-9][0-9]* skipped" _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;21;add_test;/root/repo/tests/CMakeLists.txt;60;add_libheif_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test([=[region]=] "./region")
+set_tests_properties([=[region]=] PROPERTIES  ENVIRONMENT "LIBHEIF_PLUGIN_PATH=/root/repo/_gate_default/libheif/plugins" SKIP_REGULAR_EXPRESSION "[1-9][0-9]* skipped" _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;21;add_test;/root/repo/tests/CMakeLists.txt;61;add_libheif_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test([=[sequence_encode]=] "./sequence_encode")
+set_tests_properties([=[sequence_encode]=] PROPERTIES  ENVIRONMENT "LIBHEIF_PLUGIN_PATH=/root/repo/_gate_default/libheif/plugins" SKIP_REGULAR_EXPRESSION "[1-9][0-9]* skipped" _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;21;add_test;/root/repo/tests/CMakeLists.txt;62;add_libheif_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test([=[sequence_encoder_plugin]=] "./sequence_encoder_plugin")
+set_tests_properties([=[sequence_encoder_plugin]=] PROPERTIES  ENVIRONMENT "LIBHEIF_PLUGIN_PATH=/root/repo/_gate_default/libheif/plugins" SKIP_REGULAR_EXPRESSION "[1-9][0-9]* skipped" _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;21;add_test;/root/repo/tests/CMakeLists.txt;63;add_libheif_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test([=[tai]=] "./tai")
+set_tests_properties([=[tai]=] PROPERTIES  ENVIRONMENT "LIBHEIF_PLUGIN_PATH=/root/repo/_gate_default/libheif/plugins" SKIP_REGULAR_EXPRESSION "[1-9][0-9]* skipped" _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;21;add_test;/root/repo/tests/CMakeLists.txt;64;add_libheif_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test([=[text]=] "./text")
+set_tests_properties([=[text]=] PROPERTIES  ENVIRONMENT "LIBHEIF_PLUGIN_PATH=/root/repo/_gate_default/libheif/plugins" SKIP_REGULAR_EXPRESSION "[1-9][0-9]* skipped" _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;21;add_test;/root/repo/tests/CMakeLists.txt;65;add_libheif_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test([=[thread_pool]=] "./thread_pool")
+set_tests_properties([=[thread_pool]=] PROPERTIES  ENVIRONMENT "LIBHEIF_PLUGIN_PATH=/root/repo/_gate_default/libheif/plugins" SKIP_REGULAR_EXPRESSION "[1-9][0-9]* skipped" _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;21;add_test;/root/repo/tests/CMakeLists.txt;66;add_libheif_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test([=[plugin_loading]=] "./plugin_loading")
+set_tests_properties([=[plugin_loading]=] PROPERTIES  ENVIRONMENT "LIBHEIF_PLUGIN_PATH=/root/repo/_gate_default/libheif/plugins" SKIP_REGULAR_EXPRESSION "[1-9][0-9]* skipped" _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;21;add_test;/root/repo/tests/CMakeLists.txt;71;add_libheif_test;/root/repo/tests/CMakeLists.txt;0;")
+add_test([=[tiffdecode]=] "./tiffdecode")
+set_tests_properties([=[tiffdecode]=] PROPERTIES  ENVIRONMENT "LIBHEIF_PLUGIN_PATH=/root/repo/_gate_default/libheif/plugins" SKIP_REGULAR_EXPRESSION "[1-9][0-9]* skipped" _BACKTRACE_TRIPLES "/root/repo/tests/CMakeLists.txt;30;add_test;/root/repo/tests/CMakeLists.txt;117;add_heifio_test;/root/repo/tests/CMakeLists.txt;0;")
@@ -0,0 +1,19 @@
+include(FindPackageHandleStandardArgs)
+
+find_path(LIBDEFLATE_INCLUDE_DIR "libdeflate.h")
+
+find_library(LIBDEFLATE_LIBRARY NAMES deflate libdeflate)
+
+find_package_handle_standard_args(LIBDEFLATE
+  FOUND_VAR
+    LIBDEFLATE_FOUND
+  REQUIRED_VARS
+    LIBDEFLATE_INCLUDE_DIR
+    LIBDEFLATE_LIBRARY
+  FAIL_MESSAGE
+    "Did not find libdeflate"
+)
+
+
+set(LIBDEFLATE_INCLUDE_DIRS ${LIBDEFLATE_INCLUDE_DIR})
+set(LIBDEFLATE_LIBRARIES ${LIBDEFLATE_LIBRARY})
@@ -0,0 +1,19 @@
+include(FindPackageHandleStandardArgs)
+
+find_path(ZSTD_INCLUDE_DIR "zstd.h")
+
+find_library(ZSTD_LIBRARY NAMES zstd)
+
+find_package_handle_standard_args(ZSTD
+  FOUND_VAR
+    ZSTD_FOUND
+  REQUIRED_VARS
+    ZSTD_INCLUDE_DIR
+    ZSTD_LIBRARY
+  FAIL_MESSAGE
+    "Did not find zstd"
+)
+
+
+set(ZSTD_INCLUDE_DIRS ${ZSTD_INCLUDE_DIR})
+set(ZSTD_LIBRARIES ${ZSTD_LIBRARY})
@@ -0,0 +1,990 @@
+/*
+  libheif example application "heif-bench".
+
+  MIT License
+
+  Copyright (c) 2025 Dirk Farin <dirk.farin@gmail.com>
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+/*
+  Measures the throughput of libheif itself over a set of input files and writes
+  the results as JSON, so that performance regressions can be tracked across releases.
+
+  Before anything else, the library startup is measured (stage 'startup'): heif_init() followed by the
+  first decoder lookup for one compression format. It is measured once with all plugins loaded at
+  initialization and once with a plugin manifest, with which only the plugin for this format is loaded.
+  heif_deinit() unloads the plugins after each run, but the system may keep the plugin libraries mapped.
+  The timed runs thus do not include reading the plugin files from disk.
+
+  Per input file, these stages are measured:
+    read_file       reading the file into memory
+    open_file       heif_context_read_from_file() (I/O and parsing)
+    parse           heif_context_read_from_memory_without_copy() (parsing only)
+    probe_file      heif_probe() on the file (header-only, compare with open_file)
+    probe           heif_probe() on the file in memory (compare with parse)
+    decode          decoding the primary image into its native format
+    decode_rgb      decoding the primary image into interleaved RGB(A)
+    decode_tile     decoding a single tile of a grid or tiled image
+    tile_assembly   decoding a full grid or tiled image (replaces 'decode')
+    encode          encoding the decoded image again
+    write           writing the encoded file into memory
+
+  Independent of the input files, each color conversion operation is measured in
+  isolation on synthetic images (only when the library is built with full symbol visibility).
+  The RGB to YCbCr 4:2:0 conversions are also measured with sharp YUV chroma downsampling
+  (stage 'color_pipeline_sharp_yuv') when libsharpyuv is available.
+
+  Also independent of the input files, each generic compression method that the library
+  supports is measured in isolation (stages 'compress' and 'decompress') on synthetic
+  image data of the color conversion size.
+*/
+
+#include <libheif/heif.h>
+#include <libheif/heif_items.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <getopt.h>
+
+#include "common.h"
+
+#if HEIF_BENCH_INTERNALS
+#include "api_structs.h"
+#include "color-conversion/colorconversion.h"
+#include "compression.h"
+#endif
+
+
+static int option_iterations = 10;
+static int option_threads = -1;
+static int option_no_encode = 0;
+static int option_no_conversion = 0;
+static int option_no_compression = 0;
+static int option_no_startup = 0;
+static std::string option_startup_format = "hevc";
+static uint32_t option_conversion_width = 1920;
+static uint32_t option_conversion_height = 1080;
+static std::string option_encoder;
+static std::string option_output;
+
+static option long_options[] = {
+    {(char* const) "iterations",      required_argument, 0,                     'n'},
+    {(char* const) "output",          required_argument, 0,                     'o'},
+    {(char* const) "encoder",         required_argument, 0,                     'e'},
+    {(char* const) "threads",         required_argument, 0,                     't'},
+    {(char* const) "conversion-size", required_argument, 0,                     's'},
+    {(char* const) "no-encode",       no_argument,       &option_no_encode,     1},
+    {(char* const) "no-conversion",   no_argument,       &option_no_conversion, 1},
+    {(char* const) "no-compression",  no_argument,       &option_no_compression, 1},
+    {(char* const) "no-startup",      no_argument,       &option_no_startup,    1},
+    {(char* const) "startup-format",  required_argument, 0,                     'f'},
+    {(char* const) "help",            no_argument,       0,                     'h'},
+    {(char* const) "version",         no_argument,       0,                     'v'},
+    {0, 0,                                               0,                     0}
+};
+
+
+static void show_help(const char* argv0)
+{
+  std::filesystem::path p(argv0);
+  std::string filename = p.filename().string();
+
+  std::stringstream sstr;
+  sstr << " " << filename << "  libheif version: " << heif_get_version();
+
+  std::string title = sstr.str();
+
+  std::cerr << title << "\n"
+            << std::string(title.length() + 1, '-') << "\n"
+            << "Usage: " << filename << " [options] <HEIF-files...>\n"
+            << "\n"
+               "options:\n"
+               "  -n, --iterations N        number of timed runs per stage (default: 10)\n"
+               "  -o, --output FILE         write the JSON report to FILE instead of stdout\n"
+               "  -e, --encoder FORMAT      encode with FORMAT (hevc, av1, jpeg, j2k, htj2k, avc, vvc, unci)\n"
+               "                            instead of the format of the input image\n"
+               "  -t, --threads N           maximum number of decoding threads\n"
+               "  -s, --conversion-size WxH size of the synthetic color conversion images (default: 1920x1080)\n"
+               "      --no-encode           skip the encode and write stages\n"
+               "      --no-conversion       skip the color conversion benchmarks\n"
+               "      --no-compression      skip the generic compression benchmarks\n"
+               "      --no-startup          skip the library startup benchmark\n"
+               "  -f, --startup-format FMT  decoder format looked up in the startup benchmark (default: hevc)\n"
+               "  -h, --help                show help\n"
+               "  -v, --version             show version\n";
+}
+
+
+class LibHeifInitializer
+{
+public:
+  LibHeifInitializer() { heif_init(nullptr); }
+
+  ~LibHeifInitializer() { heif_deinit(); }
+};
+
+
+// --- measurement
+
+struct BenchResult
+{
+  std::string stage;
+  std::string name;
+  std::string file;
+  double megapixels = 0; // per run, 0 if not applicable
+  std::vector<double> ms;
+};
+
+static std::vector<BenchResult> results;
+
+
+// Runs 'f' once as warm-up and then 'option_iterations' times with timing.
+// 'f' returns false on failure, in which case no result is recorded.
+// 'cleanup' (optional) is run after each call of 'f' and is not included in the timing.
+static bool measure(BenchResult result, const std::function<bool()>& f,
+                    const std::function<void()>& cleanup = nullptr)
+{
+  bool success = f();
+  if (cleanup) {
+    cleanup();
+  }
+
+  if (!success) {
+    std::cerr << "skipping " << result.stage << " (" << result.name << ")"
+              << (result.file.empty() ? "" : " for ") << result.file << "\n";
+    return false;
+  }
+
+  for (int i = 0; i < option_iterations; i++) {
+    auto start = std::chrono::steady_clock::now();
+    success = f();
+    auto end = std::chrono::steady_clock::now();
+
+    if (cleanup) {
+      cleanup();
+    }
+
+    if (!success) {
+      return false;
+    }
+
+    result.ms.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+  }
+
+  results.push_back(std::move(result));
+  return true;
+}
+
+
+static double percentile(const std::vector<double>& sorted, double p)
+{
+  // nearest-rank method
+  size_t rank = (size_t) std::ceil(p / 100.0 * (double) sorted.size());
+  return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+
+static std::string json_string(const std::string& s)
+{
+  std::ostringstream out;
+  out << '"';
+  for (char c : s) {
+    switch (c) {
+      case '"':
+        out << "\\\"";
+        break;
+      case '\\':
+        out << "\\\\";
+        break;
+      case '\n':
+        out << "\\n";
+        break;
+      default:
+        if ((unsigned char) c < 0x20) {
+          char buf[8];
+          snprintf(buf, sizeof(buf), "\\u%04x", c);
+          out << buf;
+        }
+        else {
+          out << c;
+        }
+    }
+  }
+  out << '"';
+  return out.str();
+}
+
+
+static void write_json(std::ostream& out)
+{
+  out << "{\n"
+      << "  \"libheif_version\": " << json_string(heif_get_version()) << ",\n"
+      << "  \"iterations\": " << option_iterations << ",\n"
+      << "  \"results\": [";
+
+  for (size_t i = 0; i < results.size(); i++) {
+    BenchResult& r = results[i];
+    std::vector<double> sorted = r.ms;
+    std::sort(sorted.begin(), sorted.end());
+
+    double sum = 0;
+    for (double v : sorted) {
+      sum += v;
+    }
+
+    double p50 = percentile(sorted, 50);
+
+    out << (i == 0 ? "\n" : ",\n")
+        << "    {\"stage\": " << json_string(r.stage)
+        << ", \"name\": " << json_string(r.name);
+    if (!r.file.empty()) {
+      out << ", \"file\": " << json_string(r.file);
+    }
+    out << ", \"samples\": " << sorted.size()
+        << ", \"min_ms\": " << sorted.front()
+        << ", \"mean_ms\": " << sum / (double) sorted.size()
+        << ", \"p50_ms\": " << p50
+        << ", \"p90_ms\": " << percentile(sorted, 90)
+        << ", \"p99_ms\": " << percentile(sorted, 99)
+        << ", \"max_ms\": " << sorted.back();
+    if (r.megapixels > 0 && p50 > 0) {
+      out << ", \"mpix_per_s\": " << r.megapixels / (p50 / 1000.0);
+    }
+    out << "}";
+  }
+
+  out << "\n  ]\n}\n";
+}
+
+
+// --- file benchmarks
+
+static bool compression_format_from_name(const std::string& name, heif_compression_format& format)
+{
+  static const std::pair<const char*, heif_compression_format> formats[] = {
+      {"hevc",  heif_compression_HEVC},
+      {"hvc1",  heif_compression_HEVC},
+      {"av1",   heif_compression_AV1},
+      {"av01",  heif_compression_AV1},
+      {"avc",   heif_compression_AVC},
+      {"avc1",  heif_compression_AVC},
+      {"vvc",   heif_compression_VVC},
+      {"vvc1",  heif_compression_VVC},
+      {"jpeg",  heif_compression_JPEG},
+      {"j2k",   heif_compression_JPEG2000},
+      {"j2k1",  heif_compression_JPEG2000},
+      {"htj2k", heif_compression_HTJ2K},
+      {"unci",  heif_compression_uncompressed},
+  };
+
+  for (const auto& f : formats) {
+    if (name == f.first) {
+      format = f.second;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+struct MemoryWriter
+{
+  std::vector<uint8_t> data;
+
+  static heif_error write(heif_context*, const void* data, size_t size, void* userdata)
+  {
+    auto* writer = static_cast<MemoryWriter*>(userdata);
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    writer->data.insert(writer->data.end(), bytes, bytes + size);
+    return heif_error_success;
+  }
+};
+
+
+// Minimal heif_readers over a std::istream and over a memory buffer, for heif_probe().
+struct StreamProbeReader
+{
+  std::istream* istr;
+  int64_t size;
+
+  static heif_reader get_reader()
+  {
+    heif_reader reader{};
+    reader.reader_api_version = 1;
+    reader.get_position = [](void* userdata) {
+      return (int64_t) static_cast<StreamProbeReader*>(userdata)->istr->tellg();
+    };
+    reader.read = [](void* data, size_t size, void* userdata) {
+      auto* r = static_cast<StreamProbeReader*>(userdata);
+      r->istr->read(static_cast<char*>(data), (std::streamsize) size);
+      return r->istr->good() ? 0 : 1;
+    };
+    reader.seek = [](int64_t position, void* userdata) {
+      auto* r = static_cast<StreamProbeReader*>(userdata);
+      r->istr->seekg(position, std::ios_base::beg);
+      return r->istr->good() ? 0 : 1;
+    };
+    reader.wait_for_file_size = [](int64_t target_size, void* userdata) {
+      return target_size <= static_cast<StreamProbeReader*>(userdata)->size ?
+             heif_reader_grow_status_size_reached : heif_reader_grow_status_size_beyond_eof;
+    };
+    return reader;
+  }
+};
+
+
+struct MemoryProbeReader
+{
+  const uint8_t* data;
+  int64_t size;
+  int64_t pos = 0;
+
+  static heif_reader get_reader()
+  {
+    heif_reader reader{};
+    reader.reader_api_version = 1;
+    reader.get_position = [](void* userdata) {
+      return static_cast<MemoryProbeReader*>(userdata)->pos;
+    };
+    reader.read = [](void* data, size_t size, void* userdata) {
+      auto* r = static_cast<MemoryProbeReader*>(userdata);
+      if (r->pos + (int64_t) size > r->size) {
+        return 1;
+      }
+      memcpy(data, r->data + r->pos, size);
+      r->pos += (int64_t) size;
+      return 0;
+    };
+    reader.seek = [](int64_t position, void* userdata) {
+      static_cast<MemoryProbeReader*>(userdata)->pos = position;
+      return 0;
+    };
+    reader.wait_for_file_size = [](int64_t target_size, void* userdata) {
+      return target_size <= static_cast<MemoryProbeReader*>(userdata)->size ?
+             heif_reader_grow_status_size_reached : heif_reader_grow_status_size_beyond_eof;
+    };
+    return reader;
+  }
+};
+
+
+template <class ProbeReader>
+static bool probe(ProbeReader probe_reader)
+{
+  heif_reader reader = ProbeReader::get_reader();
+
+  heif_probe_info info{};
+  info.version = 1;
+  heif_error err = heif_probe(&reader, &probe_reader, &info);
+  return err.code == heif_error_Ok;
+}
+
+
+static void benchmark_file(const std::string& path)
+{
+  std::string file = std::filesystem::path(path).filename().string();
+
+  // --- I/O and parsing
+
+  std::vector<uint8_t> file_data;
+
+  bool ok = measure({"read_file", "", file}, [&]() {
+    std::ifstream istr(path, std::ios::binary);
+    if (!istr) {
+      return false;
+    }
+
+    file_data.assign(std::istreambuf_iterator<char>(istr), std::istreambuf_iterator<char>());
+    return !file_data.empty();
+  });
+
+  if (!ok) {
+    return;
+  }
+
+  measure({"open_file", "", file}, [&]() {
+    heif_context* ctx = heif_context_alloc();
+    heif_error err = heif_context_read_from_file(ctx, path.c_str(), nullptr);
+    heif_context_free(ctx);
+    return err.code == heif_error_Ok;
+  });
+
+  measure({"parse", "", file}, [&]() {
+    heif_context* ctx = heif_context_alloc();
+    heif_error err = heif_context_read_from_memory_without_copy(ctx, file_data.data(), file_data.size(), nullptr);
+    heif_context_free(ctx);
+    return err.code == heif_error_Ok;
+  });
+
+  measure({"probe_file", "", file}, [&]() {
+    std::ifstream istr(path, std::ios::binary);
+    return istr && probe(StreamProbeReader{&istr, (int64_t) file_data.size()});
+  });
+
+  measure({"probe", "", file}, [&]() {
+    return probe(MemoryProbeReader{file_data.data(), (int64_t) file_data.size()});
+  });
+
+  // --- decoding
+
+  std::unique_ptr<heif_context, void (*)(heif_context*)> ctx(heif_context_alloc(), heif_context_free);
+  heif_error err = heif_context_read_from_memory_without_copy(ctx.get(), file_data.data(), file_data.size(), nullptr);
+  if (err.code) {
+    std::cerr << file << ": " << err.message << "\n";
+    return;
+  }
+
+  if (option_threads >= 0) {
+    heif_context_set_max_decoding_threads(ctx.get(), option_threads);
+  }
+
+  heif_image_handle* handle_ptr = nullptr;
+  err = heif_context_get_primary_image_handle(ctx.get(), &handle_ptr);
+  if (err.code) {
+    std::cerr << file << ": " << err.message << "\n";
+    return;
+  }
+
+  std::unique_ptr<heif_image_handle, void (*)(const heif_image_handle*)> handle(handle_ptr, heif_image_handle_release);
+
+  uint32_t item_type = heif_item_get_item_type(ctx.get(), heif_image_handle_get_item_id(handle.get()));
+  std::string codec = heif_examples::fourcc_to_string(item_type);
+  double megapixels = heif_image_handle_get_width(handle.get()) * (double) heif_image_handle_get_height(handle.get()) / 1e6;
+
+  heif_image_tiling tiling{};
+  bool is_tiled = false;
+  if (heif_image_handle_get_image_tiling(handle.get(), 1, &tiling).code == heif_error_Ok) {
+    is_tiled = (tiling.num_columns * tiling.num_rows > 1);
+  }
+
+  heif_image* native_image = nullptr;
+
+  measure({is_tiled ? "tile_assembly" : "decode", codec, file, megapixels}, [&]() {
+    heif_image_release(native_image);
+    native_image = nullptr;
+
+    return heif_decode_image(handle.get(), &native_image, heif_colorspace_undefined, heif_chroma_undefined, nullptr).code == heif_error_Ok;
+  });
+
+  if (is_tiled) {
+    double tile_megapixels = tiling.tile_width * (double) tiling.tile_height / 1e6;
+
+    measure({"decode_tile", codec, file, tile_megapixels}, [&]() {
+      heif_image* tile = nullptr;
+      heif_error e = heif_image_handle_decode_image_tile(handle.get(), &tile, heif_colorspace_undefined, heif_chroma_undefined,
+                                                         nullptr, 0, 0);
+      heif_image_release(tile);
+      return e.code == heif_error_Ok;
+    });
+  }
+
+  bool has_alpha = heif_image_handle_has_alpha_channel(handle.get());
+
+  measure({"decode_rgb", codec, file, megapixels}, [&]() {
+    heif_image* img = nullptr;
+    heif_error e = heif_decode_image(handle.get(), &img, heif_colorspace_RGB,
+                                     has_alpha ? heif_chroma_interleaved_RGBA : heif_chroma_interleaved_RGB, nullptr);
+    heif_image_release(img);
+    return e.code == heif_error_Ok;
+  });
+
+  // --- encoding and writing
+
+  if (native_image && !option_no_encode) {
+    std::string encoder_name = option_encoder.empty() ? codec : option_encoder;
+
+    heif_compression_format format;
+    heif_encoder* encoder = nullptr;
+    if (compression_format_from_name(encoder_name, format) &&
+        heif_context_get_encoder_for_format(nullptr, format, &encoder).code == heif_error_Ok) {
+
+      std::unique_ptr<heif_context, void (*)(heif_context*)> out_ctx(nullptr, heif_context_free);
+
+      bool encoded = measure({"encode", encoder_name, file, megapixels}, [&]() {
+        out_ctx.reset(heif_context_alloc());
+        return heif_context_encode_image(out_ctx.get(), native_image, encoder, nullptr, nullptr).code == heif_error_Ok;
+      });
+
+      if (encoded) {
+        measure({"write", encoder_name, file}, [&]() {
+          MemoryWriter writer;
+          heif_writer w{1, &MemoryWriter::write};
+          return heif_context_write(out_ctx.get(), &w, &writer).code == heif_error_Ok;
+        });
+      }
+
+      heif_encoder_release(encoder);
+    }
+    else {
+      std::cerr << "no encoder for '" << encoder_name << "', skipping encode for " << file << "\n";
+    }
+  }
+
+  heif_image_release(native_image);
+}
+
+
+// --- startup benchmark
+
+static void set_plugin_path_variable(const char* value)
+{
+#if defined(_WIN32)
+  _putenv_s("LIBHEIF_PLUGIN_PATH", value ? value : "");
+#else
+  if (value) {
+    setenv("LIBHEIF_PLUGIN_PATH", value, 1);
+  }
+  else {
+    unsetenv("LIBHEIF_PLUGIN_PATH");
+  }
+#endif
+}
+
+
+static bool is_plugin_file(const std::filesystem::path& path)
+{
+#if defined(_WIN32)
+  return path.extension() == ".dll";
+#else
+  return path.extension() == ".so";
+#endif
+}
+
+
+// Must be called while libheif is not initialized, since heif_init() only loads the plugins on its first call.
+// The plugins of all plugin directories are copied into a temporary directory, which is used as LIBHEIF_PLUGIN_PATH,
+// so that the manifest can be written without touching the installed plugin directories.
+static void benchmark_startup()
+{
+  heif_compression_format format;
+  if (!compression_format_from_name(option_startup_format, format)) {
+    std::cerr << "unknown startup format '" << option_startup_format << "', skipping startup\n";
+    return;
+  }
+
+  namespace fs = std::filesystem;
+
+  fs::path plugin_dir = fs::temp_directory_path() / ("heif-bench-plugins-" + std::to_string(
+      std::chrono::steady_clock::now().time_since_epoch().count()));
+
+  std::error_code ec;
+  fs::create_directories(plugin_dir, ec);
+  if (ec) {
+    std::cerr << "cannot create " << plugin_dir.string() << ", skipping startup\n";
+    return;
+  }
+
+  int num_plugins = 0;
+
+  const char* const* plugin_dirs = heif_get_plugin_directories();
+  for (int i = 0; plugin_dirs[i]; i++) {
+    for (const auto& entry : fs::directory_iterator(plugin_dirs[i], ec)) {
+      if (entry.is_regular_file() && is_plugin_file(entry.path()) &&
+          fs::copy_file(entry.path(), plugin_dir / entry.path().filename(), fs::copy_options::skip_existing, ec)) {
+        num_plugins++;
+      }
+    }
+  }
+  heif_free_plugin_directories(plugin_dirs);
+
+  const char* old_plugin_path = getenv("LIBHEIF_PLUGIN_PATH");
+  std::string saved_plugin_path = old_plugin_path ? old_plugin_path : "";
+  set_plugin_path_variable(plugin_dir.string().c_str());
+
+  auto startup = [format]() {
+    return heif_init(nullptr).code == heif_error_Ok && heif_have_decoder_for_format(format);
+  };
+
+  measure({"startup", option_startup_format + " (all plugins)"}, startup, heif_deinit);
+
+  if (num_plugins == 0) {
+    std::cerr << "no plugins found, skipping startup with manifest\n";
+  }
+  else if (heif_write_plugin_manifest(plugin_dir.string().c_str()).code != heif_error_Ok) {
+    std::cerr << "cannot write plugin manifest, skipping startup with manifest\n";
+  }
+  else {
+    measure({"startup", option_startup_format + " (manifest)"}, startup, heif_deinit);
+  }
+
+  set_plugin_path_variable(old_plugin_path ? saved_plugin_path.c_str() : nullptr);
+  fs::remove_all(plugin_dir, ec);
+}
+
+
+// --- color conversion benchmarks
+
+#if HEIF_BENCH_INTERNALS
+
+struct ConversionFormat
+{
+  const char* label;
+  heif_colorspace colorspace;
+  heif_chroma chroma;
+  bool has_alpha;
+  int bpp;
+};
+
+
+static const ConversionFormat conversion_inputs[] = {
+    {"YCbCr420-8",  heif_colorspace_YCbCr,      heif_chroma_420,                   false, 8},
+    {"YCbCr420-10", heif_colorspace_YCbCr,      heif_chroma_420,                   false, 10},
+    {"YCbCr422-8",  heif_colorspace_YCbCr,      heif_chroma_422,                   false, 8},
+    {"YCbCr444-8",  heif_colorspace_YCbCr,      heif_chroma_444,                   false, 8},
+    {"RGB-8",       heif_colorspace_RGB,        heif_chroma_interleaved_RGB,       false, 8},
+    {"RGBA-8",      heif_colorspace_RGB,        heif_chroma_interleaved_RGBA,      true,  8},
+    {"RGB444-10",   heif_colorspace_RGB,        heif_chroma_444,                   false, 10},
+    {"mono-8",      heif_colorspace_monochrome, heif_chroma_monochrome,            false, 8},
+};
+
+static const ConversionFormat conversion_targets[] = {
+    {"RGB-8",          heif_colorspace_RGB,   heif_chroma_interleaved_RGB,       false, 8},
+    {"RGBA-8",         heif_colorspace_RGB,   heif_chroma_interleaved_RGBA,      true,  8},
+    {"RRGGBB_LE-10",   heif_colorspace_RGB,   heif_chroma_interleaved_RRGGBB_LE, false, 10},
+    {"RGB444-8",       heif_colorspace_RGB,   heif_chroma_444,                   false, 8},
+    {"YCbCr420-8",     heif_colorspace_YCbCr, heif_chroma_420,                   false, 8},
+    {"YCbCr444-8",     heif_colorspace_YCbCr, heif_chroma_444,                   false, 8},
+};
+
+
+static std::shared_ptr<HeifPixelImage> create_synthetic_image(const ConversionFormat& format, uint32_t w, uint32_t h)
+{
+  heif_image* img;
+  if (heif_image_create(w, h, format.colorspace, format.chroma, &img).code) {
+    return nullptr;
+  }
+
+  std::vector<std::pair<heif_channel, uint32_t>> planes; // channel, width divisor (1 or 2)
+
+  switch (format.chroma) {
+    case heif_chroma_interleaved_RGB:
+    case heif_chroma_interleaved_RGBA:
+      planes = {{heif_channel_interleaved, 1}};
+      break;
+    case heif_chroma_monochrome:
+      planes = {{heif_channel_Y, 1}};
+      break;
+    default:
+      if (format.colorspace == heif_colorspace_RGB) {
+        planes = {{heif_channel_R, 1}, {heif_channel_G, 1}, {heif_channel_B, 1}};
+      }
+      else {
+        uint32_t div = (format.chroma == heif_chroma_444) ? 1 : 2;
+        planes = {{heif_channel_Y, 1}, {heif_channel_Cb, div}, {heif_channel_Cr, div}};
+      }
+  }
+
+  for (const auto& plane : planes) {
+    uint32_t pw = (w + plane.second - 1) / plane.second;
+    uint32_t ph = (format.chroma == heif_chroma_420 && plane.second == 2) ? (h + 1) / 2 : h;
+
+    if (heif_image_add_plane(img, plane.first, (int) pw, (int) ph, format.bpp).code) {
+      heif_image_release(img);
+      return nullptr;
+    }
+
+    size_t stride;
+    uint8_t* p = heif_image_get_plane2(img, plane.first, &stride);
+    int bytes_per_sample = (format.bpp > 8) ? 2 : 1;
+    uint32_t row_bytes = pw * bytes_per_sample * (plane.first == heif_channel_interleaved ? (format.has_alpha ? 4 : 3) : 1);
+
+    // a smooth gradient with some noise, so that conversions do not hit special cases
+    uint32_t max_value = (1U << format.bpp) - 1;
+    uint32_t seed = 12345;
+    for (uint32_t y = 0; y < ph; y++) {
+      for (uint32_t x = 0; x < row_bytes / bytes_per_sample; x++) {
+        seed = seed * 1103515245 + 12345;
+        uint32_t v = ((x + y) * 4 + ((seed >> 16) & 0x0F)) & max_value;
+        if (bytes_per_sample == 2) {
+          reinterpret_cast<uint16_t*>(p + y * stride)[x] = (uint16_t) v;
+        }
+        else {
+          p[y * stride + x] = (uint8_t) v;
+        }
+      }
+    }
+  }
+
+  std::shared_ptr<HeifPixelImage> image = img->image;
+  heif_image_release(img);
+
+  return image;
+}
+
+
+static void benchmark_color_conversions()
+{
+  const uint32_t w = option_conversion_width;
+  const uint32_t h = option_conversion_height;
+  const double megapixels = w * (double) h / 1e6;
+  const heif_security_limits* limits = heif_get_global_security_limits();
+
+  heif_color_conversion_options options;
+  heif_color_conversion_options_set_defaults(&options);
+
+  heif_color_conversion_options_ext* options_ext = heif_color_conversion_options_ext_alloc();
+
+  for (const auto& in_format : conversion_inputs) {
+    auto input = create_synthetic_image(in_format, w, h);
+    if (!input) {
+      continue;
+    }
+
+    ColorState input_state(in_format.colorspace, in_format.chroma, in_format.has_alpha, in_format.bpp);
+    input_state.nclx = nclx_profile::defaults();
+    input->set_color_profile_nclx(input_state.nclx);
+
+    for (const auto& out_format : conversion_targets) {
+      if (strcmp(in_format.label, out_format.label) == 0) {
+        continue;
+      }
+
+      ColorState output_state(out_format.colorspace, out_format.chroma, out_format.has_alpha, out_format.bpp);
+      output_state.nclx = input_state.nclx;
+
+      ColorConversionPipeline pipeline;
+      if (!pipeline.construct_pipeline(input_state, output_state, options, *options_ext) || pipeline.is_nop()) {
+        continue;
+      }
+
+      std::string conversion = std::string(in_format.label) + " -> " + out_format.label;
+
+      // --- full pipeline
+
+      measure({"color_pipeline", conversion, "", megapixels}, [&]() {
+        return (bool) pipeline.convert_image(input, limits);
+      });
+
+      // --- each step in isolation, on the output of the previous step
+
+      std::shared_ptr<HeifPixelImage> step_input = input;
+
+      for (size_t i = 0; i < pipeline.get_number_of_steps(); i++) {
+        std::shared_ptr<HeifPixelImage> step_output;
+
+        bool ok = measure({"color_conversion_op", pipeline.get_step_name(i) + " (" + conversion + ")", "", megapixels}, [&]() {
+          auto result = pipeline.convert_step(i, step_input, limits);
+          if (!result) {
+            return false;
+          }
+
+          step_output = *result;
+          return true;
+        });
+
+        if (!ok) {
+          break;
+        }
+
+        step_input = step_output;
+      }
+    }
+  }
+
+  // --- sharp YUV chroma downsampling (only available when libheif is built with libsharpyuv)
+
+  heif_color_conversion_options sharp_yuv_options = options;
+  sharp_yuv_options.preferred_chroma_downsampling_algorithm = heif_chroma_downsampling_sharp_yuv;
+  sharp_yuv_options.only_use_preferred_chroma_algorithm = true;
+
+  for (const auto& in_format : conversion_inputs) {
+    if (in_format.colorspace != heif_colorspace_RGB) {
+      continue;
+    }
+
+    auto input = create_synthetic_image(in_format, w, h);
+    if (!input) {
+      continue;
+    }
+
+    ColorState input_state(in_format.colorspace, in_format.chroma, in_format.has_alpha, in_format.bpp);
+    input_state.nclx = nclx_profile::defaults();
+    input->set_color_profile_nclx(input_state.nclx);
+
+    ColorState output_state(heif_colorspace_YCbCr, heif_chroma_420, false, 8);
+    output_state.nclx = input_state.nclx;
+
+    ColorConversionPipeline pipeline;
+    if (!pipeline.construct_pipeline(input_state, output_state, sharp_yuv_options, *options_ext)) {
+      continue;
+    }
+
+    measure({"color_pipeline_sharp_yuv", std::string(in_format.label) + " -> YCbCr420-8", "", megapixels}, [&]() {
+      return (bool) pipeline.convert_image(input, limits);
+    });
+  }
+
+  heif_color_conversion_options_ext_free(options_ext);
+}
+
+
+// --- generic compression benchmarks
+
+static void benchmark_compression()
+{
+  const double megapixels = option_conversion_width * (double) option_conversion_height / 1e6;
+
+  // interleaved RGB with a smooth gradient and some noise, similar to 'unci' image data
+  std::vector<uint8_t> raw_data(option_conversion_width * (size_t) option_conversion_height * 3);
+  uint32_t seed = 12345;
+  for (uint32_t y = 0; y < option_conversion_height; y++) {
+    for (uint32_t x = 0; x < option_conversion_width * 3; x++) {
+      seed = seed * 1103515245 + 12345;
+      raw_data[y * (size_t) option_conversion_width * 3 + x] = (uint8_t) ((x + y) / 4 + ((seed >> 16) & 0x07));
+    }
+  }
+
+  const char* methods[] = {"defl", "zlib", "brot", "zstd"};
+
+  for (const char* method : methods) {
+    uint32_t compression_type = heif_fourcc(method[0], method[1], method[2], method[3]);
+    if (!is_generic_compression_supported(compression_type)) {
+      continue;
+    }
+
+    std::vector<uint8_t> compressed;
+
+    bool ok = measure({"compress", method, "", megapixels}, [&]() {
+      auto result = compress_generic(compression_type, raw_data.data(), raw_data.size());
+      if (!result) {
+        return false;
+      }
+
+      compressed = std::move(*result);
+      return true;
+    });
+
+    if (!ok) {
+      continue;
+    }
+
+    std::vector<uint8_t> decompressed(raw_data.size());
+
+    measure({"decompress", method, "", megapixels}, [&]() {
+      Error err = decompress_generic(compression_type, compressed.data(), compressed.size(),
+                                     decompressed.data(), decompressed.size());
+      return !err && decompressed == raw_data;
+    });
+  }
+}
+
+#endif
+
+
+int main(int argc, char** argv)
+{
+  while (true) {
+    int option_index = 0;
+    int c = getopt_long(argc, argv, "n:o:e:t:s:f:hv", long_options, &option_index);
+    if (c == -1)
+      break;
+
+    switch (c) {
+      case 'n':
+        option_iterations = std::max(1, atoi(optarg));
+        break;
+      case 'o':
+        option_output = optarg;
+        break;
+      case 'e':
+        option_encoder = optarg;
+        break;
+      case 't':
+        option_threads = atoi(optarg);
+        break;
+      case 'f':
+        option_startup_format = optarg;
+        break;
+      case 's':
+        if (sscanf(optarg, "%ux%u", &option_conversion_width, &option_conversion_height) != 2 ||
+            option_conversion_width == 0 || option_conversion_height == 0) {
+          std::cerr << "invalid conversion size: " << optarg << "\n";
+          return 5;
+        }
+        break;
+      case 'h':
+        show_help(argv[0]);
+        return 0;
+      case 'v':
+        heif_examples::show_version();
+        return 0;
+    }
+  }
+
+  if (optind == argc && option_no_conversion && option_no_compression && option_no_startup) {
+    show_help(argv[0]);
+    return 5;
+  }
+
+  if (!option_no_startup) {
+    benchmark_startup();
+  }
+
+  // This takes care of initializing libheif and also deinitializing it at the end to free all resources.
+  LibHeifInitializer initializer;
+
+  for (int i = optind; i < argc; i++) {
+    benchmark_file(argv[i]);
+  }
+
+  if (!option_no_conversion) {
+#if HEIF_BENCH_INTERNALS
+    benchmark_color_conversions();
+#else
+    std::cerr << "color conversion benchmarks are only available when libheif is built with WITH_REDUCED_VISIBILITY=OFF\n";
+#endif
+  }
+
+  if (!option_no_compression) {
+#if HEIF_BENCH_INTERNALS
+    benchmark_compression();
+#else
+    std::cerr << "compression benchmarks are only available when libheif is built with WITH_REDUCED_VISIBILITY=OFF\n";
+#endif
+  }
+
+  if (option_output.empty()) {
+    write_json(std::cout);
+  }
+  else {
+    std::ofstream ostr(option_output);
+    if (!ostr) {
+      std::cerr << "cannot write to " << option_output << "\n";
+      return 1;
+    }
+
+    write_json(ostr);
+  }
+
+  return 0;
+}
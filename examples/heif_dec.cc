@@ -855,6 +855,9 @@ int main(int argc, char** argv)
 
     int with_alpha = heif_track_has_alpha_channel(track);
 
+    // decode intra-only sequences several frames ahead
+    heif_track_set_decoding_pipeline_depth(track, 4);
+
     for (int i=0; ;i++) {
       heif_image* out_image = nullptr;
       int bit_depth = 8; // TODO
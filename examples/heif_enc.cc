@@ -269,7 +269,7 @@ void show_help(const char* argv0)
             << "      --htj2k                    encode as High Throughput JPEG 2000 (experimental)\n"
             #if WITH_UNCOMPRESSED_CODEC
             << "  -U, --uncompressed             encode as uncompressed image (according to ISO 23001-17) (EXPERIMENTAL)\n"
-            << "      --unci-compression METHOD  choose one of these methods: none, deflate, zlib, brotli.\n"
+            << "      --unci-compression METHOD  choose one of these methods: none, deflate, zlib, brotli, zstd.\n"
             #endif
             << "      --list-encoders            list all available encoders for all compression formats\n"
             << "  -e, --encoder ID               select encoder to use (the IDs can be listed with --list-encoders)\n"
@@ -1038,7 +1038,13 @@ heif_image_handle* encode_tiled(heif_context* ctx, heif_encoder* encoder, heif_e
 
   int tile_width = 0, tile_height = 0;
 
-  for (uint32_t ty = 0; ty < tile_generator->nRows(); ty++)
+  // Tiles are passed row by row. This allows libheif to encode all tiles of a row concurrently.
+
+  for (uint32_t ty = 0; ty < tile_generator->nRows(); ty++) {
+    std::vector<InputImage> row_images;
+    std::vector<const heif_image*> row_tiles;
+    std::vector<uint32_t> row_tile_x, row_tile_y;
+
     for (uint32_t tx = 0; tx < tile_generator->nColumns(); tx++) {
       InputImage input_image = tile_generator->get_image(tx,ty, output_bit_depth);
 
@@ -1058,18 +1064,24 @@ heif_image_handle* encode_tiled(heif_context* ctx, heif_encoder* encoder, heif_e
         std::cerr << error.message << "\n";
       }
 
-      std::cout << "encoding tile " << ty+1 << " " << tx+1
-                << " (of " << tile_generator->nRows() << "x" << tile_generator->nColumns() << ")  \r";
-      std::cout.flush();
+      row_tiles.push_back(input_image.image.get());
+      row_tile_x.push_back(tx);
+      row_tile_y.push_back(ty);
+      row_images.push_back(std::move(input_image));
+    }
 
-      error = heif_context_add_image_tile(ctx, tiled_image, tx, ty,
-                                          input_image.image.get(),
-                                          encoder);
-      if (error.code != 0) {
-        std::cerr << "Could not encode HEIF/AVIF file: " << error.message << "\n";
-        return nullptr;
-      }
+    std::cout << "encoding tile row " << ty+1 << " (of " << tile_generator->nRows() << "x" << tile_generator->nColumns() << ")  \r";
+    std::cout.flush();
+
+    heif_error error = heif_context_add_image_tiles(ctx, tiled_image, (uint32_t) row_tiles.size(),
+                                                    row_tile_x.data(), row_tile_y.data(),
+                                                    row_tiles.data(),
+                                                    encoder);
+    if (error.code != 0) {
+      std::cerr << "Could not encode HEIF/AVIF file: " << error.message << "\n";
+      return nullptr;
     }
+  }
 
   std::cout << "\n";
 
@@ -1258,6 +1270,9 @@ int main(int argc, char** argv)
         else if (option == "zlib") {
           unci_compression = heif_unci_compression_zlib;
         }
+        else if (option == "zstd") {
+          unci_compression = heif_unci_compression_zstd;
+        }
         else {
           std::cerr << "Invalid unci compression method '" << option << "'\n";
           exit(5);
@@ -2053,6 +2068,7 @@ int do_encode_sequence(heif_context* context, heif_encoder* encoder, heif_encodi
 
     //seq_options->save_alpha_channel = false; // TODO: sequences with alpha ?
     seq_options->output_nclx_profile = nclx;
+    seq_options->gop_structure = heif_sequence_gop_structure_lowdelay; // the sequence is ended below
     //seq_options->image_orientation = heif_orientation_normal; // input_image.orientation;  TODO: sequence rotation
 
     heif_image_set_duration(image.get(), sequence_durations);
@@ -2071,6 +2087,14 @@ int do_encode_sequence(heif_context* context, heif_encoder* encoder, heif_encodi
 
   std::cout << "\n";
 
+  if (track) {
+    heif_error error = heif_track_encode_end_of_sequence(track, encoder);
+    if (error.code) {
+      std::cerr << "Cannot end sequence: " << error.message << "\n";
+      return 5;
+    }
+  }
+
   if (!vmt_metadata_file.empty()) {
     int ret = encode_vmt_metadata_track(context, track);
     if (ret) {
@@ -70,12 +70,14 @@ info -d // dump
  */
 
 int option_disable_limits = 0;
+int option_write_plugin_manifest = 0;
 
 static option long_options[] = {
     //{"write-raw", required_argument, 0, 'w' },
     //{"output",    required_argument, 0, 'o' },
     {(char* const) "dump-boxes", no_argument, 0, 'd'},
     {(char* const) "disable-limits", no_argument, &option_disable_limits, 1},
+    {(char* const) "write-plugin-manifest", no_argument, &option_write_plugin_manifest, 1},
     {(char* const) "help",       no_argument, 0, 'h'},
     {(char* const) "version",    no_argument, 0, 'v'},
     {0, 0,                                    0, 0}
@@ -101,6 +103,7 @@ void show_help(const char* argv0)
                //fprintf(stderr,"  -o, --output NAME    output file name for image selected by -w\n");
                "  -d, --dump-boxes     show a low-level dump of all MP4 file boxes\n"
                "      --disable-limits disable all security limits (do not use in production environment)\n"
+               "      --write-plugin-manifest  write the manifest files of all plugin directories (run after installing plugins)\n"
                "  -h, --help           show help\n"
                "  -v, --version        show version\n";
 }
@@ -152,6 +155,22 @@ int main(int argc, char** argv)
     }
   }
 
+  if (option_write_plugin_manifest) {
+    const char* const* plugin_directories = heif_get_plugin_directories();
+    int ret = 0;
+
+    for (int i = 0; plugin_directories[i]; i++) {
+      heif_error err = heif_write_plugin_manifest(plugin_directories[i]);
+      if (err.code) {
+        std::cerr << "Cannot write plugin manifest in " << plugin_directories[i] << ": " << err.message << "\n";
+        ret = 1;
+      }
+    }
+
+    heif_free_plugin_directories(plugin_directories);
+    return ret;
+  }
+
   if (optind != argc - 1) {
     show_help(argv[0]);
     return 0;
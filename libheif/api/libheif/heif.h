@@ -37,5 +37,6 @@
 #include <libheif/heif_context.h>
 #include <libheif/heif_image_handle.h>
 #include <libheif/heif_tiling.h>
+#include <libheif/heif_probe.h>
 
 #endif
@@ -56,11 +56,12 @@ void heif_color_conversion_options_set_defaults(heif_color_conversion_options* o
 
 static void fill_default_color_conversion_options_ext(heif_color_conversion_options_ext& options)
 {
-  options.version = 1;
+  options.version = 2;
   options.alpha_composition_mode = heif_alpha_composition_mode_none;
   options.background_red = options.background_green = options.background_blue = 0xFFFF;
   options.secondary_background_red = options.secondary_background_green = options.secondary_background_blue = 0xCCCC;
   options.checkerboard_square_size = 16;
+  options.bit_depth_reduction_mode = heif_bit_depth_reduction_mode_truncate;
 }
 
 
@@ -84,6 +85,9 @@ void heif_color_conversion_options_ext_copy(heif_color_conversion_options_ext* d
   int min_version = std::min(dst->version, src->version);
 
   switch (min_version) {
+    case 2:
+      dst->bit_depth_reduction_mode = src->bit_depth_reduction_mode;
+      [[fallthrough]];
     case 1:
       dst->alpha_composition_mode = src->alpha_composition_mode;
       dst->background_red = src->background_red;
@@ -79,6 +79,15 @@ enum heif_alpha_composition_mode
 };
 
 
+// How the samples are mapped when the bit depth is reduced to 8 bits.
+enum heif_bit_depth_reduction_mode
+{
+  heif_bit_depth_reduction_mode_truncate = 0, // drop the least significant bits
+  heif_bit_depth_reduction_mode_round = 1,    // round to the nearest 8-bit value
+  heif_bit_depth_reduction_mode_dither = 2    // ordered (4x4 Bayer) dithering, reduces banding in gradients
+};
+
+
 typedef struct heif_color_conversion_options_ext
 {
   uint8_t version;
@@ -91,6 +100,11 @@ typedef struct heif_color_conversion_options_ext
   uint16_t background_red, background_green, background_blue;
   uint16_t secondary_background_red, secondary_background_green, secondary_background_blue;
   uint16_t checkerboard_square_size;
+
+  // --- version 2 options
+
+  // default: heif_bit_depth_reduction_mode_truncate
+  enum heif_bit_depth_reduction_mode bit_depth_reduction_mode;
 } heif_color_conversion_options_ext;
 
 
@@ -255,6 +255,55 @@ heif_error heif_context_write_to_file(heif_context* ctx,
 }
 
 
+Result<heif_context_output> get_heif_writer_output(heif_context* ctx, const heif_writer* writer, void* userdata)
+{
+  if (writer->writer_api_version != 1) {
+    return Error(heif_error_Usage_error, heif_suberror_Unsupported_writer_version);
+  }
+
+  heif_writer writer_copy = *writer;
+
+  return heif_context_output([ctx, writer_copy, userdata](const std::vector<uint8_t>& data) -> Error {
+    heif_error writer_error = writer_copy.write(ctx, data.data(), data.size(), userdata);
+    if (writer_error.code == heif_error_Ok) {
+      return Error::Ok;
+    }
+
+    return {writer_error.code, writer_error.subcode,
+            writer_error.message ? writer_error.message : "heif_writer callback returned a null error text"};
+  });
+}
+
+
+Result<heif_context_output> get_file_output(const char* filename)
+{
+#if defined(__MINGW32__) || defined(__MINGW64__) || defined(_MSC_VER)
+  auto ostr = std::make_shared<std::ofstream>(HeifFile::convert_utf8_path_to_utf16(filename).c_str(), std::ios_base::binary);
+#else
+  auto ostr = std::make_shared<std::ofstream>(filename, std::ios_base::binary);
+#endif
+
+  if (!*ostr) {
+    return Error(heif_error_Encoding_error,
+                 heif_suberror_Cannot_write_output_data,
+                 "Cannot open output file");
+  }
+
+  return heif_context_output([ostr](const std::vector<uint8_t>& data) -> Error {
+    ostr->write(reinterpret_cast<const char*>(data.data()), (std::streamsize) data.size());
+    ostr->flush();
+
+    if (!*ostr) {
+      return {heif_error_Encoding_error,
+              heif_suberror_Cannot_write_output_data,
+              "Cannot write to output file"};
+    }
+
+    return Error::Ok;
+  });
+}
+
+
 heif_error heif_context_write(heif_context* ctx,
                               heif_writer* writer,
                               void* userdata)
@@ -269,8 +318,23 @@ heif_error heif_context_write(heif_context* ctx,
     return err.error_struct(ctx->context.get());
   }
 
+  if (ctx->context->is_fragmented_writing()) {
+    return Error(heif_error_Usage_error,
+                 heif_suberror_Unspecified,
+                 "The file is written in fragments. Use heif_context_end_fragmented_writing() to finish it.").error_struct(ctx->context.get());
+  }
+
+  if (ctx->context->is_streaming_writing()) {
+    return Error(heif_error_Usage_error,
+                 heif_suberror_Unspecified,
+                 "The file is streamed. Use heif_context_end_streaming_writing() to finish it.").error_struct(ctx->context.get());
+  }
+
   StreamWriter swriter;
-  ctx->context->write(swriter);
+  Error err = ctx->context->write(swriter);
+  if (err) {
+    return err.error_struct(ctx->context.get());
+  }
 
   const auto& data = swriter.get_data();
   heif_error writer_error = writer->write(ctx, data.data(), data.size(), userdata);
@@ -21,12 +21,21 @@
 #include "heif_decoding.h"
 #include "api_structs.h"
 #include "plugin_registry.h"
+#include "trace.h"
+#include "thread_pool.h"
 
 #include <algorithm>
+#include <map>
 #include <memory>
 #include <utility>
 #include <vector>
 
+#if ENABLE_MULTITHREADING_SUPPORT
+#include <atomic>
+#include <future>
+#include <mutex>
+#endif
+
 
 void heif_context_set_max_decoding_threads(heif_context* ctx, int max_threads)
 {
@@ -34,6 +43,12 @@ void heif_context_set_max_decoding_threads(heif_context* ctx, int max_threads)
 }
 
 
+void heif_context_set_read_coalescing(heif_context* ctx, int enable, uint32_t max_gap)
+{
+  ctx->context->set_read_coalescing(enable != 0, max_gap);
+}
+
+
 int heif_have_decoder_for_format(heif_compression_format format)
 {
   auto plugin = get_decoder(format, nullptr);
@@ -43,7 +58,7 @@ int heif_have_decoder_for_format(heif_compression_format format)
 
 static void fill_default_decoding_options(heif_decoding_options& options)
 {
-  options.version = 9;
+  options.version = 10;
 
   options.ignore_transformations = false;
 
@@ -86,6 +101,10 @@ static void fill_default_decoding_options(heif_decoding_options& options)
   // version 9
 
   options.output_image_nclx_profile = nullptr;
+
+  // version 10
+
+  options.convert_grid_tiles_individually = false;
 }
 
 
@@ -110,6 +129,9 @@ void heif_decoding_options_copy(heif_decoding_options* dst,
   int min_version = std::min(dst->version, src->version);
 
   switch (min_version) {
+    case 10:
+      dst->convert_grid_tiles_individually = src->convert_grid_tiles_individually;
+      [[fallthrough]];
     case 9:
       dst->output_image_nclx_profile = src->output_image_nclx_profile;
       [[fallthrough]];
@@ -169,7 +191,7 @@ int heif_get_decoder_descriptors(heif_compression_format format_filter,
     formats.emplace_back(format_filter);
   }
 
-  for (const auto* plugin : get_decoder_plugins()) {
+  for (const auto* plugin : get_decoder_plugins(format_filter)) {
     for (auto& format : formats) {
       int priority = plugin->does_support_format(format);
       if (priority) {
@@ -229,6 +251,10 @@ heif_error heif_decode_image(const heif_image_handle* in_handle,
   *out_img = nullptr;
   heif_item_id id = in_handle->image->get_id();
 
+  OperationTraceScope trace(in_handle->context->get_trace_callback(),
+                            in_handle->context->get_trace_callback_userdata(),
+                            heif_trace_operation_decode, id);
+
   heif_decoding_options dec_options;
   fill_default_decoding_options(dec_options);
   heif_decoding_options_copy(&dec_options, input_options);
@@ -250,3 +276,133 @@ heif_error heif_decode_image(const heif_image_handle* in_handle,
 
   return Error::Ok.error_struct(in_handle->image.get());
 }
+
+
+heif_error heif_decode_images_batch(const heif_decode_batch_item* items,
+                                    size_t num_items,
+                                    const heif_decoding_options* input_options,
+                                    int max_threads,
+                                    heif_decode_batch_callback callback,
+                                    void* userdata)
+{
+  if (num_items == 0) {
+    return heif_error_ok;
+  }
+
+  if (items == nullptr || callback == nullptr) {
+    return heif_error_null_pointer_argument;
+  }
+
+  for (size_t i = 0; i < num_items; i++) {
+    if (items[i].handle == nullptr) {
+      return heif_error_null_pointer_argument;
+    }
+  }
+
+  heif_decoding_options dec_options;
+  fill_default_decoding_options(dec_options);
+  heif_decoding_options_copy(&dec_options, input_options);
+
+
+  // --- group the items by image
+  // The items of one image are decoded sequentially. This keeps the image's decoder warm and
+  // prevents concurrent use of its decoder instance.
+
+  std::vector<std::vector<size_t>> groups;
+  std::map<const ImageItem*, size_t> group_of_image;
+
+  for (size_t i = 0; i < num_items; i++) {
+    const ImageItem* image = items[i].handle->image.get();
+    auto iter = group_of_image.find(image);
+    if (iter == group_of_image.end()) {
+      group_of_image[image] = groups.size();
+      groups.push_back({i});
+    }
+    else {
+      groups[iter->second].push_back(i);
+    }
+  }
+
+#if ENABLE_MULTITHREADING_SUPPORT
+  std::mutex callback_mutex;
+#endif
+
+  auto decode_item = [&](size_t idx) {
+    const heif_decode_batch_item& item = items[idx];
+    const heif_image_handle* handle = item.handle;
+    heif_item_id id = handle->image->get_id();
+
+    Result<std::shared_ptr<HeifPixelImage>> decodingResult;
+    {
+      OperationTraceScope trace(handle->context->get_trace_callback(),
+                                handle->context->get_trace_callback_userdata(),
+                                heif_trace_operation_decode, id);
+
+      decodingResult = handle->context->decode_image(id,
+                                                     item.colorspace,
+                                                     item.chroma,
+                                                     dec_options,
+                                                     item.decode_tile != 0, item.tile_x, item.tile_y);
+    }
+
+    heif_image* img = nullptr;
+    heif_error err;
+
+    if (!decodingResult) {
+      err = decodingResult.error_struct(handle->image.get());
+    }
+    else {
+      img = new heif_image();
+      img->image = std::move(*decodingResult);
+      err = Error::Ok.error_struct(handle->image.get());
+    }
+
+#if ENABLE_MULTITHREADING_SUPPORT
+    std::lock_guard<std::mutex> lock(callback_mutex);
+#endif
+    callback(idx, err, img, userdata);
+  };
+
+#if ENABLE_MULTITHREADING_SUPPORT
+  if (max_threads > 0 && groups.size() > 1) {
+    std::atomic<size_t> next_group{0};
+
+    auto worker = [&]() {
+      for (;;) {
+        size_t group_idx = next_group++;
+        if (group_idx >= groups.size()) {
+          return;
+        }
+
+        for (size_t idx : groups[group_idx]) {
+          decode_item(idx);
+        }
+      }
+    };
+
+    size_t nThreads = std::min(static_cast<size_t>(max_threads), groups.size());
+
+    ThreadPool& pool = ThreadPool::global();
+
+    std::vector<ThreadPool::Future<void>> workers;
+    workers.reserve(nThreads);
+    for (size_t i = 0; i < nThreads; i++) {
+      workers.push_back(pool.async(worker));
+    }
+
+    for (auto& w : workers) {
+      pool.get(w);
+    }
+
+    return heif_error_ok;
+  }
+#endif
+
+  for (const auto& group : groups) {
+    for (size_t idx : group) {
+      decode_item(idx);
+    }
+  }
+
+  return heif_error_ok;
+}
@@ -32,13 +32,22 @@ extern "C" {
 
 
 // If the maximum threads number is set to 0, the image tiles are decoded in the main thread.
-// This is different from setting it to 1, which will generate a single background thread to decode the tiles.
+// This is different from setting it to 1, which will decode the tiles one at a time in a background thread.
+// The tiles are decoded in the thread pool that libheif shares between all contexts (see heif_init_params),
+// so this limits the number of concurrently decoded tiles of this context, not the number of threads.
 // Note that this setting only affects libheif itself. The codecs itself may still use multi-threaded decoding.
 // You can use it, for example, in cases where you are decoding several images in parallel anyway you thus want
 // to minimize parallelism in each decoder.
 LIBHEIF_API
 void heif_context_set_max_decoding_threads(heif_context* ctx, int max_threads);
 
+// When a complete grid image is decoded from a file or a heif_reader, the data of all tiles (and of the
+// tiles of its alpha image) is read with a few large requests instead of one request per tile.
+// Tile data that is separated by at most 'max_gap' bytes is fetched in the same request.
+// This is enabled by default with a gap of 16 KiB. Set 'enable' to 0 to read the tiles individually.
+LIBHEIF_API
+void heif_context_set_read_coalescing(heif_context* ctx, int enable, uint32_t max_gap);
+
 // Quick check whether there is a decoder available for the given format.
 // Note that the decoder still may not be able to decode all variants of that format.
 // You will have to query that further (todo) or just try to decode and check the returned error.
@@ -110,6 +119,16 @@ typedef struct heif_decoding_options
   // version 9 options
 
   heif_color_profile_nclx* output_image_nclx_profile;
+
+  // version 10 options
+
+  // For grid images: color-convert each tile on its decoding thread and write it directly into the output image.
+  // This avoids the full-size intermediate image in the decoder's colorspace.
+  // Chroma upsampling is done for each tile separately, replicating the chroma samples at the tile borders.
+  // With bilinear upsampling, the pixels next to interior tile borders may thus differ slightly from the
+  // default decoding path. The output is identical to decoding each tile with heif_image_handle_decode_image_tile().
+  // Only applies when the output colorspace and chroma are specified. Default: false.
+  uint8_t convert_grid_tiles_individually;
 } heif_decoding_options;
 
 
@@ -164,6 +183,49 @@ heif_error heif_decode_image(const heif_image_handle* in_handle,
                              enum heif_chroma chroma,
                              const heif_decoding_options* options);
 
+
+// --- batch decoding
+
+typedef struct heif_decode_batch_item
+{
+  const heif_image_handle* handle;
+
+  enum heif_colorspace colorspace;
+  enum heif_chroma chroma;
+
+  // When non-zero, only the tile (tile_x, tile_y) is decoded, as with heif_image_handle_decode_image_tile().
+  int decode_tile;
+  uint32_t tile_x, tile_y;
+} heif_decode_batch_item;
+
+// Called once for each item as soon as it has been decoded.
+// On success, 'image' is the decoded image and the callback takes over its ownership
+// (release it with heif_image_release()). On failure, 'image' is NULL.
+// 'index' is the position of the item in the input array.
+typedef void (*heif_decode_batch_callback)(size_t index,
+                                           heif_error error,
+                                           heif_image* image,
+                                           void* userdata);
+
+// Decode many images or tiles with one call.
+// The items are decoded with up to 'max_threads' threads in parallel. The callbacks are called from these
+// threads, in the order in which the items complete, but never concurrently.
+// Items that refer to the same image (e.g. several tiles of one image) are decoded one after another by the
+// same thread, reusing that image's decoder instance. Color conversion pipelines are shared between all items.
+// The handles may belong to different heif_contexts, but these contexts must not be used by other threads
+// while the batch is running.
+// The decoding options (which may be NULL) apply to all items.
+// If 'max_threads' is 0 or libheif was built without multithreading support, all items are decoded
+// sequentially in the calling thread.
+// The function returns when all items have been decoded. Errors of individual items are passed to the callback.
+LIBHEIF_API
+heif_error heif_decode_images_batch(const heif_decode_batch_item* items,
+                                    size_t num_items,
+                                    const heif_decoding_options* options,
+                                    int max_threads,
+                                    heif_decode_batch_callback callback,
+                                    void* userdata);
+
 #ifdef __cplusplus
 }
 #endif
@@ -23,6 +23,7 @@
 #include "context.h"
 #include "init.h"
 #include "plugin_registry.h"
+#include "trace.h"
 #include "image-items/overlay.h"
 #include "image-items/tiled.h"
 #include "image-items/grid.h"
@@ -55,6 +56,12 @@ int heif_have_encoder_for_format(heif_compression_format format)
 }
 
 
+void heif_context_set_max_encoding_threads(heif_context* ctx, int max_threads)
+{
+  ctx->context->set_max_encoding_threads(max_threads);
+}
+
+
 int heif_get_encoder_descriptors(heif_compression_format format,
                                  const char* name,
                                  const heif_encoder_descriptor** out_encoder_descriptors,
@@ -651,6 +658,10 @@ heif_error heif_context_encode_image(heif_context* ctx,
     *out_image_handle = nullptr;
   }
 
+  OperationTraceScope trace(ctx->context->get_trace_callback(),
+                            ctx->context->get_trace_callback_userdata(),
+                            heif_trace_operation_encode, 0);
+
   heif_encoding_options options;
   heif_color_profile_nclx nclx;
   set_default_encoding_options(options);
@@ -680,6 +691,7 @@ heif_error heif_context_encode_image(heif_context* ctx,
   }
 
   std::shared_ptr<ImageItem> image = *encodingResult;
+  trace.set_item_id(image->get_id());
 
   // mark the new image as primary image
 
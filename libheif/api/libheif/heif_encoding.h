@@ -55,6 +55,12 @@ typedef struct heif_encoder_parameter heif_encoder_parameter;
 LIBHEIF_API
 int heif_have_encoder_for_format(enum heif_compression_format format);
 
+// If the maximum threads number is set to 0, libheif encodes image tiles in the main thread.
+// Currently, this is used by heif_context_add_image_tiles() for 'unci' images.
+// Note that this setting only affects libheif itself. The codecs may still use multi-threaded encoding.
+LIBHEIF_API
+void heif_context_set_max_encoding_threads(heif_context* ctx, int max_threads);
+
 // Get a list of available encoders. You can filter the encoders by compression format and name.
 // Use format_filter==heif_compression_undefined and name_filter==NULL as wildcards.
 // The returned list of encoders is sorted by their priority (which is a plugin property).
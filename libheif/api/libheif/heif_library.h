@@ -111,7 +111,14 @@ typedef struct heif_init_params
 {
   int version;
 
-  // currently no parameters
+  // --- version 1: no parameters
+
+  // --- version 2
+
+  // Number of worker threads in the thread pool that libheif shares between all contexts and with the codec plugins.
+  // 0 (default) starts one thread per CPU core.
+  // This is only applied by the first heif_init() call. The pool is stopped by the last heif_deinit().
+  int num_worker_threads;
 } heif_init_params;
 
 
@@ -132,7 +139,7 @@ typedef struct heif_init_params
  * Make sure that you do not have one part of your program use heif_init()/heif_deinit() and another part that does
  * not use it as the latter may try to use an uninitialized library. If in doubt, enclose everything with init/deinit.
  *
- * You may pass nullptr to get default parameters. Currently, no parameters are supported.
+ * You may pass nullptr to get default parameters.
  */
 LIBHEIF_API
 heif_error heif_init(heif_init_params*);
@@ -192,6 +199,14 @@ const char* const* heif_get_plugin_directories(void);
 LIBHEIF_API
 void heif_free_plugin_directories(const char* const*);
 
+// Loads all plugins in the directory and writes a manifest file that lists the compression formats of each plugin.
+// When a plugin directory has an up-to-date manifest, heif_init() does not load its plugins, but they are loaded
+// only when a decoder or encoder for one of their formats is requested.
+// Call this (e.g. with 'heif-info --write-plugin-manifest') after installing or updating plugins.
+// A manifest that does not match the plugin files in the directory anymore is ignored.
+LIBHEIF_API
+heif_error heif_write_plugin_manifest(const char* directory);
+
 
 // --- register plugins
 
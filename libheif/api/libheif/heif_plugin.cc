@@ -20,6 +20,7 @@
 
 #include "heif.h"
 #include "heif_plugin.h"  // needed to avoid 'unresolved symbols' on Visual Studio compiler
+#include "thread_pool.h"
 
 heif_error heif_error_ok = {heif_error_Ok, heif_suberror_Unspecified, "Success"};
 
@@ -32,3 +33,45 @@ heif_error heif_error_invalid_parameter_value = {heif_error_Usage_error,
                                                         "Invalid parameter value"};
 
 
+struct heif_task_group
+{
+  TaskGroup group;
+};
+
+
+heif_task_group* heif_task_group_alloc()
+{
+  return new heif_task_group;
+}
+
+
+void heif_task_group_submit(heif_task_group* group, void (* task)(void* task_data), void* task_data)
+{
+  group->group.submit([task, task_data]() { task(task_data); });
+}
+
+
+void heif_task_group_wait(heif_task_group* group)
+{
+  group->group.wait();
+}
+
+
+void heif_task_group_free(heif_task_group* group)
+{
+  delete group;
+}
+
+
+int heif_get_recommended_plugin_thread_count()
+{
+  // Codec libraries run their own threads. Inside a pool task (e.g. a parallel tile decode), libheif already
+  // keeps all cores busy and additional codec threads would only compete with the pool threads.
+
+  if (ThreadPool::is_running_task()) {
+    return 1;
+  }
+
+  // An explicitly configured pool size also limits the codec threads. Otherwise, keep the codec's own default.
+  return ThreadPool::get_global_num_threads();
+}
@@ -26,6 +26,7 @@ extern "C" {
 #endif
 
 #include <libheif/heif_encoding.h>
+#include <libheif/heif_sequences.h>
 
 
 // ====================================================================================================
@@ -43,9 +44,10 @@ extern "C" {
 //  1.13         2         3          2
 //  1.15         3         3          2
 //  1.20         4         3          2
+//  1.21         4         4          2
 
 #define heif_decoder_plugin_latest_version 4
-#define heif_encoder_plugin_latest_version 3
+#define heif_encoder_plugin_latest_version 4
 
 // ====================================================================================================
 //  Decoder plugin API
@@ -240,7 +242,40 @@ typedef struct heif_encoder_plugin
   void (* query_encoded_size)(void* encoder, uint32_t input_width, uint32_t input_height,
                               uint32_t* encoded_width, uint32_t* encoded_height);
 
-  // --- version 4 functions will follow below ... ---
+  // --- version 4 ---
+
+  // Sequence encoding. Instead of coding each image independently with encode_image(), all frames of a
+  // sequence are pushed into the same encoder instance, which may then use inter-frame prediction and lookahead:
+  //
+  //   start_sequence_encoding()
+  //   for each frame: encode_sequence_frame(), then get_compressed_data2() until it returns a NULL data pointer
+  //   end_sequence_encoding(), then get_compressed_data2() until it returns a NULL data pointer
+  //
+  // Because of the lookahead, get_compressed_data2() may return no data for the first frames and data for
+  // several frames later on. Frames have to be output in input order (no frame reordering).
+  // Set all four functions to NULL if the plugin does not support sequence encoding.
+
+  // `image` is the first frame of the sequence. It is only used to configure the encoder (size, chroma, bit depth,
+  // color profile). It is not encoded. It is passed again to encode_sequence_frame().
+  heif_error (* start_sequence_encoding)(void* encoder, const heif_image* image,
+                                         enum heif_image_input_class image_class,
+                                         uint32_t framerate_num, uint32_t framerate_denom,
+                                         const heif_sequence_encoding_options* options);
+
+  // `frame_nr` is an opaque number that is returned again by get_compressed_data2() for the packets of this frame.
+  // The image may be released after this call returns.
+  heif_error (* encode_sequence_frame)(void* encoder, const heif_image* image, uintptr_t frame_nr);
+
+  // Flush all frames that are still buffered in the encoder.
+  heif_error (* end_sequence_encoding)(void* encoder);
+
+  // Like get_compressed_data(), but additionally returns the frame_nr of the frame the packet belongs to,
+  // whether this frame is a keyframe (a sync sample that can be decoded independently), and whether more
+  // packets of the same frame will follow.
+  heif_error (* get_compressed_data2)(void* encoder, uint8_t** data, int* size,
+                                      uintptr_t* out_frame_nr, int* out_is_keyframe, int* out_more_frame_packets);
+
+  // --- version 5 functions will follow below ... ---
 
   // --- Note: when adding new versions, also update `heif_encoder_plugin_latest_version`.
 } heif_encoder_plugin;
@@ -311,6 +346,42 @@ extern heif_error heif_error_invalid_parameter_value;
     }                                         \
   }                                           \
 }
+
+
+// ====================================================================================================
+//  Thread pool
+//  libheif runs its parallel work on a pool of worker threads that is shared by all contexts.
+//  Plugins should submit their parallel work to this pool instead of starting their own threads,
+//  so that concurrent decoding and encoding does not oversubscribe the CPU cores.
+
+typedef struct heif_task_group heif_task_group;
+
+LIBHEIF_API
+heif_task_group* heif_task_group_alloc(void);
+
+// Runs task(task_data) on one of the worker threads.
+LIBHEIF_API
+void heif_task_group_submit(heif_task_group*, void (* task)(void* task_data), void* task_data);
+
+// Waits until all tasks submitted to this group have finished.
+// While waiting, the calling thread runs the queued tasks of this group itself. It is thus allowed to wait from within a task.
+LIBHEIF_API
+void heif_task_group_wait(heif_task_group*);
+
+// Waits for the remaining tasks and frees the group.
+LIBHEIF_API
+void heif_task_group_free(heif_task_group*);
+
+// Number of threads that a plugin should use for a codec library that runs its own threads.
+// Returns
+//  - 1 when the plugin is called from a libheif worker task (e.g. from a parallel tile decode),
+//  - heif_init_params::num_worker_threads if it was set to a value > 0,
+//  - 0 otherwise. The plugin should then keep the default thread count of the codec library.
+// Plugins should query this for each new decoder or encoder instance, since it depends on the calling thread.
+LIBHEIF_API
+int heif_get_recommended_plugin_thread_count(void);
+
+
 #ifdef __cplusplus
 }
 #endif
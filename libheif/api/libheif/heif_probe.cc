@@ -0,0 +1,330 @@
+/*
+ * HEIF codec.
+ * Copyright (c) 2025 Dirk Farin <dirk.farin@gmail.com>
+ *
+ * This file is part of libheif.
+ *
+ * libheif is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * libheif is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libheif.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "heif_probe.h"
+#include "file.h"
+#include "codecs/avc_boxes.h"
+#include "codecs/avif_boxes.h"
+#include "codecs/hevc_boxes.h"
+#include "codecs/vvc_boxes.h"
+
+#if WITH_UNCOMPRESSED_CODEC
+#include "codecs/uncompressed/unc_boxes.h"
+#include "codecs/uncompressed/unc_codec.h"
+#endif
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <vector>
+
+
+namespace {
+
+// Counts the bytes that are actually delivered by the application's reader.
+class StreamReader_probe : public StreamReader_CApi
+{
+public:
+  using StreamReader_CApi::StreamReader_CApi;
+
+  bool read(void* data, size_t size) override
+  {
+    uint64_t end = get_position() + size;
+
+    bool success = StreamReader_CApi::read(data, size);
+    if (success) {
+      m_bytes_read += size;
+      m_bytes_end = std::max(m_bytes_end, end);
+    }
+
+    return success;
+  }
+
+  uint64_t get_bytes_read() const { return m_bytes_read; }
+
+  uint64_t get_bytes_end() const { return m_bytes_end; }
+
+private:
+  uint64_t m_bytes_read = 0;
+  uint64_t m_bytes_end = 0;
+};
+
+}
+
+
+// Combines the 'irot' and 'imir' transformations (in property order) into an EXIF orientation.
+// The transformation is kept as a counter-clockwise rotation, optionally followed by a horizontal flip.
+static heif_orientation get_orientation(const std::vector<std::shared_ptr<Box>>& properties)
+{
+  int rotation_ccw = 0;
+  bool flip = false;
+
+  for (const auto& property : properties) {
+    if (auto irot = std::dynamic_pointer_cast<Box_irot>(property)) {
+      rotation_ccw += (flip ? -irot->get_rotation_ccw() : irot->get_rotation_ccw());
+    }
+    else if (auto imir = std::dynamic_pointer_cast<Box_imir>(property)) {
+      switch (imir->get_mirror_direction()) {
+        case heif_transform_mirror_direction_horizontal:
+          flip = !flip;
+          break;
+        case heif_transform_mirror_direction_vertical:
+          // vertical flip = horizontal flip + 180 degree rotation
+          flip = !flip;
+          rotation_ccw += 180;
+          break;
+        case heif_transform_mirror_direction_invalid:
+          break;
+      }
+    }
+  }
+
+  rotation_ccw = ((rotation_ccw % 360) + 360) % 360;
+
+  // inverse of HeifFile::add_orientation_properties()
+  switch (rotation_ccw) {
+    case 0:
+      return flip ? heif_orientation_flip_horizontally : heif_orientation_normal;
+    case 90:
+      return flip ? heif_orientation_rotate_90_cw_then_flip_vertically : heif_orientation_rotate_270_cw;
+    case 180:
+      return flip ? heif_orientation_flip_vertically : heif_orientation_rotate_180;
+    default:
+      return flip ? heif_orientation_rotate_90_cw_then_flip_horizontally : heif_orientation_rotate_90_cw;
+  }
+}
+
+
+static void get_bits_per_pixel(const std::vector<std::shared_ptr<Box>>& properties, int* luma, int* chroma)
+{
+  for (const auto& property : properties) {
+    if (auto pixi = std::dynamic_pointer_cast<Box_pixi>(property)) {
+      if (pixi->get_num_channels() > 0) {
+        *luma = pixi->get_bits_per_channel(0);
+        *chroma = pixi->get_bits_per_channel(pixi->get_num_channels() > 1 ? 1 : 0);
+        return;
+      }
+    }
+  }
+
+  for (const auto& property : properties) {
+    if (auto hvcC = std::dynamic_pointer_cast<Box_hvcC>(property)) {
+      *luma = hvcC->get_configuration().bit_depth_luma;
+      *chroma = hvcC->get_configuration().bit_depth_chroma;
+      return;
+    }
+    else if (auto avcC = std::dynamic_pointer_cast<Box_avcC>(property)) {
+      *luma = avcC->get_configuration().bit_depth_luma;
+      *chroma = avcC->get_configuration().bit_depth_chroma;
+      return;
+    }
+    else if (auto av1C = std::dynamic_pointer_cast<Box_av1C>(property)) {
+      Box_av1C::configuration config = av1C->get_configuration();
+      *luma = *chroma = (!config.high_bitdepth ? 8 : (config.twelve_bit ? 12 : 10));
+      return;
+    }
+    else if (auto vvcC = std::dynamic_pointer_cast<Box_vvcC>(property)) {
+      const Box_vvcC::configuration& config = vvcC->get_configuration();
+      if (config.ptl_present_flag) {
+        *luma = *chroma = config.bit_depth_minus8 + 8;
+        return;
+      }
+    }
+  }
+}
+
+
+static bool has_alpha_component(const std::vector<std::shared_ptr<Box>>& properties)
+{
+#if WITH_UNCOMPRESSED_CODEC
+  std::shared_ptr<Box_uncC> uncC;
+  std::shared_ptr<Box_cmpd> cmpd;
+
+  for (const auto& property : properties) {
+    if (auto box = std::dynamic_pointer_cast<Box_uncC>(property)) {
+      uncC = box;
+    }
+    else if (auto box = std::dynamic_pointer_cast<Box_cmpd>(property)) {
+      cmpd = box;
+    }
+  }
+
+  if (!uncC) {
+    return false;
+  }
+
+  heif_chroma chroma;
+  heif_colorspace colorspace;
+  bool has_alpha = false;
+  Error err = UncompressedImageCodec::get_heif_chroma_uncompressed(uncC, cmpd, &chroma, &colorspace, &has_alpha);
+
+  return !err && has_alpha;
+#else
+  (void) properties;
+  return false;
+#endif
+}
+
+
+static bool has_alpha_aux_image(const HeifFile& file, heif_item_id primary_id)
+{
+  auto iref = file.get_iref_box();
+  if (!iref) {
+    return false;
+  }
+
+  for (heif_item_id id : file.get_item_IDs()) {
+    std::vector<heif_item_id> refs = iref->get_references(id, fourcc("auxl"));
+    if (std::find(refs.begin(), refs.end(), primary_id) == refs.end()) {
+      continue;
+    }
+
+    std::vector<std::shared_ptr<Box>> properties;
+    if (file.get_properties(id, properties)) {
+      continue;
+    }
+
+    for (const auto& property : properties) {
+      if (auto auxC = std::dynamic_pointer_cast<Box_auxC>(property)) {
+        if (auxC->get_aux_type() == "urn:mpeg:avc:2015:auxid:1" ||
+            auxC->get_aux_type() == "urn:mpeg:hevc:2015:auxid:1" ||
+            auxC->get_aux_type() == "urn:mpeg:mpegB:cicp:systems:auxiliary:alpha") {
+          return true;
+        }
+      }
+    }
+  }
+
+  return false;
+}
+
+
+// Returns the file range of the first metadata item of the given type that describes the primary image.
+static void get_metadata_range(const HeifFile& file, heif_item_id primary_id,
+                               uint32_t item_type, const char* content_type,
+                               uint64_t* out_offset, uint64_t* out_size)
+{
+  auto iref = file.get_iref_box();
+  if (!iref) {
+    return;
+  }
+
+  for (heif_item_id id : file.get_item_IDs()) {
+    if (file.get_item_type_4cc(id) != item_type ||
+        (content_type && file.get_content_type(id) != content_type)) {
+      continue;
+    }
+
+    std::vector<heif_item_id> refs = iref->get_references(id, fourcc("cdsc"));
+    if (std::find(refs.begin(), refs.end(), primary_id) == refs.end()) {
+      continue;
+    }
+
+    std::vector<FileRange> ranges;
+    Error err = file.get_file_ranges_from_iloc(id, 0, std::numeric_limits<uint64_t>::max(), ranges);
+    if (!err && ranges.size() == 1) {
+      *out_offset = ranges[0].start;
+      *out_size = ranges[0].end - ranges[0].start;
+    }
+
+    return;
+  }
+}
+
+
+heif_error heif_probe(const heif_reader* reader_func_table, void* userdata, heif_probe_info* info)
+{
+  if (!reader_func_table || !info) {
+    return {heif_error_Usage_error, heif_suberror_Null_pointer_argument, "NULL argument passed to heif_probe()"};
+  }
+
+  if (info->version < 1) {
+    return {heif_error_Usage_error, heif_suberror_Unsupported_parameter, "Unsupported heif_probe_info version"};
+  }
+
+  auto reader = std::make_shared<StreamReader_probe>(reader_func_table, userdata);
+
+  HeifFile file;
+  file.set_security_limits(heif_get_global_security_limits());
+
+  Error err = file.read(reader, true);
+
+  info->bytes_read = reader->get_bytes_read();
+  info->bytes_end = reader->get_bytes_end();
+
+  if (err) {
+    return err.error_struct(nullptr);
+  }
+
+  if (!file.has_images()) {
+    return {heif_error_Invalid_input, heif_suberror_No_meta_box, "File contains no images"};
+  }
+
+  heif_item_id primary_id = file.get_primary_image_ID();
+  if (!file.item_exists(primary_id)) {
+    return {heif_error_Invalid_input, heif_suberror_Nonexisting_item_referenced, "Primary image does not exist"};
+  }
+
+  std::vector<std::shared_ptr<Box>> properties;
+  err = file.get_properties(primary_id, properties);
+  if (err) {
+    return err.error_struct(nullptr);
+  }
+
+  info->main_brand = file.get_ftyp_box()->get_major_brand();
+  info->primary_image_id = primary_id;
+  info->primary_item_type = file.get_item_type_4cc(primary_id);
+
+  info->width = 0;
+  info->height = 0;
+  for (const auto& property : properties) {
+    if (auto ispe = std::dynamic_pointer_cast<Box_ispe>(property)) {
+      info->width = ispe->get_width();
+      info->height = ispe->get_height();
+      break;
+    }
+  }
+
+  info->orientation = get_orientation(properties);
+
+  // For derived images, the coding parameters are taken from the first input image.
+  std::vector<std::shared_ptr<Box>> coding_properties = properties;
+  if (auto iref = file.get_iref_box()) {
+    std::vector<heif_item_id> inputs = iref->get_references(primary_id, fourcc("dimg"));
+    if (!inputs.empty()) {
+      coding_properties.clear();
+      file.get_properties(inputs[0], coding_properties);
+      coding_properties.insert(coding_properties.begin(), properties.begin(), properties.end());
+    }
+  }
+
+  info->luma_bits_per_pixel = -1;
+  info->chroma_bits_per_pixel = -1;
+  get_bits_per_pixel(coding_properties, &info->luma_bits_per_pixel, &info->chroma_bits_per_pixel);
+
+  info->has_alpha = has_alpha_aux_image(file, primary_id) || has_alpha_component(coding_properties);
+
+  info->exif_offset = info->exif_size = 0;
+  info->xmp_offset = info->xmp_size = 0;
+  get_metadata_range(file, primary_id, fourcc("Exif"), nullptr, &info->exif_offset, &info->exif_size);
+  get_metadata_range(file, primary_id, fourcc("mime"), "application/rdf+xml", &info->xmp_offset, &info->xmp_size);
+
+  return heif_error_success;
+}
@@ -0,0 +1,95 @@
+/*
+ * HEIF codec.
+ * Copyright (c) 2025 Dirk Farin <dirk.farin@gmail.com>
+ *
+ * This file is part of libheif.
+ *
+ * libheif is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * libheif is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libheif.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBHEIF_HEIF_PROBE_H
+#define LIBHEIF_HEIF_PROBE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <libheif/heif_library.h>
+#include <libheif/heif_error.h>
+#include <libheif/heif_brands.h>
+#include <libheif/heif_context.h>
+#include <libheif/heif_encoding.h>
+
+
+// --- header-only probing
+
+typedef struct heif_probe_info
+{
+  uint8_t version;
+
+  // --- version 1
+
+  heif_brand2 main_brand;
+
+  heif_item_id primary_image_id;
+  uint32_t primary_item_type; // four character code, e.g. 'hvc1', 'grid'
+
+  // Size of the primary image as stored in the file ('ispe'), before applying the transformations.
+  // For orientations 5 to 8, width and height are swapped in the displayed image.
+  // Clean aperture cropping is not taken into account.
+  uint32_t width;
+  uint32_t height;
+
+  enum heif_orientation orientation;
+
+  // -1 if the bit depth cannot be determined from the metadata alone
+  int luma_bits_per_pixel;
+  int chroma_bits_per_pixel;
+
+  int has_alpha;
+
+  // File range of the Exif and XMP metadata items that describe the primary image.
+  // The Exif data starts with the 4-byte offset to the TIFF header, like the data of heif_image_handle_get_metadata().
+  // The size is 0 if there is no such item or if its data is not stored as one contiguous range in the file.
+  uint64_t exif_offset;
+  uint64_t exif_size;
+  uint64_t xmp_offset;
+  uint64_t xmp_size;
+
+  // Total number of bytes delivered by heif_reader.read(). Bytes that are read twice are counted twice.
+  uint64_t bytes_read;
+
+  // End of the highest file range that has been read. Only the file prefix up to this position is needed for probing.
+  uint64_t bytes_end;
+} heif_probe_info;
+
+
+// Reads the basic properties of the primary image without opening a heif_context.
+// Only the 'ftyp' box, the box headers up to the 'meta' (or 'mini') box, and the 'meta' box itself are read.
+// The image data in 'mdat' is never read and no image decoders are set up.
+// This is intended for indexing large numbers of files. Use heif_context_read_from_reader() for everything else.
+//
+// 'info->version' has to be set to the struct version that the caller allocated.
+LIBHEIF_API
+heif_error heif_probe(const heif_reader* reader, void* userdata, heif_probe_info* info);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -50,6 +50,32 @@ int heif_image_handle_get_list_of_region_item_ids(const heif_image_handle* handl
 }
 
 
+int heif_image_handle_query_regions_in_rect(const heif_image_handle* handle,
+                                            int32_t x, int32_t y,
+                                            uint32_t width, uint32_t height,
+                                            heif_item_id* out_region_item_ids,
+                                            int* out_region_indices,
+                                            int max_count)
+{
+  if (handle == nullptr) {
+    return 0;
+  }
+
+  auto index = handle->image->get_region_spatial_index();
+  auto hits = index->query({(double) x, (double) y, (double) x + width, (double) y + height});
+
+  int num = std::min((int) hits.size(), max_count);
+  for (int i = 0; i < num; i++) {
+    out_region_item_ids[i] = hits[i]->region_item_id;
+    if (out_region_indices) {
+      out_region_indices[i] = hits[i]->region_index;
+    }
+  }
+
+  return (int) hits.size();
+}
+
+
 heif_error heif_context_get_region_item(const heif_context* context,
                                         heif_item_id region_item_id,
                                         heif_region_item** out)
@@ -124,6 +150,29 @@ int heif_region_item_get_list_of_regions(const heif_region_item* region_item,
 }
 
 
+heif_error heif_region_item_get_region(const heif_region_item* region_item,
+                                       int index,
+                                       heif_region** out_region)
+{
+  if (region_item == nullptr || out_region == nullptr) {
+    return heif_error_null_pointer_argument;
+  }
+
+  if (index < 0 || index >= region_item->region_item->get_number_of_regions()) {
+    return heif_error_invalid_parameter_value;
+  }
+
+  auto region = new heif_region();
+  region->context = region_item->context;
+  region->region_item = region_item->region_item;
+  region->region = region_item->region_item->get_region(index);
+
+  *out_region = region;
+
+  return heif_error_success;
+}
+
+
 void heif_region_release(const heif_region* region)
 {
   delete region;
@@ -508,6 +557,58 @@ heif_error heif_region_get_mask_image(const heif_region* region,
 }
 
 
+heif_error heif_region_item_rasterize_to_mask(const heif_region_item* region_item,
+                                              heif_item_id image_id,
+                                              enum heif_region_mask_type mask_type,
+                                              heif_image** out_mask_image)
+{
+  if (region_item == nullptr || out_mask_image == nullptr) {
+    return heif_error_null_pointer_argument;
+  }
+
+  *out_mask_image = nullptr;
+
+  const auto& item = region_item->region_item;
+  std::shared_ptr<HeifContext> context = region_item->context;
+
+  RegionCoordinateTransform transform;
+  uint32_t width = item->reference_width;
+  uint32_t height = item->reference_height;
+
+  if (image_id != 0) {
+    transform = RegionCoordinateTransform::create(context->get_heif_file(), image_id,
+                                                  item->reference_width, item->reference_height);
+    width = transform.get_image_width();
+    height = transform.get_image_height();
+
+    if (width == 0 || height == 0) {
+      return {heif_error_Usage_error, heif_suberror_Nonexisting_item_referenced, "Image does not exist or has no size"};
+    }
+  }
+
+  RegionItem::MaskLoader load_mask = [&context](heif_item_id mask_id) {
+    heif_decoding_options* options = heif_decoding_options_alloc();
+
+    auto result = context->decode_image(mask_id, heif_colorspace_monochrome, heif_chroma_monochrome,
+                                        *options, false, 0, 0);
+
+    heif_decoding_options_free(options);
+    return result;
+  };
+
+  auto maskResult = item->rasterize(transform, width, height, mask_type, load_mask,
+                                    context->get_security_limits());
+  if (!maskResult) {
+    return maskResult.error_struct(context.get());
+  }
+
+  *out_mask_image = new heif_image();
+  (*out_mask_image)->image = *maskResult;
+
+  return heif_error_success;
+}
+
+
 heif_error heif_image_handle_add_region_item(heif_image_handle* image_handle,
                                              uint32_t reference_width, uint32_t reference_height,
                                              heif_region_item** out_region_item)
@@ -155,6 +155,47 @@ int heif_image_handle_get_list_of_region_item_ids(const heif_image_handle* image
                                                   heif_item_id* region_item_ids_array,
                                                   int max_count);
 
+/**
+ * Find the regions attached to an image whose bounding box intersects a rectangle.
+ *
+ * The rectangle is given in the coordinate system of the image after all transformative
+ * properties have been applied, like the "_transformed" region functions.
+ * For a point query, use a rectangle of size 1x1.
+ *
+ * The query uses a spatial index over the region bounding boxes that is built on the first
+ * query and reused afterwards, so no region objects are created for non-matching regions.
+ * Since only bounding boxes are compared, a hit does not guarantee that the region geometry
+ * itself covers a pixel in the rectangle.
+ *
+ * Each hit is returned as the ID of the region item and the index of the region within that
+ * item (see heif_region_item_get_region()). Hits are ordered by region item and region index.
+ *
+ * Possible usage (in C++):
+ * @code
+ *  int num_hits = heif_image_handle_query_regions_in_rect(handle, x, y, w, h, nullptr, nullptr, 0);
+ *  std::vector<heif_item_id> region_item_ids(num_hits);
+ *  std::vector<int> region_indices(num_hits);
+ *  heif_image_handle_query_regions_in_rect(handle, x, y, w, h, region_item_ids.data(), region_indices.data(), num_hits);
+ * @endcode
+ *
+ * @param image_handle the image handle for the image to query
+ * @param x the left edge of the query rectangle
+ * @param y the top edge of the query rectangle
+ * @param width the width of the query rectangle
+ * @param height the height of the query rectangle
+ * @param out_region_item_ids array for the region item IDs of the hits (may be NULL if max_count is 0)
+ * @param out_region_indices array for the region indices of the hits (optional, may be NULL)
+ * @param max_count the maximum number of hits to return, which needs to correspond to the size of the arrays
+ * @return the total number of hits, which may be larger than max_count
+ */
+LIBHEIF_API
+int heif_image_handle_query_regions_in_rect(const heif_image_handle* image_handle,
+                                            int32_t x, int32_t y,
+                                            uint32_t width, uint32_t height,
+                                            heif_item_id* out_region_item_ids,
+                                            int* out_region_indices,
+                                            int max_count);
+
 /**
  * Get the region item.
  *
@@ -238,6 +279,21 @@ int heif_region_item_get_list_of_regions(const heif_region_item* region_item,
                                          heif_region** out_regions_array,
                                          int max_count);
 
+/**
+ * Get a single region of a region item.
+ *
+ * Caller is responsible for releasing the returned `heif_region` object with heif_region_release().
+ *
+ * @param region_item the region_item to query
+ * @param index the index of the region, in the range 0 to heif_region_item_get_number_of_regions()-1
+ * @param out_region the returned region
+ * @return heif_error_ok on success, or an error value indicating the problem on failure
+ */
+LIBHEIF_API
+heif_error heif_region_item_get_region(const heif_region_item* region_item,
+                                       int index,
+                                       heif_region** out_region);
+
 /**
  * Release a region.
  *
@@ -637,6 +693,58 @@ heif_error heif_region_get_mask_image(const heif_region* region,
                                       uint32_t* out_width, uint32_t* out_height,
                                       heif_image** out_mask_image);
 
+/**
+ * Output format for heif_region_item_rasterize_to_mask().
+ */
+enum heif_region_mask_type
+{
+  /**
+   * Pixels that are part of any region are set to 255, all other pixels are 0.
+   * Referenced masks keep their (scaled) probability values.
+   */
+  heif_region_mask_type_binary = 0,
+
+  /**
+   * Like heif_region_mask_type_binary, but area shapes (rectangles, ellipses and polygons)
+   * are anti-aliased. The pixel value is the fraction of the pixel area covered by the shape.
+   */
+  heif_region_mask_type_coverage = 1,
+
+  /**
+   * Each pixel holds the 1-based index of the last region (in the order of
+   * heif_region_item_get_list_of_regions()) that covers the pixel, or 0 if no region covers it.
+   * Since the mask is an 8-bit image, this is limited to region items with at most 255 regions
+   * (which is also the maximum number of regions that can be written to a file).
+   * For larger region items, heif_region_item_rasterize_to_mask() returns heif_suberror_Too_many_regions.
+   */
+  heif_region_mask_type_label_map = 2
+};
+
+/**
+ * Rasterize all regions of a region item into a single mask image.
+ *
+ * If `image_id` is non-zero, the regions are mapped into the coordinate system of that image,
+ * including all transformative properties, and the mask has the size of the transformed image.
+ * This is the same mapping as used by the "_transformed" functions above.
+ * If `image_id` is 0, the mask is drawn in the reference coordinate space of the region item.
+ *
+ * The returned image is an 8-bit monochrome image. Referenced mask regions are decoded as part
+ * of this call.
+ *
+ * @param region_item the region item to rasterize
+ * @param image_id the image to map the regions to, or 0 for the reference coordinate space
+ * @param mask_type the kind of mask to generate
+ * @param out_mask_image the returned mask image
+ * @return heif_error_ok on success, or an error value indicating the problem on failure
+ *
+ * \note the caller is responsible for releasing the mask image
+ */
+LIBHEIF_API
+heif_error heif_region_item_rasterize_to_mask(const heif_region_item* region_item,
+                                              heif_item_id image_id,
+                                              enum heif_region_mask_type mask_type,
+                                              heif_image** out_mask_image);
+
 // --- adding region items
 
 /**
@@ -29,6 +29,7 @@
 #include <array>
 #include <cstring>
 #include <memory>
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <utility>
@@ -154,6 +155,45 @@ heif_error heif_track_get_image_resolution(const heif_track* track_ptr, uint16_t
 }
 
 
+heif_error heif_track_seek_to_sample(heif_track* track_ptr, uint64_t sample_index)
+{
+  Error err = track_ptr->track->seek_to_sample(sample_index);
+  if (err) {
+    return err.error_struct(track_ptr->context.get());
+  }
+
+  return heif_error_success;
+}
+
+
+heif_error heif_track_seek_to_time(heif_track* track_ptr, uint64_t time)
+{
+  auto sampleResult = track_ptr->track->get_output_sample_at_time(time);
+  if (!sampleResult) {
+    return sampleResult.error_struct(track_ptr->context.get());
+  }
+
+  return heif_track_seek_to_sample(track_ptr, *sampleResult);
+}
+
+
+heif_error heif_track_set_decoding_pipeline_depth(heif_track* track_ptr, int depth)
+{
+  auto visual_track = std::dynamic_pointer_cast<Track_Visual>(track_ptr->track);
+  if (!visual_track) {
+    return {
+      heif_error_Usage_error,
+      heif_suberror_Invalid_parameter_value,
+      "Cannot set decoding pipeline depth of non-visual track."
+    };
+  }
+
+  visual_track->set_decoding_pipeline_depth(depth);
+
+  return heif_error_success;
+}
+
+
 heif_error heif_track_decode_next_image(heif_track* track_ptr,
                                         heif_image** out_img,
                                         heif_colorspace colorspace,
@@ -394,17 +434,44 @@ void heif_track_options_set_gimi_track_id(heif_track_options* options,
 }
 
 
+static void fill_default_sequence_encoding_options(heif_sequence_encoding_options& options)
+{
+  options.version = 2;
+  options.output_nclx_profile = nullptr;
+
+  options.color_conversion_options.version = 1;
+  options.color_conversion_options.preferred_chroma_downsampling_algorithm = heif_chroma_downsampling_average;
+  options.color_conversion_options.preferred_chroma_upsampling_algorithm = heif_chroma_upsampling_bilinear;
+  options.color_conversion_options.only_use_preferred_chroma_algorithm = false;
+
+  options.gop_structure = heif_sequence_gop_structure_intra_only;
+  options.keyframe_distance_max = 0;
+}
+
+
+// overwrite the (possibly lower version) input options over the default options
+static void copy_sequence_encoding_options(heif_sequence_encoding_options& dst,
+                                           const heif_sequence_encoding_options& src)
+{
+  int min_version = std::min(dst.version, src.version);
+
+  switch (min_version) {
+    case 2:
+      dst.gop_structure = src.gop_structure;
+      dst.keyframe_distance_max = src.keyframe_distance_max;
+      [[fallthrough]];
+    case 1:
+      dst.output_nclx_profile = src.output_nclx_profile;
+      dst.color_conversion_options = src.color_conversion_options;
+  }
+}
+
+
 heif_sequence_encoding_options* heif_sequence_encoding_options_alloc()
 {
   heif_sequence_encoding_options* options = new heif_sequence_encoding_options();
 
-  options->version = 1;
-  options->output_nclx_profile = nullptr;
-
-  options->color_conversion_options.version = 1;
-  options->color_conversion_options.preferred_chroma_downsampling_algorithm = heif_chroma_downsampling_average;
-  options->color_conversion_options.preferred_chroma_upsampling_algorithm = heif_chroma_upsampling_bilinear;
-  options->color_conversion_options.only_use_preferred_chroma_algorithm = false;
+  fill_default_sequence_encoding_options(*options);
 
   return options;
 }
@@ -501,11 +568,18 @@ heif_error heif_track_encode_sequence_image(heif_track* track,
     }
   }
 
+  heif_sequence_encoding_options seq_options;
+  fill_default_sequence_encoding_options(seq_options);
+  if (sequence_encoding_options) {
+    copy_sequence_encoding_options(seq_options, *sequence_encoding_options);
+  }
+
   // encode the image
 
   auto error = visual_track->encode_image(input_image->image,
                                           encoder,
                                           *encoding_options,
+                                          seq_options,
                                           heif_image_input_class_normal);
   heif_encoding_options_free(encoding_options);
 
@@ -517,6 +591,26 @@ heif_error heif_track_encode_sequence_image(heif_track* track,
 }
 
 
+heif_error heif_track_encode_end_of_sequence(heif_track* track, heif_encoder* encoder)
+{
+  auto visual_track = std::dynamic_pointer_cast<Track_Visual>(track->track);
+  if (!visual_track) {
+    return {
+      heif_error_Usage_error,
+      heif_suberror_Invalid_parameter_value,
+      "Cannot end sequence of non-visual track."
+    };
+  }
+
+  auto error = visual_track->encode_end_of_sequence(encoder);
+  if (error.error_code) {
+    return error.error_struct(track->context.get());
+  }
+
+  return heif_error_ok;
+}
+
+
 heif_error heif_context_add_uri_metadata_sequence_track(heif_context* ctx,
                                                         const char* uri,
                                                         const heif_track_options* track_options,
@@ -589,6 +683,66 @@ heif_error heif_track_add_raw_sequence_sample(heif_track* track,
 }
 
 
+heif_error heif_context_start_fragmented_writing(heif_context* ctx,
+                                                 heif_writer* writer,
+                                                 void* userdata,
+                                                 uint32_t max_fragment_duration_ms)
+{
+  if (!ctx || !writer) {
+    return heif_error_null_pointer_argument;
+  }
+
+  auto output = get_heif_writer_output(ctx, writer, userdata);
+  if (!output) {
+    return output.error().error_struct(ctx->context.get());
+  }
+
+  Error err = ctx->context->start_fragmented_writing(*output, max_fragment_duration_ms);
+  if (err) {
+    return err.error_struct(ctx->context.get());
+  }
+
+  return heif_error_ok;
+}
+
+
+heif_error heif_context_start_fragmented_writing_to_file(heif_context* ctx,
+                                                         const char* filename,
+                                                         uint32_t max_fragment_duration_ms)
+{
+  if (!ctx || !filename) {
+    return heif_error_null_pointer_argument;
+  }
+
+  auto output = get_file_output(filename);
+  if (!output) {
+    return output.error().error_struct(ctx->context.get());
+  }
+
+  Error err = ctx->context->start_fragmented_writing(*output, max_fragment_duration_ms);
+  if (err) {
+    return err.error_struct(ctx->context.get());
+  }
+
+  return heif_error_ok;
+}
+
+
+heif_error heif_context_end_fragmented_writing(heif_context* ctx)
+{
+  if (!ctx) {
+    return heif_error_null_pointer_argument;
+  }
+
+  Error err = ctx->context->end_fragmented_writing();
+  if (err) {
+    return err.error_struct(ctx->context.get());
+  }
+
+  return heif_error_ok;
+}
+
+
 int heif_track_get_number_of_sample_aux_infos(const heif_track* track)
 {
   std::vector<heif_sample_aux_info_type> aux_info_types = track->track->get_sample_aux_info_types();
@@ -155,6 +155,31 @@ LIBHEIF_API
 uint32_t heif_track_get_timescale(const heif_track*);
 
 
+// --- random access
+
+/**
+ * Set the sample that is returned by the next call to heif_track_decode_next_image()
+ * or heif_track_get_next_raw_sequence_sample().
+ *
+ * The sample index counts the samples in presentation order, starting at 0. When the sequence
+ * is repeated through its edit list, the repetitions are counted as well.
+ * For visual tracks, decoding restarts at the preceding sync sample. The frames between
+ * the sync sample and the requested sample are decoded on the next decode call, but not returned.
+ *
+ * If the index is after the end of the sequence, `heif_error_End_of_sequence` is returned.
+ */
+LIBHEIF_API
+heif_error heif_track_seek_to_sample(heif_track*, uint64_t sample_index);
+
+/**
+ * Seek to the sample that is displayed at the given time.
+ * The time is specified in clock ticks of the track timescale (see heif_track_get_timescale()).
+ * See heif_track_seek_to_sample() for details.
+ */
+LIBHEIF_API
+heif_error heif_track_seek_to_time(heif_track*, uint64_t time);
+
+
 // --- reading visual tracks
 
 /**
@@ -181,6 +206,23 @@ heif_error heif_track_decode_next_image(heif_track* track,
                                         enum heif_chroma chroma,
                                         const heif_decoding_options* options);
 
+/**
+ * Decode up to `depth` frames of the track ahead, in parallel to the application's processing.
+ * The frames are still returned one at a time by heif_track_decode_next_image(), in presentation order.
+ *
+ * Pipelining is only applied to sequences in which every frame is a sync sample (intra-only sequences).
+ * Sequences with inter-predicted frames are decoded sequentially, because each frame depends on the decoder
+ * state of the previous ones.
+ * It has no effect when libheif is compiled without multithreading support.
+ * Values <= 1 switch pipelining off (default).
+ *
+ * Note: the decoding options of the first call to heif_track_decode_next_image() after the pipeline
+ * was (re)filled are used for the frames decoded ahead. The progress and cancellation callbacks are not
+ * called for these frames.
+ */
+LIBHEIF_API
+heif_error heif_track_set_decoding_pipeline_depth(heif_track* track, int depth);
+
 /**
  * Get the image display duration in clock ticks of this track.
  * Make sure to use the timescale of the track and not the timescale of the total sequence.
@@ -335,7 +377,15 @@ void heif_track_options_set_gimi_track_id(heif_track_options*,
 
 // --- writing visual tracks
 
-// This structure is for future use. It is not defined yet.
+enum heif_sequence_gop_structure
+{
+  // All frames are coded as independent intra frames.
+  heif_sequence_gop_structure_intra_only = 0,
+
+  // Frames may be predicted from previous frames, but there is no frame reordering (no B-frames).
+  heif_sequence_gop_structure_lowdelay = 1
+};
+
 typedef struct heif_sequence_encoding_options
 {
   uint8_t version;
@@ -347,6 +397,18 @@ typedef struct heif_sequence_encoding_options
   const heif_color_profile_nclx* output_nclx_profile;
 
   heif_color_conversion_options color_conversion_options;
+
+  // version 2 options
+
+  // Inter-frame prediction is only used when the encoder plugin supports sequence encoding.
+  // Otherwise, all frames are coded as intra frames.
+  // With heif_sequence_gop_structure_lowdelay, the encoder may buffer frames and heif_track_encode_end_of_sequence()
+  // has to be called after the last frame.
+  // Default: heif_sequence_gop_structure_intra_only
+  enum heif_sequence_gop_structure gop_structure;
+
+  // Maximum distance between keyframes. Set to 0 to use the encoder default.
+  int keyframe_distance_max;
 } heif_sequence_encoding_options;
 
 
@@ -394,6 +456,16 @@ heif_error heif_track_encode_sequence_image(heif_track*,
                                             heif_encoder* encoder,
                                             const heif_sequence_encoding_options* sequence_encoding_options);
 
+/**
+ * Finish encoding the visual track.
+ * Encoders with lookahead keep some frames buffered. This call writes these remaining frames into the track.
+ * It has to be called with the same encoder after the last image has been passed to heif_track_encode_sequence_image()
+ * and before the file is written.
+ * This is only required when the images were encoded with heif_sequence_gop_structure_lowdelay. Otherwise, it does nothing.
+ */
+LIBHEIF_API
+heif_error heif_track_encode_end_of_sequence(heif_track*, heif_encoder* encoder);
+
 // --- metadata tracks
 
 /**
@@ -436,6 +508,44 @@ heif_error heif_track_add_raw_sequence_sample(heif_track*,
                                               const heif_raw_sequence_sample*);
 
 
+// --- fragmented writing
+
+/**
+ * Start writing the sequence as a fragmented file.
+ * Instead of collecting all samples in memory until heif_context_write() is called,
+ * the file header is passed to the writer as soon as all tracks have received their first sample
+ * and the samples are then written in movie fragments ('moof' + 'mdat' boxes) of at most
+ * `max_fragment_duration_ms` milliseconds.
+ *
+ * All images and tracks have to be added to the context before calling this function.
+ * Each call to the writer appends data to the output.
+ * Each track can only use a single compression format (sample description) in fragmented mode.
+ *
+ * Finish the file with heif_context_end_fragmented_writing(). heif_context_write() cannot be used
+ * on a context in fragmented writing mode.
+ */
+LIBHEIF_API
+heif_error heif_context_start_fragmented_writing(heif_context*,
+                                                 heif_writer* writer,
+                                                 void* userdata,
+                                                 uint32_t max_fragment_duration_ms);
+
+/**
+ * Same as heif_context_start_fragmented_writing(), but writes into a file.
+ */
+LIBHEIF_API
+heif_error heif_context_start_fragmented_writing_to_file(heif_context*,
+                                                         const char* filename,
+                                                         uint32_t max_fragment_duration_ms);
+
+/**
+ * Write the remaining samples and finish the fragmented file.
+ * Visual tracks with encoders that buffer frames have to be ended with heif_track_encode_end_of_sequence() first.
+ */
+LIBHEIF_API
+heif_error heif_context_end_fragmented_writing(heif_context*);
+
+
 // --- sample auxiliary data
 
 /**
@@ -22,6 +22,8 @@
 #include "api_structs.h"
 #include "image-items/grid.h"
 #include "image-items/tiled.h"
+#include "trace.h"
+#include "file.h"
 
 #if WITH_UNCOMPRESSED_CODEC
 #include "image-items/unc_image.h"
@@ -31,6 +33,7 @@
 #include <utility>
 #include <vector>
 #include <array>
+#include <algorithm>
 
 
 heif_error heif_image_handle_get_image_tiling(const heif_image_handle* handle, int process_image_transformations, struct heif_image_tiling* tiling)
@@ -102,6 +105,10 @@ heif_error heif_image_handle_decode_image_tile(const heif_image_handle* in_handl
 
   heif_item_id id = in_handle->image->get_id();
 
+  OperationTraceScope trace(in_handle->context->get_trace_callback(),
+                            in_handle->context->get_trace_callback_userdata(),
+                            heif_trace_operation_decode, id);
+
   heif_decoding_options* dec_options = heif_decoding_options_alloc();
   heif_decoding_options_copy(dec_options, input_options);
 
@@ -125,6 +132,168 @@ heif_error heif_image_handle_decode_image_tile(const heif_image_handle* in_handl
 }
 
 
+// Tiles whose data is separated by less than this are fetched in one request.
+static const uint64_t max_prefetch_range_gap = 16 * 1024;
+
+
+heif_error heif_image_handle_prefetch_tiles(const heif_image_handle* handle,
+                                            int process_image_transformations,
+                                            uint32_t viewport_x, uint32_t viewport_y,
+                                            uint32_t viewport_width, uint32_t viewport_height,
+                                            int pan_dx, int pan_dy,
+                                            uint32_t lookahead_tiles)
+{
+  if (!handle) {
+    return heif_error_null_pointer_argument;
+  }
+
+  heif_image_tiling tiling;
+  heif_error err = heif_image_handle_get_image_tiling(handle, process_image_transformations, &tiling);
+  if (err.code) {
+    return err;
+  }
+
+  if (viewport_width == 0 || viewport_height == 0 ||
+      tiling.tile_width == 0 || tiling.tile_height == 0) {
+    return heif_error_ok;
+  }
+
+  // --- tile range covered by the viewport
+
+  uint64_t x0 = uint64_t{viewport_x} + tiling.left_offset;
+  uint64_t y0 = uint64_t{viewport_y} + tiling.top_offset;
+
+  uint64_t first_column = x0 / tiling.tile_width;
+  uint64_t first_row = y0 / tiling.tile_height;
+  if (first_column >= tiling.num_columns || first_row >= tiling.num_rows) {
+    return heif_error_ok;
+  }
+
+  uint64_t last_column = std::min<uint64_t>((x0 + viewport_width - 1) / tiling.tile_width, tiling.num_columns - 1);
+  uint64_t last_row = std::min<uint64_t>((y0 + viewport_height - 1) / tiling.tile_height, tiling.num_rows - 1);
+
+  // --- extend into the panning direction
+
+  uint64_t ahead_first_column = first_column, ahead_last_column = last_column;
+  uint64_t ahead_first_row = first_row, ahead_last_row = last_row;
+
+  if (pan_dx > 0) {
+    ahead_last_column = std::min<uint64_t>(last_column + lookahead_tiles, tiling.num_columns - 1);
+  }
+  else if (pan_dx < 0) {
+    ahead_first_column = first_column - std::min<uint64_t>(first_column, lookahead_tiles);
+  }
+
+  if (pan_dy > 0) {
+    ahead_last_row = std::min<uint64_t>(last_row + lookahead_tiles, tiling.num_rows - 1);
+  }
+  else if (pan_dy < 0) {
+    ahead_first_row = first_row - std::min<uint64_t>(first_row, lookahead_tiles);
+  }
+
+  // --- collect file ranges of the tiles and their alpha tiles
+
+  std::vector<FileRange> viewport_ranges;
+  std::vector<FileRange> ahead_ranges;
+
+  // Alpha tiles are only prefetched when they use the same tile layout as the color image.
+  std::shared_ptr<ImageItem> alpha_image = handle->image->get_alpha_channel();
+  if (alpha_image) {
+    heif_image_tiling color_tiling = handle->image->get_heif_image_tiling();
+    heif_image_tiling alpha_tiling = alpha_image->get_heif_image_tiling();
+    if (alpha_tiling.num_columns != color_tiling.num_columns ||
+        alpha_tiling.num_rows != color_tiling.num_rows) {
+      alpha_image.reset();
+    }
+  }
+
+  for (uint64_t row = ahead_first_row; row <= ahead_last_row; row++) {
+    for (uint64_t column = ahead_first_column; column <= ahead_last_column; column++) {
+      bool in_viewport = (row >= first_row && row <= last_row &&
+                          column >= first_column && column <= last_column);
+
+      auto tile_x = static_cast<uint32_t>(column);
+      auto tile_y = static_cast<uint32_t>(row);
+
+      if (process_image_transformations) {
+        Error error = handle->image->transform_requested_tile_position_to_original_tile_position(tile_x, tile_y);
+        if (error) {
+          return error.error_struct(handle->image.get());
+        }
+      }
+
+      std::vector<FileRange>& ranges = (in_viewport ? viewport_ranges : ahead_ranges);
+
+      Error error = handle->image->append_tile_file_ranges(tile_x, tile_y, ranges);
+      if (error) {
+        return error.error_struct(handle->image.get());
+      }
+
+      if (alpha_image) {
+        error = alpha_image->append_tile_file_ranges(tile_x, tile_y, ranges);
+        if (error) {
+          return error.error_struct(handle->image.get());
+        }
+      }
+    }
+  }
+
+  // --- issue the hints, tiles in the viewport first
+
+  merge_file_ranges(viewport_ranges, max_prefetch_range_gap);
+  merge_file_ranges(ahead_ranges, max_prefetch_range_gap);
+
+  auto reader = handle->context->get_heif_file()->get_reader();
+
+  for (const auto& range : viewport_ranges) {
+    reader->preload_range_hint(range.start, range.end);
+  }
+
+  for (const auto& range : ahead_ranges) {
+    reader->preload_range_hint(range.start, range.end);
+  }
+
+  return heif_error_ok;
+}
+
+
+void heif_context_set_tile_cache_size(heif_context* ctx, size_t max_bytes)
+{
+  if (!ctx) {
+    return;
+  }
+
+  ctx->context->set_tile_cache_size(max_bytes);
+}
+
+
+void heif_context_clear_tile_cache(heif_context* ctx)
+{
+  if (!ctx) {
+    return;
+  }
+
+  ctx->context->get_tile_cache().clear();
+}
+
+
+heif_error heif_context_get_tile_cache_statistics(const heif_context* ctx, heif_tile_cache_statistics* out_stats)
+{
+  if (!ctx || !out_stats) {
+    return heif_error_null_pointer_argument;
+  }
+
+  if (out_stats->version < 1) {
+    return {heif_error_Usage_error, heif_suberror_Unsupported_parameter, "Unsupported heif_tile_cache_statistics version"};
+  }
+
+  // only version 1 exists so far
+  ctx->context->get_tile_cache().get_statistics(out_stats);
+
+  return heif_error_success;
+}
+
+
 // --- encoding ---
 
 heif_error heif_context_encode_grid(heif_context* ctx,
@@ -276,3 +445,90 @@ heif_error heif_context_add_image_tile(heif_context* ctx,
     };
   }
 }
+
+
+heif_error heif_context_add_image_tiles(heif_context* ctx,
+                                        heif_image_handle* tiled_image,
+                                        uint32_t num_tiles,
+                                        const uint32_t* tile_x, const uint32_t* tile_y,
+                                        const heif_image* const* images,
+                                        heif_encoder* encoder)
+{
+  if (!ctx || !tiled_image || (num_tiles > 0 && (!tile_x || !tile_y || !images))) {
+    return heif_error_null_pointer_argument;
+  }
+
+  for (uint32_t i = 0; i < num_tiles; i++) {
+    if (!images[i]) {
+      return heif_error_null_pointer_argument;
+    }
+  }
+
+#if WITH_UNCOMPRESSED_CODEC
+  if (auto unci = std::dynamic_pointer_cast<ImageItem_uncompressed>(tiled_image->image)) {
+    std::vector<ImageItem_uncompressed::TileInput> tiles;
+    tiles.reserve(num_tiles);
+    for (uint32_t i = 0; i < num_tiles; i++) {
+      tiles.push_back({tile_x[i], tile_y[i], images[i]->image});
+    }
+
+    Error err = unci->add_image_tiles(tiles, ctx->context->get_max_encoding_threads());
+    return err.error_struct(ctx->context.get());
+  }
+#endif
+
+  for (uint32_t i = 0; i < num_tiles; i++) {
+    heif_error err = heif_context_add_image_tile(ctx, tiled_image, tile_x[i], tile_y[i], images[i], encoder);
+    if (err.code != heif_error_Ok) {
+      return err;
+    }
+  }
+
+  return heif_error_success;
+}
+
+
+heif_error heif_context_start_streaming_writing(heif_context* ctx,
+                                                heif_writer* writer,
+                                                void* userdata)
+{
+  if (!ctx || !writer) {
+    return heif_error_null_pointer_argument;
+  }
+
+  auto output = get_heif_writer_output(ctx, writer, userdata);
+  if (!output) {
+    return output.error().error_struct(ctx->context.get());
+  }
+
+  Error err = ctx->context->start_streaming_writing(*output);
+  return err.error_struct(ctx->context.get());
+}
+
+
+heif_error heif_context_start_streaming_writing_to_file(heif_context* ctx,
+                                                        const char* filename)
+{
+  if (!ctx || !filename) {
+    return heif_error_null_pointer_argument;
+  }
+
+  auto output = get_file_output(filename);
+  if (!output) {
+    return output.error().error_struct(ctx->context.get());
+  }
+
+  Error err = ctx->context->start_streaming_writing(*output);
+  return err.error_struct(ctx->context.get());
+}
+
+
+heif_error heif_context_end_streaming_writing(heif_context* ctx)
+{
+  if (!ctx) {
+    return heif_error_null_pointer_argument;
+  }
+
+  Error err = ctx->context->end_streaming_writing();
+  return err.error_struct(ctx->context.get());
+}
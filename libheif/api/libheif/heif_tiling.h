@@ -28,6 +28,7 @@ extern "C" {
 #include <libheif/heif_library.h>
 #include <libheif/heif_error.h>
 #include <libheif/heif_image.h>
+#include <libheif/heif_context.h>
 
 // forward declaration from other headers
 typedef struct heif_encoder heif_encoder;
@@ -91,6 +92,66 @@ heif_error heif_image_handle_decode_image_tile(const heif_image_handle* in_handl
                                                uint32_t tile_x, uint32_t tile_y);
 
 
+// --- prefetching
+
+// Hints the heif_reader to preload the data of the tiles covering a viewport and of the tiles that
+// will likely be needed next when the viewport keeps moving in the direction (pan_dx;pan_dy).
+// Only the signs of 'pan_dx' and 'pan_dy' are used. 'lookahead_tiles' is the number of additional
+// tile columns/rows to prefetch in the panning direction.
+// The viewport is given in pixels. If 'process_image_transformations' is true, it is given in the
+// transformed image as for heif_image_handle_decode_image_tile().
+//
+// The byte ranges of all tiles are merged and passed to preload_range_hint() in one batch, the tiles
+// in the viewport first. Readers that do not implement preload_range_hint() (heif_reader version < 2)
+// ignore the hints.
+// This is supported for 'grid' and 'tili' images. For other images, no hints are issued.
+// For 'tili' images, the required parts of the tile offset table are read synchronously.
+LIBHEIF_API
+heif_error heif_image_handle_prefetch_tiles(const heif_image_handle* handle,
+                                            int process_image_transformations,
+                                            uint32_t viewport_x, uint32_t viewport_y,
+                                            uint32_t viewport_width, uint32_t viewport_height,
+                                            int pan_dx, int pan_dy,
+                                            uint32_t lookahead_tiles);
+
+
+// --- cache of decoded tiles
+
+// Enables an LRU cache of the tiles decoded with heif_image_handle_decode_image_tile().
+// Repeated requests of the same tile with the same colorspace, chroma and decoding options are served
+// from the cache without decoding the tile again. Each call still returns a separate copy that the
+// application may modify.
+// The cached tiles count towards the 'max_total_memory' security limit of the context. The cache size
+// is limited to half of this limit. When decoding fails because of the memory limit, the cache is
+// emptied and the tile decoded again.
+// A size of 0 (the default) disables the cache and releases all cached tiles.
+LIBHEIF_API
+void heif_context_set_tile_cache_size(heif_context*, size_t max_bytes);
+
+// Releases all cached tiles. The cache stays enabled.
+LIBHEIF_API
+void heif_context_clear_tile_cache(heif_context*);
+
+typedef struct heif_tile_cache_statistics
+{
+  uint8_t version;
+
+  // --- version 1
+
+  uint64_t hits;
+  uint64_t misses;
+  uint64_t evictions;
+
+  uint64_t cached_bytes;
+  uint32_t cached_tiles;
+} heif_tile_cache_statistics;
+
+// Set 'version' in the passed struct to the version you are using (currently 1). Only the fields
+// of that version are filled in.
+LIBHEIF_API
+heif_error heif_context_get_tile_cache_statistics(const heif_context*, heif_tile_cache_statistics* out_stats);
+
+
 // --- encoding ---
 
 /**
@@ -130,6 +191,60 @@ heif_error heif_context_add_image_tile(heif_context* ctx,
                                        const heif_image* image,
                                        heif_encoder* encoder);
 
+/**
+ * Add several tiles to a tiled image with one call.
+ *
+ * For 'unci' images, the tiles are encoded and compressed concurrently with up to the
+ * number of threads set with heif_context_set_max_encoding_threads(). The tile data is
+ * stored in the order of the passed arrays.
+ * For other tiled images, this is equivalent to calling heif_context_add_image_tile() for each tile.
+ *
+ * @param tile_x Array of 'num_tiles' tile column indices.
+ * @param tile_y Array of 'num_tiles' tile row indices.
+ * @param images Array of 'num_tiles' tile images.
+ * @param encoder The encoder to use. May be NULL for 'unci' images.
+ */
+LIBHEIF_API
+heif_error heif_context_add_image_tiles(heif_context* ctx,
+                                        heif_image_handle* tiled_image,
+                                        uint32_t num_tiles,
+                                        const uint32_t* tile_x, const uint32_t* tile_y,
+                                        const heif_image* const* images,
+                                        heif_encoder* encoder);
+
+/**
+ * Start writing the file while the tiles are added.
+ *
+ * The 'ftyp' box is written immediately. After that, the tile data added to 'unci' and 'tili' images
+ * is passed to the writer in 'mdat' boxes as soon as it is encoded, instead of keeping it in memory until
+ * heif_context_write() is called. This allows writing images that are larger than the available memory.
+ * Finish the file with heif_context_end_streaming_writing(), which writes the 'meta' box at the end of the file.
+ *
+ * Create all images before starting to stream. The brands in the 'ftyp' box are determined from
+ * the images that exist at that time.
+ * Streaming cannot be used for files with sequence tracks. heif_context_write() cannot be used on a
+ * context in streaming mode.
+ *
+ * @param writer The writer is called several times with consecutive pieces of the file.
+ */
+LIBHEIF_API
+heif_error heif_context_start_streaming_writing(heif_context* ctx,
+                                                heif_writer* writer,
+                                                void* userdata);
+
+/**
+ * Same as heif_context_start_streaming_writing(), but writes into a file.
+ */
+LIBHEIF_API
+heif_error heif_context_start_streaming_writing_to_file(heif_context* ctx,
+                                                        const char* filename);
+
+/**
+ * Write the remaining data and the 'meta' box and finish the streamed file.
+ */
+LIBHEIF_API
+heif_error heif_context_end_streaming_writing(heif_context* ctx);
+
 #ifdef __cplusplus
 }
 #endif
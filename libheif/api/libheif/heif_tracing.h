@@ -0,0 +1,94 @@
+/*
+ * HEIF codec.
+ * Copyright (c) 2025 Dirk Farin <dirk.farin@gmail.com>
+ *
+ * This file is part of libheif.
+ *
+ * libheif is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * libheif is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libheif.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBHEIF_HEIF_TRACING_H
+#define LIBHEIF_HEIF_TRACING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <libheif/heif_library.h>
+#include <libheif/heif_error.h>
+
+
+// --- per-operation tracing
+
+enum heif_trace_operation
+{
+  heif_trace_operation_decode = 0,
+  heif_trace_operation_encode = 1
+};
+
+typedef struct heif_trace_record
+{
+  uint8_t version;
+
+  // --- version 1
+
+  enum heif_trace_operation operation;
+  heif_item_id item_id;
+
+  // Wall-clock time of the whole API call.
+  uint64_t total_ns;
+
+  // Time spent in each stage. When work is distributed over several threads (grid tiles,
+  // overlay layers), the times of all threads are summed up. Thus, the sum of the stages
+  // can exceed 'total_ns'. Nested stages are not counted twice: the time spent in the codec
+  // while decoding the alpha image is counted as 'codec_ns', not as 'alpha_ns'.
+  uint64_t io_ns;                // reading from the input (heif_reader, file or memory)
+  uint64_t codec_ns;             // decoder/encoder plugin
+  uint64_t color_conversion_ns;
+  uint64_t transform_ns;         // rotation, mirroring, cropping
+  uint64_t alpha_ns;             // attaching the alpha channel
+  uint64_t other_ns;             // everything else, e.g. tile assembly and bookkeeping
+
+  uint64_t bytes_read;
+  uint64_t num_allocations;      // image planes allocated
+  uint64_t bytes_allocated;
+
+  // The color conversion pipelines that were used, one line per conversion step,
+  // with separate pipelines separated by an empty line. Empty if no conversion was done.
+  // The string is only valid during the callback.
+  const char* color_conversion_pipeline;
+} heif_trace_record;
+
+
+// The callback is called at the end of each heif_decode_image(), heif_image_handle_decode_image_tile()
+// and heif_context_encode_image() call on this context. It is also called when the operation fails.
+// It is called from the thread that called the API function. For heif_decode_images_batch(), it is
+// called once per item from the batch worker threads, possibly concurrently.
+typedef void (*heif_trace_callback)(const heif_trace_record* record, void* userdata);
+
+// Set 'callback' to NULL to switch tracing off. Tracing is off by default.
+// When tracing is off, the instrumentation has no measurable overhead.
+// Tracing should not be enabled while another thread is decoding with this context.
+LIBHEIF_API
+void heif_context_set_trace_callback(heif_context*, heif_trace_callback callback, void* userdata);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -45,7 +45,11 @@ enum heif_unci_compression
   //heif_unci_compression_unknown = 2, // only used when reading unknown method from input file
   heif_unci_compression_deflate = 3,
   heif_unci_compression_zlib = 4,
-  heif_unci_compression_brotli = 5
+  heif_unci_compression_brotli = 5,
+
+  // Zstandard is not (yet) one of the generic compression methods of ISO/IEC 23001-17.
+  // Only available when libheif is compiled with zstd.
+  heif_unci_compression_zstd = 6
 };
 
 
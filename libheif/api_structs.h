@@ -24,6 +24,7 @@
 #include "pixelimage.h"
 #include "context.h"
 
+#include <functional>
 #include <memory>
 #include <vector>
 #include <string>
@@ -111,4 +112,16 @@ struct heif_text_item
 };
 
 
+// Output functions for files that are written incrementally (fragmented or streamed).
+// Both are defined in heif_context.cc.
+
+using heif_context_output = std::function<Error(const std::vector<uint8_t>&)>;
+
+// Passes the data to the heif_writer callback. Fails if the writer API version is not supported.
+Result<heif_context_output> get_heif_writer_output(heif_context* ctx, const heif_writer* writer, void* userdata);
+
+// Writes the data into the file. Each block is flushed, so that the data written so far is in the file.
+Result<heif_context_output> get_file_output(const char* filename);
+
+
 #endif
@@ -19,6 +19,7 @@
  */
 
 #include "bitstream.h"
+#include "trace.h"
 
 #include <utility>
 #include <cstring>
@@ -33,6 +34,30 @@
 #define MAX_UVLC_LEADING_ZEROS 20
 
 
+void merge_file_ranges(std::vector<FileRange>& ranges, uint64_t max_gap)
+{
+  if (ranges.empty()) {
+    return;
+  }
+
+  std::sort(ranges.begin(), ranges.end(),
+            [](const FileRange& a, const FileRange& b) { return a.start < b.start; });
+
+  size_t out = 0;
+  for (size_t i = 1; i < ranges.size(); i++) {
+    if (ranges[i].start <= ranges[out].end ||
+        ranges[i].start - ranges[out].end <= max_gap) {
+      ranges[out].end = std::max(ranges[out].end, ranges[i].end);
+    }
+    else {
+      ranges[++out] = ranges[i];
+    }
+  }
+
+  ranges.resize(out + 1);
+}
+
+
 StreamReader_istream::StreamReader_istream(std::unique_ptr<std::istream>&& istr)
     : m_istr(std::move(istr))
 {
@@ -58,6 +83,9 @@ bool StreamReader_istream::read(void* data, size_t size)
     return false;
   }
 
+  TraceScope trace_scope(TraceStage::io);
+  trace_bytes_read(size);
+
   m_istr->read((char*) data, size);
   return true;
 }
@@ -72,9 +100,10 @@ bool StreamReader_istream::seek(uint64_t position)
 }
 
 
-StreamReader_memory::StreamReader_memory(const uint8_t* data, size_t size, bool copy)
+StreamReader_memory::StreamReader_memory(const uint8_t* data, size_t size, bool copy, uint64_t base_offset)
     : m_length(size),
-      m_position(0)
+      m_position(0),
+      m_base_offset(base_offset)
 {
   if (copy) {
     m_owned_data = new uint8_t[m_length];
@@ -96,12 +125,12 @@ StreamReader_memory::~StreamReader_memory()
 
 uint64_t StreamReader_memory::get_position() const
 {
-  return m_position;
+  return m_base_offset + m_position;
 }
 
 StreamReader::grow_status StreamReader_memory::wait_for_file_size(uint64_t target_size)
 {
-  return (target_size > m_length) ? grow_status::size_beyond_eof : grow_status::size_reached;
+  return (target_size > m_base_offset + m_length) ? grow_status::size_beyond_eof : grow_status::size_reached;
 }
 
 bool StreamReader_memory::read(void* data, size_t size)
@@ -111,6 +140,8 @@ bool StreamReader_memory::read(void* data, size_t size)
     return false;
   }
 
+  trace_bytes_read(size);
+
   memcpy(data, &m_data[m_position], size);
   m_position += size;
 
@@ -119,10 +150,10 @@ bool StreamReader_memory::read(void* data, size_t size)
 
 bool StreamReader_memory::seek(uint64_t position)
 {
-  if (position > m_length)
+  if (position < m_base_offset || position - m_base_offset > m_length)
     return false;
 
-  m_position = position;
+  m_position = position - m_base_offset;
   return true;
 }
 
@@ -132,6 +163,14 @@ StreamReader_CApi::StreamReader_CApi(const heif_reader* func_table, void* userda
 {
 }
 
+bool StreamReader_CApi::read(void* data, size_t size)
+{
+  TraceScope trace_scope(TraceStage::io);
+  trace_bytes_read(size);
+
+  return !m_func_table->read(data, size, m_userdata);
+}
+
 StreamReader::grow_status StreamReader_CApi::wait_for_file_size(uint64_t target_size)
 {
   heif_reader_grow_status status = m_func_table->wait_for_file_size(target_size, m_userdata);
@@ -157,14 +196,23 @@ BitstreamRange::BitstreamRange(std::shared_ptr<StreamReader> istr,
   if (parent) {
     m_nesting_level = parent->m_nesting_level + 1;
   }
+
+  if (parent && parent->m_istr == m_istr) {
+    m_memory_reader = parent->m_memory_reader;
+  }
+  else {
+    m_memory_reader = dynamic_cast<StreamReader_memory*>(m_istr.get());
+  }
 }
 
 
 BitstreamRange::BitstreamRange(std::shared_ptr<StreamReader> istr,
                                size_t start,
                                size_t end) // one past end
-  : m_istr(std::move(istr)), m_remaining(end)
+  : m_istr(std::move(istr)), m_remaining(end >= start ? end - start : 0)
 {
+  m_memory_reader = dynamic_cast<StreamReader_memory*>(m_istr.get());
+
   bool success = m_istr->seek(start);
   assert(success);
   (void)success; // TODO
@@ -177,43 +225,51 @@ StreamReader::grow_status BitstreamRange::wait_until_range_is_available()
 }
 
 
-uint8_t BitstreamRange::read8()
+const uint8_t* BitstreamRange::read_span(size_t n, uint8_t* buffer)
 {
-  if (!prepare_read(1)) {
-    return 0;
+  if (!prepare_read(n)) {
+    return nullptr;
   }
 
-  uint8_t buf;
+  if (m_memory_reader) {
+    const uint8_t* data = m_memory_reader->read_direct(n);
+    if (!data) {
+      set_eof_while_reading();
+    }
 
-  auto istr = get_istream();
-  bool success = istr->read((char*) &buf, 1);
+    return data;
+  }
 
-  if (!success) {
+  if (!m_istr->read(buffer, n)) {
     set_eof_while_reading();
-    return 0;
+    return nullptr;
   }
 
-  return buf;
+  return buffer;
 }
 
 
-uint16_t BitstreamRange::read16()
+uint8_t BitstreamRange::read8()
 {
-  if (!prepare_read(2)) {
+  uint8_t buf;
+  const uint8_t* data = read_span(1, &buf);
+  if (!data) {
     return 0;
   }
 
-  uint8_t buf[2];
+  return data[0];
+}
 
-  auto istr = get_istream();
-  bool success = istr->read((char*) buf, 2);
 
-  if (!success) {
-    set_eof_while_reading();
+uint16_t BitstreamRange::read16()
+{
+  uint8_t buf[2];
+  const uint8_t* data = read_span(2, buf);
+  if (!data) {
     return 0;
   }
 
-  return static_cast<uint16_t>((buf[0] << 8) | (buf[1]));
+  return static_cast<uint16_t>((data[0] << 8) | (data[1]));
 }
 
 
@@ -233,45 +289,29 @@ int16_t BitstreamRange::read16s()
 
 uint32_t BitstreamRange::read24()
 {
-  if (!prepare_read(3)) {
-    return 0;
-  }
-
   uint8_t buf[3];
-
-  auto istr = get_istream();
-  bool success = istr->read((char*) buf, 3);
-
-  if (!success) {
-    set_eof_while_reading();
+  const uint8_t* data = read_span(3, buf);
+  if (!data) {
     return 0;
   }
 
-  return (uint32_t) ((buf[0] << 16) |
-                     (buf[1] << 8) |
-                     (buf[2]));
+  return (uint32_t) ((data[0] << 16) |
+                     (data[1] << 8) |
+                     (data[2]));
 }
 
 uint32_t BitstreamRange::read32()
 {
-  if (!prepare_read(4)) {
-    return 0;
-  }
-
   uint8_t buf[4];
-
-  auto istr = get_istream();
-  bool success = istr->read((char*) buf, 4);
-
-  if (!success) {
-    set_eof_while_reading();
+  const uint8_t* data = read_span(4, buf);
+  if (!data) {
     return 0;
   }
 
-  return (uint32_t) ((buf[0] << 24) |
-                     (buf[1] << 16) |
-                     (buf[2] << 8) |
-                     (buf[3]));
+  return (uint32_t) ((data[0] << 24) |
+                     (data[1] << 16) |
+                     (data[2] << 8) |
+                     (data[3]));
 }
 
 
@@ -311,28 +351,20 @@ int32_t BitstreamRange::read32s()
 
 uint64_t BitstreamRange::read64()
 {
-  if (!prepare_read(8)) {
-    return 0;
-  }
-
   uint8_t buf[8];
-
-  auto istr = get_istream();
-  bool success = istr->read((char*) buf, 8);
-
-  if (!success) {
-    set_eof_while_reading();
+  const uint8_t* data = read_span(8, buf);
+  if (!data) {
     return 0;
   }
 
-  return ((static_cast<uint64_t>(buf[0]) << 56) |
-          (static_cast<uint64_t>(buf[1]) << 48) |
-          (static_cast<uint64_t>(buf[2]) << 40) |
-          (static_cast<uint64_t>(buf[3]) << 32) |
-          (static_cast<uint64_t>(buf[4]) << 24) |
-          (static_cast<uint64_t>(buf[5]) << 16) |
-          (static_cast<uint64_t>(buf[6]) << 8) |
-          (static_cast<uint64_t>(buf[7])));
+  return ((static_cast<uint64_t>(data[0]) << 56) |
+          (static_cast<uint64_t>(data[1]) << 48) |
+          (static_cast<uint64_t>(data[2]) << 40) |
+          (static_cast<uint64_t>(data[3]) << 32) |
+          (static_cast<uint64_t>(data[4]) << 24) |
+          (static_cast<uint64_t>(data[5]) << 16) |
+          (static_cast<uint64_t>(data[6]) << 8) |
+          (static_cast<uint64_t>(data[7])));
 }
 
 
@@ -395,20 +427,14 @@ std::string BitstreamRange::read_string()
     return std::string();
   }
 
-  auto istr = get_istream();
-
   for (;;) {
-    if (!prepare_read(1)) {
+    uint8_t buf;
+    const uint8_t* data = read_span(1, &buf);
+    if (!data) {
       return std::string();
     }
 
-    char c;
-    bool success = istr->read(&c, 1);
-
-    if (!success) {
-      set_eof_while_reading();
-      return std::string();
-    }
+    char c = (char) data[0];
 
     if (c == 0) {
       break;
@@ -424,52 +450,37 @@ std::string BitstreamRange::read_string()
 
 std::string BitstreamRange::read_fixed_string(int len)
 {
-  std::string str;
-
-  if (!prepare_read(len)) {
-    return std::string();
+  if (len <= 0) {
+    return {};
   }
 
-  auto istr = get_istream();
-
-  uint8_t n;
-  bool success = istr->read(&n, 1);
-  if (!success || n > len - 1) {
+  std::vector<uint8_t> buffer(len);
+  const uint8_t* data = read_span(len, buffer.data());
+  if (!data) {
     return {};
   }
 
-  for (int i = 0; i < n; i++) {
-    char c;
-    success = istr->read(&c, 1);
-
-    if (!success) {
-      set_eof_while_reading();
-      return std::string();
-    }
-
-    str += (char) c;
+  uint8_t n = data[0];
+  if (n > len - 1) {
+    return {};
   }
 
-  istr->seek_cur(len-n-1);
-
-  return str;
+  return std::string((const char*) data + 1, n);
 }
 
 
 bool BitstreamRange::read(uint8_t* data, size_t n)
 {
-  if (!prepare_read(n)) {
+  const uint8_t* src = read_span(n, data);
+  if (!src) {
     return false;
   }
 
-  auto istr = get_istream();
-  bool success = istr->read(data, n);
-
-  if (!success) {
-    set_eof_while_reading();
+  if (src != data) {
+    memcpy(data, src, n);
   }
 
-  return success;
+  return true;
 }
 
 
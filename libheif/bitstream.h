@@ -36,6 +36,17 @@
 #include <algorithm>
 
 
+// Byte range [start, end) in the input file.
+struct FileRange
+{
+  uint64_t start = 0;
+  uint64_t end = 0;
+};
+
+// Sorts the ranges and merges ranges that overlap or are separated by at most 'max_gap' bytes.
+void merge_file_ranges(std::vector<FileRange>& ranges, uint64_t max_gap);
+
+
 class StreamReader
 {
 public:
@@ -123,7 +134,9 @@ private:
 class StreamReader_memory : public StreamReader
 {
 public:
-  StreamReader_memory(const uint8_t* data, size_t size, bool copy);
+  // 'base_offset' is the file position of the first byte of 'data'. This is used when only a part
+  // of a file (e.g. a single box) is held in memory. Positions are still reported as file positions.
+  StreamReader_memory(const uint8_t* data, size_t size, bool copy, uint64_t base_offset = 0);
 
   ~StreamReader_memory() override;
 
@@ -137,13 +150,27 @@ public:
 
   // end_pos is last byte to read + 1. I.e. like a file size.
   uint64_t request_range(uint64_t start, uint64_t end_pos) override {
-    return m_length;
+    return m_base_offset + m_length;
+  }
+
+  // Non-virtual alternative to read() without copying the data.
+  // Returns a pointer to the next 'size' bytes and advances the position, or NULL if there is not enough data.
+  const uint8_t* read_direct(size_t size)
+  {
+    if (size > m_length - m_position) {
+      return nullptr;
+    }
+
+    const uint8_t* p = m_data + m_position;
+    m_position += size;
+    return p;
   }
 
 private:
   const uint8_t* m_data;
   uint64_t m_length;
   uint64_t m_position;
+  uint64_t m_base_offset;
 
   // if we made a copy of the data, we store a pointer to the owned memory area here
   uint8_t* m_owned_data = nullptr;
@@ -159,7 +186,7 @@ public:
 
   StreamReader::grow_status wait_for_file_size(uint64_t target_size) override;
 
-  bool read(void* data, size_t size) override { return !m_func_table->read(data, size, m_userdata); }
+  bool read(void* data, size_t size) override;
 
   bool seek(uint64_t position) override { return !m_func_table->seek(position, m_userdata); }
 
@@ -398,8 +425,16 @@ private:
   size_t m_remaining;
   bool m_error = false;
 
+  // Set when reading from memory. Reads then access the memory directly instead of
+  // going through the virtual StreamReader::read().
+  StreamReader_memory* m_memory_reader = nullptr;
+
   // Note: 'nBytes' may not be larger than the number of remaining bytes
   void skip_without_advancing_file_pos(size_t nBytes);
+
+  // Returns a pointer to the next 'n' bytes, or NULL if they are not available.
+  // 'buffer' is used when the data has to be copied from the stream. It must hold at least 'n' bytes.
+  const uint8_t* read_span(size_t n, uint8_t* buffer);
 };
 
 
@@ -41,6 +41,7 @@
 #include <set>
 #include <cassert>
 #include <array>
+#include <iterator>
 #include <mutex>
 
 
@@ -805,6 +806,7 @@ Error Box::read(BitstreamRange& range, std::shared_ptr<Box>* result, const heif_
       break;
 
     case fourcc("stco"):
+    case fourcc("co64"):
       box = std::make_shared<Box_stco>();
       break;
 
@@ -868,6 +870,38 @@ Error Box::read(BitstreamRange& range, std::shared_ptr<Box>* result, const heif_
       box = std::make_shared<Box_tref>();
       break;
 
+    case fourcc("mvex"):
+      box = std::make_shared<Box_mvex>();
+      break;
+
+    case fourcc("trex"):
+      box = std::make_shared<Box_trex>();
+      break;
+
+    case fourcc("moof"):
+      box = std::make_shared<Box_moof>();
+      break;
+
+    case fourcc("mfhd"):
+      box = std::make_shared<Box_mfhd>();
+      break;
+
+    case fourcc("traf"):
+      box = std::make_shared<Box_traf>();
+      break;
+
+    case fourcc("tfhd"):
+      box = std::make_shared<Box_tfhd>();
+      break;
+
+    case fourcc("tfdt"):
+      box = std::make_shared<Box_tfdt>();
+      break;
+
+    case fourcc("trun"):
+      box = std::make_shared<Box_trun>();
+      break;
+
     default:
       box = std::make_shared<Box_other>(hdr.get_short_type());
       break;
@@ -1709,6 +1743,53 @@ std::string Box_iloc::dump(Indent& indent) const
 }
 
 
+#if ENABLE_MULTITHREADING_SUPPORT
+// Serializes all accesses to the input stream for item data.
+static std::mutex& get_iloc_read_mutex()
+{
+  static std::mutex read_mutex;
+  return read_mutex;
+}
+#endif
+
+
+Error Box_iloc::read_file_range(const std::shared_ptr<StreamReader>& istr,
+                                const FileRange& range,
+                                std::vector<uint8_t>& out_data)
+{
+#if ENABLE_MULTITHREADING_SUPPORT
+  std::lock_guard<std::mutex> lock(get_iloc_read_mutex());
+#endif
+
+  uint64_t size = range.end - range.start;
+
+  if (istr->wait_for_file_size(range.end) != StreamReader::grow_status::size_reached) {
+    return {heif_error_Invalid_input,
+            heif_suberror_End_of_data};
+  }
+
+  uint64_t rangeRequestEndPos = istr->request_range(range.start, range.end);
+  if (rangeRequestEndPos == 0) {
+    return istr->get_error();
+  }
+
+  if (!istr->seek(range.start)) {
+    return {heif_error_Invalid_input,
+            heif_suberror_Unspecified,
+            "Error setting input file position"};
+  }
+
+  out_data.resize(static_cast<size_t>(size));
+  if (!istr->read(out_data.data(), static_cast<size_t>(size))) {
+    return {heif_error_Invalid_input,
+            heif_suberror_Unspecified,
+            "Error reading input file"};
+  }
+
+  return Error::Ok;
+}
+
+
 Error Box_iloc::read_data(heif_item_id item,
                           const std::shared_ptr<StreamReader>& istr,
                           const std::shared_ptr<Box_idat>& idat,
@@ -1744,9 +1825,7 @@ Error Box_iloc::read_data(heif_item_id item_id,
   }
 
 #if ENABLE_MULTITHREADING_SUPPORT
-  static std::mutex read_mutex;
-
-  std::lock_guard<std::mutex> lock(read_mutex);
+  std::lock_guard<std::mutex> lock(get_iloc_read_mutex());
 #endif
 
   bool limited_size = (size != std::numeric_limits<uint64_t>::max());
@@ -1888,9 +1967,62 @@ Error Box_iloc::read_data(heif_item_id item_id,
 }
 
 
-Error Box_iloc::append_data(heif_item_id item_ID,
-                            const std::vector<uint8_t>& data,
-                            uint8_t construction_method)
+Error Box_iloc::get_file_ranges(heif_item_id item_id, uint64_t offset, uint64_t size,
+                                std::vector<FileRange>& out_ranges) const
+{
+  const Item* item = nullptr;
+  for (auto& i : m_items) {
+    if (i.item_ID == item_id) {
+      item = &i;
+      break;
+    }
+  }
+
+  if (!item) {
+    std::stringstream sstr;
+    sstr << "Item with ID " << item_id << " has no compressed data";
+
+    return Error(heif_error_Invalid_input,
+                 heif_suberror_No_item_data,
+                 sstr.str());
+  }
+
+  if (item->construction_method != 0) {
+    return Error::Ok;
+  }
+
+  for (const auto& extent : item->extents) {
+    if (size == 0) {
+      break;
+    }
+
+    if (extent.offset > MAX_FILE_POS ||
+        item->base_offset > MAX_FILE_POS ||
+        extent.length > MAX_FILE_POS) {
+      return {heif_error_Invalid_input,
+              heif_suberror_Security_limit_exceeded,
+              "iloc data pointers out of allowed range"};
+    }
+
+    uint64_t skip_len = std::min(offset, extent.length);
+    offset -= skip_len;
+
+    uint64_t read_len = std::min(extent.length - skip_len, size);
+    if (offset > 0 || read_len == 0) {
+      continue;
+    }
+
+    uint64_t start = extent.offset + item->base_offset + skip_len;
+    out_ranges.push_back({start, start + read_len});
+
+    size -= read_len;
+  }
+
+  return Error::Ok;
+}
+
+
+Box_iloc::Item* Box_iloc::find_or_add_item(heif_item_id item_ID, uint8_t construction_method)
 {
   // check whether this item ID already exists
 
@@ -1915,6 +2047,16 @@ Error Box_iloc::append_data(heif_item_id item_ID,
     // TODO: return error: construction methods do not match
   }
 
+  return &m_items[idx];
+}
+
+
+Error Box_iloc::append_data(heif_item_id item_ID,
+                            const std::vector<uint8_t>& data,
+                            uint8_t construction_method)
+{
+  Item* item = find_or_add_item(item_ID, construction_method);
+
   Extent extent;
   extent.length = data.size();
 
@@ -1944,8 +2086,11 @@ Error Box_iloc::append_data(heif_item_id item_ID,
     }
   }
   else {
-    if (!m_items[idx].extents.empty()) {
-      Extent& e = m_items[idx].extents.back();
+    // Extend the last extent unless it has already been written or is a reserved range without data.
+    if (!item->extents.empty() &&
+        !item->extents.back().written &&
+        item->extents.back().data.size() == item->extents.back().length) {
+      Extent& e = item->extents.back();
       e.data.insert(e.data.end(), data.begin(), data.end());
       e.length = e.data.size();
       return Error::Ok;
@@ -1961,7 +2106,7 @@ Error Box_iloc::append_data(heif_item_id item_ID,
     m_idat_offset += (int) data.size();
   }
 
-  m_items[idx].extents.push_back(std::move(extent));
+  item->extents.push_back(std::move(extent));
 
   return Error::Ok;
 }
@@ -1987,11 +2132,22 @@ Error Box_iloc::replace_data(heif_item_id item_ID,
 
   uint64_t data_start = 0;
   for (auto& extent : m_items[idx].extents) {
-    if (output_offset >= extent.data.size()) {
-      output_offset -= extent.data.size();
+    if (output_offset >= extent.length) {
+      output_offset -= extent.length;
     }
     else {
-      uint64_t write_n = std::min(extent.data.size() - output_offset,
+      if (extent.written) {
+        return {heif_error_Usage_error,
+                heif_suberror_Unspecified,
+                "Cannot replace item data that has already been written"};
+      }
+
+      // allocate reserved data range
+      if (extent.data.size() < extent.length) {
+        extent.data.resize(extent.length);
+      }
+
+      uint64_t write_n = std::min(extent.length - output_offset,
                                   data.size() - data_start);
       assert(write_n > 0);
 
@@ -2010,6 +2166,133 @@ Error Box_iloc::replace_data(heif_item_id item_ID,
 }
 
 
+Error Box_iloc::reserve_data(heif_item_id item_ID, uint64_t length)
+{
+  if (m_use_tmpfile) {
+    return append_data(item_ID, std::vector<uint8_t>(length), 0);
+  }
+
+  Item* item = find_or_add_item(item_ID, 0);
+
+  if (!item->extents.empty() &&
+      !item->extents.back().written &&
+      item->extents.back().data.empty()) {
+    item->extents.back().length += length;
+    return Error::Ok;
+  }
+
+  Extent extent;
+  extent.length = length;
+  item->extents.push_back(std::move(extent));
+
+  return Error::Ok;
+}
+
+
+static Error check_number_of_extents(size_t n)
+{
+  if (n > 0xFFFF) {
+    return {heif_error_Usage_error,
+            heif_suberror_Unspecified,
+            "Item data is split into too many extents"};
+  }
+
+  return Error::Ok;
+}
+
+
+Error Box_iloc::append_written_data(heif_item_id item_ID, uint64_t length, uint64_t file_offset)
+{
+  Item* item = find_or_add_item(item_ID, 0);
+
+  if (Error err = check_number_of_extents(item->extents.size() + 1)) {
+    return err;
+  }
+
+  Extent extent;
+  extent.offset = file_offset;
+  extent.length = length;
+  extent.written = true;
+  item->extents.push_back(std::move(extent));
+
+  m_written_data_end = std::max(m_written_data_end, file_offset + length);
+
+  return Error::Ok;
+}
+
+
+Error Box_iloc::set_reserved_data_written(heif_item_id item_ID, uint64_t item_offset, uint64_t length, uint64_t file_offset)
+{
+  Item* item = find_or_add_item(item_ID, 0);
+  std::vector<Extent>& extents = item->extents;
+
+  uint64_t extent_start = 0;
+  for (size_t i = 0; i < extents.size(); i++) {
+    Extent& extent = extents[i];
+
+    if (item_offset >= extent_start + extent.length) {
+      extent_start += extent.length;
+      continue;
+    }
+
+    if (extent.written || item_offset + length > extent_start + extent.length) {
+      return {heif_error_Usage_error,
+              heif_suberror_Unspecified,
+              "Item data range has already been written"};
+    }
+
+    // split the reserved extent into [head] [written range] [tail]
+
+    uint64_t head_length = item_offset - extent_start;
+    uint64_t tail_length = extent.length - head_length - length;
+
+    std::vector<Extent> new_extents;
+
+    Extent written_extent;
+    written_extent.offset = file_offset;
+    written_extent.length = length;
+    written_extent.written = true;
+
+    Extent tail_extent;
+    tail_extent.length = tail_length;
+    if (!extent.data.empty()) {
+      tail_extent.data.assign(extent.data.begin() + (head_length + length), extent.data.end());
+    }
+
+    if (head_length > 0) {
+      extent.length = head_length;
+      if (!extent.data.empty()) {
+        extent.data.resize(head_length);
+      }
+      new_extents.push_back(std::move(extent));
+    }
+
+    new_extents.push_back(std::move(written_extent));
+
+    if (tail_length > 0) {
+      new_extents.push_back(std::move(tail_extent));
+    }
+
+    if (Error err = check_number_of_extents(extents.size() - 1 + new_extents.size())) {
+      return err;
+    }
+
+    extents.erase(extents.begin() + i);
+    extents.insert(extents.begin() + i,
+                   std::make_move_iterator(new_extents.begin()),
+                   std::make_move_iterator(new_extents.end()));
+
+    m_written_data_end = std::max(m_written_data_end, file_offset + length);
+
+    return Error::Ok;
+  }
+
+  return {heif_error_Usage_error,
+          heif_suberror_Unspecified,
+          "Item data range has not been reserved"};
+}
+
+
 void Box_iloc::derive_box_version()
 {
   int min_version = m_user_defined_min_version;
@@ -2023,7 +2306,10 @@ void Box_iloc::derive_box_version()
   m_base_offset_size = 0;
   m_index_size = 0;
 
-  uint64_t total_data_size = 0;
+  uint64_t total_data_size = 0; // data that is still to be written
+  uint64_t max_item_data_size = 0;
+  uint64_t max_extent_length = 0;
+  bool has_written_data = false;
 
   for (const auto& item : m_items) {
     // check item_ID size
@@ -2036,7 +2322,20 @@ void Box_iloc::derive_box_version()
       min_version = std::max(min_version, 1);
     }
 
-    total_data_size += item.extents[0].length;
+    uint64_t item_data_size = 0;
+    for (const auto& extent : item.extents) {
+      if (extent.written) {
+        has_written_data = true;
+      }
+      else {
+        total_data_size += extent.length;
+      }
+
+      item_data_size += extent.length;
+      max_extent_length = std::max(max_extent_length, extent.length);
+    }
+
+    max_item_data_size = std::max(max_item_data_size, item_data_size);
 
     /* cannot compute this here because values are not set yet
     // base offset size
@@ -2081,15 +2380,24 @@ void Box_iloc::derive_box_version()
   }
 
   uint64_t maximum_meta_box_size_guess = 0x10000000; // 256 MB
-  if (total_data_size + maximum_meta_box_size_guess > 0xFFFFFFFF) {
+  uint64_t maximum_file_size_guess = m_written_data_end + total_data_size + maximum_meta_box_size_guess;
+  if (maximum_file_size_guess > 0xFFFFFFFF) {
     m_base_offset_size = 8;
   }
   else {
     m_base_offset_size = 4;
   }
 
-  m_offset_size = 4;
-  m_length_size = 4;
+  // Items with data that has already been written use absolute extent offsets.
+  if (max_item_data_size > 0xFFFFFFFF ||
+      (has_written_data && maximum_file_size_guess > 0xFFFFFFFF)) {
+    m_offset_size = 8;
+  }
+  else {
+    m_offset_size = 4;
+  }
+
+  m_length_size = (max_extent_length > 0xFFFFFFFF) ? 8 : 4;
   //m_base_offset_size = 4; // set above
   m_index_size = 0;
 
@@ -2161,16 +2469,18 @@ Error Box_iloc::write(StreamWriter& writer) const
 }
 
 
-Error Box_iloc::write_mdat_after_iloc(StreamWriter& writer)
+Error Box_iloc::write_mdat_after_iloc(StreamWriter& writer, uint64_t file_offset)
 {
   // --- compute sum of all mdat data
 
-  size_t sum_mdat_size = 0;
+  uint64_t sum_mdat_size = 0;
 
   for (const auto& item : m_items) {
     if (item.construction_method == 0) {
       for (const auto& extent : item.extents) {
-        sum_mdat_size += extent.length;
+        if (!extent.written) {
+          sum_mdat_size += extent.length;
+        }
       }
     }
   }
@@ -2195,10 +2505,18 @@ Error Box_iloc::write_mdat_after_iloc(StreamWriter& writer)
 
   for (auto& item : m_items) {
     if (item.construction_method == 0) {
-      item.base_offset = writer.get_position();
+      bool has_written_data = std::any_of(item.extents.begin(), item.extents.end(),
+                                          [](const Extent& extent) { return extent.written; });
+
+      // When some data has already been written, all extent offsets are absolute file positions.
+      item.base_offset = has_written_data ? 0 : file_offset + writer.get_position();
 
       for (auto& extent : item.extents) {
-        extent.offset = writer.get_position() - item.base_offset;
+        if (extent.written) {
+          continue;
+        }
+
+        extent.offset = file_offset + writer.get_position() - item.base_offset;
         //extent.length = extent.data.size();
 
         if (m_use_tmpfile) {
@@ -2230,6 +2548,14 @@ Error Box_iloc::write_mdat_after_iloc(StreamWriter& writer)
         }
         else {
           writer.write(extent.data);
+
+          // reserved data that has not been filled
+          uint64_t n_zeros = extent.length - extent.data.size();
+          while (n_zeros > 0) {
+            int n = (int) std::min(n_zeros, uint64_t{0x40000000});
+            writer.skip(n);
+            n_zeros -= n;
+          }
         }
       }
     }
@@ -553,6 +553,9 @@ public:
     uint64_t length = 0;
 
     std::vector<uint8_t> data; // only used when writing data
+
+    // Only used when writing data: the data has already been written at the absolute file position 'offset'.
+    bool written = false;
   };
 
   struct Item
@@ -581,6 +584,16 @@ public:
                   uint64_t offset, uint64_t size,
                   const heif_security_limits* limits) const;
 
+  // Appends the file ranges that read_data() would read for the same item range.
+  // Only data stored in the file itself (construction method 0) is considered.
+  Error get_file_ranges(heif_item_id item, uint64_t offset, uint64_t size,
+                        std::vector<FileRange>& out_ranges) const;
+
+  // Reads a raw file range with a single request. This is synchronized with read_data().
+  static Error read_file_range(const std::shared_ptr<StreamReader>& istr,
+                               const FileRange& range,
+                               std::vector<uint8_t>& out_data);
+
   void set_min_version(uint8_t min_version) { m_user_defined_min_version = min_version; }
 
   // append bitstream data that will be written later (after iloc box)
@@ -594,21 +607,25 @@ public:
                      const std::vector<uint8_t>& data,
                      uint8_t construction_method);
 
-  // append bitstream data that already has been written (before iloc box)
-  // Error write_mdat_before_iloc(heif_image_id item_ID,
-  //                              std::vector<uint8_t>& data)
+  // Reserve 'length' bytes of item data (in the 'mdat') that are filled later with replace_data()
+  // or set_reserved_data_written(). Memory is only allocated when data is written into the reserved range.
+  // Data that is never filled is written as zeros.
+  Error reserve_data(heif_item_id item_ID, uint64_t length);
+
+  // --- item data that has already been written (before the iloc box)
 
-  // reserve data entry that will be written later
-  // Error reserve_mdat_item(heif_image_id item_ID,
-  //                         uint8_t construction_method,
-  //                         uint32_t* slot_ID);
-  // void patch_mdat_slot(uint32_t slot_ID, size_t start, size_t length);
+  // Append 'length' bytes of item data that have been written at the absolute file position 'file_offset'.
+  Error append_written_data(heif_item_id item_ID, uint64_t length, uint64_t file_offset);
+
+  // The reserved item data range [item_offset, item_offset+length) has been written at the absolute file position 'file_offset'.
+  Error set_reserved_data_written(heif_item_id item_ID, uint64_t item_offset, uint64_t length, uint64_t file_offset);
 
   void derive_box_version() override;
 
   Error write(StreamWriter& writer) const override;
 
-  Error write_mdat_after_iloc(StreamWriter& writer);
+  // 'file_offset' is the absolute file position of the start of 'writer'.
+  Error write_mdat_after_iloc(StreamWriter& writer, uint64_t file_offset = 0);
 
   void append_item(Item &item) { m_items.push_back(item); }
 
@@ -627,8 +644,12 @@ private:
 
   void patch_iloc_header(StreamWriter& writer) const;
 
+  Item* find_or_add_item(heif_item_id item_ID, uint8_t construction_method);
+
   int m_idat_offset = 0; // only for writing: offset of next data array
 
+  uint64_t m_written_data_end = 0; // only for writing: end of the data that has already been written
+
   bool m_use_tmpfile = false;
   int m_tmpfile_fd = 0;
   char m_tmp_filename[20];
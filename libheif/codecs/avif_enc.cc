@@ -92,3 +92,35 @@ std::shared_ptr<class Box_VisualSampleEntry> Encoder_AVIF::get_sample_descriptio
   assert(false); // no av1C generated
   return nullptr;
 }
+
+
+void Encoder_AVIF::start_sequence(const std::shared_ptr<HeifPixelImage>& first_image)
+{
+  // Preliminary av1C in case we cannot parse the sequence_header() (see encode()).
+  m_sequence_config = Box_av1C::configuration{};
+  fill_av1C_configuration(&m_sequence_config, first_image);
+}
+
+
+Error Encoder_AVIF::append_sequence_packet(CodedImageData& frame, const uint8_t* data, int size)
+{
+  fill_av1C_configuration_from_stream(&m_sequence_config, data, size);
+
+  frame.append(data, size);
+
+  return Error::Ok;
+}
+
+
+Error Encoder_AVIF::finish_sequence_frame(CodedImageData& frame)
+{
+  auto av1C = std::make_shared<Box_av1C>();
+  av1C->set_configuration(m_sequence_config);
+  frame.properties.push_back(av1C);
+
+  frame.codingConstraints.intra_pred_used = true;
+  frame.codingConstraints.all_ref_pics_intra = false;
+  frame.codingConstraints.max_ref_per_pic = 0; // unknown
+
+  return Error::Ok;
+}
@@ -31,6 +31,7 @@
 #include <utility>
 #include <vector>
 #include "codecs/encoder.h"
+#include "codecs/avif_boxes.h"
 
 
 class Encoder_AVIF : public Encoder {
@@ -41,6 +42,16 @@ public:
                                 heif_image_input_class input_class) override;
 
   std::shared_ptr<Box_VisualSampleEntry> get_sample_description_box(const CodedImageData&) const override;
+
+protected:
+  void start_sequence(const std::shared_ptr<HeifPixelImage>& first_image) override;
+
+  Error append_sequence_packet(CodedImageData& frame, const uint8_t* data, int size) override;
+
+  Error finish_sequence_frame(CodedImageData& frame) override;
+
+private:
+  Box_av1C::configuration m_sequence_config;
 };
 
 
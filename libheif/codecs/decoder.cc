@@ -24,6 +24,7 @@
 #include "error.h"
 #include "context.h"
 #include "plugin_registry.h"
+#include "trace.h"
 #include "api_structs.h"
 
 #include "codecs/hevc_dec.h"
@@ -92,6 +93,12 @@ Result<std::vector<uint8_t>> DataExtent::read_data(uint64_t offset, uint64_t siz
   std::vector<uint8_t> data;
 
   if (!m_raw.empty()) {
+    if (offset > m_raw.size() || size > m_raw.size() - offset) {
+      return Error{heif_error_Invalid_input,
+                   heif_suberror_End_of_data,
+                   "Read beyond the end of the image data"};
+    }
+
     data.insert(data.begin(), m_raw.begin() + offset, m_raw.begin() + offset + size);
     return data;
   }
@@ -107,7 +114,13 @@ Result<std::vector<uint8_t>> DataExtent::read_data(uint64_t offset, uint64_t siz
   }
   else {
     // file range
-    Error err = m_file->append_data_from_file_range(data, m_offset, m_size);
+    if (offset > m_size || size > m_size - offset) {
+      return Error{heif_error_Invalid_input,
+                   heif_suberror_End_of_data,
+                   "Read beyond the end of the image data"};
+    }
+
+    Error err = m_file->append_data_from_file_range(data, m_offset + offset, static_cast<uint32_t>(size));
     if (err) {
       return err;
     }
@@ -221,13 +234,17 @@ Result<std::vector<uint8_t>> Decoder::get_compressed_data() const
   // --- get the compressed image data
 
   // data from configuration blocks
+  // For sequences, this is prepended to every frame. Since it does not change, we only build it once.
 
-  Result<std::vector<uint8_t>> confData = read_bitstream_configuration_data();
-  if (!confData) {
-    return confData.error();
-  }
+  if (!m_configuration_data_read) {
+    Result<std::vector<uint8_t>> confData = read_bitstream_configuration_data();
+    if (!confData) {
+      return confData.error();
+    }
 
-  std::vector<uint8_t> data = *confData;
+    m_configuration_data = std::move(*confData);
+    m_configuration_data_read = true;
+  }
 
   // append image data
 
@@ -236,6 +253,9 @@ Result<std::vector<uint8_t>> Decoder::get_compressed_data() const
     return dataResult.error();
   }
 
+  std::vector<uint8_t> data;
+  data.reserve(m_configuration_data.size() + (*dataResult)->size());
+  data.insert(data.end(), m_configuration_data.begin(), m_configuration_data.end());
   data.insert(data.end(), (*dataResult)->begin(), (*dataResult)->end());
 
   return data;
@@ -257,6 +277,8 @@ Result<std::shared_ptr<HeifPixelImage>>
 Decoder::decode_single_frame_from_compressed_data(const heif_decoding_options& options,
                                                   const heif_security_limits* limits)
 {
+  TraceScope trace_scope(TraceStage::codec);
+
   if (!m_decoder_plugin) {
     m_decoder_plugin = get_decoder(get_compression_format(), options.decoder_id);
     if (!m_decoder_plugin) {
@@ -101,6 +101,9 @@ public:
 private:
   DataExtent m_data_extent;
 
+  mutable std::vector<uint8_t> m_configuration_data;
+  mutable bool m_configuration_data_read = false;
+
   const heif_decoder_plugin* m_decoder_plugin = nullptr;
   void* m_decoder = nullptr;
 };
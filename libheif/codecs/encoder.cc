@@ -165,3 +165,165 @@ Result<std::shared_ptr<HeifPixelImage>> Encoder::convert_colorspace_for_encoding
                             output_bpp, options.color_conversion_options, nullptr,
                             security_limits);
 }
+
+
+bool Encoder::plugin_supports_sequence_encoding(const heif_encoder* encoder)
+{
+  const heif_encoder_plugin* plugin = encoder->plugin;
+
+  return (plugin->plugin_api_version >= 4 &&
+          plugin->start_sequence_encoding != nullptr &&
+          plugin->encode_sequence_frame != nullptr &&
+          plugin->end_sequence_encoding != nullptr &&
+          plugin->get_compressed_data2 != nullptr);
+}
+
+
+Error Encoder::encode_sequence_frame(const std::shared_ptr<HeifPixelImage>& image,
+                                     heif_encoder* encoder,
+                                     const heif_sequence_encoding_options& options,
+                                     heif_image_input_class input_class,
+                                     uint32_t framerate_num, uint32_t framerate_denom,
+                                     uintptr_t frame_nr)
+{
+  assert(plugin_supports_sequence_encoding(encoder));
+
+  if (m_sequence_encoder != nullptr && m_sequence_encoder != encoder) {
+    return {heif_error_Usage_error,
+            heif_suberror_Unspecified,
+            "The encoder cannot be changed within a sequence. End the sequence first."};
+  }
+
+  heif_image c_api_image;
+  c_api_image.image = image;
+
+  if (m_sequence_encoder == nullptr) {
+    start_sequence(image);
+
+    heif_error err = encoder->plugin->start_sequence_encoding(encoder->encoder, &c_api_image, input_class,
+                                                              framerate_num, framerate_denom, &options);
+    if (err.code) {
+      return Error(err.code,
+                   err.subcode,
+                   err.message);
+    }
+
+    m_sequence_encoder = encoder;
+  }
+
+  heif_error err = encoder->plugin->encode_sequence_frame(encoder->encoder, &c_api_image, frame_nr);
+  if (err.code) {
+    return Error(err.code,
+                 err.subcode,
+                 err.message);
+  }
+
+  return pull_sequence_packets(encoder);
+}
+
+
+Error Encoder::encode_sequence_flush(heif_encoder* encoder)
+{
+  if (m_sequence_encoder == nullptr) {
+    return Error::Ok;
+  }
+
+  if (m_sequence_encoder != encoder) {
+    return {heif_error_Usage_error,
+            heif_suberror_Unspecified,
+            "The sequence has to be ended with the same encoder that it was encoded with."};
+  }
+
+  heif_error err = encoder->plugin->end_sequence_encoding(encoder->encoder);
+  if (err.code) {
+    return Error(err.code,
+                 err.subcode,
+                 err.message);
+  }
+
+  Error pullErr = pull_sequence_packets(encoder);
+  if (pullErr) {
+    return pullErr;
+  }
+
+  if (m_sequence_frame_in_progress) {
+    return {heif_error_Encoder_plugin_error,
+            heif_suberror_Unspecified,
+            "Encoder plugin did not output all packets of the last frame."};
+  }
+
+  m_sequence_encoder = nullptr;
+
+  return Error::Ok;
+}
+
+
+Error Encoder::pull_sequence_packets(heif_encoder* encoder)
+{
+  for (;;) {
+    uint8_t* data = nullptr;
+    int size = 0;
+    uintptr_t frame_nr = 0;
+    int is_keyframe = 0;
+    int more_frame_packets = 0;
+
+    heif_error err = encoder->plugin->get_compressed_data2(encoder->encoder, &data, &size,
+                                                           &frame_nr, &is_keyframe, &more_frame_packets);
+    if (err.code) {
+      return Error(err.code,
+                   err.subcode,
+                   err.message);
+    }
+
+    if (data == nullptr) {
+      return Error::Ok;
+    }
+
+    if (!m_sequence_frame_in_progress) {
+      m_sequence_frame_in_progress = CodedImageData{};
+      m_sequence_frame_in_progress->frame_nr = frame_nr;
+      m_sequence_frame_in_progress->is_sync_frame = (is_keyframe != 0);
+    }
+    else if (m_sequence_frame_in_progress->frame_nr != frame_nr) {
+      return {heif_error_Encoder_plugin_error,
+              heif_suberror_Unspecified,
+              "Encoder plugin started a new frame before the previous frame was complete."};
+    }
+
+    Error appendErr = append_sequence_packet(*m_sequence_frame_in_progress, data, size);
+    if (appendErr) {
+      return appendErr;
+    }
+
+    if (!more_frame_packets) {
+      Error finishErr = finish_sequence_frame(*m_sequence_frame_in_progress);
+      if (finishErr) {
+        return finishErr;
+      }
+
+      m_coded_sequence_frames.emplace_back(std::move(*m_sequence_frame_in_progress));
+      m_sequence_frame_in_progress.reset();
+    }
+  }
+}
+
+
+Error Encoder::append_sequence_packet(CodedImageData& frame, const uint8_t* data, int size)
+{
+  frame.append(data, size);
+
+  return Error::Ok;
+}
+
+
+std::optional<Encoder::CodedImageData> Encoder::get_next_coded_sequence_frame()
+{
+  if (m_coded_sequence_frames.empty()) {
+    return std::nullopt;
+  }
+
+  CodedImageData frame = std::move(m_coded_sequence_frames.front());
+  m_coded_sequence_frames.pop_front();
+
+  return frame;
+}
@@ -25,7 +25,9 @@
 #include "error.h"
 #include "libheif/heif_plugin.h"
 
+#include <deque>
 #include <memory>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -49,7 +51,10 @@ public:
     uint32_t encoded_image_width = 0;
     uint32_t encoded_image_height = 0;
 
-    bool is_sync_frame = true; // TODO: set in encoder
+    bool is_sync_frame = true;
+
+    // The frame_nr passed to encode_sequence_frame(). Only used for sequence encoding.
+    uintptr_t frame_nr = 0;
 
     void append(const uint8_t* data, size_t size);
 
@@ -70,6 +75,47 @@ public:
                                         heif_image_input_class input_class) { return {}; }
 
   virtual std::shared_ptr<Box_VisualSampleEntry> get_sample_description_box(const CodedImageData&) const { return {}; }
+
+
+  // --- sequence encoding with inter-frame prediction (encoder plugin API v4)
+
+  static bool plugin_supports_sequence_encoding(const heif_encoder* encoder);
+
+  // The sequence is started with the first frame.
+  // Coded frames are not returned immediately because the encoder may buffer frames for its lookahead.
+  Error encode_sequence_frame(const std::shared_ptr<HeifPixelImage>& image,
+                              heif_encoder* encoder,
+                              const heif_sequence_encoding_options& options,
+                              heif_image_input_class input_class,
+                              uint32_t framerate_num, uint32_t framerate_denom,
+                              uintptr_t frame_nr);
+
+  Error encode_sequence_flush(heif_encoder* encoder);
+
+  bool is_sequence_encoding_active() const { return m_sequence_encoder != nullptr; }
+
+  // The heif_encoder that the sequence was started with, or NULL.
+  const heif_encoder* get_sequence_encoder() const { return m_sequence_encoder; }
+
+  // Completely coded frames, in coding order (which is equal to the input order).
+  std::optional<CodedImageData> get_next_coded_sequence_frame();
+
+protected:
+  // Codec-specific handling of the sequence bitstream packets.
+
+  virtual void start_sequence(const std::shared_ptr<HeifPixelImage>& first_image) { }
+
+  virtual Error append_sequence_packet(CodedImageData& frame, const uint8_t* data, int size);
+
+  virtual Error finish_sequence_frame(CodedImageData& frame) { return Error::Ok; }
+
+private:
+  const heif_encoder* m_sequence_encoder = nullptr;
+
+  std::optional<CodedImageData> m_sequence_frame_in_progress;
+  std::deque<CodedImageData> m_coded_sequence_frames;
+
+  Error pull_sequence_packets(heif_encoder* encoder);
 };
 
 
@@ -126,3 +126,64 @@ std::shared_ptr<Box_VisualSampleEntry> Encoder_HEVC::get_sample_description_box(
   assert(false); // no hvcC generated
   return nullptr;
 }
+
+
+void Encoder_HEVC::start_sequence(const std::shared_ptr<HeifPixelImage>& first_image)
+{
+  m_sequence_hvcC = std::make_shared<Box_hvcC>();
+  m_sequence_hvcC_complete = false;
+  m_sequence_encoded_width = 0;
+  m_sequence_encoded_height = 0;
+}
+
+
+Error Encoder_HEVC::append_sequence_packet(CodedImageData& frame, const uint8_t* data, int size)
+{
+  if (size < 1) {
+    return {heif_error_Encoder_plugin_error,
+            heif_suberror_Unspecified,
+            "Encoder plugin returned an empty NAL unit."};
+  }
+
+  switch (data[0] >> 1) {
+    case NAL_UNIT_SPS_NUT:
+      if (!m_sequence_hvcC_complete) {
+        parse_sps_for_hvcC_configuration(data, size, &m_sequence_hvcC->get_configuration(),
+                                         &m_sequence_encoded_width, &m_sequence_encoded_height);
+      }
+      // fallthrough
+    case NAL_UNIT_VPS_NUT:
+    case NAL_UNIT_PPS_NUT:
+      // The 'hvc1' sample entry requires that all parameter sets are stored in the 'hvcC'.
+      if (!m_sequence_hvcC_complete) {
+        m_sequence_hvcC->append_nal_data(data, size);
+      }
+      break;
+
+    default:
+      frame.append_with_4bytes_size(data, size);
+  }
+
+  return Error::Ok;
+}
+
+
+Error Encoder_HEVC::finish_sequence_frame(CodedImageData& frame)
+{
+  if (!m_sequence_encoded_width || !m_sequence_encoded_height) {
+    return Error(heif_error_Encoder_plugin_error,
+                 heif_suberror_Invalid_image_size);
+  }
+
+  m_sequence_hvcC_complete = true;
+
+  frame.properties.push_back(m_sequence_hvcC);
+  frame.encoded_image_width = m_sequence_encoded_width;
+  frame.encoded_image_height = m_sequence_encoded_height;
+
+  frame.codingConstraints.intra_pred_used = true;
+  frame.codingConstraints.all_ref_pics_intra = false;
+  frame.codingConstraints.max_ref_per_pic = 0; // unknown
+
+  return Error::Ok;
+}
@@ -41,6 +41,21 @@ public:
                                 heif_image_input_class input_class) override;
 
   std::shared_ptr<Box_VisualSampleEntry> get_sample_description_box(const CodedImageData&) const override;
+
+protected:
+  void start_sequence(const std::shared_ptr<HeifPixelImage>& first_image) override;
+
+  Error append_sequence_packet(CodedImageData& frame, const uint8_t* data, int size) override;
+
+  Error finish_sequence_frame(CodedImageData& frame) override;
+
+private:
+  // Parameter sets of the sequence. Repeated parameter sets in later frames are not stored again.
+  std::shared_ptr<class Box_hvcC> m_sequence_hvcC;
+  bool m_sequence_hvcC_complete = false;
+
+  int m_sequence_encoded_width = 0;
+  int m_sequence_encoded_height = 0;
 };
 
 
@@ -208,6 +208,17 @@ const Error AbstractDecoder::get_compressed_image_data_uncompressed(const DataEx
 
     const std::vector<uint8_t>& compressed_bytes = *readingResult;
 
+    // With tile_component interleave, the requested range is only one component of the unit
+    // and the decompressed size of the whole unit is not known here.
+    // In all other interleave modes, the unit holds exactly the requested tile. Decompress it in
+    // one pass into the final buffer.
+    if (m_uncC->get_interleave_type() != interleave_mode_tile_component) {
+      data->resize(range_size);
+      return decompress_generic(cmpC_box->get_compression_type(),
+                                compressed_bytes.data(), compressed_bytes.size(),
+                                data->data(), data->size());
+    }
+
     // decompress only the unit
     auto dataResult = do_decompress_data(cmpC_box, compressed_bytes);
     if (!dataResult) {
@@ -223,7 +234,8 @@ const Error AbstractDecoder::get_compressed_image_data_uncompressed(const DataEx
       return readResult.error();
     }
 
-    const std::vector<uint8_t> compressed_bytes = std::move(**readResult);
+    // Do not move the data out of the DataExtent cache. Other tiles will be cut from the same data.
+    const std::vector<uint8_t>& compressed_bytes = **readResult;
 
     for (Box_icef::CompressedUnitInfo unit_info : icef_box->get_units()) {
       auto unit_start = compressed_bytes.begin() + unit_info.unit_offset;
@@ -256,7 +268,7 @@ const Error AbstractDecoder::get_compressed_image_data_uncompressed(const DataEx
       return readResult.error();
     }
 
-    std::vector<uint8_t> compressed_bytes = std::move(**readResult);
+    const std::vector<uint8_t>& compressed_bytes = **readResult;
 
     // Decode as a single blob
     auto dataResult = do_decompress_data(cmpC_box, compressed_bytes);
@@ -284,44 +296,5 @@ const Error AbstractDecoder::get_compressed_image_data_uncompressed(const DataEx
 Result<std::vector<uint8_t>> AbstractDecoder::do_decompress_data(std::shared_ptr<const Box_cmpC>& cmpC_box,
                                                                  std::vector<uint8_t> compressed_data) const
 {
-  if (cmpC_box->get_compression_type() == fourcc("brot")) {
-#if HAVE_BROTLI
-    return decompress_brotli(compressed_data);
-#else
-    std::stringstream sstr;
-  sstr << "cannot decode unci item with brotli compression - not enabled" << std::endl;
-  return Error(heif_error_Unsupported_feature,
-               heif_suberror_Unsupported_generic_compression_method,
-               sstr.str());
-#endif
-  }
-  else if (cmpC_box->get_compression_type() == fourcc("zlib")) {
-#if HAVE_ZLIB
-    return decompress_zlib(compressed_data);
-#else
-    std::stringstream sstr;
-    sstr << "cannot decode unci item with zlib compression - not enabled" << std::endl;
-    return Error(heif_error_Unsupported_feature,
-                 heif_suberror_Unsupported_generic_compression_method,
-                 sstr.str());
-#endif
-  }
-  else if (cmpC_box->get_compression_type() == fourcc("defl")) {
-#if HAVE_ZLIB
-    return decompress_deflate(compressed_data);
-#else
-    std::stringstream sstr;
-    sstr << "cannot decode unci item with deflate compression - not enabled" << std::endl;
-    return Error(heif_error_Unsupported_feature,
-                 heif_suberror_Unsupported_generic_compression_method,
-                 sstr.str());
-#endif
-  }
-  else {
-    std::stringstream sstr;
-    sstr << "cannot decode unci item with unsupported compression type: " << cmpC_box->get_compression_type() << std::endl;
-    return Error(heif_error_Unsupported_feature,
-                 heif_suberror_Unsupported_generic_compression_method,
-                 sstr.str());
-  }
+  return decompress_generic(cmpC_box->get_compression_type(), compressed_data);
 }
@@ -39,6 +39,13 @@
 #include <iostream>
 #include <cassert>
 #include "security_limits.h"
+#include "trace.h"
+#include "thread_pool.h"
+
+#if ENABLE_PARALLEL_TILE_DECODING
+#include <atomic>
+#include <future>
+#endif
 
 
 bool isKnownUncompressedFrameConfigurationBoxProfile(const std::shared_ptr<const Box_uncC>& uncC)
@@ -509,6 +516,111 @@ Result<std::shared_ptr<HeifPixelImage>> UncompressedImageCodec::create_image(con
 }
 
 
+// Decodes all uncC tiles of the image into 'img'.
+// The tiles are independent byte ranges and every tile is written into its own region of the output planes.
+// Thus, with max_threads > 0, we distribute the tiles over a set of worker threads that all write into the shared image.
+static Error decode_uncompressed_image_tiles(AbstractDecoder* decoder,
+                                             const DataExtent& extent,
+                                             const UncompressedImageCodec::unci_properties& properties,
+                                             std::shared_ptr<HeifPixelImage>& img,
+                                             uint32_t width, uint32_t height,
+                                             int max_threads)
+{
+  const std::shared_ptr<const Box_uncC>& uncC = properties.uncC;
+
+  uint32_t nTileColumns = uncC->get_number_of_tile_columns();
+  uint32_t nTileRows = uncC->get_number_of_tile_rows();
+  uint32_t tile_width = width / nTileColumns;
+  uint32_t tile_height = height / nTileRows;
+  uint64_t nTiles = uint64_t{nTileColumns} * nTileRows;
+
+  auto decode_tile = [&](uint64_t tile_idx) {
+    auto tile_x = static_cast<uint32_t>(tile_idx % nTileColumns);
+    auto tile_y = static_cast<uint32_t>(tile_idx / nTileColumns);
+
+    return decoder->decode_tile(extent, properties, img,
+                                tile_x * tile_width, tile_y * tile_height,
+                                width, height,
+                                tile_x, tile_y);
+  };
+
+#if ENABLE_PARALLEL_TILE_DECODING
+  if (max_threads > 0 && nTiles > 1) {
+    // When the generic compression does not use one compressed unit per tile, all tiles are cut out of
+    // the same decompressed data. Load the compressed data once before starting the threads, because the
+    // DataExtent caches it in an unsynchronized buffer.
+
+    bool per_tile_compressed_units = (properties.cmpC && properties.icef &&
+                                      properties.cmpC->get_compressed_unit_type() == heif_cmpC_compressed_unit_type_image_tile);
+
+    if (properties.cmpC && !per_tile_compressed_units) {
+      auto readResult = extent.read_data();
+      if (!readResult) {
+        return readResult.error();
+      }
+    }
+
+    std::atomic<uint64_t> next_tile{0};
+    std::atomic<bool> failed{false};
+
+    OperationTrace* trace = current_trace();
+
+    auto worker = [&]() -> Error {
+      TraceBinding trace_binding(trace);
+
+      for (;;) {
+        if (failed) {
+          return Error::Ok;
+        }
+
+        uint64_t tile_idx = next_tile++;
+        if (tile_idx >= nTiles) {
+          return Error::Ok;
+        }
+
+        Error err = decode_tile(tile_idx);
+        if (err) {
+          failed = true;
+          return err;
+        }
+      }
+    };
+
+    auto nThreads = static_cast<size_t>(std::min(uint64_t(max_threads), nTiles));
+
+    ThreadPool& pool = ThreadPool::global();
+
+    std::vector<ThreadPool::Future<Error>> workers;
+    workers.reserve(nThreads);
+    for (size_t i = 0; i < nThreads; i++) {
+      workers.push_back(pool.async(worker));
+    }
+
+    // wait for all tasks before returning, since they access the image and the decoder
+
+    Error result = Error::Ok;
+    for (auto& w : workers) {
+      Error err = pool.get(w);
+      if (err && !result) {
+        result = err;
+      }
+    }
+
+    return result;
+  }
+#endif
+
+  for (uint64_t tile_idx = 0; tile_idx < nTiles; tile_idx++) {
+    Error error = decode_tile(tile_idx);
+    if (error) {
+      return error;
+    }
+  }
+
+  return Error::Ok;
+}
+
+
 Error UncompressedImageCodec::decode_uncompressed_image_tile(const HeifContext* context,
                                                              heif_item_id ID,
                                                              std::shared_ptr<HeifPixelImage>& img,
@@ -626,6 +738,8 @@ Error UncompressedImageCodec::decode_uncompressed_image(const HeifContext* conte
                                                         heif_item_id ID,
                                                         std::shared_ptr<HeifPixelImage>& img)
 {
+  TraceScope trace_scope(TraceStage::codec);
+
   // Get the properties for this item
   // We need: ispe, cmpd, uncC
   std::vector<std::shared_ptr<Box>> item_properties;
@@ -686,26 +800,16 @@ Error UncompressedImageCodec::decode_uncompressed_image(const HeifContext* conte
 
   decoder->buildChannelList(img);
 
-  uint32_t tile_width = width / uncC->get_number_of_tile_columns();
-  uint32_t tile_height = height / uncC->get_number_of_tile_rows();
-
   DataExtent dataExtent;
   dataExtent.set_from_image_item(context->get_heif_file(), ID);
 
-  for (uint32_t tile_y0 = 0; tile_y0 < height; tile_y0 += tile_height)
-    for (uint32_t tile_x0 = 0; tile_x0 < width; tile_x0 += tile_width) {
-      error = decoder->decode_tile(dataExtent, properties, img, tile_x0, tile_y0,
-                                   width, height,
-                                   tile_x0 / tile_width, tile_y0 / tile_height);
-      if (error) {
-        delete decoder;
-        return error;
-      }
-    }
+  error = decode_uncompressed_image_tiles(decoder, dataExtent, properties, img,
+                                          width, height,
+                                          context->get_max_decoding_threads());
 
   //Error result = decoder->decode(source_data, img);
   delete decoder;
-  return Error::Ok;
+  return error;
 }
 
 
@@ -722,7 +826,8 @@ void UncompressedImageCodec::unci_properties::fill_from_image_item(const std::sh
 Result<std::shared_ptr<HeifPixelImage>>
 UncompressedImageCodec::decode_uncompressed_image(const UncompressedImageCodec::unci_properties& properties,
                                                   const DataExtent& extent,
-                                                  const heif_security_limits* securityLimits)
+                                                  const heif_security_limits* securityLimits,
+                                                  int max_threads)
 {
   std::shared_ptr<HeifPixelImage> img;
 
@@ -769,22 +874,17 @@ UncompressedImageCodec::decode_uncompressed_image(const UncompressedImageCodec::
 
   decoder->buildChannelList(img);
 
-  uint32_t tile_width = width / uncC->get_number_of_tile_columns();
-  uint32_t tile_height = height / uncC->get_number_of_tile_rows();
-
-  for (uint32_t tile_y0 = 0; tile_y0 < height; tile_y0 += tile_height)
-    for (uint32_t tile_x0 = 0; tile_x0 < width; tile_x0 += tile_width) {
-      error = decoder->decode_tile(extent, properties, img, tile_x0, tile_y0,
-                                   width, height,
-                                   tile_x0 / tile_width, tile_y0 / tile_height);
-      if (error) {
-        delete decoder;
-        return error;
-      }
-    }
+  error = decode_uncompressed_image_tiles(decoder, extent, properties, img,
+                                          width, height,
+                                          max_threads);
 
   //Error result = decoder->decode(source_data, img);
   delete decoder;
+
+  if (error) {
+    return error;
+  }
+
   return img;
 }
 
@@ -76,9 +76,11 @@ public:
     void fill_from_image_item(const std::shared_ptr<const ImageItem>&);
   };
 
+  // With max_threads > 0, the uncC tiles are decoded in parallel by up to max_threads threads.
   static Result<std::shared_ptr<HeifPixelImage>> decode_uncompressed_image(const unci_properties& properties,
                                                                            const struct DataExtent& extent,
-                                                                           const heif_security_limits*);
+                                                                           const heif_security_limits*,
+                                                                           int max_threads = 0);
 
 
   static Error get_heif_chroma_uncompressed(const std::shared_ptr<const Box_uncC>& uncC,
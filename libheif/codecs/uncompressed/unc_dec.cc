@@ -22,6 +22,7 @@
 #include "codecs/uncompressed/unc_codec.h"
 #include "error.h"
 #include "context.h"
+#include "trace.h"
 
 #include <string>
 #include <algorithm>
@@ -167,6 +168,8 @@ Result<std::shared_ptr<HeifPixelImage>>
 Decoder_uncompressed::decode_single_frame_from_compressed_data(const struct heif_decoding_options& options,
                                                                const struct heif_security_limits* limits)
 {
+  TraceScope trace_scope(TraceStage::codec);
+
   UncompressedImageCodec::unci_properties properties;
   properties.uncC = m_uncC;
   properties.cmpd = m_cmpd;
@@ -19,6 +19,8 @@
  */
 
 #include <cstdint>
+#include <cassert>
+#include <algorithm>
 #include "alpha.h"
 
 
@@ -90,6 +92,114 @@ Op_drop_alpha_plane::convert_colorspace(const std::shared_ptr<const HeifPixelIma
 }
 
 
+// --- alpha composition kernels
+//
+// The row loops are free of divisions and data-dependent branches so that the compiler can vectorize them.
+
+// Exact floor(t / alpha_max) for alpha_max = 2^alpha_bits - 1 and t <= alpha_max^2.
+static inline uint32_t div_by_alpha_max(uint32_t t, int alpha_bits)
+{
+  return (t + 1 + (t >> alpha_bits)) >> alpha_bits;
+}
+
+
+template<class Pixel>
+static void flatten_row(Pixel* __restrict out, const Pixel* __restrict in, const Pixel* __restrict alpha,
+                        uint32_t width, uint32_t bkg, int alpha_bits)
+{
+  const uint32_t alpha_max = (1U << alpha_bits) - 1;
+
+  for (uint32_t x = 0; x < width; x++) {
+    uint32_t a = alpha[x];
+    uint32_t t = uint32_t{in[x]} * a + bkg * (alpha_max - a);
+    out[x] = static_cast<Pixel>(div_by_alpha_max(t, alpha_bits));
+  }
+}
+
+
+// Input colors are already multiplied with alpha. Only the background has to be weighted.
+template<class Pixel>
+static void flatten_row_premultiplied(Pixel* __restrict out, const Pixel* __restrict in, const Pixel* __restrict alpha,
+                                      uint32_t width, uint32_t bkg, int alpha_bits, uint32_t value_max)
+{
+  const uint32_t alpha_max = (1U << alpha_bits) - 1;
+
+  for (uint32_t x = 0; x < width; x++) {
+    uint32_t a = alpha[x];
+    uint32_t v = in[x] + div_by_alpha_max(bkg * (alpha_max - a), alpha_bits);
+    out[x] = static_cast<Pixel>(std::min(v, value_max));
+  }
+}
+
+
+static void flatten_row_RGBA32(uint8_t* __restrict out, const uint8_t* __restrict in,
+                               uint32_t width, const uint8_t bkg[3], bool premultiplied)
+{
+  if (premultiplied) {
+    for (uint32_t x = 0; x < width; x++) {
+      uint32_t a = in[4 * x + 3];
+      for (int c = 0; c < 3; c++) {
+        uint32_t v = in[4 * x + c] + div_by_alpha_max(bkg[c] * (255 - a), 8);
+        out[3 * x + c] = static_cast<uint8_t>(std::min(v, 255U));
+      }
+    }
+  }
+  else {
+    for (uint32_t x = 0; x < width; x++) {
+      uint32_t a = in[4 * x + 3];
+      for (int c = 0; c < 3; c++) {
+        uint32_t t = in[4 * x + c] * a + bkg[c] * (255 - a);
+        out[3 * x + c] = static_cast<uint8_t>(div_by_alpha_max(t, 8));
+      }
+    }
+  }
+}
+
+
+// Splits row 'y' into spans of constant background and calls f(x_start, x_end, use_primary_background) for each.
+// Instead of computing the checkerboard parity for each pixel, it only changes at the square borders.
+template<class F>
+static void for_each_background_span(uint32_t y, uint32_t width, const heif_color_conversion_options_ext& options_ext, F f)
+{
+  uint32_t square_size = options_ext.checkerboard_square_size;
+
+  if (options_ext.alpha_composition_mode != heif_alpha_composition_mode_checkerboard || square_size == 0) {
+    f(0, width, true);
+    return;
+  }
+
+  bool parity = (y / square_size) % 2;
+
+  for (uint32_t x0 = 0; x0 < width; x0 += square_size) {
+    f(x0, std::min(x0 + square_size, width), parity);
+    parity = !parity;
+  }
+}
+
+
+static void get_background_color(const heif_color_conversion_options_ext& options_ext, heif_channel channel,
+                                 uint16_t* out_primary, uint16_t* out_secondary)
+{
+  switch (channel) {
+    case heif_channel_R:
+      *out_primary = options_ext.background_red;
+      *out_secondary = options_ext.secondary_background_red;
+      break;
+    case heif_channel_G:
+      *out_primary = options_ext.background_green;
+      *out_secondary = options_ext.secondary_background_green;
+      break;
+    case heif_channel_B:
+      *out_primary = options_ext.background_blue;
+      *out_secondary = options_ext.secondary_background_blue;
+      break;
+    default:
+      assert(false);
+      *out_primary = *out_secondary = 0;
+  }
+}
+
+
 template<class Pixel>
 std::vector<ColorStateWithCost>
 Op_flatten_alpha_plane<Pixel>::state_after_conversion(const ColorState& input_state,
@@ -130,7 +240,19 @@ Op_flatten_alpha_plane<Pixel>::state_after_conversion(const ColorState& input_st
   output_state = input_state;
   output_state.has_alpha = false;
 
-  states.emplace_back(output_state, SpeedCosts_Trivial);
+  if (input_state.colorspace == heif_colorspace_RGB && input_state.chroma == heif_chroma_444) {
+    states.emplace_back(output_state, SpeedCosts_Trivial);
+  }
+  else {
+    // The composition is done in RGB. Prefer to continue with the RGB image instead of converting it back.
+
+    states.emplace_back(output_state, SpeedCosts_Unoptimized);
+
+    output_state.colorspace = heif_colorspace_RGB;
+    output_state.chroma = heif_chroma_444;
+    output_state.nclx = nclx_profile::undefined();
+    states.emplace_back(output_state, SpeedCosts_Trivial);
+  }
 
   return states;
 }
@@ -150,7 +272,8 @@ Op_flatten_alpha_plane<Pixel>::convert_colorspace(const std::shared_ptr<const He
   heif_color_conversion_options_ext options_ext_skip_alpha = options_ext;
   options_ext_skip_alpha.alpha_composition_mode = heif_alpha_composition_mode_none;
 
-  if (options_ext.alpha_composition_mode != heif_alpha_composition_mode_none) {
+  if (input->get_colorspace() != heif_colorspace_RGB ||
+      input->get_chroma_format() != heif_chroma_444) {
     Result<std::shared_ptr<const HeifPixelImage>> convInput = ::convert_colorspace(input,
                                                                                    heif_colorspace_RGB,
                                                                                    heif_chroma_444,
@@ -175,16 +298,27 @@ Op_flatten_alpha_plane<Pixel>::convert_colorspace(const std::shared_ptr<const He
                  input->get_colorspace(),
                  input->get_chroma_format());
 
+  const Pixel* p_alpha;
+  size_t stride_alpha;
+  p_alpha = (const Pixel*)input->get_plane(heif_channel_Alpha, &stride_alpha);
+  int bpp_alpha = input->get_bits_per_pixel(heif_channel_Alpha);
+
+  bool premultiplied = input->is_premultiplied_alpha();
+
+  for (heif_channel channel : {heif_channel_R, heif_channel_G, heif_channel_B}) {
+    if (input->get_bits_per_pixel(channel) != bpp_alpha) {
+      return Error{heif_error_Unsupported_feature,
+                   heif_suberror_Unsupported_bit_depth,
+                   "Alpha composition requires the same bit depth for the color and alpha channels"};
+    }
+  }
+
   for (heif_channel channel : {heif_channel_R,
                                heif_channel_G,
                                heif_channel_B}) {
-    outimg->add_plane(channel, width, height, target_state.bits_per_pixel, limits);
-
-    const Pixel* p_alpha;
-    size_t stride_alpha;
-    p_alpha = (const Pixel*)input->get_plane(heif_channel_Alpha, &stride_alpha);
-    int bpp_alpha = input->get_bits_per_pixel(heif_channel_Alpha);
-    Pixel alpha_max = (Pixel)((1 << bpp_alpha) - 1);
+    if (auto err = outimg->add_plane(channel, width, height, target_state.bits_per_pixel, limits)) {
+      return err;
+    }
 
     const Pixel* p_in;
     size_t stride_in;
@@ -194,94 +328,139 @@ Op_flatten_alpha_plane<Pixel>::convert_colorspace(const std::shared_ptr<const He
     size_t stride_out;
     p_out = (Pixel*)outimg->get_plane(channel, &stride_out);
 
-    if (sizeof(Pixel) == 2) {
-      stride_alpha /= 2;
-      stride_in /= 2;
-      stride_out /= 2;
-    }
+    size_t stride_alpha_pixels = stride_alpha / sizeof(Pixel);
+    stride_in /= sizeof(Pixel);
+    stride_out /= sizeof(Pixel);
 
-    if (options_ext.alpha_composition_mode == heif_alpha_composition_mode_solid_color ||
-        (options_ext.alpha_composition_mode == heif_alpha_composition_mode_checkerboard && options_ext.checkerboard_square_size == 0)) {
-      uint16_t bkg16;
-
-      switch (channel) {
-        case heif_channel_R:
-          bkg16 = options_ext.background_red;
-          break;
-        case heif_channel_G:
-          bkg16 = options_ext.background_green;
-          break;
-        case heif_channel_B:
-          bkg16 = options_ext.background_blue;
-          break;
-        default:
-          assert(false);
-          bkg16 = 0;
-      }
+    int bpp = input->get_bits_per_pixel(channel);
+    uint32_t value_max = (1U << bpp) - 1;
 
-      Pixel bkg = static_cast<Pixel>(bkg16 >> (16 - input->get_bits_per_pixel(channel)));
+    uint16_t bkg16_1, bkg16_2;
+    get_background_color(options_ext, channel, &bkg16_1, &bkg16_2);
 
-      for (uint32_t y = 0; y < height; y++)
-        for (uint32_t x = 0; x < width; x++) {
-          int a = p_alpha[y * stride_alpha + x];
-          p_out[y * stride_out + x] = static_cast<Pixel>((p_in[y * stride_in + x] * a + bkg * (alpha_max - a)) >> bpp_alpha);
-        }
-    }
-    else {
-      uint16_t bkg16_1, bkg16_2;
-
-      switch (channel) {
-        case heif_channel_R:
-          bkg16_1 = options_ext.background_red;
-          bkg16_2 = options_ext.secondary_background_red;
-          break;
-        case heif_channel_G:
-          bkg16_1 = options_ext.background_green;
-          bkg16_2 = options_ext.secondary_background_green;
-          break;
-        case heif_channel_B:
-          bkg16_1 = options_ext.background_blue;
-          bkg16_2 = options_ext.secondary_background_blue;
-          break;
-        default:
-          assert(false);
-          bkg16_1 = bkg16_2 = 0;
-      }
+    uint32_t bkg1 = bkg16_1 >> (16 - bpp);
+    uint32_t bkg2 = bkg16_2 >> (16 - bpp);
 
-      Pixel bkg1 = static_cast<Pixel>(bkg16_1 >> (16 - input->get_bits_per_pixel(channel)));
-      Pixel bkg2 = static_cast<Pixel>(bkg16_2 >> (16 - input->get_bits_per_pixel(channel)));
+    for (uint32_t y = 0; y < height; y++) {
+      const Pixel* in_row = p_in + y * stride_in;
+      const Pixel* alpha_row = p_alpha + y * stride_alpha_pixels;
+      Pixel* out_row = p_out + y * stride_out;
 
-      for (uint32_t y = 0; y < height; y++)
-        for (uint32_t x = 0; x < width; x++) {
-          uint8_t parity = (x / options_ext.checkerboard_square_size + y / options_ext.checkerboard_square_size) % 2;
-          Pixel bkg = parity ? bkg1 : bkg2;
+      for_each_background_span(y, width, options_ext, [&](uint32_t x0, uint32_t x1, bool primary) {
+        uint32_t bkg = primary ? bkg1 : bkg2;
 
-          int a = p_alpha[y * stride_alpha + x];
-          p_out[y * stride_out + x] = static_cast<Pixel>((p_in[y * stride_in + x] * a + bkg * (alpha_max - a)) >> bpp_alpha);
+        if (premultiplied) {
+          flatten_row_premultiplied(out_row + x0, in_row + x0, alpha_row + x0, x1 - x0, bkg, bpp_alpha, value_max);
+        }
+        else {
+          flatten_row(out_row + x0, in_row + x0, alpha_row + x0, x1 - x0, bkg, bpp_alpha);
         }
+      });
     }
+  }
 
+  if (target_state.colorspace == heif_colorspace_RGB && target_state.chroma == heif_chroma_444) {
+    return outimg;
   }
 
-  if (options_ext.alpha_composition_mode != heif_alpha_composition_mode_none) {
-    Result<std::shared_ptr<HeifPixelImage>> convOutput = ::convert_colorspace(outimg,
-                                                                              input_raw->get_colorspace(),
-                                                                              input_raw->get_chroma_format(),
-                                                                              input_state.nclx,
-                                                                              input_state.bits_per_pixel,
-                                                                              options, &options_ext_skip_alpha,
-                                                                              limits);
-    if (!convOutput) {
-      return convOutput.error();
-    }
-    else {
-      return convOutput;
-    }
+  Result<std::shared_ptr<HeifPixelImage>> convOutput = ::convert_colorspace(outimg,
+                                                                            input_raw->get_colorspace(),
+                                                                            input_raw->get_chroma_format(),
+                                                                            input_state.nclx,
+                                                                            input_state.bits_per_pixel,
+                                                                            options, &options_ext_skip_alpha,
+                                                                            limits);
+  if (!convOutput) {
+    return convOutput.error();
   }
   else {
-    return outimg;
+    return convOutput;
   }
 }
 
 template class Op_flatten_alpha_plane<uint8_t>;
 template class Op_flatten_alpha_plane<uint16_t>;
+
+
+std::vector<ColorStateWithCost>
+Op_flatten_alpha_RGBA32::state_after_conversion(const ColorState& input_state,
+                                                const ColorState& target_state,
+                                                const heif_color_conversion_options& options,
+                                                const heif_color_conversion_options_ext& options_ext) const
+{
+  if (input_state.colorspace != heif_colorspace_RGB ||
+      input_state.chroma != heif_chroma_interleaved_RGBA ||
+      target_state.has_alpha == true) {
+    return {};
+  }
+
+  if (options_ext.alpha_composition_mode == heif_alpha_composition_mode_none) {
+    return {};
+  }
+
+  std::vector<ColorStateWithCost> states;
+
+  ColorState output_state;
+
+  // --- RGBA -> RGB with alpha composited onto the background
+
+  output_state = input_state;
+  output_state.chroma = heif_chroma_interleaved_RGB;
+  output_state.has_alpha = false;
+
+  states.emplace_back(output_state, SpeedCosts_Trivial);
+
+  return states;
+}
+
+
+Result<std::shared_ptr<HeifPixelImage>>
+Op_flatten_alpha_RGBA32::convert_colorspace(const std::shared_ptr<const HeifPixelImage>& input,
+                                            const ColorState& input_state,
+                                            const ColorState& target_state,
+                                            const heif_color_conversion_options& options,
+                                            const heif_color_conversion_options_ext& options_ext,
+                                            const heif_security_limits* limits) const
+{
+  uint32_t width = input->get_width();
+  uint32_t height = input->get_height();
+
+  auto outimg = std::make_shared<HeifPixelImage>();
+
+  outimg->create(width, height, heif_colorspace_RGB, heif_chroma_interleaved_RGB);
+
+  if (auto err = outimg->add_plane(heif_channel_interleaved, width, height, 8, limits)) {
+    return err;
+  }
+
+  const uint8_t* p_in;
+  size_t stride_in;
+  p_in = input->get_plane(heif_channel_interleaved, &stride_in);
+
+  uint8_t* p_out;
+  size_t stride_out;
+  p_out = outimg->get_plane(heif_channel_interleaved, &stride_out);
+
+  uint8_t bkg1[3], bkg2[3];
+  int c = 0;
+  for (heif_channel channel : {heif_channel_R, heif_channel_G, heif_channel_B}) {
+    uint16_t bkg16_1, bkg16_2;
+    get_background_color(options_ext, channel, &bkg16_1, &bkg16_2);
+    bkg1[c] = static_cast<uint8_t>(bkg16_1 >> 8);
+    bkg2[c] = static_cast<uint8_t>(bkg16_2 >> 8);
+    c++;
+  }
+
+  bool premultiplied = input->is_premultiplied_alpha();
+
+  for (uint32_t y = 0; y < height; y++) {
+    const uint8_t* in_row = p_in + y * stride_in;
+    uint8_t* out_row = p_out + y * stride_out;
+
+    for_each_background_span(y, width, options_ext, [&](uint32_t x0, uint32_t x1, bool primary) {
+      flatten_row_RGBA32(out_row + 3 * x0, in_row + 4 * x0, x1 - x0, primary ? bkg1 : bkg2, premultiplied);
+    });
+  }
+
+  return outimg;
+}
@@ -22,6 +22,7 @@
 #include "colorconversion.h"
 #include "common_utils.h"
 #include "nclx.h"
+#include "trace.h"
 #include <typeinfo>
 #include <algorithm>
 #include <cstring>
@@ -46,6 +47,11 @@
 
 #endif
 
+#if defined(__GNUC__) || defined(__clang__)
+#include <cxxabi.h>
+#include <cstdlib>
+#endif
+
 #define DEBUG_ME 0
 #define DEBUG_PIPELINE_CREATION 0
 
@@ -226,11 +232,15 @@ void ColorConversionPipeline::init_ops()
   ops.emplace_back(std::make_shared<Op_YCbCr420_to_RGB24>());
   ops.emplace_back(std::make_shared<Op_YCbCr420_to_RGB32>());
   ops.emplace_back(std::make_shared<Op_YCbCr420_to_RRGGBBaa>());
+  ops.emplace_back(std::make_shared<Op_YCbCr_bilinear_to_RGB24_32>());
+  ops.emplace_back(std::make_shared<Op_YCbCr_bilinear_to_RGB24_32_simd>());
   ops.emplace_back(std::make_shared<Op_RGB_HDR_to_RRGGBBaa_BE>());
+  ops.emplace_back(std::make_shared<Op_RGB_HDR_to_RRGGBBaa_BE_simd>());
   ops.emplace_back(std::make_shared<Op_RGB_to_RRGGBBaa_BE>());
   ops.emplace_back(std::make_shared<Op_mono_to_YCbCr420>());
   ops.emplace_back(std::make_shared<Op_mono_to_RGB24_32>());
   ops.emplace_back(std::make_shared<Op_RRGGBBaa_swap_endianness>());
+  ops.emplace_back(std::make_shared<Op_RRGGBBaa_swap_endianness_simd>());
   ops.emplace_back(std::make_shared<Op_RRGGBBaa_BE_to_RGB_HDR>());
   ops.emplace_back(std::make_shared<Op_RGB24_32_to_YCbCr>());
   ops.emplace_back(std::make_shared<Op_RGB_to_YCbCr<uint8_t>>());
@@ -240,8 +250,11 @@ void ColorConversionPipeline::init_ops()
   ops.emplace_back(std::make_shared<Op_drop_alpha_plane>());
   ops.emplace_back(std::make_shared<Op_flatten_alpha_plane<uint8_t>>());
   ops.emplace_back(std::make_shared<Op_flatten_alpha_plane<uint16_t>>());
+  ops.emplace_back(std::make_shared<Op_flatten_alpha_RGBA32>());
   ops.emplace_back(std::make_shared<Op_to_hdr_planes>());
+  ops.emplace_back(std::make_shared<Op_to_hdr_planes_simd>());
   ops.emplace_back(std::make_shared<Op_to_sdr_planes>());
+  ops.emplace_back(std::make_shared<Op_to_sdr_planes_simd>());
   ops.emplace_back(std::make_shared<Op_YCbCr420_bilinear_to_YCbCr444<uint8_t>>());
   ops.emplace_back(std::make_shared<Op_YCbCr420_bilinear_to_YCbCr444<uint16_t>>());
   ops.emplace_back(std::make_shared<Op_YCbCr422_bilinear_to_YCbCr444<uint8_t>>());
@@ -254,8 +267,115 @@ void ColorConversionPipeline::init_ops()
 }
 
 
+// --- cache of constructed pipelines
+
+namespace {
+  struct PipelineCacheEntry
+  {
+    ColorState input_state;
+    ColorState target_state;
+    heif_color_conversion_options options;
+    heif_color_conversion_options_ext options_ext;
+
+    std::shared_ptr<const ColorConversionPipeline> pipeline; // NULL if there is no pipeline for this conversion
+  };
+
+  // Note: ColorState::operator==() ignores some nclx parameters, but the cache key has to match exactly.
+  bool states_identical(const ColorState& a, const ColorState& b)
+  {
+    return (a.colorspace == b.colorspace &&
+            a.chroma == b.chroma &&
+            a.has_alpha == b.has_alpha &&
+            a.bits_per_pixel == b.bits_per_pixel &&
+            a.nclx == b.nclx);
+  }
+
+  bool options_identical(const heif_color_conversion_options& a, const heif_color_conversion_options& b)
+  {
+    return (a.preferred_chroma_downsampling_algorithm == b.preferred_chroma_downsampling_algorithm &&
+            a.preferred_chroma_upsampling_algorithm == b.preferred_chroma_upsampling_algorithm &&
+            a.only_use_preferred_chroma_algorithm == b.only_use_preferred_chroma_algorithm);
+  }
+
+  bool options_identical(const heif_color_conversion_options_ext& a, const heif_color_conversion_options_ext& b)
+  {
+    return (a.alpha_composition_mode == b.alpha_composition_mode &&
+            a.background_red == b.background_red &&
+            a.background_green == b.background_green &&
+            a.background_blue == b.background_blue &&
+            a.secondary_background_red == b.secondary_background_red &&
+            a.secondary_background_green == b.secondary_background_green &&
+            a.secondary_background_blue == b.secondary_background_blue &&
+            a.checkerboard_square_size == b.checkerboard_square_size &&
+            a.bit_depth_reduction_mode == b.bit_depth_reduction_mode);
+  }
+
+  const size_t cMaxCachedPipelines = 32;
+
+  // most recently used entry first
+  std::vector<PipelineCacheEntry> pipeline_cache;
+
+#if ENABLE_MULTITHREADING_SUPPORT
+  std::mutex pipeline_cache_mutex;
+#endif
+}
+
+
+std::shared_ptr<const ColorConversionPipeline>
+ColorConversionPipeline::get_pipeline(const ColorState& input_state,
+                                      const ColorState& target_state,
+                                      const heif_color_conversion_options& options,
+                                      const heif_color_conversion_options_ext& options_ext)
+{
+  {
+#if ENABLE_MULTITHREADING_SUPPORT
+    std::lock_guard<std::mutex> lock(pipeline_cache_mutex);
+#endif
+
+    for (size_t i = 0; i < pipeline_cache.size(); i++) {
+      const PipelineCacheEntry& entry = pipeline_cache[i];
+      if (states_identical(entry.input_state, input_state) &&
+          states_identical(entry.target_state, target_state) &&
+          options_identical(entry.options, options) &&
+          options_identical(entry.options_ext, options_ext)) {
+        std::rotate(pipeline_cache.begin(), pipeline_cache.begin() + i, pipeline_cache.begin() + i + 1);
+        return pipeline_cache.front().pipeline;
+      }
+    }
+  }
+
+  // The pipeline search is done without holding the lock. If two threads search the same
+  // pipeline concurrently, both will insert it, but this does no harm.
+
+  auto pipeline = std::make_shared<ColorConversionPipeline>();
+  if (!pipeline->construct_pipeline(input_state, target_state, options, options_ext)) {
+    pipeline.reset();
+  }
+
+  PipelineCacheEntry entry{input_state, target_state, options, options_ext, pipeline};
+
+#if ENABLE_MULTITHREADING_SUPPORT
+  std::lock_guard<std::mutex> lock(pipeline_cache_mutex);
+#endif
+
+  pipeline_cache.insert(pipeline_cache.begin(), std::move(entry));
+  if (pipeline_cache.size() > cMaxCachedPipelines) {
+    pipeline_cache.pop_back();
+  }
+
+  return pipeline;
+}
+
+
 void ColorConversionPipeline::release_ops()
 {
+  {
+#if ENABLE_MULTITHREADING_SUPPORT
+    std::lock_guard<std::mutex> lock(pipeline_cache_mutex);
+#endif
+    pipeline_cache.clear();
+  }
+
   m_operation_pool.clear();
 }
 
@@ -419,77 +539,123 @@ bool ColorConversionPipeline::construct_pipeline(const ColorState& input_state,
 }
 
 
+std::string ColorConversionPipeline::get_operation_name(const ColorConversionOperation& op)
+{
+  const char* name = typeid(op).name();
+
+#if defined(__GNUC__) || defined(__clang__)
+  int status = 0;
+  char* demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+  if (status == 0 && demangled) {
+    std::string result = demangled;
+    free(demangled);
+    return result;
+  }
+#endif
+
+  return name;
+}
+
+
+std::string ColorConversionPipeline::get_step_name(size_t step) const
+{
+  assert(step < m_conversion_steps.size());
+  return get_operation_name(*m_conversion_steps[step].operation);
+}
+
+
 std::string ColorConversionPipeline::debug_dump_pipeline() const
 {
   std::ostringstream ostr;
   ostr << "final pipeline has " << m_conversion_steps.size() << " steps:\n";
-  for (const auto& step : m_conversion_steps) {
-    auto& op = *step.operation;
-    ostr << "> " << typeid(op).name() << "\n";
+  for (size_t i = 0; i < m_conversion_steps.size(); i++) {
+    ostr << "> " << get_step_name(i) << "\n";
   }
   return ostr.str();
 }
 
 
-Result<std::shared_ptr<HeifPixelImage>> ColorConversionPipeline::convert_image(const std::shared_ptr<HeifPixelImage>& input,
-                                                                               const heif_security_limits* limits)
+Result<std::shared_ptr<HeifPixelImage>> ColorConversionPipeline::convert_step(size_t step_idx,
+                                                                              const std::shared_ptr<HeifPixelImage>& in,
+                                                                              const heif_security_limits* limits) const
 {
-  std::shared_ptr<HeifPixelImage> in = input;
-  std::shared_ptr<HeifPixelImage> out = in;
-
-  for (const auto& step : m_conversion_steps) {
+  assert(step_idx < m_conversion_steps.size());
+  const ConversionStep& step = m_conversion_steps[step_idx];
 
 #if DEBUG_ME
-    std::cerr << "input spec: ";
-    print_spec(std::cerr, in);
+  std::cerr << "input spec: ";
+  print_spec(std::cerr, in);
 #endif
 
-    auto outResult = step.operation->convert_colorspace(in, step.input_state, step.output_state, m_options, m_options_ext, limits);
-    if (!outResult) {
-      return outResult.error();
-    }
-    else {
-      out = *outResult;
-    }
+  auto outResult = step.operation->convert_colorspace(in, step.input_state, step.output_state, m_options, m_options_ext, limits);
+  if (!outResult) {
+    return outResult.error();
+  }
 
-    // --- pass the color profiles to the new image
+  std::shared_ptr<HeifPixelImage> out = *outResult;
 
-    out->set_color_profile_nclx(step.output_state.nclx);
-    out->set_color_profile_icc(in->get_color_profile_icc());
+  // --- pass the color profiles to the new image
 
-    out->set_premultiplied_alpha(in->is_premultiplied_alpha());
+  out->set_color_profile_nclx(step.output_state.nclx);
+  out->set_color_profile_icc(in->get_color_profile_icc());
 
-    // pass through HDR information
-    if (in->has_clli()) {
-      out->set_clli(in->get_clli());
-    }
+  out->set_premultiplied_alpha(in->is_premultiplied_alpha());
 
-    if (in->has_mdcv()) {
-      out->set_mdcv(in->get_mdcv());
-    }
+  // pass through HDR information
+  if (in->has_clli()) {
+    out->set_clli(in->get_clli());
+  }
 
-    if (in->has_nonsquare_pixel_ratio()) {
-      uint32_t h, v;
-      in->get_pixel_ratio(&h, &v);
-      out->set_pixel_ratio(h, v);
-    }
+  if (in->has_mdcv()) {
+    out->set_mdcv(in->get_mdcv());
+  }
+
+  if (in->has_nonsquare_pixel_ratio()) {
+    uint32_t h, v;
+    in->get_pixel_ratio(&h, &v);
+    out->set_pixel_ratio(h, v);
+  }
+
+  if (in->has_gimi_sample_content_id()) {
+    out->set_gimi_sample_content_id(in->get_gimi_sample_content_id());
+  }
+
+  if (auto* tai = in->get_tai_timestamp()) {
+    out->set_tai_timestamp(tai);
+  }
+
+  out->set_sample_duration(in->get_sample_duration());
+
+  const auto& warnings = in->get_warnings();
+  for (const auto& warning : warnings) {
+    out->add_warning(warning);
+  }
+
+  return out;
+}
 
-    if (in->has_gimi_sample_content_id()) {
-      out->set_gimi_sample_content_id(in->get_gimi_sample_content_id());
-    }
 
-    if (auto* tai = in->get_tai_timestamp()) {
-      out->set_tai_timestamp(tai);
+Result<std::shared_ptr<HeifPixelImage>> ColorConversionPipeline::convert_image(const std::shared_ptr<HeifPixelImage>& input,
+                                                                               const heif_security_limits* limits) const
+{
+  if (current_trace()) {
+    std::string steps;
+    for (size_t i = 0; i < m_conversion_steps.size(); i++) {
+      steps += get_step_name(i);
+      steps += '\n';
     }
+    trace_conversion_pipeline(steps);
+  }
 
-    out->set_sample_duration(in->get_sample_duration());
+  std::shared_ptr<HeifPixelImage> out = input;
 
-    const auto& warnings = in->get_warnings();
-    for (const auto& warning : warnings) {
-      out->add_warning(warning);
+  for (size_t i = 0; i < m_conversion_steps.size(); i++) {
+    auto outResult = convert_step(i, out, limits);
+    if (!outResult) {
+      return outResult.error();
     }
 
-    in = out;
+    out = *outResult;
   }
 
   return out;
@@ -505,6 +671,8 @@ Result<std::shared_ptr<HeifPixelImage>> convert_colorspace(const std::shared_ptr
                                                            const heif_color_conversion_options_ext* options_ext_optional,
                                                            const heif_security_limits* limits)
 {
+  TraceScope trace_scope(TraceStage::color_conversion);
+
   std::unique_ptr<heif_color_conversion_options_ext, void(*)(heif_color_conversion_options_ext*)>
       options_ext(heif_color_conversion_options_ext_alloc(), heif_color_conversion_options_ext_free);
 
@@ -609,18 +777,17 @@ Result<std::shared_ptr<HeifPixelImage>> convert_colorspace(const std::shared_ptr
     output_state.bits_per_pixel = 10;
   }
 
-  ColorConversionPipeline pipeline;
-  bool success = pipeline.construct_pipeline(input_state, output_state, options, *options_ext);
-  if (!success) {
+  auto pipeline = ColorConversionPipeline::get_pipeline(input_state, output_state, options, *options_ext);
+  if (!pipeline) {
     return Error{heif_error_Unsupported_feature,
                  heif_suberror_Unsupported_color_conversion};
   }
 
-  if (pipeline.is_nop()) {
+  if (pipeline->is_nop()) {
     return input;
   }
   else {
-    return pipeline.convert_image(input, limits);
+    return pipeline->convert_image(input, limits);
   }
 }
 
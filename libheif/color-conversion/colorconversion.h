@@ -110,10 +110,31 @@ public:
                           const heif_color_conversion_options_ext& options_ext);
 
   Result<std::shared_ptr<HeifPixelImage>> convert_image(const std::shared_ptr<HeifPixelImage>& input,
-                                                        const heif_security_limits* limits);
+                                                        const heif_security_limits* limits) const;
+
+  // Returns a shared, already constructed pipeline for this conversion, or NULL if there is none.
+  // The most recently used pipelines are kept in a cache, which saves the pipeline search when
+  // many images of the same format are converted.
+  static std::shared_ptr<const ColorConversionPipeline> get_pipeline(const ColorState& input_state,
+                                                                     const ColorState& target_state,
+                                                                     const heif_color_conversion_options& options,
+                                                                     const heif_color_conversion_options_ext& options_ext);
+
+  // Access to the individual steps, e.g. for benchmarking each operation in isolation.
+  // convert_image() is equivalent to calling convert_step() for all steps in sequence.
+
+  size_t get_number_of_steps() const { return m_conversion_steps.size(); }
+
+  std::string get_step_name(size_t step) const;
+
+  Result<std::shared_ptr<HeifPixelImage>> convert_step(size_t step,
+                                                       const std::shared_ptr<HeifPixelImage>& input,
+                                                       const heif_security_limits* limits) const;
 
   std::string debug_dump_pipeline() const;
 
+  static std::string get_operation_name(const ColorConversionOperation&);
+
 private:
   static std::vector<std::shared_ptr<ColorConversionOperation>> m_operation_pool;
 
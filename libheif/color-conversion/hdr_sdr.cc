@@ -18,8 +18,10 @@
  * along with libheif.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <cassert>
 #include "hdr_sdr.h"
+#include "simd.h"
 
 
 std::vector<ColorStateWithCost>
@@ -83,9 +85,6 @@ Op_to_hdr_planes::convert_colorspace(const std::shared_ptr<const HeifPixelImage>
       int input_bits = input->get_bits_per_pixel(channel);
       int output_bits = target_state.bits_per_pixel;
 
-      int shift1 = output_bits - input_bits;
-      int shift2 = 2 * input_bits - output_bits;
-
       const uint8_t* p_in;
       size_t stride_in;
       p_in = input->get_plane(channel, &stride_in);
@@ -95,12 +94,9 @@ Op_to_hdr_planes::convert_colorspace(const std::shared_ptr<const HeifPixelImage>
       p_out = (uint16_t*) outimg->get_plane(channel, &stride_out);
       stride_out /= 2;
 
-      for (uint32_t y = 0; y < height; y++)
-        for (uint32_t x = 0; x < width; x++) {
-          int in = p_in[y * stride_in + x];
-          // TODO: support for <8 bpp may need more than two copies of the input bit pattern
-          p_out[y * stride_out + x] = (uint16_t) ((in << shift1) | (in >> shift2));
-        }
+      for (uint32_t y = 0; y < height; y++) {
+        convert_row(p_in + y * stride_in, p_out + y * stride_out, width, input_bits, output_bits);
+      }
     }
   }
 
@@ -108,6 +104,75 @@ Op_to_hdr_planes::convert_colorspace(const std::shared_ptr<const HeifPixelImage>
 }
 
 
+void Op_to_hdr_planes::convert_row(const uint8_t* in, uint16_t* out, uint32_t width, int input_bits, int output_bits) const
+{
+  int shift1 = output_bits - input_bits;
+  int shift2 = 2 * input_bits - output_bits;
+
+  for (uint32_t x = 0; x < width; x++) {
+    // TODO: support for <8 bpp may need more than two copies of the input bit pattern
+    out[x] = (uint16_t) ((in[x] << shift1) | (in[x] >> shift2));
+  }
+}
+
+
+std::vector<ColorStateWithCost>
+Op_to_hdr_planes_simd::state_after_conversion(const ColorState& input_state,
+                                              const ColorState& target_state,
+                                              const heif_color_conversion_options& options,
+                                              const heif_color_conversion_options_ext& options_ext) const
+{
+  if (!simd::available()) {
+    return {};
+  }
+
+  auto states = Op_to_hdr_planes::state_after_conversion(input_state, target_state, options, options_ext);
+  for (auto& state : states) {
+    state.speed_costs = SpeedCosts_OptimizedSoftware;
+  }
+
+  return states;
+}
+
+
+void Op_to_hdr_planes_simd::convert_row(const uint8_t* in, uint16_t* out, uint32_t width, int input_bits, int output_bits) const
+{
+  if (input_bits == 8 && output_bits > 8 && output_bits <= 16) {
+    simd::expand_8_to_16(in, out, width, output_bits);
+  }
+  else {
+    Op_to_hdr_planes::convert_row(in, out, width, input_bits, output_bits);
+  }
+}
+
+
+// Offsets that are added to the four samples x%4 = 0..3 in row 'y' before shifting them down by 'shift' bits.
+static void get_reduction_offsets(heif_bit_depth_reduction_mode mode, int shift, uint32_t y, uint16_t offsets[4])
+{
+  static const uint8_t bayer4x4[4][4] = {
+      {0,  8,  2,  10},
+      {12, 4,  14, 6},
+      {3,  11, 1,  9},
+      {15, 7,  13, 5}
+  };
+
+  for (int x = 0; x < 4; x++) {
+    switch (mode) {
+      case heif_bit_depth_reduction_mode_round:
+        offsets[x] = (uint16_t) (1 << (shift - 1));
+        break;
+      case heif_bit_depth_reduction_mode_dither:
+        // threshold (t + 1/2) / 16 of the dropped bits
+        offsets[x] = (uint16_t) (((2 * bayer4x4[y % 4][x] + 1) << shift) >> 5);
+        break;
+      default:
+        offsets[x] = 0;
+        break;
+    }
+  }
+}
+
+
 std::vector<ColorStateWithCost>
 Op_to_sdr_planes::state_after_conversion(const ColorState& input_state,
                                          const ColorState& target_state,
@@ -157,6 +222,8 @@ Op_to_sdr_planes::convert_colorspace(const std::shared_ptr<const HeifPixelImage>
                  input->get_colorspace(),
                  input->get_chroma_format());
 
+  heif_bit_depth_reduction_mode mode = options_ext.bit_depth_reduction_mode;
+
   for (heif_channel channel : {heif_channel_Y,
                                heif_channel_Cb,
                                heif_channel_Cr,
@@ -185,11 +252,12 @@ Op_to_sdr_planes::convert_colorspace(const std::shared_ptr<const HeifPixelImage>
         size_t stride_out;
         p_out = outimg->get_plane(channel, &stride_out);
 
-        for (uint32_t y = 0; y < height; y++)
-          for (uint32_t x = 0; x < width; x++) {
-            int in = p_in[y * stride_in + x];
-            p_out[y * stride_out + x] = (uint8_t) (in >> shift); // TODO: I think no rounding here, but am not sure.
-          }
+        for (uint32_t y = 0; y < height; y++) {
+          uint16_t offsets[4];
+          get_reduction_offsets(mode, shift, y, offsets);
+
+          convert_row(p_in + y * stride_in, p_out + y * stride_out, width, input_bits, offsets);
+        }
       } else if (input_bits < 8) {
         uint32_t width = input->get_width(channel);
         uint32_t height = input->get_height(channel);
@@ -241,3 +309,44 @@ Op_to_sdr_planes::convert_colorspace(const std::shared_ptr<const HeifPixelImage>
   return outimg;
 }
 
+
+
+void Op_to_sdr_planes::convert_row(const uint16_t* in, uint8_t* out, uint32_t width, int input_bits, const uint16_t offsets[4]) const
+{
+  int shift = input_bits - 8;
+
+  for (uint32_t x = 0; x < width; x++) {
+    int v = std::min(in[x] + offsets[x % 4], 0xFFFF);
+    out[x] = (uint8_t) std::min(255, v >> shift);
+  }
+}
+
+
+std::vector<ColorStateWithCost>
+Op_to_sdr_planes_simd::state_after_conversion(const ColorState& input_state,
+                                              const ColorState& target_state,
+                                              const heif_color_conversion_options& options,
+                                              const heif_color_conversion_options_ext& options_ext) const
+{
+  if (!simd::available()) {
+    return {};
+  }
+
+  auto states = Op_to_sdr_planes::state_after_conversion(input_state, target_state, options, options_ext);
+  for (auto& state : states) {
+    state.speed_costs = SpeedCosts_OptimizedSoftware;
+  }
+
+  return states;
+}
+
+
+void Op_to_sdr_planes_simd::convert_row(const uint16_t* in, uint8_t* out, uint32_t width, int input_bits, const uint16_t offsets[4]) const
+{
+  if (input_bits <= 16) {
+    simd::reduce_16_to_8(in, out, width, input_bits, offsets);
+  }
+  else {
+    Op_to_sdr_planes::convert_row(in, out, width, input_bits, offsets);
+  }
+}
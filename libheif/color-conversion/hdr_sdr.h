@@ -42,6 +42,23 @@ public:
                      const heif_color_conversion_options& options,
                      const heif_color_conversion_options_ext& options_ext,
                      const heif_security_limits* limits) const override;
+
+protected:
+  virtual void convert_row(const uint8_t* in, uint16_t* out, uint32_t width, int input_bits, int output_bits) const;
+};
+
+
+class Op_to_hdr_planes_simd : public Op_to_hdr_planes
+{
+public:
+  std::vector<ColorStateWithCost>
+  state_after_conversion(const ColorState& input_state,
+                         const ColorState& target_state,
+                         const heif_color_conversion_options& options,
+                         const heif_color_conversion_options_ext& options_ext) const override;
+
+protected:
+  void convert_row(const uint8_t* in, uint16_t* out, uint32_t width, int input_bits, int output_bits) const override;
 };
 
 
@@ -61,6 +78,25 @@ public:
                      const heif_color_conversion_options& options,
                      const heif_color_conversion_options_ext& options_ext,
                      const heif_security_limits* limits) const override;
+
+protected:
+  // out[x] = min(255, (in[x] + offsets[x % 4]) >> (input_bits - 8))
+  // The offsets implement the rounding or dithering of the heif_bit_depth_reduction_mode.
+  virtual void convert_row(const uint16_t* in, uint8_t* out, uint32_t width, int input_bits, const uint16_t offsets[4]) const;
+};
+
+
+class Op_to_sdr_planes_simd : public Op_to_sdr_planes
+{
+public:
+  std::vector<ColorStateWithCost>
+  state_after_conversion(const ColorState& input_state,
+                         const ColorState& target_state,
+                         const heif_color_conversion_options& options,
+                         const heif_color_conversion_options_ext& options_ext) const override;
+
+protected:
+  void convert_row(const uint16_t* in, uint8_t* out, uint32_t width, int input_bits, const uint16_t offsets[4]) const override;
 };
 
 #endif //LIBHEIF_COLORCONVERSION_HDR_SDR_H
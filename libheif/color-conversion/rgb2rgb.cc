@@ -23,6 +23,7 @@
 #include <memory>
 #include <vector>
 #include "rgb2rgb.h"
+#include "simd.h"
 
 
 std::vector<ColorStateWithCost>
@@ -257,30 +258,67 @@ Op_RGB_HDR_to_RRGGBBaa_BE::convert_colorspace(const std::shared_ptr<const HeifPi
   in_b_stride /= 2;
   in_a_stride /= 2;
 
+  auto alpha_max = static_cast<uint16_t>((1 << bpp) - 1);
+  for (uint32_t y = 0; y < height; y++) {
+    convert_row(in_r + y * in_r_stride,
+                in_g + y * in_g_stride,
+                in_b + y * in_b_stride,
+                input_has_alpha ? in_a + y * in_a_stride : nullptr,
+                output_has_alpha, alpha_max,
+                out_p + y * out_p_stride, width);
+  }
+
+  return outimg;
+}
+
+
+void Op_RGB_HDR_to_RRGGBBaa_BE::convert_row(const uint16_t* in_r, const uint16_t* in_g, const uint16_t* in_b, const uint16_t* in_a,
+                                            bool output_has_alpha, uint16_t alpha_value, uint8_t* out_p, uint32_t width) const
+{
   const int pixelsize = (output_has_alpha ? 8 : 6);
 
-  uint32_t x, y;
-  auto alpha_max = static_cast<uint16_t>((1 << bpp) - 1);
-  for (y = 0; y < height; y++) {
-    for (x = 0; x < width; x++) {
-      uint16_t r = in_r[x + y * in_r_stride];
-      uint16_t g = in_g[x + y * in_g_stride];
-      uint16_t b = in_b[x + y * in_b_stride];
-      out_p[y * out_p_stride + pixelsize * x + 0] = (uint8_t)(r >> 8);
-      out_p[y * out_p_stride + pixelsize * x + 1] = (uint8_t)(r & 0xFF);
-      out_p[y * out_p_stride + pixelsize * x + 2] = (uint8_t)(g >> 8);
-      out_p[y * out_p_stride + pixelsize * x + 3] = (uint8_t)(g & 0xFF);
-      out_p[y * out_p_stride + pixelsize * x + 4] = (uint8_t)(b >> 8);
-      out_p[y * out_p_stride + pixelsize * x + 5] = (uint8_t)(b & 0xFF);
-      if (output_has_alpha) {
-        uint16_t a = input_has_alpha ? in_a[x + y * in_a_stride] : alpha_max;
-        out_p[y * out_p_stride + pixelsize * x + 6] = (uint8_t)(a >> 8);
-        out_p[y * out_p_stride + pixelsize * x + 7] = (uint8_t)(a & 0xFF);
-      }
+  for (uint32_t x = 0; x < width; x++) {
+    uint16_t r = in_r[x];
+    uint16_t g = in_g[x];
+    uint16_t b = in_b[x];
+    out_p[pixelsize * x + 0] = (uint8_t)(r >> 8);
+    out_p[pixelsize * x + 1] = (uint8_t)(r & 0xFF);
+    out_p[pixelsize * x + 2] = (uint8_t)(g >> 8);
+    out_p[pixelsize * x + 3] = (uint8_t)(g & 0xFF);
+    out_p[pixelsize * x + 4] = (uint8_t)(b >> 8);
+    out_p[pixelsize * x + 5] = (uint8_t)(b & 0xFF);
+    if (output_has_alpha) {
+      uint16_t a = in_a ? in_a[x] : alpha_value;
+      out_p[pixelsize * x + 6] = (uint8_t)(a >> 8);
+      out_p[pixelsize * x + 7] = (uint8_t)(a & 0xFF);
     }
   }
+}
 
-  return outimg;
+
+std::vector<ColorStateWithCost>
+Op_RGB_HDR_to_RRGGBBaa_BE_simd::state_after_conversion(const ColorState& input_state,
+                                                       const ColorState& target_state,
+                                                       const heif_color_conversion_options& options,
+                                                       const heif_color_conversion_options_ext& options_ext) const
+{
+  if (!simd::available()) {
+    return {};
+  }
+
+  auto states = Op_RGB_HDR_to_RRGGBBaa_BE::state_after_conversion(input_state, target_state, options, options_ext);
+  for (auto& state : states) {
+    state.speed_costs = SpeedCosts_OptimizedSoftware;
+  }
+
+  return states;
+}
+
+
+void Op_RGB_HDR_to_RRGGBBaa_BE_simd::convert_row(const uint16_t* r, const uint16_t* g, const uint16_t* b, const uint16_t* a,
+                                                 bool output_alpha, uint16_t alpha_value, uint8_t* out, uint32_t width) const
+{
+  simd::interleave_16_BE(r, g, b, a, output_alpha, alpha_value, out, width);
 }
 
 
@@ -738,13 +776,43 @@ Op_RRGGBBaa_swap_endianness::convert_colorspace(const std::shared_ptr<const Heif
 
   size_t n_bytes = std::min(in_p_stride, out_p_stride);
 
-  uint32_t x, y;
-  for (y = 0; y < height; y++) {
-    for (x = 0; x < n_bytes; x += 2) {
-      out_p[y * out_p_stride + x + 0] = in_p[y * in_p_stride + x + 1];
-      out_p[y * out_p_stride + x + 1] = in_p[y * in_p_stride + x + 0];
-    }
+  for (uint32_t y = 0; y < height; y++) {
+    swap_row(in_p + y * in_p_stride, out_p + y * out_p_stride, n_bytes);
   }
 
   return outimg;
 }
+
+
+void Op_RRGGBBaa_swap_endianness::swap_row(const uint8_t* in_p, uint8_t* out_p, size_t n_bytes) const
+{
+  for (size_t x = 0; x < n_bytes; x += 2) {
+    out_p[x + 0] = in_p[x + 1];
+    out_p[x + 1] = in_p[x + 0];
+  }
+}
+
+
+std::vector<ColorStateWithCost>
+Op_RRGGBBaa_swap_endianness_simd::state_after_conversion(const ColorState& input_state,
+                                                         const ColorState& target_state,
+                                                         const heif_color_conversion_options& options,
+                                                         const heif_color_conversion_options_ext& options_ext) const
+{
+  if (!simd::available()) {
+    return {};
+  }
+
+  auto states = Op_RRGGBBaa_swap_endianness::state_after_conversion(input_state, target_state, options, options_ext);
+  for (auto& state : states) {
+    state.speed_costs = SpeedCosts_OptimizedSoftware;
+  }
+
+  return states;
+}
+
+
+void Op_RRGGBBaa_swap_endianness_simd::swap_row(const uint8_t* in, uint8_t* out, size_t n_bytes) const
+{
+  simd::swap_bytes_16(in, out, n_bytes & ~size_t{1});
+}
@@ -61,6 +61,26 @@ public:
                      const heif_color_conversion_options& options,
                      const heif_color_conversion_options_ext& options_ext,
                      const heif_security_limits* limits) const override;
+
+protected:
+  // If 'a' is NULL, the alpha samples are filled with 'alpha_value'.
+  virtual void convert_row(const uint16_t* r, const uint16_t* g, const uint16_t* b, const uint16_t* a,
+                           bool output_alpha, uint16_t alpha_value, uint8_t* out, uint32_t width) const;
+};
+
+
+class Op_RGB_HDR_to_RRGGBBaa_BE_simd : public Op_RGB_HDR_to_RRGGBBaa_BE
+{
+public:
+  std::vector<ColorStateWithCost>
+  state_after_conversion(const ColorState& input_state,
+                         const ColorState& target_state,
+                         const heif_color_conversion_options& options,
+                         const heif_color_conversion_options_ext& options_ext) const override;
+
+protected:
+  void convert_row(const uint16_t* r, const uint16_t* g, const uint16_t* b, const uint16_t* a,
+                   bool output_alpha, uint16_t alpha_value, uint8_t* out, uint32_t width) const override;
 };
 
 
@@ -137,6 +157,23 @@ public:
                      const heif_color_conversion_options& options,
                      const heif_color_conversion_options_ext& options_ext,
                      const heif_security_limits* limits) const override;
+
+protected:
+  virtual void swap_row(const uint8_t* in, uint8_t* out, size_t n_bytes) const;
+};
+
+
+class Op_RRGGBBaa_swap_endianness_simd : public Op_RRGGBBaa_swap_endianness
+{
+public:
+  std::vector<ColorStateWithCost>
+  state_after_conversion(const ColorState& input_state,
+                         const ColorState& target_state,
+                         const heif_color_conversion_options& options,
+                         const heif_color_conversion_options_ext& options_ext) const override;
+
+protected:
+  void swap_row(const uint8_t* in, uint8_t* out, size_t n_bytes) const override;
 };
 
 
@@ -0,0 +1,457 @@
+/*
+ * HEIF codec.
+ * Copyright (c) 2025 Dirk Farin <dirk.farin@gmail.com>
+ *
+ * This file is part of libheif.
+ *
+ * libheif is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * libheif is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libheif.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "simd.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HAVE_SIMD_SSE2 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#define HAVE_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+
+// --- scalar code for the remaining samples at the end of a row
+
+static inline void expand_8_to_16_scalar(const uint8_t* in, uint16_t* out, uint32_t x, uint32_t n, int output_bits)
+{
+  int shift1 = output_bits - 8;
+  int shift2 = 16 - output_bits;
+
+  for (; x < n; x++) {
+    out[x] = (uint16_t) ((in[x] << shift1) | (in[x] >> shift2));
+  }
+}
+
+
+static inline void reduce_16_to_8_scalar(const uint16_t* in, uint8_t* out, uint32_t x, uint32_t n, int input_bits,
+                                         const uint16_t offsets[4])
+{
+  int shift = input_bits - 8;
+
+  for (; x < n; x++) {
+    out[x] = (uint8_t) std::min(255, (std::min(in[x] + offsets[x % 4], 0xFFFF)) >> shift);
+  }
+}
+
+
+static inline void swap_bytes_16_scalar(const uint8_t* in, uint8_t* out, size_t x, size_t n_bytes)
+{
+  for (; x < n_bytes; x += 2) {
+    out[x + 0] = in[x + 1];
+    out[x + 1] = in[x + 0];
+  }
+}
+
+
+static inline void interleave_16_BE_scalar(const uint16_t* r, const uint16_t* g, const uint16_t* b, const uint16_t* a,
+                                           bool output_alpha, uint16_t alpha_value, uint8_t* out, uint32_t x, uint32_t n)
+{
+  const int pixelsize = (output_alpha ? 8 : 6);
+
+  for (; x < n; x++) {
+    uint8_t* p = out + pixelsize * x;
+    p[0] = (uint8_t) (r[x] >> 8);
+    p[1] = (uint8_t) (r[x] & 0xFF);
+    p[2] = (uint8_t) (g[x] >> 8);
+    p[3] = (uint8_t) (g[x] & 0xFF);
+    p[4] = (uint8_t) (b[x] >> 8);
+    p[5] = (uint8_t) (b[x] & 0xFF);
+    if (output_alpha) {
+      uint16_t alpha = a ? a[x] : alpha_value;
+      p[6] = (uint8_t) (alpha >> 8);
+      p[7] = (uint8_t) (alpha & 0xFF);
+    }
+  }
+}
+
+
+static inline void upsample_2x_bilinear_16_scalar(const int16_t* in, int16_t* out, uint32_t k, uint32_t n)
+{
+  for (; k < n; k++) {
+    out[2 * k + 0] = (int16_t) ((3 * in[k] + in[k + 1] + 8) >> 4);
+    out[2 * k + 1] = (int16_t) ((in[k] + 3 * in[k + 1] + 8) >> 4);
+  }
+}
+
+
+static inline uint8_t clip_u8(int v)
+{
+  return (uint8_t) std::min(255, std::max(0, v));
+}
+
+
+static inline void ycbcr_to_rgb_8_scalar(const uint8_t* y, const int16_t* cb, const int16_t* cr, const uint8_t* a,
+                                         const simd::YCbCr_to_RGB_matrix& m, bool output_alpha,
+                                         uint8_t* out, uint32_t x, uint32_t n)
+{
+  const int pixelsize = (output_alpha ? 4 : 3);
+
+  for (; x < n; x++) {
+    int yv = m.y_mul * y[x] + m.y_add;
+    int cbv = cb[x] - 128;
+    int crv = cr[x] - 128;
+
+    uint8_t* p = out + pixelsize * x;
+    p[0] = clip_u8((yv + m.r_cr * crv) >> 8);
+    p[1] = clip_u8((yv + m.g_cb * cbv + m.g_cr * crv) >> 8);
+    p[2] = clip_u8((yv + m.b_cb * cbv) >> 8);
+    if (output_alpha) {
+      p[3] = a ? a[x] : 0xFF;
+    }
+  }
+}
+
+
+#if HAVE_SIMD_SSE2
+
+static inline __m128i swap_bytes_epi16(__m128i v)
+{
+  return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+#endif
+
+
+bool simd::available()
+{
+#if HAVE_SIMD_SSE2 || HAVE_SIMD_NEON
+  return true;
+#else
+  return false;
+#endif
+}
+
+
+void simd::expand_8_to_16(const uint8_t* in, uint16_t* out, uint32_t n, int output_bits)
+{
+  assert(output_bits > 8 && output_bits <= 16);
+
+  uint32_t x = 0;
+
+#if HAVE_SIMD_SSE2
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i shift1 = _mm_cvtsi32_si128(output_bits - 8);
+  const __m128i shift2 = _mm_cvtsi32_si128(16 - output_bits);
+
+  for (; x + 16 <= n; x += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i*) (in + x));
+    __m128i lo = _mm_unpacklo_epi8(v, zero);
+    __m128i hi = _mm_unpackhi_epi8(v, zero);
+
+    lo = _mm_or_si128(_mm_sll_epi16(lo, shift1), _mm_srl_epi16(lo, shift2));
+    hi = _mm_or_si128(_mm_sll_epi16(hi, shift1), _mm_srl_epi16(hi, shift2));
+
+    _mm_storeu_si128((__m128i*) (out + x), lo);
+    _mm_storeu_si128((__m128i*) (out + x + 8), hi);
+  }
+#elif HAVE_SIMD_NEON
+  const int16x8_t shift1 = vdupq_n_s16((int16_t) (output_bits - 8));
+  const int16x8_t shift2 = vdupq_n_s16((int16_t) -(16 - output_bits));
+
+  for (; x + 16 <= n; x += 16) {
+    uint8x16_t v = vld1q_u8(in + x);
+    uint16x8_t lo = vmovl_u8(vget_low_u8(v));
+    uint16x8_t hi = vmovl_u8(vget_high_u8(v));
+
+    lo = vorrq_u16(vshlq_u16(lo, shift1), vshlq_u16(lo, shift2));
+    hi = vorrq_u16(vshlq_u16(hi, shift1), vshlq_u16(hi, shift2));
+
+    vst1q_u16(out + x, lo);
+    vst1q_u16(out + x + 8, hi);
+  }
+#endif
+
+  expand_8_to_16_scalar(in, out, x, n, output_bits);
+}
+
+
+void simd::reduce_16_to_8(const uint16_t* in, uint8_t* out, uint32_t n, int input_bits, const uint16_t offsets[4])
+{
+  assert(input_bits > 8 && input_bits <= 16);
+
+  uint32_t x = 0;
+
+  // The offset pattern repeats every 4 samples, hence it is identical for all vectors of 8 samples.
+  // Since input_bits > 8, the shifted values fit into the positive int16 range expected by the saturating pack.
+
+#if HAVE_SIMD_SSE2
+  const __m128i shift = _mm_cvtsi32_si128(input_bits - 8);
+  const __m128i offset = _mm_setr_epi16((short) offsets[0], (short) offsets[1], (short) offsets[2], (short) offsets[3],
+                                        (short) offsets[0], (short) offsets[1], (short) offsets[2], (short) offsets[3]);
+
+  for (; x + 16 <= n; x += 16) {
+    __m128i a = _mm_loadu_si128((const __m128i*) (in + x));
+    __m128i b = _mm_loadu_si128((const __m128i*) (in + x + 8));
+
+    a = _mm_srl_epi16(_mm_adds_epu16(a, offset), shift);
+    b = _mm_srl_epi16(_mm_adds_epu16(b, offset), shift);
+
+    _mm_storeu_si128((__m128i*) (out + x), _mm_packus_epi16(a, b));
+  }
+#elif HAVE_SIMD_NEON
+  const int16x8_t shift = vdupq_n_s16((int16_t) -(input_bits - 8));
+  const uint16x4_t offset4 = vld1_u16(offsets);
+  const uint16x8_t offset = vcombine_u16(offset4, offset4);
+
+  for (; x + 16 <= n; x += 16) {
+    uint16x8_t a = vld1q_u16(in + x);
+    uint16x8_t b = vld1q_u16(in + x + 8);
+
+    a = vshlq_u16(vqaddq_u16(a, offset), shift);
+    b = vshlq_u16(vqaddq_u16(b, offset), shift);
+
+    vst1q_u8(out + x, vcombine_u8(vqmovn_u16(a), vqmovn_u16(b)));
+  }
+#endif
+
+  reduce_16_to_8_scalar(in, out, x, n, input_bits, offsets);
+}
+
+
+void simd::swap_bytes_16(const uint8_t* in, uint8_t* out, size_t n_bytes)
+{
+  assert(n_bytes % 2 == 0);
+
+  size_t x = 0;
+
+#if HAVE_SIMD_SSE2
+  for (; x + 16 <= n_bytes; x += 16) {
+    __m128i v = _mm_loadu_si128((const __m128i*) (in + x));
+    _mm_storeu_si128((__m128i*) (out + x), swap_bytes_epi16(v));
+  }
+#elif HAVE_SIMD_NEON
+  for (; x + 16 <= n_bytes; x += 16) {
+    vst1q_u8(out + x, vrev16q_u8(vld1q_u8(in + x)));
+  }
+#endif
+
+  swap_bytes_16_scalar(in, out, x, n_bytes);
+}
+
+
+void simd::interleave_16_BE(const uint16_t* r, const uint16_t* g, const uint16_t* b, const uint16_t* a,
+                            bool output_alpha, uint16_t alpha_value, uint8_t* out, uint32_t n)
+{
+  uint32_t x = 0;
+
+#if HAVE_SIMD_SSE2
+  const __m128i alpha = _mm_set1_epi16((short) alpha_value);
+
+  // Without alpha, each pixel is written as 8 bytes, of which the last two are overwritten by the next pixel.
+  // Thus, at least one pixel is left for the scalar code to stay within the row.
+  const uint32_t vector_end = (output_alpha ? n : (n > 0 ? n - 1 : 0));
+
+  for (; x + 8 <= vector_end; x += 8) {
+    __m128i vr = swap_bytes_epi16(_mm_loadu_si128((const __m128i*) (r + x)));
+    __m128i vg = swap_bytes_epi16(_mm_loadu_si128((const __m128i*) (g + x)));
+    __m128i vb = swap_bytes_epi16(_mm_loadu_si128((const __m128i*) (b + x)));
+    __m128i va = swap_bytes_epi16(a ? _mm_loadu_si128((const __m128i*) (a + x)) : alpha);
+
+    __m128i rg_lo = _mm_unpacklo_epi16(vr, vg);
+    __m128i rg_hi = _mm_unpackhi_epi16(vr, vg);
+    __m128i ba_lo = _mm_unpacklo_epi16(vb, va);
+    __m128i ba_hi = _mm_unpackhi_epi16(vb, va);
+
+    __m128i pixels[4] = {
+        _mm_unpacklo_epi32(rg_lo, ba_lo),
+        _mm_unpackhi_epi32(rg_lo, ba_lo),
+        _mm_unpacklo_epi32(rg_hi, ba_hi),
+        _mm_unpackhi_epi32(rg_hi, ba_hi)
+    };
+
+    if (output_alpha) {
+      for (int i = 0; i < 4; i++) {
+        _mm_storeu_si128((__m128i*) (out + 8 * x + 16 * i), pixels[i]);
+      }
+    }
+    else {
+      for (int i = 0; i < 4; i++) {
+        _mm_storel_epi64((__m128i*) (out + 6 * (x + 2 * i)), pixels[i]);
+        _mm_storel_epi64((__m128i*) (out + 6 * (x + 2 * i + 1)), _mm_srli_si128(pixels[i], 8));
+      }
+    }
+  }
+#elif HAVE_SIMD_NEON
+  const uint16x8_t alpha = vdupq_n_u16(alpha_value);
+
+  auto swap = [](uint16x8_t v) { return vreinterpretq_u16_u8(vrev16q_u8(vreinterpretq_u8_u16(v))); };
+
+  for (; x + 8 <= n; x += 8) {
+    uint16x8_t vr = swap(vld1q_u16(r + x));
+    uint16x8_t vg = swap(vld1q_u16(g + x));
+    uint16x8_t vb = swap(vld1q_u16(b + x));
+
+    if (output_alpha) {
+      uint16x8x4_t v{{vr, vg, vb, swap(a ? vld1q_u16(a + x) : alpha)}};
+      vst4q_u16((uint16_t*) (out + 8 * x), v);
+    }
+    else {
+      uint16x8x3_t v{{vr, vg, vb}};
+      vst3q_u16((uint16_t*) (out + 6 * x), v);
+    }
+  }
+#endif
+
+  interleave_16_BE_scalar(r, g, b, a, output_alpha, alpha_value, out, x, n);
+}
+
+
+void simd::upsample_2x_bilinear_16(const int16_t* in, int16_t* out, uint32_t n)
+{
+  uint32_t k = 0;
+
+  // The inputs are at most 4 * 255, hence the weighted sums fit into int16.
+
+#if HAVE_SIMD_SSE2
+  const __m128i rounding = _mm_set1_epi16(8);
+
+  for (; k + 8 <= n; k += 8) {
+    __m128i v0 = _mm_loadu_si128((const __m128i*) (in + k));
+    __m128i v1 = _mm_loadu_si128((const __m128i*) (in + k + 1));
+
+    __m128i sum = _mm_add_epi16(_mm_add_epi16(v0, v1), rounding);
+    __m128i even = _mm_srai_epi16(_mm_add_epi16(sum, _mm_add_epi16(v0, v0)), 4);
+    __m128i odd = _mm_srai_epi16(_mm_add_epi16(sum, _mm_add_epi16(v1, v1)), 4);
+
+    _mm_storeu_si128((__m128i*) (out + 2 * k), _mm_unpacklo_epi16(even, odd));
+    _mm_storeu_si128((__m128i*) (out + 2 * k + 8), _mm_unpackhi_epi16(even, odd));
+  }
+#elif HAVE_SIMD_NEON
+  const int16x8_t rounding = vdupq_n_s16(8);
+
+  for (; k + 8 <= n; k += 8) {
+    int16x8_t v0 = vld1q_s16(in + k);
+    int16x8_t v1 = vld1q_s16(in + k + 1);
+
+    int16x8_t sum = vaddq_s16(vaddq_s16(v0, v1), rounding);
+
+    int16x8x2_t v;
+    v.val[0] = vshrq_n_s16(vaddq_s16(sum, vaddq_s16(v0, v0)), 4);
+    v.val[1] = vshrq_n_s16(vaddq_s16(sum, vaddq_s16(v1, v1)), 4);
+    vst2q_s16(out + 2 * k, v);
+  }
+#endif
+
+  upsample_2x_bilinear_16_scalar(in, out, k, n);
+}
+
+
+void simd::ycbcr_to_rgb_8(const uint8_t* y, const int16_t* cb, const int16_t* cr, const uint8_t* a,
+                          const YCbCr_to_RGB_matrix& m, bool output_alpha, uint8_t* out, uint32_t n)
+{
+  uint32_t x = 0;
+
+#if HAVE_SIMD_SSE2
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i offset = _mm_set1_epi16(128);
+  const __m128i alpha = _mm_set1_epi8((char) 0xFF);
+
+  // coefficient pairs for _mm_madd_epi16() on interleaved (Y,1) and (Cb,Cr) samples
+  const __m128i y_coeffs = _mm_set1_epi32((int) ((uint16_t) m.y_mul | ((uint32_t) (uint16_t) m.y_add << 16)));
+  const __m128i r_coeffs = _mm_set1_epi32((int) ((uint32_t) (uint16_t) m.r_cr << 16));
+  const __m128i g_coeffs = _mm_set1_epi32((int) ((uint16_t) m.g_cb | ((uint32_t) (uint16_t) m.g_cr << 16)));
+  const __m128i b_coeffs = _mm_set1_epi32((int) (uint16_t) m.b_cb);
+  const __m128i one = _mm_set1_epi16(1);
+
+  // Without alpha, each pixel is written as 4 bytes, of which the last one is overwritten by the next pixel.
+  // Thus, at least one pixel is left for the scalar code to stay within the row.
+  const uint32_t vector_end = (output_alpha ? n : (n > 0 ? n - 1 : 0));
+
+  for (; x + 8 <= vector_end; x += 8) {
+    __m128i vy = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*) (y + x)), zero);
+    __m128i vcb = _mm_sub_epi16(_mm_loadu_si128((const __m128i*) (cb + x)), offset);
+    __m128i vcr = _mm_sub_epi16(_mm_loadu_si128((const __m128i*) (cr + x)), offset);
+
+    __m128i y_lo = _mm_madd_epi16(_mm_unpacklo_epi16(vy, one), y_coeffs);
+    __m128i y_hi = _mm_madd_epi16(_mm_unpackhi_epi16(vy, one), y_coeffs);
+    __m128i c_lo = _mm_unpacklo_epi16(vcb, vcr);
+    __m128i c_hi = _mm_unpackhi_epi16(vcb, vcr);
+
+    auto channel = [&](__m128i coeffs) {
+      __m128i lo = _mm_srai_epi32(_mm_add_epi32(y_lo, _mm_madd_epi16(c_lo, coeffs)), 8);
+      __m128i hi = _mm_srai_epi32(_mm_add_epi32(y_hi, _mm_madd_epi16(c_hi, coeffs)), 8);
+      __m128i v16 = _mm_packs_epi32(lo, hi);
+      return _mm_packus_epi16(v16, v16);
+    };
+
+    __m128i vr = channel(r_coeffs);
+    __m128i vg = channel(g_coeffs);
+    __m128i vb = channel(b_coeffs);
+    __m128i va = (output_alpha && a) ? _mm_loadl_epi64((const __m128i*) (a + x)) : alpha;
+
+    __m128i rg = _mm_unpacklo_epi8(vr, vg);
+    __m128i ba = _mm_unpacklo_epi8(vb, va);
+    __m128i pixels[2] = {
+        _mm_unpacklo_epi16(rg, ba),
+        _mm_unpackhi_epi16(rg, ba)
+    };
+
+    if (output_alpha) {
+      _mm_storeu_si128((__m128i*) (out + 4 * x), pixels[0]);
+      _mm_storeu_si128((__m128i*) (out + 4 * x + 16), pixels[1]);
+    }
+    else {
+      for (int i = 0; i < 8; i++) {
+        int32_t pixel = _mm_cvtsi128_si32(pixels[i / 4]);
+        pixels[i / 4] = _mm_srli_si128(pixels[i / 4], 4);
+        memcpy(out + 3 * (x + i), &pixel, 4);
+      }
+    }
+  }
+#elif HAVE_SIMD_NEON
+  const int16x8_t offset = vdupq_n_s16(128);
+  const uint8x8_t alpha = vdup_n_u8(0xFF);
+
+  auto channel = [](int32x4_t y_lo, int32x4_t y_hi, int16x8_t c1, int16_t m1, int16x8_t c2, int16_t m2) {
+    int32x4_t lo = vmlal_n_s16(vmlal_n_s16(y_lo, vget_low_s16(c1), m1), vget_low_s16(c2), m2);
+    int32x4_t hi = vmlal_n_s16(vmlal_n_s16(y_hi, vget_high_s16(c1), m1), vget_high_s16(c2), m2);
+    return vqmovun_s16(vcombine_s16(vshrn_n_s32(lo, 8), vshrn_n_s32(hi, 8)));
+  };
+
+  for (; x + 8 <= n; x += 8) {
+    int16x8_t vy = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(y + x)));
+    int16x8_t vcb = vsubq_s16(vld1q_s16(cb + x), offset);
+    int16x8_t vcr = vsubq_s16(vld1q_s16(cr + x), offset);
+
+    int32x4_t y_lo = vmlal_n_s16(vdupq_n_s32(m.y_add), vget_low_s16(vy), m.y_mul);
+    int32x4_t y_hi = vmlal_n_s16(vdupq_n_s32(m.y_add), vget_high_s16(vy), m.y_mul);
+
+    uint8x8_t vr = channel(y_lo, y_hi, vcr, m.r_cr, vcb, 0);
+    uint8x8_t vg = channel(y_lo, y_hi, vcb, m.g_cb, vcr, m.g_cr);
+    uint8x8_t vb = channel(y_lo, y_hi, vcb, m.b_cb, vcr, 0);
+
+    if (output_alpha) {
+      uint8x8x4_t v{{vr, vg, vb, a ? vld1_u8(a + x) : alpha}};
+      vst4_u8(out + 4 * x, v);
+    }
+    else {
+      uint8x8x3_t v{{vr, vg, vb}};
+      vst3_u8(out + 3 * x, v);
+    }
+  }
+#endif
+
+  ycbcr_to_rgb_8_scalar(y, cb, cr, a, m, output_alpha, out, x, n);
+}
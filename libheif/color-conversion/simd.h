@@ -0,0 +1,72 @@
+/*
+ * HEIF codec.
+ * Copyright (c) 2025 Dirk Farin <dirk.farin@gmail.com>
+ *
+ * This file is part of libheif.
+ *
+ * libheif is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * libheif is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libheif.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBHEIF_COLORCONVERSION_SIMD_H
+#define LIBHEIF_COLORCONVERSION_SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+
+
+// Row kernels for the color conversion operations, implemented with SSE2 (x86) or NEON (ARM).
+// The kernels process the remaining samples at the end of a row with scalar code, so any row width is fine.
+// They may only be called when simd::available() returns true.
+namespace simd {
+
+  // Returns false when libheif has been compiled for a platform without SSE2 or NEON support.
+  bool available();
+
+  // out = (in << (output_bits - 8)) | (in >> (16 - output_bits)), for 8 < output_bits <= 16
+  void expand_8_to_16(const uint8_t* in, uint16_t* out, uint32_t n, int output_bits);
+
+  // out = min(255, (in + offsets[x % 4]) >> (input_bits - 8)), for 8 < input_bits <= 16
+  void reduce_16_to_8(const uint16_t* in, uint8_t* out, uint32_t n, int input_bits, const uint16_t offsets[4]);
+
+  // Swaps the two bytes of each 16-bit sample. 'n_bytes' has to be even.
+  void swap_bytes_16(const uint8_t* in, uint8_t* out, size_t n_bytes);
+
+  // Interleaves the R,G,B planes into big-endian RRGGBB, or RRGGBBAA when 'output_alpha' is set.
+  // If 'a' is NULL, the alpha samples are filled with 'alpha_value'.
+  void interleave_16_BE(const uint16_t* r, const uint16_t* g, const uint16_t* b, const uint16_t* a,
+                        bool output_alpha, uint16_t alpha_value, uint8_t* out, uint32_t n);
+
+  // 2x bilinear upsampling of a row of samples that are located between the output samples, for k < n:
+  //   out[2k]   = (3 * in[k] + in[k+1] + 8) >> 4
+  //   out[2k+1] = (in[k] + 3 * in[k+1] + 8) >> 4
+  // The input is scaled by 4 (as after a vertical filter pass), 'in' has to contain n+1 samples.
+  void upsample_2x_bilinear_16(const int16_t* in, int16_t* out, uint32_t n);
+
+  // YCbCr to RGB matrix in fixed-point with 8 fractional bits:
+  //   R = (y_mul * Y + y_add + r_cr * (Cr - 128)) >> 8
+  //   G = (y_mul * Y + y_add + g_cb * (Cb - 128) + g_cr * (Cr - 128)) >> 8
+  //   B = (y_mul * Y + y_add + b_cb * (Cb - 128)) >> 8
+  struct YCbCr_to_RGB_matrix
+  {
+    int16_t y_mul, y_add;
+    int16_t r_cr, g_cb, g_cr, b_cb;
+  };
+
+  // Converts a row of 8 bit YCbCr with full-resolution chroma into interleaved RGB, or RGBA when 'output_alpha' is set.
+  // If 'a' is NULL, the alpha samples are filled with 0xFF.
+  void ycbcr_to_rgb_8(const uint8_t* y, const int16_t* cb, const int16_t* cr, const uint8_t* a,
+                      const YCbCr_to_RGB_matrix& m, bool output_alpha, uint8_t* out, uint32_t n);
+}
+
+#endif
@@ -681,3 +681,262 @@ Op_YCbCr420_to_RRGGBBaa::convert_colorspace(const std::shared_ptr<const HeifPixe
   return outimg;
 }
 
+
+
+std::vector<ColorStateWithCost>
+Op_YCbCr_bilinear_to_RGB24_32::state_after_conversion(const ColorState& input_state,
+                                                      const ColorState& target_state,
+                                                      const heif_color_conversion_options& options,
+                                                      const heif_color_conversion_options_ext& options_ext) const
+{
+  // this Op only implements the bilinear algorithm
+
+  if (options.preferred_chroma_upsampling_algorithm != heif_chroma_upsampling_bilinear) {
+    return {};
+  }
+
+  if (input_state.colorspace != heif_colorspace_YCbCr ||
+      (input_state.chroma != heif_chroma_420 &&
+       input_state.chroma != heif_chroma_422) ||
+      input_state.bits_per_pixel != 8) {
+    return {};
+  }
+
+  int matrix = input_state.nclx.get_matrix_coefficients();
+  if (matrix == 0 || matrix == 8 || matrix == 11 || matrix == 14) {
+    return {};
+  }
+
+  std::vector<ColorStateWithCost> states;
+
+  ColorState output_state;
+
+  // --- convert to RGB
+
+  output_state.colorspace = heif_colorspace_RGB;
+  output_state.bits_per_pixel = 8;
+
+  if (!input_state.has_alpha) {
+    output_state.chroma = heif_chroma_interleaved_RGB;
+    output_state.has_alpha = false;
+    states.emplace_back(output_state, SpeedCosts_Unoptimized);
+  }
+
+  // Note: no input alpha channel required. It will be filled up with 0xFF.
+
+  output_state.chroma = heif_chroma_interleaved_RGBA;
+  output_state.has_alpha = true;
+  states.emplace_back(output_state, SpeedCosts_Unoptimized);
+
+  return states;
+}
+
+
+Result<std::shared_ptr<HeifPixelImage>>
+Op_YCbCr_bilinear_to_RGB24_32::convert_colorspace(const std::shared_ptr<const HeifPixelImage>& input,
+                                                  const ColorState& input_state,
+                                                  const ColorState& target_state,
+                                                  const heif_color_conversion_options& options,
+                                                  const heif_color_conversion_options_ext& options_ext,
+                                                  const heif_security_limits* limits) const
+{
+  heif_chroma chroma = input->get_chroma_format();
+  bool output_alpha = (target_state.chroma == heif_chroma_interleaved_RGBA);
+  bool with_alpha = output_alpha && input->has_channel(heif_channel_Alpha);
+
+  if ((chroma != heif_chroma_420 && chroma != heif_chroma_422) ||
+      input->get_bits_per_pixel(heif_channel_Y) != 8 ||
+      input->get_bits_per_pixel(heif_channel_Cb) != 8 ||
+      input->get_bits_per_pixel(heif_channel_Cr) != 8 ||
+      (with_alpha && input->get_bits_per_pixel(heif_channel_Alpha) != 8)) {
+    return Error::InternalError;
+  }
+
+  uint32_t width = input->get_width();
+  uint32_t height = input->get_height();
+
+  auto outimg = std::make_shared<HeifPixelImage>();
+
+  outimg->create(width, height, heif_colorspace_RGB,
+                 output_alpha ? heif_chroma_interleaved_32bit : heif_chroma_interleaved_24bit);
+
+  if (auto err = outimg->add_plane(heif_channel_interleaved, width, height, 8, limits)) {
+    return err;
+  }
+
+
+  // --- get conversion coefficients
+
+  YCbCr_to_RGB_coefficients coeffs = YCbCr_to_RGB_coefficients::defaults();
+  bool full_range_flag = true;
+  if (input->has_nclx_color_profile()) {
+    nclx_profile colorProfile = input->get_color_profile_nclx();
+    full_range_flag = colorProfile.get_full_range_flag();
+    coeffs = get_YCbCr_to_RGB_coefficients(colorProfile.get_matrix_coefficients(),
+                                           colorProfile.get_colour_primaries());
+  }
+
+  // same limited range scaling as in Op_YCbCr_to_RGB
+  float y_scale = full_range_flag ? 1.0f : 1.1689f;
+  float c_scale = full_range_flag ? 1.0f : 1.1429f;
+
+  simd::YCbCr_to_RGB_matrix m{};
+  m.y_mul = static_cast<int16_t>(std::lround(256 * y_scale));
+  m.y_add = static_cast<int16_t>(128 - (full_range_flag ? 0 : 16 * m.y_mul));
+  m.r_cr = static_cast<int16_t>(std::lround(256 * c_scale * coeffs.r_cr));
+  m.g_cb = static_cast<int16_t>(std::lround(256 * c_scale * coeffs.g_cb));
+  m.g_cr = static_cast<int16_t>(std::lround(256 * c_scale * coeffs.g_cr));
+  m.b_cb = static_cast<int16_t>(std::lround(256 * c_scale * coeffs.b_cb));
+
+
+  const uint8_t* in_y, * in_cb, * in_cr, * in_a = nullptr;
+  size_t in_y_stride = 0, in_cb_stride = 0, in_cr_stride = 0, in_a_stride = 0;
+
+  uint8_t* out_p;
+  size_t out_p_stride = 0;
+
+  in_y = input->get_plane(heif_channel_Y, &in_y_stride);
+  in_cb = input->get_plane(heif_channel_Cb, &in_cb_stride);
+  in_cr = input->get_plane(heif_channel_Cr, &in_cr_stride);
+  if (with_alpha) {
+    in_a = input->get_plane(heif_channel_Alpha, &in_a_stride);
+  }
+
+  out_p = outimg->get_plane(heif_channel_interleaved, &out_p_stride);
+
+  /*
+   * The chroma samples are filtered separately in both directions. The vertical filter computes a row
+   * at chroma resolution that is scaled by 4. It uses the weights 3/4, 1/4 of the two nearest chroma rows
+   * (4:2:0), or copies the chroma row (4:2:2 and the top/bottom border rows).
+   * The horizontal filter then interpolates between the chroma columns with the weights 3/4, 1/4 and
+   * scales the result back to 8 bits. Border columns are copied.
+   */
+
+  uint32_t chroma_width = (width + 1) / 2;
+  uint32_t chroma_height = (chroma == heif_chroma_420) ? (height + 1) / 2 : height;
+
+  std::vector<int16_t> vertical_cb(chroma_width), vertical_cr(chroma_width);
+  std::vector<int16_t> row_cb(width), row_cr(width);
+
+  // number of luma pixel pairs between two chroma samples in a row
+  uint32_t inner_pairs = (width - 1) / 2;
+
+  for (uint32_t y = 0; y < height; y++) {
+    uint32_t cy0 = y, cy1 = y;
+    int w0 = 4, w1 = 0;
+
+    if (chroma == heif_chroma_420 && y > 0) {
+      if (y % 2 == 1) {
+        cy0 = y / 2;
+        cy1 = cy0 + 1;
+        if (cy1 < chroma_height) {
+          w0 = 3;
+          w1 = 1;
+        }
+        else {
+          cy1 = cy0;
+        }
+      }
+      else {
+        cy0 = y / 2 - 1;
+        cy1 = y / 2;
+        w0 = 1;
+        w1 = 3;
+      }
+    }
+    else if (chroma == heif_chroma_420) {
+      cy0 = cy1 = 0;
+    }
+
+    const uint8_t* cb0 = &in_cb[cy0 * in_cb_stride];
+    const uint8_t* cb1 = &in_cb[cy1 * in_cb_stride];
+    const uint8_t* cr0 = &in_cr[cy0 * in_cr_stride];
+    const uint8_t* cr1 = &in_cr[cy1 * in_cr_stride];
+
+    for (uint32_t cx = 0; cx < chroma_width; cx++) {
+      vertical_cb[cx] = (int16_t) (w0 * cb0[cx] + w1 * cb1[cx]);
+      vertical_cr[cx] = (int16_t) (w0 * cr0[cx] + w1 * cr1[cx]);
+    }
+
+    row_cb[0] = (int16_t) ((4 * vertical_cb[0] + 8) >> 4);
+    row_cr[0] = (int16_t) ((4 * vertical_cr[0] + 8) >> 4);
+
+    upsample_row(vertical_cb.data(), &row_cb[1], inner_pairs);
+    upsample_row(vertical_cr.data(), &row_cr[1], inner_pairs);
+
+    if (width % 2 == 0 && width > 1) {
+      row_cb[width - 1] = (int16_t) ((4 * vertical_cb[chroma_width - 1] + 8) >> 4);
+      row_cr[width - 1] = (int16_t) ((4 * vertical_cr[chroma_width - 1] + 8) >> 4);
+    }
+
+    convert_row(&in_y[y * in_y_stride], row_cb.data(), row_cr.data(),
+                with_alpha ? &in_a[y * in_a_stride] : nullptr,
+                m, output_alpha, &out_p[y * out_p_stride], width);
+  }
+
+  return outimg;
+}
+
+
+void Op_YCbCr_bilinear_to_RGB24_32::upsample_row(const int16_t* in, int16_t* out, uint32_t n) const
+{
+  for (uint32_t k = 0; k < n; k++) {
+    out[2 * k + 0] = (int16_t) ((3 * in[k] + in[k + 1] + 8) >> 4);
+    out[2 * k + 1] = (int16_t) ((in[k] + 3 * in[k + 1] + 8) >> 4);
+  }
+}
+
+
+void Op_YCbCr_bilinear_to_RGB24_32::convert_row(const uint8_t* y, const int16_t* cb, const int16_t* cr, const uint8_t* a,
+                                                const simd::YCbCr_to_RGB_matrix& m, bool output_alpha,
+                                                uint8_t* out, uint32_t n) const
+{
+  const int pixelsize = (output_alpha ? 4 : 3);
+
+  for (uint32_t x = 0; x < n; x++) {
+    int yv = m.y_mul * y[x] + m.y_add;
+    int cbv = cb[x] - 128;
+    int crv = cr[x] - 128;
+
+    uint8_t* p = &out[pixelsize * x];
+    p[0] = clip_int_u8((yv + m.r_cr * crv) >> 8);
+    p[1] = clip_int_u8((yv + m.g_cb * cbv + m.g_cr * crv) >> 8);
+    p[2] = clip_int_u8((yv + m.b_cb * cbv) >> 8);
+    if (output_alpha) {
+      p[3] = a ? a[x] : 0xFF;
+    }
+  }
+}
+
+
+std::vector<ColorStateWithCost>
+Op_YCbCr_bilinear_to_RGB24_32_simd::state_after_conversion(const ColorState& input_state,
+                                                           const ColorState& target_state,
+                                                           const heif_color_conversion_options& options,
+                                                           const heif_color_conversion_options_ext& options_ext) const
+{
+  if (!simd::available()) {
+    return {};
+  }
+
+  auto states = Op_YCbCr_bilinear_to_RGB24_32::state_after_conversion(input_state, target_state, options, options_ext);
+  for (auto& state : states) {
+    state.speed_costs = SpeedCosts_OptimizedSoftware;
+  }
+
+  return states;
+}
+
+
+void Op_YCbCr_bilinear_to_RGB24_32_simd::upsample_row(const int16_t* in, int16_t* out, uint32_t n) const
+{
+  simd::upsample_2x_bilinear_16(in, out, n);
+}
+
+
+void Op_YCbCr_bilinear_to_RGB24_32_simd::convert_row(const uint8_t* y, const int16_t* cb, const int16_t* cr, const uint8_t* a,
+                                                     const simd::YCbCr_to_RGB_matrix& m, bool output_alpha,
+                                                     uint8_t* out, uint32_t n) const
+{
+  simd::ycbcr_to_rgb_8(y, cb, cr, a, m, output_alpha, out, n);
+}
@@ -25,6 +25,7 @@
 #include <vector>
 #include <memory>
 #include "colorconversion.h"
+#include "simd.h"
 
 
 template<class Pixel>
@@ -103,4 +104,50 @@ public:
                      const heif_security_limits* limits) const override;
 };
 
+// Converts 8 bit 4:2:0 and 4:2:2 images to interleaved RGB(A) with bilinear chroma upsampling.
+// The upsampled chroma is computed row by row and is identical to the output of
+// Op_YCbCr420_bilinear_to_YCbCr444 / Op_YCbCr422_bilinear_to_YCbCr444, but without the intermediate 4:4:4 image.
+class Op_YCbCr_bilinear_to_RGB24_32 : public ColorConversionOperation
+{
+public:
+  std::vector<ColorStateWithCost>
+  state_after_conversion(const ColorState& input_state,
+                         const ColorState& target_state,
+                         const heif_color_conversion_options& options,
+                         const heif_color_conversion_options_ext& options_ext) const override;
+
+  Result<std::shared_ptr<HeifPixelImage>>
+  convert_colorspace(const std::shared_ptr<const HeifPixelImage>& input,
+                     const ColorState& input_state,
+                     const ColorState& target_state,
+                     const heif_color_conversion_options& options,
+                     const heif_color_conversion_options_ext& options_ext,
+                     const heif_security_limits* limits) const override;
+
+protected:
+  // see simd::upsample_2x_bilinear_16()
+  virtual void upsample_row(const int16_t* in, int16_t* out, uint32_t n) const;
+
+  // see simd::ycbcr_to_rgb_8()
+  virtual void convert_row(const uint8_t* y, const int16_t* cb, const int16_t* cr, const uint8_t* a,
+                           const simd::YCbCr_to_RGB_matrix& m, bool output_alpha, uint8_t* out, uint32_t n) const;
+};
+
+
+class Op_YCbCr_bilinear_to_RGB24_32_simd : public Op_YCbCr_bilinear_to_RGB24_32
+{
+public:
+  std::vector<ColorStateWithCost>
+  state_after_conversion(const ColorState& input_state,
+                         const ColorState& target_state,
+                         const heif_color_conversion_options& options,
+                         const heif_color_conversion_options_ext& options_ext) const override;
+
+protected:
+  void upsample_row(const int16_t* in, int16_t* out, uint32_t n) const override;
+
+  void convert_row(const uint8_t* y, const int16_t* cb, const int16_t* cr, const uint8_t* a,
+                   const simd::YCbCr_to_RGB_matrix& m, bool output_alpha, uint8_t* out, uint32_t n) const override;
+};
+
 #endif //LIBHEIF_COLORCONVERSION_YUV2RGB_H
@@ -0,0 +1,153 @@
+/*
+ * HEIF codec.
+ * Copyright (c) 2025 Dirk Farin <dirk.farin@gmail.com>
+ *
+ * This file is part of libheif.
+ *
+ * libheif is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * libheif is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libheif.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "compression.h"
+#include "common_utils.h"
+
+#include <sstream>
+#include <string>
+
+
+static const char* generic_compression_name(uint32_t compression_type)
+{
+  switch (compression_type) {
+    case fourcc("defl"):
+      return "deflate";
+    case fourcc("zlib"):
+      return "zlib";
+    case fourcc("brot"):
+      return "brotli";
+    case fourcc("zstd"):
+      return "zstd";
+    default:
+      return nullptr;
+  }
+}
+
+
+static Error unsupported_compression_error(uint32_t compression_type)
+{
+  std::stringstream sstr;
+
+  const char* name = generic_compression_name(compression_type);
+  if (name) {
+    sstr << "cannot decode unci item with " << name << " compression - not enabled" << std::endl;
+  }
+  else {
+    sstr << "cannot decode unci item with unsupported compression type: " << fourcc_to_string(compression_type) << std::endl;
+  }
+
+  return {heif_error_Unsupported_feature,
+          heif_suberror_Unsupported_generic_compression_method,
+          sstr.str()};
+}
+
+
+bool is_generic_compression_supported(uint32_t compression_type)
+{
+  switch (compression_type) {
+#if HAVE_ZLIB
+    case fourcc("defl"):
+    case fourcc("zlib"):
+      return true;
+#endif
+#if HAVE_BROTLI
+    case fourcc("brot"):
+      return true;
+#endif
+#if HAVE_ZSTD
+    case fourcc("zstd"):
+      return true;
+#endif
+    default:
+      return false;
+  }
+}
+
+
+Result<std::vector<uint8_t>> compress_generic(uint32_t compression_type, const uint8_t* input, size_t size)
+{
+  switch (compression_type) {
+#if HAVE_ZLIB
+    case fourcc("defl"):
+      return compress_deflate(input, size);
+    case fourcc("zlib"):
+      return compress_zlib(input, size);
+#endif
+#if HAVE_BROTLI
+    case fourcc("brot"):
+      return compress_brotli(input, size);
+#endif
+#if HAVE_ZSTD
+    case fourcc("zstd"):
+      return compress_zstd(input, size);
+#endif
+    default:
+      return unsupported_compression_error(compression_type);
+  }
+}
+
+
+Result<std::vector<uint8_t>> decompress_generic(uint32_t compression_type, const std::vector<uint8_t>& compressed_input)
+{
+  switch (compression_type) {
+#if HAVE_ZLIB
+    case fourcc("defl"):
+      return decompress_deflate(compressed_input);
+    case fourcc("zlib"):
+      return decompress_zlib(compressed_input);
+#endif
+#if HAVE_BROTLI
+    case fourcc("brot"):
+      return decompress_brotli(compressed_input);
+#endif
+#if HAVE_ZSTD
+    case fourcc("zstd"):
+      return decompress_zstd(compressed_input);
+#endif
+    default:
+      return unsupported_compression_error(compression_type);
+  }
+}
+
+
+Error decompress_generic(uint32_t compression_type,
+                         const uint8_t* compressed_input, size_t input_size,
+                         uint8_t* output, size_t output_size)
+{
+  switch (compression_type) {
+#if HAVE_ZLIB
+    case fourcc("defl"):
+      return decompress_deflate(compressed_input, input_size, output, output_size);
+    case fourcc("zlib"):
+      return decompress_zlib(compressed_input, input_size, output, output_size);
+#endif
+#if HAVE_BROTLI
+    case fourcc("brot"):
+      return decompress_brotli(compressed_input, input_size, output, output_size);
+#endif
+#if HAVE_ZSTD
+    case fourcc("zstd"):
+      return decompress_zstd(compressed_input, input_size, output, output_size);
+#endif
+    default:
+      return unsupported_compression_error(compression_type);
+  }
+}
@@ -34,9 +34,9 @@
  * 
  * @param input pointer to the data to be compressed
  * @param size the length of the input array in bytes
- * @return the corresponding compressed data
+ * @return the corresponding compressed data, or an error if the compression failed
  */
-std::vector<uint8_t> compress_zlib(const uint8_t* input, size_t size);
+Result<std::vector<uint8_t>> compress_zlib(const uint8_t* input, size_t size);
 
 /**
  * Compress data using deflate method.
@@ -45,9 +45,9 @@ std::vector<uint8_t> compress_zlib(const uint8_t* input, size_t size);
  * 
  * @param input pointer to the data to be compressed
  * @param size the length of the input array in bytes
- * @return the corresponding compressed data
+ * @return the corresponding compressed data, or an error if the compression failed
  */
-std::vector<uint8_t> compress_deflate(const uint8_t* input, size_t size);
+Result<std::vector<uint8_t>> compress_deflate(const uint8_t* input, size_t size);
 
 /**
  * Decompress zlib compressed data.
@@ -77,6 +77,23 @@ Result<std::vector<uint8_t>> decompress_zlib(const std::vector<uint8_t>& compres
  */
 Result<std::vector<uint8_t>> decompress_deflate(const std::vector<uint8_t>& compressed_input);
 
+/**
+ * Decompress zlib compressed data into a buffer of known size.
+ *
+ * The decompressed data has to fill the output buffer exactly.
+ * When libheif is built with libdeflate, this uses libdeflate's one-shot decompressor.
+ *
+ * @return success (Ok) or an error on failure (corrupt data or unexpected decompressed size)
+ */
+Error decompress_zlib(const uint8_t* compressed_input, size_t input_size, uint8_t* output, size_t output_size);
+
+/**
+ * Decompress "deflate" compressed data into a buffer of known size.
+ *
+ * @sa decompress_zlib
+ */
+Error decompress_deflate(const uint8_t* compressed_input, size_t input_size, uint8_t* output, size_t output_size);
+
 #endif
 
 #if HAVE_BROTLI
@@ -91,7 +108,53 @@ Result<std::vector<uint8_t>> decompress_deflate(const std::vector<uint8_t>& comp
  */
 Result<std::vector<uint8_t>> decompress_brotli(const std::vector<uint8_t>& compressed_input);
 
+/**
+ * Decompress Brotli compressed data into a buffer of known size.
+ *
+ * The decompressed data has to fill the output buffer exactly.
+ */
+Error decompress_brotli(const uint8_t* compressed_input, size_t input_size, uint8_t* output, size_t output_size);
+
 std::vector<uint8_t> compress_brotli(const uint8_t* input, size_t size);
 #endif
 
+#if HAVE_ZSTD
+/**
+ * Compress data using Zstandard.
+ *
+ * Zstandard is described in RFC 8878.
+ */
+Result<std::vector<uint8_t>> compress_zstd(const uint8_t* input, size_t size);
+
+Result<std::vector<uint8_t>> decompress_zstd(const std::vector<uint8_t>& compressed_input);
+
+/**
+ * Decompress Zstandard compressed data into a buffer of known size.
+ *
+ * The decompressed data has to fill the output buffer exactly.
+ */
+Error decompress_zstd(const uint8_t* compressed_input, size_t input_size, uint8_t* output, size_t output_size);
+#endif
+
+
+// --- generic compression methods, selected by their 'cmpC' compression_type four-character code
+
+/**
+ * Check whether this libheif build supports the generic compression method.
+ * Known methods are 'defl', 'zlib', 'brot', and 'zstd'.
+ */
+bool is_generic_compression_supported(uint32_t compression_type);
+
+Result<std::vector<uint8_t>> compress_generic(uint32_t compression_type, const uint8_t* input, size_t size);
+
+Result<std::vector<uint8_t>> decompress_generic(uint32_t compression_type, const std::vector<uint8_t>& compressed_input);
+
+/**
+ * Decompress into a caller-provided buffer of known size. Use this when the decompressed size
+ * is known in advance (e.g. from the image geometry) to avoid growing the output buffer.
+ */
+Error decompress_generic(uint32_t compression_type,
+                         const uint8_t* compressed_input, size_t input_size,
+                         uint8_t* output, size_t output_size);
+
 #endif //LIBHEIF_COMPRESSION_H
@@ -87,6 +87,27 @@ Result<std::vector<uint8_t>> decompress_brotli(const std::vector<uint8_t> &compr
 }
 
 
+Error decompress_brotli(const uint8_t* compressed_input, size_t input_size, uint8_t* output, size_t output_size)
+{
+  size_t decoded_size = output_size;
+  BrotliDecoderResult result = BrotliDecoderDecompress(input_size, compressed_input, &decoded_size, output);
+
+  if (result == BROTLI_DECODER_RESULT_SUCCESS) {
+    if (decoded_size != output_size) {
+      return {heif_error_Invalid_input, heif_suberror_Decompression_invalid_data, "Decompressed data is shorter than expected"};
+    }
+
+    return Error::Ok;
+  }
+  else if (result == BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT) {
+    return {heif_error_Invalid_input, heif_suberror_Decompression_invalid_data, "Decompressed data is longer than expected"};
+  }
+  else {
+    return {heif_error_Invalid_input, heif_suberror_Decompression_invalid_data, "Error performing brotli inflate"};
+  }
+}
+
+
 std::vector<uint8_t> compress_brotli(const uint8_t* input, size_t size)
 {
   std::unique_ptr<BrotliEncoderState, void(*)(BrotliEncoderState*)> state(BrotliEncoderCreateInstance(nullptr, nullptr, nullptr), BrotliEncoderDestroyInstance);
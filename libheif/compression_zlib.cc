@@ -28,8 +28,47 @@
 #include <cstring>
 #include <iostream>
 
-std::vector<uint8_t> compress(const uint8_t* input, size_t size, int windowSize)
+#if HAVE_LIBDEFLATE
+#include <libdeflate.h>
+#include <memory>
+#endif
+
+
+#if HAVE_LIBDEFLATE
+// libdeflate only supports one-shot compression of the whole buffer, which is what we always do anyway.
+// It is considerably faster than zlib and produces compatible zlib/deflate streams.
+static Result<std::vector<uint8_t>> compress_libdeflate(const uint8_t* input, size_t size, bool zlib_format)
+{
+  std::unique_ptr<libdeflate_compressor, void (*)(libdeflate_compressor*)> compressor(libdeflate_alloc_compressor(6),
+                                                                                    libdeflate_free_compressor);
+  if (!compressor) {
+    return Error(heif_error_Memory_allocation_error, heif_suberror_Compression_initialisation_error,
+                 "Error initialising libdeflate");
+  }
+
+  size_t bound = zlib_format ? libdeflate_zlib_compress_bound(compressor.get(), size)
+                             : libdeflate_deflate_compress_bound(compressor.get(), size);
+
+  std::vector<uint8_t> output(bound);
+
+  size_t compressed_size = zlib_format ? libdeflate_zlib_compress(compressor.get(), input, size, output.data(), output.size())
+                                       : libdeflate_deflate_compress(compressor.get(), input, size, output.data(), output.size());
+  if (compressed_size == 0) {
+    return Error(heif_error_Encoding_error, heif_suberror_Encoder_encoding,
+                 "Error performing libdeflate compression");
+  }
+
+  output.resize(compressed_size);
+  return output;
+}
+#endif
+
+
+static Result<std::vector<uint8_t>> compress(const uint8_t* input, size_t size, int windowSize)
 {
+#if HAVE_LIBDEFLATE
+  return compress_libdeflate(input, size, windowSize > 0);
+#else
   std::vector<uint8_t> output;
 
   // initialize compressor
@@ -52,7 +91,9 @@ std::vector<uint8_t> compress(const uint8_t* input, size_t size, int windowSize)
 
   int err = deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowSize, 8, Z_DEFAULT_STRATEGY);
   if (err != Z_OK) {
-    return {}; // TODO: return error
+    std::stringstream sstr;
+    sstr << "Error initialising zlib deflate: " << (strm.msg ? strm.msg : "NULL") << " (" << err << ")\n";
+    return Error(heif_error_Memory_allocation_error, heif_suberror_Compression_initialisation_error, sstr.str());
   }
 
   do {
@@ -65,7 +106,10 @@ std::vector<uint8_t> compress(const uint8_t* input, size_t size, int windowSize)
       // -> do nothing
     }
     else if (err == Z_STREAM_ERROR) {
-      return {}; // TODO: return error
+      std::stringstream sstr;
+      sstr << "Error performing zlib deflate: " << (strm.msg ? strm.msg : "NULL") << " (" << err << ")\n";
+      deflateEnd(&strm);
+      return Error(heif_error_Encoding_error, heif_suberror_Encoder_encoding, sstr.str());
     }
 
 
@@ -77,6 +121,7 @@ std::vector<uint8_t> compress(const uint8_t* input, size_t size, int windowSize)
   deflateEnd(&strm);
 
   return output;
+#endif
 }
 
 
@@ -137,12 +182,84 @@ Result<std::vector<uint8_t>> do_inflate(const std::vector<uint8_t>& compressed_i
   return output;
 }
 
-std::vector<uint8_t> compress_zlib(const uint8_t* input, size_t size)
+static Error do_inflate_to_buffer(const uint8_t* compressed_input, size_t input_size,
+                                  uint8_t* output, size_t output_size,
+                                  int windowSize)
+{
+#if HAVE_LIBDEFLATE
+  std::unique_ptr<libdeflate_decompressor, void (*)(libdeflate_decompressor*)> decompressor(libdeflate_alloc_decompressor(),
+                                                                                          libdeflate_free_decompressor);
+  if (!decompressor) {
+    return {heif_error_Memory_allocation_error, heif_suberror_Compression_initialisation_error, "Error initialising libdeflate"};
+  }
+
+  // Without the 'actual_out_nbytes' parameter, libdeflate requires the decompressed data to fill the buffer exactly.
+  libdeflate_result result = (windowSize > 0) ?
+                             libdeflate_zlib_decompress(decompressor.get(), compressed_input, input_size, output, output_size, nullptr) :
+                             libdeflate_deflate_decompress(decompressor.get(), compressed_input, input_size, output, output_size, nullptr);
+
+  switch (result) {
+    case LIBDEFLATE_SUCCESS:
+      return Error::Ok;
+    case LIBDEFLATE_SHORT_OUTPUT:
+      return {heif_error_Invalid_input, heif_suberror_Decompression_invalid_data, "Decompressed data is shorter than expected"};
+    case LIBDEFLATE_INSUFFICIENT_SPACE:
+      return {heif_error_Invalid_input, heif_suberror_Decompression_invalid_data, "Decompressed data is longer than expected"};
+    default:
+      return {heif_error_Invalid_input, heif_suberror_Decompression_invalid_data, "Error performing deflate decompression"};
+  }
+#else
+  z_stream strm;
+  memset(&strm, 0, sizeof(z_stream));
+
+  strm.avail_in = (uInt) input_size;
+  strm.next_in = (Bytef*) compressed_input;
+
+  strm.avail_out = (uInt) output_size;
+  strm.next_out = (Bytef*) output;
+
+  strm.zalloc = Z_NULL;
+  strm.zfree = Z_NULL;
+  strm.opaque = Z_NULL;
+
+  int err = inflateInit2(&strm, windowSize);
+  if (err != Z_OK) {
+    std::stringstream sstr;
+    sstr << "Error initialising zlib inflate: " << (strm.msg ? strm.msg : "NULL") << " (" << err << ")\n";
+    return {heif_error_Memory_allocation_error, heif_suberror_Compression_initialisation_error, sstr.str()};
+  }
+
+  // The whole output buffer is available, thus we can decompress in a single call.
+  err = inflate(&strm, Z_FINISH);
+  uLong total_out = strm.total_out;
+  std::string msg = strm.msg ? strm.msg : "NULL";
+  inflateEnd(&strm);
+
+  if (err == Z_STREAM_END) {
+    if (total_out != output_size) {
+      return {heif_error_Invalid_input, heif_suberror_Decompression_invalid_data, "Decompressed data is shorter than expected"};
+    }
+
+    return Error::Ok;
+  }
+  else if (err == Z_BUF_ERROR && total_out == output_size) {
+    return {heif_error_Invalid_input, heif_suberror_Decompression_invalid_data, "Decompressed data is longer than expected"};
+  }
+  else {
+    std::stringstream sstr;
+    sstr << "Error performing zlib inflate: " << msg << " (" << err << ")\n";
+    return {heif_error_Invalid_input, heif_suberror_Decompression_invalid_data, sstr.str()};
+  }
+#endif
+}
+
+
+Result<std::vector<uint8_t>> compress_zlib(const uint8_t* input, size_t size)
 {
   return compress(input, size, 15);
 }
 
-std::vector<uint8_t> compress_deflate(const uint8_t* input, size_t size)
+Result<std::vector<uint8_t>> compress_deflate(const uint8_t* input, size_t size)
 {
   return compress(input, size, -15);
 }
@@ -157,4 +274,14 @@ Result<std::vector<uint8_t>> decompress_deflate(const std::vector<uint8_t>& comp
 {
   return do_inflate(compressed_input, -15);
 }
+
+Error decompress_zlib(const uint8_t* compressed_input, size_t input_size, uint8_t* output, size_t output_size)
+{
+  return do_inflate_to_buffer(compressed_input, input_size, output, output_size, 15);
+}
+
+Error decompress_deflate(const uint8_t* compressed_input, size_t input_size, uint8_t* output, size_t output_size)
+{
+  return do_inflate_to_buffer(compressed_input, input_size, output, output_size, -15);
+}
 #endif
@@ -0,0 +1,114 @@
+/*
+ * HEIF codec.
+ * Copyright (c) 2025 Dirk Farin <dirk.farin@gmail.com>
+ *
+ * This file is part of libheif.
+ *
+ * libheif is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * libheif is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libheif.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "compression.h"
+
+#if HAVE_ZSTD
+
+#include <zstd.h>
+#include <zstd_errors.h>
+#include <memory>
+#include <sstream>
+#include <string>
+
+
+Result<std::vector<uint8_t>> compress_zstd(const uint8_t* input, size_t size)
+{
+  std::vector<uint8_t> output(ZSTD_compressBound(size));
+
+  size_t compressed_size = ZSTD_compress(output.data(), output.size(), input, size, ZSTD_CLEVEL_DEFAULT);
+  if (ZSTD_isError(compressed_size)) {
+    std::stringstream sstr;
+    sstr << "Error performing zstd compression: " << ZSTD_getErrorName(compressed_size) << "\n";
+    return Error(heif_error_Encoding_error, heif_suberror_Encoder_encoding, sstr.str());
+  }
+
+  output.resize(compressed_size);
+  return output;
+}
+
+
+Result<std::vector<uint8_t>> decompress_zstd(const std::vector<uint8_t>& compressed_input)
+{
+  std::unique_ptr<ZSTD_DStream, size_t (*)(ZSTD_DStream*)> stream(ZSTD_createDStream(), ZSTD_freeDStream);
+  if (!stream) {
+    return Error(heif_error_Memory_allocation_error, heif_suberror_Compression_initialisation_error, "Error initialising zstd");
+  }
+
+  std::vector<uint8_t> output;
+
+  // If the frame header contains the content size, we can decompress without growing the output.
+  unsigned long long content_size = ZSTD_getFrameContentSize(compressed_input.data(), compressed_input.size());
+  if (content_size != ZSTD_CONTENTSIZE_UNKNOWN && content_size != ZSTD_CONTENTSIZE_ERROR &&
+      content_size <= compressed_input.size() * 1024) { // sanity limit against forged headers
+    output.reserve(content_size);
+  }
+
+  std::vector<uint8_t> buffer(ZSTD_DStreamOutSize());
+
+  ZSTD_inBuffer in{compressed_input.data(), compressed_input.size(), 0};
+
+  for (;;) {
+    ZSTD_outBuffer out{buffer.data(), buffer.size(), 0};
+    size_t ret = ZSTD_decompressStream(stream.get(), &out, &in);
+    if (ZSTD_isError(ret)) {
+      std::stringstream sstr;
+      sstr << "Error performing zstd decompression: " << ZSTD_getErrorName(ret) << "\n";
+      return Error(heif_error_Invalid_input, heif_suberror_Decompression_invalid_data, sstr.str());
+    }
+
+    output.insert(output.end(), buffer.data(), buffer.data() + out.pos);
+
+    if (ret == 0) {
+      break;
+    }
+
+    if (in.pos == in.size && out.pos < out.size) {
+      return Error(heif_error_Invalid_input, heif_suberror_Decompression_invalid_data,
+                   "Error performing zstd decompression - insufficient data.\n");
+    }
+  }
+
+  return output;
+}
+
+
+Error decompress_zstd(const uint8_t* compressed_input, size_t input_size, uint8_t* output, size_t output_size)
+{
+  size_t decoded_size = ZSTD_decompress(output, output_size, compressed_input, input_size);
+
+  if (ZSTD_isError(decoded_size)) {
+    if (ZSTD_getErrorCode(decoded_size) == ZSTD_error_dstSize_tooSmall) {
+      return {heif_error_Invalid_input, heif_suberror_Decompression_invalid_data, "Decompressed data is longer than expected"};
+    }
+
+    std::stringstream sstr;
+    sstr << "Error performing zstd decompression: " << ZSTD_getErrorName(decoded_size) << "\n";
+    return {heif_error_Invalid_input, heif_suberror_Decompression_invalid_data, sstr.str()};
+  }
+
+  if (decoded_size != output_size) {
+    return {heif_error_Invalid_input, heif_suberror_Decompression_invalid_data, "Decompressed data is shorter than expected"};
+  }
+
+  return Error::Ok;
+}
+
+#endif
@@ -149,6 +149,17 @@ static void copy_security_limits(heif_security_limits* dst, const heif_security_
 }
 
 
+void HeifContext::set_tile_cache_size(size_t max_bytes)
+{
+  // Leave at least half of the total memory budget for decoding.
+  if (m_limits.max_total_memory != 0) {
+    max_bytes = std::min(max_bytes, (size_t) (m_limits.max_total_memory / 2));
+  }
+
+  m_tile_cache.set_max_size(max_bytes);
+}
+
+
 void HeifContext::set_security_limits(const heif_security_limits* limits)
 {
   // copy default limits
@@ -296,14 +307,32 @@ static uint64_t rescale(uint64_t duration, uint32_t old_base, uint32_t new_base)
 }
 
 
-void HeifContext::write(StreamWriter& writer)
+Error HeifContext::write(StreamWriter& writer, uint64_t file_offset)
 {
   // --- finalize some parameters
 
   uint64_t max_sequence_duration = 0;
-  if (auto mvhd = m_heif_file->get_mvhd_box()) {
+  auto mvhd = m_heif_file->get_mvhd_box();
+
+  if (mvhd && is_fragmented_writing()) {
+    // The samples and durations are stored in the movie fragments.
     for (const auto& track : m_tracks) {
-      track.second->finalize_track();
+      Error err = track.second->finalize_track();
+      if (err) {
+        return err;
+      }
+    }
+
+    if (mvhd->get_time_scale() == 0 && !m_tracks.empty()) {
+      mvhd->set_time_scale(m_tracks.begin()->second->get_timescale());
+    }
+  }
+  else if (mvhd) {
+    for (const auto& track : m_tracks) {
+      Error err = track.second->finalize_track();
+      if (err) {
+        return err;
+      }
 
       // rescale track duration to movie timescale units
 
@@ -394,6 +423,18 @@ void HeifContext::write(StreamWriter& writer)
 
   // --- determine brands
 
+  set_ftyp_brands();
+
+  // --- write to file
+
+  m_heif_file->write(writer, file_offset);
+
+  return Error::Ok;
+}
+
+
+void HeifContext::set_ftyp_brands()
+{
   heif_brand2 main_brand;
   std::vector<heif_brand2> compatible_brands;
   compatible_brands = compute_compatible_brands(this, &main_brand);
@@ -415,10 +456,6 @@ void HeifContext::write(StreamWriter& writer)
   for (auto brand : compatible_brands) {
     ftyp->add_compatible_brand(brand);
   }
-
-  // --- write to file
-
-  m_heif_file->write(writer);
 }
 
 std::string HeifContext::debug_dump_boxes() const
@@ -1286,6 +1323,62 @@ Result<std::shared_ptr<HeifPixelImage>> HeifContext::decode_image(heif_item_id I
     return Error(heif_error_Invalid_input, heif_suberror_Nonexisting_item_referenced);
   }
 
+  if (!decode_only_tile || m_tile_cache.get_max_size() == 0) {
+    return decode_and_convert_image(imgitem, out_colorspace, out_chroma, options, decode_only_tile, tx, ty);
+  }
+
+
+  // --- decode tile through the tile cache
+
+  auto key = DecodedTileCache::make_key(ID, tx, ty, out_colorspace, out_chroma, options);
+
+  // The cached image is shared and must not be modified. Hand out a copy.
+  if (auto cached = m_tile_cache.get(key)) {
+    return cached->clone(get_security_limits());
+  }
+
+  auto tileResult = decode_and_convert_image(imgitem, out_colorspace, out_chroma, options, true, tx, ty);
+
+  // The cached tiles count towards the total memory limit. Release them and try again.
+  if (!tileResult &&
+      tileResult.error().error_code == heif_error_Memory_allocation_error &&
+      m_tile_cache.clear()) {
+    tileResult = decode_and_convert_image(imgitem, out_colorspace, out_chroma, options, true, tx, ty);
+  }
+
+  if (!tileResult) {
+    return tileResult.error();
+  }
+
+  std::shared_ptr<HeifPixelImage> tile = *tileResult;
+  m_tile_cache.put(key, tile);
+
+  return tile->clone(get_security_limits());
+}
+
+
+Result<std::shared_ptr<HeifPixelImage>> HeifContext::decode_and_convert_image(const std::shared_ptr<ImageItem>& imgitem,
+                                                                              heif_colorspace out_colorspace,
+                                                                              heif_chroma out_chroma,
+                                                                              const heif_decoding_options& options,
+                                                                              bool decode_only_tile, uint32_t tx, uint32_t ty) const
+{
+  // --- try to convert the tiles into the output format while decoding
+
+  if (options.convert_grid_tiles_individually &&
+      !decode_only_tile &&
+      out_colorspace != heif_colorspace_undefined &&
+      out_chroma != heif_chroma_undefined) {
+    auto directResult = imgitem->decode_image_to_output(options, out_colorspace, out_chroma);
+    if (!directResult) {
+      return directResult.error();
+    }
+
+    if (std::shared_ptr<HeifPixelImage> img = *directResult) {
+      img->add_warnings(imgitem->get_decoding_warnings());
+      return img;
+    }
+  }
 
   auto decodingResult = imgitem->decode_image(options, decode_only_tile, tx, ty);
   if (!decodingResult) {
@@ -1697,7 +1790,11 @@ Error HeifContext::add_generic_metadata(const std::shared_ptr<ImageItem>& master
   std::vector<uint8_t> data_array;
   if (compression == heif_metadata_compression_zlib) {
 #if HAVE_ZLIB
-    data_array = compress_zlib((const uint8_t*) data, size);
+    Result<std::vector<uint8_t>> compressed = compress_zlib((const uint8_t*) data, size);
+    if (!compressed) {
+      return compressed.error();
+    }
+    data_array = std::move(*compressed);
     metadata_infe_box->set_content_encoding("compress_zlib");
 #else
     return Error(heif_error_Unsupported_feature,
@@ -1706,7 +1803,11 @@ Error HeifContext::add_generic_metadata(const std::shared_ptr<ImageItem>& master
   }
   else if (compression == heif_metadata_compression_deflate) {
 #if HAVE_ZLIB
-    data_array = compress_zlib((const uint8_t*) data, size);
+    Result<std::vector<uint8_t>> compressed = compress_zlib((const uint8_t*) data, size);
+    if (!compressed) {
+      return compressed.error();
+    }
+    data_array = std::move(*compressed);
     metadata_infe_box->set_content_encoding("deflate");
 #else
     return Error(heif_error_Unsupported_feature,
@@ -1978,6 +2079,12 @@ Result<std::shared_ptr<Track_Visual>> HeifContext::add_visual_sequence_track(con
                                                                              uint32_t handler_type,
                                                                              uint16_t width, uint16_t height)
 {
+  if (is_fragmented_writing()) {
+    return Error{heif_error_Usage_error,
+                 heif_suberror_Unspecified,
+                 "Tracks have to be added before starting fragmented writing."};
+  }
+
   m_heif_file->init_for_sequence();
 
   std::shared_ptr<Track_Visual> trak = std::make_shared<Track_Visual>(this, 0, width, height, options, handler_type);
@@ -1990,6 +2097,12 @@ Result<std::shared_ptr<Track_Visual>> HeifContext::add_visual_sequence_track(con
 Result<std::shared_ptr<class Track_Metadata>> HeifContext::add_uri_metadata_sequence_track(const TrackOptions* options,
                                                                                            std::string uri)
 {
+  if (is_fragmented_writing()) {
+    return Error{heif_error_Usage_error,
+                 heif_suberror_Unspecified,
+                 "Tracks have to be added before starting fragmented writing."};
+  }
+
   m_heif_file->init_for_sequence();
 
   std::shared_ptr<Track_Metadata> trak = std::make_shared<Track_Metadata>(this, 0, uri, options);
@@ -1998,6 +2111,341 @@ Result<std::shared_ptr<class Track_Metadata>> HeifContext::add_uri_metadata_sequ
   return trak;
 }
 
+Error HeifContext::start_fragmented_writing(std::function<Error(const std::vector<uint8_t>&)> output,
+                                           uint32_t max_fragment_duration_ms)
+{
+  if (is_fragmented_writing()) {
+    return {heif_error_Usage_error,
+            heif_suberror_Unspecified,
+            "Fragmented writing has already been started."};
+  }
+
+  if (is_streaming_writing()) {
+    return {heif_error_Usage_error,
+            heif_suberror_Unspecified,
+            "Fragmented writing cannot be combined with streaming writing."};
+  }
+
+  if (m_tracks.empty()) {
+    return {heif_error_Usage_error,
+            heif_suberror_Unspecified,
+            "Fragmented writing requires at least one track."};
+  }
+
+  for (const auto& track : m_tracks) {
+    if (track.second->has_chunks()) {
+      return {heif_error_Usage_error,
+              heif_suberror_Unspecified,
+              "Fragmented writing has to be started before adding samples to the tracks."};
+    }
+  }
+
+  for (const auto& track : m_tracks) {
+    uint64_t max_fragment_duration = uint64_t{max_fragment_duration_ms} * track.second->get_timescale() / 1000;
+    track.second->enable_fragmented_writing(max_fragment_duration);
+  }
+
+  m_fragment_output = std::move(output);
+
+  return Error::Ok;
+}
+
+
+Error HeifContext::write_fragment_header(bool force)
+{
+  if (m_fragment_header_written) {
+    return Error::Ok;
+  }
+
+  // We can only write the 'moov' box when all sample descriptions are known.
+  if (!force) {
+    for (const auto& track : m_tracks) {
+      if (!track.second->has_sample_description()) {
+        return Error::Ok;
+      }
+    }
+  }
+
+  StreamWriter writer;
+  Error err = write(writer);
+  if (err) {
+    return err;
+  }
+
+  err = m_fragment_output(writer.get_data());
+  if (err) {
+    return err;
+  }
+
+  m_fragment_header_written = true;
+
+  // Fragments that were postponed until the header could be written.
+  for (const auto& track : m_tracks) {
+    if (track.second->has_fragment_data() && !force) {
+      err = write_track_fragment(track.second.get());
+      if (err) {
+        return err;
+      }
+    }
+  }
+
+  return Error::Ok;
+}
+
+
+Error HeifContext::write_track_fragment(Track* track)
+{
+  if (!m_fragment_header_written) {
+    return write_fragment_header(false);
+  }
+
+  auto fragmentResult = track->write_fragment(++m_fragment_sequence_number);
+  if (!fragmentResult) {
+    return fragmentResult.error();
+  }
+
+  return m_fragment_output(*fragmentResult);
+}
+
+
+Error HeifContext::end_fragmented_writing()
+{
+  if (!is_fragmented_writing() || m_fragmented_writing_ended) {
+    return {heif_error_Usage_error,
+            heif_suberror_Unspecified,
+            "Fragmented writing has not been started."};
+  }
+
+  for (const auto& track : m_tracks) {
+    if (track.second->has_buffered_samples()) {
+      return {heif_error_Usage_error,
+              heif_suberror_Unspecified,
+              "Frames are still buffered in the encoder. Call heif_track_encode_end_of_sequence() before ending the file."};
+    }
+  }
+
+  Error err = write_fragment_header(true);
+  if (err) {
+    return err;
+  }
+
+  for (const auto& track : m_tracks) {
+    if (track.second->has_fragment_data()) {
+      err = write_track_fragment(track.second.get());
+      if (err) {
+        return err;
+      }
+    }
+  }
+
+  m_fragmented_writing_ended = true;
+
+  return Error::Ok;
+}
+
+
+// Item data is collected until this size before it is written into an 'mdat' box.
+// With at most 65535 extents per item, this allows items of up to 256 GB.
+static const size_t kStreamingChunkSize = 4 * 1024 * 1024;
+
+
+Error HeifContext::start_streaming_writing(std::function<Error(const std::vector<uint8_t>&)> output)
+{
+  if (is_streaming_writing()) {
+    return {heif_error_Usage_error,
+            heif_suberror_Unspecified,
+            "Streaming writing has already been started."};
+  }
+
+  if (is_fragmented_writing()) {
+    return {heif_error_Usage_error,
+            heif_suberror_Unspecified,
+            "Streaming writing cannot be combined with fragmented writing."};
+  }
+
+  if (!m_tracks.empty()) {
+    return {heif_error_Usage_error,
+            heif_suberror_Unspecified,
+            "Streaming writing cannot be used for files with sequence tracks."};
+  }
+
+  // the brands depend on the box versions
+  m_heif_file->derive_box_versions();
+  set_ftyp_brands();
+
+  StreamWriter writer;
+  Error err = m_heif_file->get_ftyp_box()->write(writer);
+  if (err) {
+    return err;
+  }
+
+  err = output(writer.get_data());
+  if (err) {
+    return err;
+  }
+
+  m_streaming_output = std::move(output);
+  m_streaming_writing = true;
+  m_streaming_position = writer.data_size();
+
+  return Error::Ok;
+}
+
+
+Error HeifContext::append_streamed_item_data(heif_item_id id, const std::vector<uint8_t>& data)
+{
+  return stream_item_data(id, false, 0, data);
+}
+
+
+Error HeifContext::write_streamed_reserved_item_data(heif_item_id id, uint64_t item_offset, const std::vector<uint8_t>& data)
+{
+  return stream_item_data(id, true, item_offset, data);
+}
+
+
+Error HeifContext::stream_item_data(heif_item_id id, bool reserved_data, uint64_t item_offset, const std::vector<uint8_t>& data)
+{
+  if (m_streaming_writing_ended) {
+    return {heif_error_Usage_error,
+            heif_suberror_Unspecified,
+            "Cannot add item data after the streamed file has been finished."};
+  }
+
+  StreamingChunk& chunk = m_streaming_chunk;
+
+  bool continues_chunk = (!chunk.data.empty() &&
+                          chunk.item_id == id &&
+                          chunk.reserved_data == reserved_data &&
+                          (!reserved_data || chunk.item_offset + chunk.data.size() == item_offset) &&
+                          chunk.data.size() + data.size() <= kStreamingChunkSize);
+
+  if (!continues_chunk) {
+    Error err = flush_streaming_chunk();
+    if (err) {
+      return err;
+    }
+  }
+
+  // large pieces of data are written without copying them into the chunk buffer
+  if (data.size() >= kStreamingChunkSize) {
+    return write_streamed_mdat(id, reserved_data, item_offset, data);
+  }
+
+  if (chunk.data.empty()) {
+    chunk.item_id = id;
+    chunk.reserved_data = reserved_data;
+    chunk.item_offset = item_offset;
+  }
+
+  chunk.data.insert(chunk.data.end(), data.begin(), data.end());
+
+  return Error::Ok;
+}
+
+
+Error HeifContext::flush_streaming_chunk()
+{
+  StreamingChunk& chunk = m_streaming_chunk;
+
+  if (chunk.data.empty()) {
+    return Error::Ok;
+  }
+
+  Error err = write_streamed_mdat(chunk.item_id, chunk.reserved_data, chunk.item_offset, chunk.data);
+
+  chunk.data.clear();
+
+  return err;
+}
+
+
+Error HeifContext::write_streamed_mdat(heif_item_id id, bool reserved_data, uint64_t item_offset, const std::vector<uint8_t>& data)
+{
+  StreamWriter header;
+
+  if (data.size() + 8 <= 0xFFFFFFFF) {
+    header.write32((uint32_t) (data.size() + 8));
+    header.write32(fourcc("mdat"));
+  }
+  else {
+    // box size > 4 GB
+
+    header.write32(1);
+    header.write32(fourcc("mdat"));
+    header.write64(data.size() + 8 + 8);
+  }
+
+  uint64_t data_position = m_streaming_position + header.data_size();
+
+  // Register the data first. This fails when a reserved range has already been written.
+
+  auto iloc = m_heif_file->get_iloc_box();
+  Error err;
+  if (reserved_data) {
+    err = iloc->set_reserved_data_written(id, item_offset, data.size(), data_position);
+  }
+  else {
+    err = iloc->append_written_data(id, data.size(), data_position);
+  }
+
+  if (err) {
+    return err;
+  }
+
+  err = m_streaming_output(header.get_data());
+  if (err) {
+    return err;
+  }
+
+  err = m_streaming_output(data);
+  if (err) {
+    return err;
+  }
+
+  m_streaming_position = data_position + data.size();
+
+  return Error::Ok;
+}
+
+
+Error HeifContext::end_streaming_writing()
+{
+  if (!is_streaming_writing() || m_streaming_writing_ended) {
+    return {heif_error_Usage_error,
+            heif_suberror_Unspecified,
+            "Streaming writing has not been started."};
+  }
+
+  if (!m_tracks.empty()) {
+    return {heif_error_Usage_error,
+            heif_suberror_Unspecified,
+            "Streaming writing cannot be used for files with sequence tracks."};
+  }
+
+  Error err = flush_streaming_chunk();
+  if (err) {
+    return err;
+  }
+
+  StreamWriter writer;
+  err = write(writer, m_streaming_position);
+  if (err) {
+    return err;
+  }
+
+  err = m_streaming_output(writer.get_data());
+  if (err) {
+    return err;
+  }
+
+  m_streaming_writing_ended = true;
+  m_streaming_output = nullptr; // e.g. closes the output file
+
+  return Error::Ok;
+}
+
+
 std::shared_ptr<TextItem> HeifContext::add_text_item(const char* content_type, const char* text)
 {
   std::shared_ptr<Box_infe> box = m_heif_file->add_new_infe_box(fourcc("mime"));
@@ -21,6 +21,7 @@
 #ifndef LIBHEIF_CONTEXT_H
 #define LIBHEIF_CONTEXT_H
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <set>
@@ -33,7 +34,9 @@
 #include "libheif/heif.h"
 #include "libheif/heif_experimental.h"
 #include "libheif/heif_plugin.h"
+#include "libheif/heif_tracing.h"
 #include "bitstream.h"
+#include "tile_cache.h"
 
 #include "box.h" // only for color_profile, TODO: maybe move the color_profiles to its own header
 #include "file.h"
@@ -68,12 +71,42 @@ public:
 
   int get_max_decoding_threads() const { return m_max_decoding_threads; }
 
+  void set_max_encoding_threads(int max_threads) { m_max_encoding_threads = max_threads; }
+
+  int get_max_encoding_threads() const { return m_max_encoding_threads; }
+
+  void set_read_coalescing(bool enable, uint32_t max_gap)
+  {
+    m_read_coalescing = enable;
+    m_read_coalescing_max_gap = max_gap;
+  }
+
+  bool get_read_coalescing() const { return m_read_coalescing; }
+
+  uint32_t get_read_coalescing_max_gap() const { return m_read_coalescing_max_gap; }
+
   void set_security_limits(const heif_security_limits* limits);
 
   [[nodiscard]] heif_security_limits* get_security_limits() { return &m_limits; }
 
   [[nodiscard]] const heif_security_limits* get_security_limits() const { return &m_limits; }
 
+  void set_trace_callback(heif_trace_callback callback, void* userdata)
+  {
+    m_trace_callback = callback;
+    m_trace_callback_userdata = userdata;
+  }
+
+  heif_trace_callback get_trace_callback() const { return m_trace_callback; }
+
+  void* get_trace_callback_userdata() const { return m_trace_callback_userdata; }
+
+  void set_tile_cache_size(size_t max_bytes);
+
+  const DecodedTileCache& get_tile_cache() const { return m_tile_cache; }
+
+  DecodedTileCache& get_tile_cache() { return m_tile_cache; }
+
   Error read(const std::shared_ptr<StreamReader>& reader);
 
   Error read_from_file(const char* input_filename);
@@ -124,7 +157,8 @@ public:
 
   // === writing ===
 
-  void write(StreamWriter& writer);
+  // 'file_offset' is the file position of the start of 'writer' (see HeifFile::write()).
+  Error write(StreamWriter& writer, uint64_t file_offset = 0);
 
   // Create all boxes necessary for an empty HEIF file.
   // Note that this is no valid HEIF file, since some boxes (e.g. pitm) are generated, but
@@ -208,6 +242,40 @@ public:
 
   Result<std::shared_ptr<class Track_Metadata>> add_uri_metadata_sequence_track(const TrackOptions*, std::string uri);
 
+  // --- fragmented writing
+  //
+  // The file header ('ftyp', 'meta', 'moov') is written as soon as all tracks have a sample description.
+  // After that, each track writes a 'moof'+'mdat' pair whenever it collected samples of 'max_fragment_duration_ms'.
+
+  Error start_fragmented_writing(std::function<Error(const std::vector<uint8_t>&)> output,
+                                 uint32_t max_fragment_duration_ms);
+
+  bool is_fragmented_writing() const { return (bool) m_fragment_output; }
+
+  Error write_track_fragment(Track*);
+
+  Error end_fragmented_writing();
+
+  // --- streaming writing
+  //
+  // The 'ftyp' box is written when streaming is started. After that, the tile data added to 'unci' and 'tili'
+  // images is written into 'mdat' boxes immediately instead of being kept in memory until the file is written.
+  // end_streaming_writing() writes the 'meta' box, together with the remaining item data, at the end of the file.
+  // The brands are determined from the images that exist when streaming is started.
+
+  Error start_streaming_writing(std::function<Error(const std::vector<uint8_t>&)> output);
+
+  bool is_streaming_writing() const { return m_streaming_writing; }
+
+  // Appends data to the item and writes it to the output.
+  Error append_streamed_item_data(heif_item_id id, const std::vector<uint8_t>& data);
+
+  // Fills the reserved item data at 'item_offset' (see HeifFile::reserve_iloc_data()) and writes it to the output.
+  // Writing the same range twice is reported when the data is passed to the output, which may be in a later call.
+  Error write_streamed_reserved_item_data(heif_item_id id, uint64_t item_offset, const std::vector<uint8_t>& data);
+
+  Error end_streaming_writing();
+
   void add_text_item(std::shared_ptr<TextItem> text_item)
   {
     m_text_items.push_back(std::move(text_item));
@@ -267,6 +335,12 @@ public:
   }
 
 private:
+  Result<std::shared_ptr<HeifPixelImage>> decode_and_convert_image(const std::shared_ptr<ImageItem>& imgitem,
+                                                                   heif_colorspace out_colorspace,
+                                                                   heif_chroma out_chroma,
+                                                                   const heif_decoding_options& options,
+                                                                   bool decode_only_tile, uint32_t tx, uint32_t ty) const;
+
   std::map<heif_item_id, std::shared_ptr<ImageItem>> m_all_images;
 
   // We store this in a vector because we need stable indices for the C API.
@@ -278,10 +352,20 @@ private:
   std::shared_ptr<HeifFile> m_heif_file;
 
   int m_max_decoding_threads = 4;
+  int m_max_encoding_threads = 4;
+
+  bool m_read_coalescing = true;
+  uint32_t m_read_coalescing_max_gap = 16 * 1024;
 
   heif_security_limits m_limits;
   TotalMemoryTracker m_memory_tracker;
 
+  // Declared after the memory tracker so that the cached tiles are released first.
+  mutable DecodedTileCache m_tile_cache;
+
+  heif_trace_callback m_trace_callback = nullptr;
+  void* m_trace_callback_userdata = nullptr;
+
   std::vector<std::shared_ptr<RegionItem>> m_region_items;
   std::vector<std::shared_ptr<TextItem>> m_text_items;
 
@@ -291,6 +375,37 @@ private:
   uint32_t m_visual_track_id = 0;
   uint32_t m_sequence_repetitions = 1;
 
+  std::function<Error(const std::vector<uint8_t>&)> m_fragment_output;
+  bool m_fragment_header_written = false;
+  bool m_fragmented_writing_ended = false;
+  uint32_t m_fragment_sequence_number = 0;
+
+  Error write_fragment_header(bool force);
+
+  std::function<Error(const std::vector<uint8_t>&)> m_streaming_output; // released when the file is finished
+  bool m_streaming_writing = false;
+  bool m_streaming_writing_ended = false;
+  uint64_t m_streaming_position = 0; // number of bytes passed to the output
+
+  // Small pieces of item data are collected into one 'mdat' box to limit the number of 'iloc' extents.
+  struct StreamingChunk
+  {
+    heif_item_id item_id = 0;
+    bool reserved_data = false;
+    uint64_t item_offset = 0; // only for reserved data
+    std::vector<uint8_t> data;
+  };
+
+  StreamingChunk m_streaming_chunk;
+
+  Error stream_item_data(heif_item_id id, bool reserved_data, uint64_t item_offset, const std::vector<uint8_t>& data);
+
+  Error write_streamed_mdat(heif_item_id id, bool reserved_data, uint64_t item_offset, const std::vector<uint8_t>& data);
+
+  Error flush_streaming_chunk();
+
+  void set_ftyp_brands();
+
   Error interpret_heif_file();
 
   Error interpret_heif_file_images();
@@ -126,14 +126,14 @@ Error HeifFile::read_from_memory(const void* data, size_t size, bool copy)
 }
 
 
-Error HeifFile::read(const std::shared_ptr<StreamReader>& reader)
+Error HeifFile::read(const std::shared_ptr<StreamReader>& reader, bool metadata_only)
 {
   assert(m_limits);
 
   m_input_stream = reader;
 
   Error err;
-  err = m_file_layout->read(reader, m_limits);
+  err = m_file_layout->read(reader, m_limits, metadata_only);
   if (err) {
     return err;
   }
@@ -221,7 +221,7 @@ void HeifFile::derive_box_versions()
 }
 
 
-void HeifFile::write(StreamWriter& writer)
+void HeifFile::write(StreamWriter& writer, uint64_t file_offset)
 {
   for (auto& box : m_top_level_boxes) {
 #if ENABLE_EXPERIMENTAL_MINI_FORMAT
@@ -230,13 +230,17 @@ void HeifFile::write(StreamWriter& writer)
       continue;
     }
 #endif
+    if (file_offset > 0 && box == m_ftyp_box) {
+      continue;
+    }
+
     Error err = box->write(writer);
     (void)err; // TODO: error ?
   }
 
   if (m_iloc_box) {
     // TODO: rewrite to use MdatData class
-    Error err = m_iloc_box->write_mdat_after_iloc(writer);
+    Error err = m_iloc_box->write_mdat_after_iloc(writer, file_offset);
     (void)err; // TODO: error ?
   }
 
@@ -729,7 +733,137 @@ Error HeifFile::append_data_from_iloc(heif_item_id ID, std::vector<uint8_t>& out
             sstr.str()};
   }
 
-  return m_iloc_box->read_data(ID, m_input_stream, m_idat_box, &out_data, offset, size, m_limits);
+  return m_iloc_box->read_data(ID, get_reader_for_item(ID), m_idat_box, &out_data, offset, size, m_limits);
+}
+
+
+std::vector<std::shared_ptr<HeifFile::ReadBuffer>> HeifFile::add_read_buffers(const std::vector<FileRange>& ranges)
+{
+  std::vector<std::shared_ptr<ReadBuffer>> buffers;
+
+  // There is nothing to gain when the whole file is in memory already.
+  if (std::dynamic_pointer_cast<StreamReader_memory>(m_input_stream)) {
+    return buffers;
+  }
+
+  for (const auto& range : ranges) {
+    // e.g. the alpha tiles, which have been read together with the color tiles
+    if (is_range_buffered(range)) {
+      continue;
+    }
+
+    uint64_t size = range.end - range.start;
+    if (size == 0) {
+      continue;
+    }
+
+    // Reserve the size in the total budget of this file. Concurrent decodes of the same file share the budget.
+    {
+#if ENABLE_MULTITHREADING_SUPPORT
+      std::lock_guard<std::mutex> lock(m_read_buffers_mutex);
+#endif
+
+      if (size > max_total_read_buffer_size - m_read_buffers_total_size) {
+        continue;
+      }
+
+      m_read_buffers_total_size += size;
+    }
+
+    auto buffer = std::make_shared<ReadBuffer>();
+    buffer->range = range;
+
+    Error err = buffer->memory.alloc(size, m_limits, "coalesced read buffer");
+    if (!err) {
+      err = Box_iloc::read_file_range(m_input_stream, range, buffer->data);
+    }
+
+    if (err) {
+#if ENABLE_MULTITHREADING_SUPPORT
+      std::lock_guard<std::mutex> lock(m_read_buffers_mutex);
+#endif
+      m_read_buffers_total_size -= size;
+      continue;
+    }
+
+    buffers.push_back(buffer);
+  }
+
+#if ENABLE_MULTITHREADING_SUPPORT
+  std::lock_guard<std::mutex> lock(m_read_buffers_mutex);
+#endif
+
+  m_read_buffers.insert(m_read_buffers.end(), buffers.begin(), buffers.end());
+
+  return buffers;
+}
+
+
+void HeifFile::release_read_buffers(const std::vector<std::shared_ptr<ReadBuffer>>& buffers)
+{
+#if ENABLE_MULTITHREADING_SUPPORT
+  std::lock_guard<std::mutex> lock(m_read_buffers_mutex);
+#endif
+
+  // Readers that are still in use keep their buffer alive (see get_reader_for_item()).
+  // It is only removed from the list, such that no new readers are created for it.
+  for (const auto& buffer : buffers) {
+    m_read_buffers.erase(std::remove(m_read_buffers.begin(), m_read_buffers.end(), buffer), m_read_buffers.end());
+    m_read_buffers_total_size -= buffer->range.end - buffer->range.start;
+  }
+}
+
+
+bool HeifFile::is_range_buffered(const FileRange& range) const
+{
+#if ENABLE_MULTITHREADING_SUPPORT
+  std::lock_guard<std::mutex> lock(m_read_buffers_mutex);
+#endif
+
+  return std::any_of(m_read_buffers.begin(), m_read_buffers.end(), [&range](const std::shared_ptr<ReadBuffer>& buffer) {
+    return range.start >= buffer->range.start && range.end <= buffer->range.end;
+  });
+}
+
+
+std::shared_ptr<StreamReader> HeifFile::get_reader_for_item(heif_item_id ID) const
+{
+#if ENABLE_MULTITHREADING_SUPPORT
+  std::lock_guard<std::mutex> lock(m_read_buffers_mutex);
+#endif
+
+  if (m_read_buffers.empty()) {
+    return m_input_stream;
+  }
+
+  // Box_iloc::read_data() checks the availability of all extents, even when it reads only a part of the item.
+  // Thus, a buffer can only be used when it holds the complete item.
+  std::vector<FileRange> item_ranges;
+  Error err = m_iloc_box->get_file_ranges(ID, 0, std::numeric_limits<uint64_t>::max(), item_ranges);
+  if (err || item_ranges.empty()) {
+    return m_input_stream;
+  }
+
+  for (const auto& buffer : m_read_buffers) {
+    bool contains_all = std::all_of(item_ranges.begin(), item_ranges.end(), [&buffer](const FileRange& r) {
+      return r.start >= buffer->range.start && r.end <= buffer->range.end;
+    });
+
+    if (contains_all) {
+      // Each caller gets its own reader because the read position is not shared between threads.
+      // The reader keeps the buffer alive, even when the buffer is released while the item is still being read.
+      return std::shared_ptr<StreamReader>(new StreamReader_memory(buffer->data.data(), buffer->data.size(), false, buffer->range.start),
+                                           [buffer](StreamReader* reader) { delete reader; });
+    }
+  }
+
+  return m_input_stream;
+}
+
+
+Error HeifFile::get_file_ranges_from_iloc(heif_item_id ID, uint64_t offset, uint64_t size, std::vector<FileRange>& out_ranges) const
+{
+  return m_iloc_box->get_file_ranges(ID, offset, size, out_ranges);
 }
 
 
@@ -1059,7 +1193,11 @@ Error HeifFile::set_item_data(const std::shared_ptr<Box_infe>& item, const uint8
   std::vector<uint8_t> data_array;
   if (compression == heif_metadata_compression_zlib) {
 #if HAVE_ZLIB
-    data_array = compress_zlib((const uint8_t*) data, size);
+    Result<std::vector<uint8_t>> compressed = compress_zlib((const uint8_t*) data, size);
+    if (!compressed) {
+      return compressed.error();
+    }
+    data_array = std::move(*compressed);
     item->set_content_encoding("compress_zlib");
 #else
     return Error(heif_error_Unsupported_feature,
@@ -1068,7 +1206,11 @@ Error HeifFile::set_item_data(const std::shared_ptr<Box_infe>& item, const uint8
   }
   else if (compression == heif_metadata_compression_deflate) {
 #if HAVE_ZLIB
-    data_array = compress_deflate((const uint8_t*) data, size);
+    Result<std::vector<uint8_t>> compressed = compress_deflate((const uint8_t*) data, size);
+    if (!compressed) {
+      return compressed.error();
+    }
+    data_array = std::move(*compressed);
     item->set_content_encoding("compress_zlib");
 #else
     return Error(heif_error_Unsupported_feature,
@@ -1128,6 +1270,12 @@ void HeifFile::replace_iloc_data(heif_item_id id, uint64_t offset, const std::ve
 }
 
 
+void HeifFile::reserve_iloc_data(heif_item_id id, uint64_t length)
+{
+  m_iloc_box->reserve_data(id, length);
+}
+
+
 void HeifFile::set_primary_item_id(heif_item_id id)
 {
   if (!m_pitm_box) {
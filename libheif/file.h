@@ -38,8 +38,9 @@
 #include <limits>
 #include <utility>
 #include "mdat_data.h"
+#include "security_limits.h"
 
-#if ENABLE_PARALLEL_TILE_DECODING
+#if ENABLE_MULTITHREADING_SUPPORT
 
 #include <mutex>
 
@@ -67,7 +68,8 @@ public:
   // You have to make sure that the pointer points to a valid object as long as the HeifFile is used.
   void set_security_limits(const heif_security_limits* limits) { m_limits = limits; }
 
-  Error read(const std::shared_ptr<StreamReader>& reader);
+  // See FileLayout::read() for 'metadata_only'.
+  Error read(const std::shared_ptr<StreamReader>& reader, bool metadata_only = false);
 
   Error read_from_file(const char* input_filename);
 
@@ -91,7 +93,9 @@ public:
 
   void derive_box_versions();
 
-  void write(StreamWriter& writer);
+  // 'file_offset' is the file position of the start of 'writer'. If it is not zero, the 'ftyp' box and the
+  // streamed item data have already been written (see HeifContext::start_streaming_writing()).
+  void write(StreamWriter& writer, uint64_t file_offset = 0);
 
   int get_num_images() const { return static_cast<int>(m_infe_boxes.size()); }
 
@@ -117,10 +121,32 @@ public:
 
   Error append_data_from_iloc(heif_item_id ID, std::vector<uint8_t>& out_data, uint64_t offset, uint64_t size) const;
 
+  Error get_file_ranges_from_iloc(heif_item_id ID, uint64_t offset, uint64_t size, std::vector<FileRange>& out_ranges) const;
+
   Error append_data_from_iloc(heif_item_id ID, std::vector<uint8_t>& out_data) const {
     return append_data_from_iloc(ID, out_data, 0, std::numeric_limits<uint64_t>::max());
   }
 
+  // --- read buffers
+
+  struct ReadBuffer
+  {
+    FileRange range;
+    std::vector<uint8_t> data;
+    MemoryHandle memory;
+  };
+
+  // Reads each of the file ranges with a single request. Until the buffers are released, item data
+  // that lies completely within one of the ranges is read from the buffer instead of the input stream.
+  // Ranges that cannot be read are skipped. Their data will be read on demand as usual.
+  // The same happens when buffering a range would exceed the security limits or the total size
+  // of all read buffers of this file (max_total_read_buffer_size).
+  std::vector<std::shared_ptr<ReadBuffer>> add_read_buffers(const std::vector<FileRange>& ranges);
+
+  static const uint64_t max_total_read_buffer_size = 256 * 1024 * 1024;
+
+  void release_read_buffers(const std::vector<std::shared_ptr<ReadBuffer>>& buffers);
+
   // If `out_compression` is not NULL, the compression method is returned there and the compressed data is returned.
   // If `out_compression` is NULL, the data is returned decompressed.
   Result<std::vector<uint8_t>> get_item_data(heif_item_id ID, heif_metadata_compression* out_compression) const;
@@ -217,6 +243,8 @@ public:
 
   void replace_iloc_data(heif_item_id id, uint64_t offset, const std::vector<uint8_t>& data, uint8_t construction_method = 0);
 
+  void reserve_iloc_data(heif_item_id id, uint64_t length);
+
   void set_iloc_box(std::shared_ptr<Box_iloc>);
 
   std::shared_ptr<Box_iloc> get_iloc_box() { return m_iloc_box; }
@@ -243,6 +271,8 @@ public:
 
   std::shared_ptr<Box_mvhd> get_mvhd_box() { return m_mvhd_box; }
 
+  const std::vector<FileLayout::MovieFragment>& get_movie_fragments() const { return m_file_layout->get_movie_fragments(); }
+
 private:
 #if ENABLE_PARALLEL_TILE_DECODING
   mutable std::mutex m_read_mutex;
@@ -252,6 +282,16 @@ private:
 
   std::shared_ptr<StreamReader> m_input_stream;
 
+#if ENABLE_MULTITHREADING_SUPPORT
+  mutable std::mutex m_read_buffers_mutex;
+#endif
+  std::vector<std::shared_ptr<ReadBuffer>> m_read_buffers;
+  uint64_t m_read_buffers_total_size = 0;
+
+  bool is_range_buffered(const FileRange& range) const;
+
+  std::shared_ptr<StreamReader> get_reader_for_item(heif_item_id ID) const;
+
   std::vector<std::shared_ptr<Box> > m_top_level_boxes;
 
   std::shared_ptr<Box_ftyp> m_ftyp_box;
@@ -300,4 +340,26 @@ private:
                                       std::unordered_set<heif_item_id>& parent_items) const;
 };
 
+
+// Keeps read buffers of a HeifFile alive for the lifetime of this object.
+class ScopedReadBuffers
+{
+public:
+  ScopedReadBuffers(std::shared_ptr<HeifFile> file, const std::vector<FileRange>& ranges)
+      : m_file(std::move(file))
+  {
+    m_buffers = m_file->add_read_buffers(ranges);
+  }
+
+  ~ScopedReadBuffers() { m_file->release_read_buffers(m_buffers); }
+
+  ScopedReadBuffers(const ScopedReadBuffers&) = delete;
+
+  ScopedReadBuffers& operator=(const ScopedReadBuffers&) = delete;
+
+private:
+  std::shared_ptr<HeifFile> m_file;
+  std::vector<std::shared_ptr<HeifFile::ReadBuffer>> m_buffers;
+};
+
 #endif
@@ -35,9 +35,11 @@ FileLayout::FileLayout()
 }
 
 
-Error FileLayout::read(const std::shared_ptr<StreamReader>& stream, const heif_security_limits* limits)
+Error FileLayout::read(const std::shared_ptr<StreamReader>& stream, const heif_security_limits* limits,
+                       bool metadata_only)
 {
   m_boxes.clear();
+  m_movie_fragments.clear();
 
   m_stream_reader = stream;
 
@@ -147,9 +149,8 @@ Error FileLayout::read(const std::shared_ptr<StreamReader>& stream, const heif_s
                 "Cannot read full meta box"};
       }
 
-      BitstreamRange meta_box_range(m_stream_reader, meta_box_start, end_of_meta_box);
       std::shared_ptr<Box> meta_box;
-      err = Box::read(meta_box_range, &meta_box, limits);
+      err = read_top_level_box(meta_box_start, end_of_meta_box, &meta_box, limits);
       if (err) {
         return err;
       }
@@ -218,9 +219,8 @@ Error FileLayout::read(const std::shared_ptr<StreamReader>& stream, const heif_s
                 "Cannot read full moov box"};
       }
 
-      BitstreamRange moov_box_range(m_stream_reader, moov_box_start, end_of_moov_box);
       std::shared_ptr<Box> moov_box;
-      err = Box::read(moov_box_range, &moov_box, limits);
+      err = read_top_level_box(moov_box_start, end_of_moov_box, &moov_box, limits);
       if (err) {
         return err;
       }
@@ -231,6 +231,45 @@ Error FileLayout::read(const std::shared_ptr<StreamReader>& stream, const heif_s
       moov_found = true;
     }
 
+    if (box_header.get_short_type() == fourcc("moof")) {
+      const uint64_t moof_box_start = next_box_start;
+      if (box_header.get_box_size() == 0) {
+        return {heif_error_Invalid_input,
+                heif_suberror_Unspecified,
+                "Cannot read moof box with unspecified size"};
+      }
+
+      if (std::numeric_limits<uint64_t>::max() - box_header.get_box_size() < moof_box_start) {
+        return {heif_error_Invalid_input,
+                heif_suberror_Unspecified,
+                "Box size too large, integer overflow"};
+      }
+
+      uint64_t end_of_moof_box = moof_box_start + box_header.get_box_size();
+      if (m_max_length < end_of_moof_box) {
+        m_max_length = m_stream_reader->request_range(moof_box_start, end_of_moof_box);
+      }
+
+      if (m_max_length < end_of_moof_box) {
+        return {heif_error_Invalid_input,
+                heif_suberror_Unspecified,
+                "Cannot read full moof box"};
+      }
+
+      std::shared_ptr<Box> moof_box;
+      err = read_top_level_box(moof_box_start, end_of_moof_box, &moof_box, limits);
+      if (err) {
+        return err;
+      }
+
+      m_boxes.push_back(moof_box);
+      m_movie_fragments.push_back({std::dynamic_pointer_cast<Box_moof>(moof_box), moof_box_start});
+    }
+
+    if (metadata_only && (meta_found || mini_found || moov_found)) {
+      return Error::Ok;
+    }
+
     uint64_t boxSize = box_header.get_box_size();
     if (boxSize == Box::size_until_end_of_file) {
       if (meta_found || mini_found || moov_found) {
@@ -256,6 +295,38 @@ Error FileLayout::read(const std::shared_ptr<StreamReader>& stream, const heif_s
 }
 
 
+Error FileLayout::read_top_level_box(uint64_t start, uint64_t end, std::shared_ptr<Box>* box, const heif_security_limits* limits)
+{
+  std::shared_ptr<StreamReader> reader = m_stream_reader;
+  std::vector<uint8_t> data;
+
+  uint64_t size = end - start;
+  bool fits_into_memory_limit = (limits == nullptr ||
+                                 limits->max_memory_block_size == 0 ||
+                                 size <= limits->max_memory_block_size);
+
+  if (!std::dynamic_pointer_cast<StreamReader_memory>(m_stream_reader) &&
+      fits_into_memory_limit &&
+      size <= MAX_BOX_SIZE) {
+    data.resize(static_cast<size_t>(size));
+
+    if (!m_stream_reader->seek(start) ||
+        !m_stream_reader->read(data.data(), data.size())) {
+      return {heif_error_Invalid_input,
+              heif_suberror_End_of_data,
+              "Cannot read box data"};
+    }
+
+    // The memory reader reports file positions, such that boxes that remember
+    // their file position (e.g. 'idat') refer to the right data in the file.
+    reader = std::make_shared<StreamReader_memory>(data.data(), data.size(), false, start);
+  }
+
+  BitstreamRange range(reader, start, end);
+  return Box::read(range, box, limits);
+}
+
+
 void FileLayout::set_write_mode(WriteMode writeMode, const std::shared_ptr<StreamWriter>& writer)
 {
 
@@ -33,6 +33,8 @@
 
 class Box_moov;
 
+class Box_moof;
+
 
 class FileLayout
 {
@@ -46,7 +48,10 @@ public:
   // Generate a file in WriteMode::Floating
   FileLayout();
 
-  Error read(const std::shared_ptr<StreamReader>& stream, const heif_security_limits* limits);
+  // With 'metadata_only', reading stops as soon as the 'meta', 'mini' or 'moov' box has been parsed.
+  // No further box headers are read, such that the following 'mdat' is not touched.
+  Error read(const std::shared_ptr<StreamReader>& stream, const heif_security_limits* limits,
+             bool metadata_only = false);
 
   // For WriteMode::Streaming, writer cannot be null.
   void set_write_mode(WriteMode writeMode, const std::shared_ptr<StreamWriter>& writer = nullptr);
@@ -67,6 +72,15 @@ public:
 
   std::shared_ptr<Box_moov> get_moov_box() { return m_moov_box; }
 
+  struct MovieFragment
+  {
+    std::shared_ptr<Box_moof> moof;
+    uint64_t file_offset; // start of the 'moof' box
+  };
+
+  // The movie fragments in file order.
+  const std::vector<MovieFragment>& get_movie_fragments() const { return m_movie_fragments; }
+
 private:
   WriteMode m_writeMode = WriteMode::Floating;
 
@@ -83,6 +97,7 @@ private:
   std::shared_ptr<Box_mini> m_mini_box;
 #endif
   std::shared_ptr<Box_moov> m_moov_box;
+  std::vector<MovieFragment> m_movie_fragments;
 
 
   uint64_t m_max_length = 0; // Length seen so far. It can grow over time.
@@ -90,6 +105,10 @@ private:
   std::shared_ptr<StreamReader> m_stream_reader;
   std::shared_ptr<StreamWriter> m_stream_writer;
 
+  // Parses the box [start, end). Unless the input is already in memory, the box is first fetched with
+  // a single read so that the many small reads of the box parsers do not each go to the StreamReader.
+  Error read_top_level_box(uint64_t start, uint64_t end, std::shared_ptr<Box>* box, const heif_security_limits* limits);
+
   static const uint64_t INITIAL_FTYP_REQUEST = 1024; // should be enough to read ftyp and next box header
   static const uint16_t MAXIMUM_BOX_HEADER_SIZE = 32;
 };
@@ -26,8 +26,11 @@
 #include <future>
 #include <set>
 #include <algorithm>
+#include <limits>
 #include "api_structs.h"
 #include "security_limits.h"
+#include "trace.h"
+#include "thread_pool.h"
 
 
 Error ImageGrid::parse(const std::vector<uint8_t>& data)
@@ -223,12 +226,22 @@ Result<std::shared_ptr<HeifPixelImage>> ImageItem_Grid::decode_compressed_image(
     return decode_grid_tile(options, tile_x0, tile_y0);
   }
   else {
-    return decode_full_grid_image(options);
+    return decode_full_grid_image(options, heif_colorspace_undefined, heif_chroma_undefined);
   }
 }
 
 
-Result<std::shared_ptr<HeifPixelImage>> ImageItem_Grid::decode_full_grid_image(const heif_decoding_options& options) const
+Result<std::shared_ptr<HeifPixelImage>> ImageItem_Grid::decode_compressed_image_to_output(const heif_decoding_options& options,
+                                                                                          heif_colorspace out_colorspace,
+                                                                                          heif_chroma out_chroma) const
+{
+  return decode_full_grid_image(options, out_colorspace, out_chroma);
+}
+
+
+Result<std::shared_ptr<HeifPixelImage>> ImageItem_Grid::decode_full_grid_image(const heif_decoding_options& options,
+                                                                               heif_colorspace out_colorspace,
+                                                                               heif_chroma out_chroma) const
 {
   std::shared_ptr<HeifPixelImage> img; // the decoded image
 
@@ -275,7 +288,7 @@ Result<std::shared_ptr<HeifPixelImage>> ImageItem_Grid::decode_full_grid_image(c
   if (get_context()->get_max_decoding_threads() > 0)
     tiles.resize(static_cast<size_t>(grid.get_rows()) * static_cast<size_t>(grid.get_columns()));
 
-  std::deque<std::future<Error> > errs;
+  std::deque<ThreadPool::Future<Error> > errs;
 #endif
 
   uint32_t tile_width = 0;
@@ -347,7 +360,7 @@ Result<std::shared_ptr<HeifPixelImage>> ImageItem_Grid::decode_full_grid_image(c
           }
         }
 
-        err = decode_and_paste_tile_image(tileID, x0, y0, img, options, progress_counter);
+        err = decode_and_paste_tile_image(tileID, x0, y0, img, options, out_colorspace, out_chroma, progress_counter);
         if (err) {
           return err;
         }
@@ -363,20 +376,29 @@ Result<std::shared_ptr<HeifPixelImage>> ImageItem_Grid::decode_full_grid_image(c
 
 #if ENABLE_PARALLEL_TILE_DECODING
   if (get_context()->get_max_decoding_threads() > 0) {
-    // Process all tiles in a set of background threads.
-    // Do not start more than the maximum number of threads.
+    // Process all tiles in the thread pool.
+    // Do not queue more than the maximum number of tiles at a time.
+
+    ThreadPool& pool = ThreadPool::global();
+
+    // The tasks reference 'img' and 'progress_counter'. Wait for all of them before returning.
+    auto wait_for_remaining_tiles = [&pool, &errs]() {
+      for (auto& e : errs) {
+        pool.wait(e);
+      }
+    };
 
     while (!tiles.empty() && !cancelled) {
 
-      // If maximum number of threads running, wait until first thread finishes
+      // If maximum number of tiles is queued, wait until the first one finishes
 
       if (errs.size() >= (size_t) get_context()->get_max_decoding_threads()) {
-        Error e = errs.front().get();
+        Error e = pool.get(errs.front());
+        errs.pop_front();
         if (e) {
+          wait_for_remaining_tiles();
           return e;
         }
-
-        errs.pop_front();
       }
 
 
@@ -387,26 +409,28 @@ Result<std::shared_ptr<HeifPixelImage>> ImageItem_Grid::decode_full_grid_image(c
       }
 
 
-      // Start a new decoding thread
+      // Queue the next tile
 
       tile_data data = tiles.front();
       tiles.pop_front();
 
-      errs.push_back(std::async(std::launch::async,
-                                &ImageItem_Grid::decode_and_paste_tile_image, this,
-                                data.tileID, data.x_origin, data.y_origin, std::ref(img), options,
-                                std::ref(progress_counter)));
+      errs.push_back(pool.async([this, data, &img, options, out_colorspace, out_chroma, &progress_counter, trace = current_trace()]() {
+                                  TraceBinding trace_binding(trace);
+                                  return decode_and_paste_tile_image(data.tileID, data.x_origin, data.y_origin,
+                                                                     img, options, out_colorspace, out_chroma,
+                                                                     progress_counter);
+                                }));
     }
 
     // check for decoding errors in remaining tiles
 
     while (!errs.empty()) {
-      Error e = errs.front().get();
+      Error e = pool.get(errs.front());
+      errs.pop_front();
       if (e) {
+        wait_for_remaining_tiles();
         return e;
       }
-
-      errs.pop_front();
     }
   }
 #endif
@@ -425,6 +449,7 @@ Result<std::shared_ptr<HeifPixelImage>> ImageItem_Grid::decode_full_grid_image(c
 Error ImageItem_Grid::decode_and_paste_tile_image(heif_item_id tileID, uint32_t x0, uint32_t y0,
                                                   std::shared_ptr<HeifPixelImage>& inout_image,
                                                   const heif_decoding_options& options,
+                                                  heif_colorspace out_colorspace, heif_chroma out_chroma,
                                                   int& progress_counter) const
 {
   std::shared_ptr<HeifPixelImage> tile_img;
@@ -442,6 +467,26 @@ Error ImageItem_Grid::decode_and_paste_tile_image(heif_item_id tileID, uint32_t
 
   tile_img = *decodeResult;
 
+  // --- convert the tile into the output colorspace, using the color profiles of the grid image
+
+  if (out_colorspace != heif_colorspace_undefined && out_chroma != heif_chroma_undefined) {
+    auto nclx = get_color_profile_nclx();
+    if (!nclx.is_undefined()) {
+      tile_img->set_color_profile_nclx(nclx);
+    }
+
+    if (auto icc = get_color_profile_icc()) {
+      tile_img->set_color_profile_icc(icc);
+    }
+
+    auto convertResult = get_context()->convert_to_output_colorspace(tile_img, out_colorspace, out_chroma, options);
+    if (!convertResult) {
+      return convertResult.error();
+    }
+
+    tile_img = *convertResult;
+  }
+
   uint32_t w = get_grid_spec().get_width();
   uint32_t h = get_grid_spec().get_height();
 
@@ -514,7 +559,8 @@ Result<std::shared_ptr<HeifPixelImage>> ImageItem_Grid::decode_grid_tile(const h
     return error;
   }
 
-  return tile_item->decode_compressed_image(options, true, tx, ty);
+  // (tx;ty) is the position in the grid. The tile item itself is decoded completely.
+  return tile_item->decode_compressed_image(options, false, 0, 0);
 }
 
 
@@ -570,6 +616,29 @@ void ImageItem_Grid::get_tile_size(uint32_t& w, uint32_t& h) const
 }
 
 
+Error ImageItem_Grid::append_tile_file_ranges(uint32_t tile_x, uint32_t tile_y, std::vector<FileRange>& ranges) const
+{
+  if (tile_x >= m_grid_spec.get_columns() || tile_y >= m_grid_spec.get_rows()) {
+    return {heif_error_Usage_error,
+            heif_suberror_Unspecified,
+            "Grid tile index out of range"};
+  }
+
+  heif_item_id tile_id = m_grid_tile_ids[tile_y * m_grid_spec.get_columns() + tile_x];
+
+  return get_file()->get_file_ranges_from_iloc(tile_id, 0, std::numeric_limits<uint64_t>::max(), ranges);
+}
+
+
+void ImageItem_Grid::append_file_ranges_for_full_decode(std::vector<FileRange>& ranges) const
+{
+  for (heif_item_id tile_id : m_grid_tile_ids) {
+    // Errors are reported when the tile is decoded.
+    (void) get_file()->get_file_ranges_from_iloc(tile_id, 0, std::numeric_limits<uint64_t>::max(), ranges);
+  }
+}
+
+
 
 int ImageItem_Grid::get_luma_bits_per_pixel() const
 {
@@ -739,8 +808,8 @@ Result<std::shared_ptr<ImageItem_Grid>> ImageItem_Grid::add_and_encode_full_grid
 
   ImageGrid grid;
   grid.set_num_tiles(columns, rows);
-  uint32_t tile_width = tiles[0]->get_width(heif_channel_interleaved);
-  uint32_t tile_height = tiles[0]->get_height(heif_channel_interleaved);
+  uint32_t tile_width = tiles[0]->get_width();
+  uint32_t tile_height = tiles[0]->get_height();
   grid.set_output_size(tile_width * columns, tile_height * rows);
   std::vector<uint8_t> grid_data = grid.write();
 
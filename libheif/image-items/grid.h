@@ -132,6 +132,13 @@ public:
   Result<std::shared_ptr<HeifPixelImage>> decode_compressed_image(const heif_decoding_options& options,
                                                                   bool decode_tile_only, uint32_t tile_x0, uint32_t tile_y0) const override;
 
+  bool can_decode_compressed_image_to_output() const override { return true; }
+
+  // Each tile is color-converted on its decoding thread and then pasted into the output image.
+  Result<std::shared_ptr<HeifPixelImage>> decode_compressed_image_to_output(const heif_decoding_options& options,
+                                                                            heif_colorspace out_colorspace,
+                                                                            heif_chroma out_chroma) const override;
+
   heif_brand2 get_compatible_brand() const override;
 
 protected:
@@ -153,6 +160,10 @@ public:
 
   void get_tile_size(uint32_t& w, uint32_t& h) const override;
 
+  Error append_tile_file_ranges(uint32_t tile_x, uint32_t tile_y, std::vector<FileRange>& ranges) const override;
+
+  void append_file_ranges_for_full_decode(std::vector<FileRange>& ranges) const override;
+
 private:
   ImageGrid m_grid_spec;
   std::vector<heif_item_id> m_grid_tile_ids;
@@ -161,13 +172,18 @@ private:
 
   Error read_grid_spec();
 
-  Result<std::shared_ptr<HeifPixelImage>> decode_full_grid_image(const heif_decoding_options& options) const;
+  // When 'out_colorspace' and 'out_chroma' are defined, the tiles are converted before pasting them into the image.
+  Result<std::shared_ptr<HeifPixelImage>> decode_full_grid_image(const heif_decoding_options& options,
+                                                                 heif_colorspace out_colorspace,
+                                                                 heif_chroma out_chroma) const;
 
   Result<std::shared_ptr<HeifPixelImage>> decode_grid_tile(const heif_decoding_options& options, uint32_t tx, uint32_t ty) const;
 
   Error decode_and_paste_tile_image(heif_item_id tileID, uint32_t x0, uint32_t y0,
                                     std::shared_ptr<HeifPixelImage>& inout_image,
-                                    const heif_decoding_options& options, int& progress_counter) const;
+                                    const heif_decoding_options& options,
+                                    heif_colorspace out_colorspace, heif_chroma out_chroma,
+                                    int& progress_counter) const;
 };
 
 
@@ -36,7 +36,9 @@
 #include "api_structs.h"
 #include "plugin_registry.h"
 #include "security_limits.h"
+#include "trace.h"
 
+#include <optional>
 #include <limits>
 #include <cassert>
 #include <cstring>
@@ -244,6 +246,8 @@ Result<Encoder::CodedImageData> ImageItem::encode_to_bitstream_and_boxes(const s
                                                                            const heif_encoding_options& options,
                                                                            heif_image_input_class input_class)
 {
+  TraceScope trace_scope(TraceStage::codec);
+
   // === generate compressed image bitstream
 
   Result<Encoder::CodedImageData> encodeResult = encode(image, encoder, options, input_class);
@@ -682,16 +686,21 @@ Result<std::shared_ptr<HeifPixelImage>> ImageItem::decode_image(const heif_decod
   // --- check whether image size (according to 'ispe') exceeds maximum
 
   if (!decode_tile_only) {
-    auto ispe = get_property<Box_ispe>();
-    if (ispe) {
-      Error err = check_for_valid_image_size(get_context()->get_security_limits(), ispe->get_width(), ispe->get_height());
-      if (err) {
-        return err;
-      }
+    if (Error err = check_image_size_for_full_decode()) {
+      return err;
     }
   }
 
 
+  // --- read the coded data of all tiles with a few large requests
+
+  std::optional<ScopedReadBuffers> read_buffers;
+
+  if (!decode_tile_only) {
+    read_coded_data_for_full_decode(read_buffers);
+  }
+
+
   // --- transform tile position
 
   if (decode_tile_only && options.ignore_transformations == false) {
@@ -709,14 +718,13 @@ Result<std::shared_ptr<HeifPixelImage>> ImageItem::decode_image(const heif_decod
 
   auto img = *decodingResult;
 
-  std::shared_ptr<HeifFile> file = m_heif_context->get_heif_file();
-
-
   // --- apply image transformations
 
   Error error;
 
   if (options.ignore_transformations == false) {
+    TraceScope trace_scope(TraceStage::transform);
+
     Result<std::vector<std::shared_ptr<Box>>> propertiesResult = get_properties();
     if (!propertiesResult) {
       return propertiesResult.error();
@@ -792,6 +800,8 @@ Result<std::shared_ptr<HeifPixelImage>> ImageItem::decode_image(const heif_decod
 
   std::shared_ptr<ImageItem> alpha_image = get_alpha_channel();
   if (alpha_image) {
+    TraceScope trace_scope(TraceStage::alpha);
+
     if (alpha_image->get_item_error()) {
       return alpha_image->get_item_error();
     }
@@ -862,39 +872,114 @@ Result<std::shared_ptr<HeifPixelImage>> ImageItem::decode_image(const heif_decod
 
   // --- attach metadata to image
 
-  {
-    auto ipco_box = file->get_ipco_box();
-    auto ipma_box = file->get_ipma_box();
+  attach_metadata_to_decoded_image(img);
 
-    // CLLI
+  return img;
+}
 
-    auto clli = get_property<Box_clli>();
-    if (clli) {
-      img->set_clli(clli->clli);
-    }
 
-    // MDCV
+Error ImageItem::check_image_size_for_full_decode() const
+{
+  auto ispe = get_property<Box_ispe>();
+  if (ispe) {
+    return check_for_valid_image_size(get_context()->get_security_limits(), ispe->get_width(), ispe->get_height());
+  }
 
-    auto mdcv = get_property<Box_mdcv>();
-    if (mdcv) {
-      img->set_mdcv(mdcv->mdcv);
-    }
+  return Error::Ok;
+}
 
-    // PASP
 
-    auto pasp = get_property<Box_pasp>();
-    if (pasp) {
-      img->set_pixel_ratio(pasp->hSpacing, pasp->vSpacing);
-    }
+void ImageItem::read_coded_data_for_full_decode(std::optional<ScopedReadBuffers>& read_buffers) const
+{
+  if (!get_context()->get_read_coalescing()) {
+    return;
+  }
+
+  std::vector<FileRange> ranges;
+  append_file_ranges_for_full_decode(ranges);
+  if (m_alpha_channel) {
+    m_alpha_channel->append_file_ranges_for_full_decode(ranges);
+  }
 
-    // TAI
+  if (!ranges.empty()) {
+    merge_file_ranges(ranges, get_context()->get_read_coalescing_max_gap());
+    read_buffers.emplace(get_file(), ranges);
+  }
+}
+
+
+void ImageItem::attach_metadata_to_decoded_image(const std::shared_ptr<HeifPixelImage>& img) const
+{
+  // CLLI
 
-    auto itai = get_property<Box_itai>();
-    if (itai) {
-      img->set_tai_timestamp(itai->get_tai_timestamp_packet());
+  auto clli = get_property<Box_clli>();
+  if (clli) {
+    img->set_clli(clli->clli);
+  }
+
+  // MDCV
+
+  auto mdcv = get_property<Box_mdcv>();
+  if (mdcv) {
+    img->set_mdcv(mdcv->mdcv);
+  }
+
+  // PASP
+
+  auto pasp = get_property<Box_pasp>();
+  if (pasp) {
+    img->set_pixel_ratio(pasp->hSpacing, pasp->vSpacing);
+  }
+
+  // TAI
+
+  auto itai = get_property<Box_itai>();
+  if (itai) {
+    img->set_tai_timestamp(itai->get_tai_timestamp_packet());
+  }
+}
+
+
+Result<std::shared_ptr<HeifPixelImage>> ImageItem::decode_image_to_output(const heif_decoding_options& options,
+                                                                          heif_colorspace out_colorspace,
+                                                                          heif_chroma out_chroma) const
+{
+  if (!can_decode_compressed_image_to_output()) {
+    return std::shared_ptr<HeifPixelImage>();
+  }
+
+  // The alpha channel of an auxiliary image has to be merged before the color conversion.
+
+  if (get_alpha_channel()) {
+    return std::shared_ptr<HeifPixelImage>();
+  }
+
+  // The image transformations do not support interleaved output images.
+
+  if (options.ignore_transformations == false) {
+    if (get_property<Box_irot>() || get_property<Box_imir>() || get_property<Box_clap>()) {
+      return std::shared_ptr<HeifPixelImage>();
     }
   }
 
+  if (Error err = check_image_size_for_full_decode()) {
+    return err;
+  }
+
+  std::optional<ScopedReadBuffers> read_buffers;
+  read_coded_data_for_full_decode(read_buffers);
+
+  auto decodingResult = decode_compressed_image_to_output(options, out_colorspace, out_chroma);
+  if (!decodingResult) {
+    return decodingResult.error();
+  }
+
+  auto img = *decodingResult;
+
+  // The color profiles of the item have already been used for the color conversion.
+
+  attach_metadata_to_decoded_image(img);
+
   return img;
 }
 
@@ -933,6 +1018,18 @@ Result<std::shared_ptr<HeifPixelImage>> ImageItem::decode_compressed_image(const
 }
 
 
+std::shared_ptr<const RegionSpatialIndex> ImageItem::get_region_spatial_index() const
+{
+  std::lock_guard<std::mutex> lock(m_region_index_mutex);
+
+  if (!m_region_index || m_region_index->is_outdated(get_context(), m_region_item_ids)) {
+    m_region_index = RegionSpatialIndex::create(get_context(), get_id(), m_region_item_ids);
+  }
+
+  return m_region_index;
+}
+
+
 heif_image_tiling ImageItem::get_heif_image_tiling() const
 {
   // --- Return a dummy tiling consisting of only a single tile for the whole image
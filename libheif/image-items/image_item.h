@@ -29,6 +29,8 @@
 #include <memory>
 #include <utility>
 #include <set>
+#include <mutex>
+#include <optional>
 
 #include "pixelimage.h"
 #include "api/libheif/heif_plugin.h"
@@ -311,6 +313,22 @@ public:
                                                                           bool decode_tile_only, uint32_t tile_x0,
                                                                           uint32_t tile_y0) const;
 
+  // Decodes the full image and converts it into the output colorspace while decoding.
+  // Returns a NULL image if the item does not support this. The image then has to be decoded with decode_image().
+  Result<std::shared_ptr<HeifPixelImage>> decode_image_to_output(const heif_decoding_options& options,
+                                                                 heif_colorspace out_colorspace,
+                                                                 heif_chroma out_chroma) const;
+
+  virtual bool can_decode_compressed_image_to_output() const { return false; }
+
+  virtual Result<std::shared_ptr<HeifPixelImage>> decode_compressed_image_to_output(const heif_decoding_options& options,
+                                                                                    heif_colorspace out_colorspace,
+                                                                                    heif_chroma out_chroma) const
+  {
+    return Error{heif_error_Unsupported_feature, heif_suberror_Unspecified,
+                 "Image item cannot be decoded directly into the output colorspace"};
+  }
+
   Result<std::vector<std::shared_ptr<Box>>> get_properties() const;
 
   bool has_essential_property_other_than(const std::set<uint32_t>&) const;
@@ -357,6 +375,9 @@ public:
 
   const std::vector<heif_item_id>& get_region_item_ids() const { return m_region_item_ids; }
 
+  // Built on first use and rebuilt when regions have been added since.
+  std::shared_ptr<const class RegionSpatialIndex> get_region_spatial_index() const;
+
 
   void add_decoding_warning(Error err) { m_decoding_warnings.emplace_back(std::move(err)); }
 
@@ -368,6 +389,14 @@ public:
 
   Error transform_requested_tile_position_to_original_tile_position(uint32_t& tile_x, uint32_t& tile_y) const;
 
+  // Appends the file ranges holding the coded data of a tile, given in original (untransformed) tile coordinates.
+  // This is only used for preload hints. Items that do not support it add no ranges.
+  virtual Error append_tile_file_ranges(uint32_t tile_x, uint32_t tile_y, std::vector<FileRange>& ranges) const { return Error::Ok; }
+
+  // Appends the file ranges that a decode of the whole image will read, if this is known in advance.
+  // These ranges are read in bulk before decoding.
+  virtual void append_file_ranges_for_full_decode(std::vector<FileRange>& ranges) const { }
+
   virtual Result<std::shared_ptr<class Decoder>> get_decoder() const
   {
     return Error{
@@ -417,6 +446,9 @@ private:
 
   std::vector<heif_item_id> m_region_item_ids;
 
+  mutable std::mutex m_region_index_mutex;
+  mutable std::shared_ptr<class RegionSpatialIndex> m_region_index;
+
   bool m_has_intrinsic_matrix = false;
   Box_cmin::AbsoluteIntrinsicMatrix m_intrinsic_matrix{};
 
@@ -429,6 +461,13 @@ private:
 
   void generate_property_boxes_for_ImageExtraData();
 
+  Error check_image_size_for_full_decode() const;
+
+  // Reads the coded data of all tiles with a few large requests, if read coalescing is enabled.
+  void read_coded_data_for_full_decode(std::optional<class ScopedReadBuffers>& read_buffers) const;
+
+  void attach_metadata_to_decoded_image(const std::shared_ptr<HeifPixelImage>& img) const;
+
 protected:
   // Result<std::vector<uint8_t>> read_bitstream_configuration_data_override(heif_item_id itemId, heif_compression_format format) const;
 
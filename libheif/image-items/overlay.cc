@@ -23,6 +23,11 @@
 #include "file.h"
 #include "color-conversion/colorconversion.h"
 #include "security_limits.h"
+#include "trace.h"
+#include "thread_pool.h"
+#include <algorithm>
+#include <deque>
+#include <future>
 
 
 template<typename I>
@@ -39,6 +44,7 @@ void writevec(uint8_t* data, size_t& idx, I value, int len)
 static int32_t readvec_signed(const std::vector<uint8_t>& data, int& ptr, int len)
 {
   const uint32_t high_bit = UINT32_C(0x80) << ((len - 1) * 8);
+  const int64_t range = INT64_C(1) << (len * 8);
 
   uint32_t val = 0;
   while (len--) {
@@ -49,7 +55,7 @@ static int32_t readvec_signed(const std::vector<uint8_t>& data, int& ptr, int le
   bool negative = (val & high_bit) != 0;
 
   if (negative) {
-    return -static_cast<int32_t>((~val) & 0x7fffffff) -1;
+    return static_cast<int32_t>(static_cast<int64_t>(val) - range);
   }
   else {
     return static_cast<int32_t>(val);
@@ -279,6 +285,39 @@ Result<std::shared_ptr<HeifPixelImage>> ImageItem_Overlay::decode_compressed_ima
 }
 
 
+Result<std::shared_ptr<HeifPixelImage>> ImageItem_Overlay::decode_overlay_layer(heif_item_id layer_id,
+                                                                               const heif_decoding_options& options) const
+{
+  auto imgItem = get_context()->get_image(layer_id, true);
+
+  auto decodeResult = imgItem->decode_image(options, false, 0, 0);
+  if (!decodeResult) {
+    return decodeResult.error();
+  }
+
+  std::shared_ptr<HeifPixelImage> overlay_img = *decodeResult;
+
+
+  // Convert the layer directly into the format of the canvas (8 bit RGB 4:4:4).
+
+  if (overlay_img->get_colorspace() != heif_colorspace_RGB ||
+      overlay_img->get_chroma_format() != heif_chroma_444 ||
+      overlay_img->get_bits_per_pixel(heif_channel_R) != 8) {
+    auto overlay_img_result = convert_colorspace(overlay_img, heif_colorspace_RGB, heif_chroma_444,
+                                                 nclx_profile::undefined(),
+                                                 8, options.color_conversion_options, options.color_conversion_options_ext,
+                                                 get_context()->get_security_limits());
+    if (!overlay_img_result) {
+      return overlay_img_result.error();
+    }
+
+    overlay_img = *overlay_img_result;
+  }
+
+  return overlay_img;
+}
+
+
 Result<std::shared_ptr<HeifPixelImage>> ImageItem_Overlay::decode_overlay_image(const heif_decoding_options& options) const
 {
   std::shared_ptr<HeifPixelImage> img;
@@ -314,6 +353,22 @@ Result<std::shared_ptr<HeifPixelImage>> ImageItem_Overlay::decode_overlay_image(
     return err;
   }
 
+
+  // --- collect the visible layers
+
+  struct Layer
+  {
+    heif_item_id id;
+    int32_t dx, dy;
+  };
+
+  struct Rect
+  {
+    int64_t x0, y0, x1, y1;
+  };
+
+  std::vector<Layer> layers;
+
   for (size_t i = 0; i < m_overlay_image_ids.size(); i++) {
 
     // detect if 'iovl' is referencing itself
@@ -332,34 +387,54 @@ Result<std::shared_ptr<HeifPixelImage>> ImageItem_Overlay::decode_overlay_image(
       return error;
     }
 
-    auto decodeResult = imgItem->decode_image(options, false, 0,0);
-    if (!decodeResult) {
-      return decodeResult.error();
-    }
+    int32_t dx, dy;
+    m_overlay_spec.get_offset(i, &dx, &dy);
+
+    layers.push_back(Layer{m_overlay_image_ids[i], dx, dy});
+  }
+
+  // Skip layers that are completely hidden behind an opaque layer on top of them or that lie outside of the canvas.
+  // The layer sizes are only known in advance when the transformations are applied.
 
-    std::shared_ptr<HeifPixelImage> overlay_img = *decodeResult;
+  if (!options.ignore_transformations) {
+    std::vector<Rect> opaque_areas;
+    std::vector<Layer> visible_layers;
 
+    for (auto it = layers.rbegin(); it != layers.rend(); ++it) {
+      auto imgItem = get_context()->get_image(it->id, true);
 
-    // process overlay in RGB space
+      Rect area{std::max<int64_t>(it->dx, 0),
+                std::max<int64_t>(it->dy, 0),
+                std::min<int64_t>(int64_t{it->dx} + imgItem->get_width(), w),
+                std::min<int64_t>(int64_t{it->dy} + imgItem->get_height(), h)};
 
-    if (overlay_img->get_colorspace() != heif_colorspace_RGB ||
-        overlay_img->get_chroma_format() != heif_chroma_444) {
-      auto overlay_img_result = convert_colorspace(overlay_img, heif_colorspace_RGB, heif_chroma_444,
-                                                   nclx_profile::undefined(),
-                                                   0, options.color_conversion_options, options.color_conversion_options_ext,
-                                                   get_context()->get_security_limits());
-      if (!overlay_img_result) {
-        return overlay_img_result.error();
+      if (area.x0 >= area.x1 || area.y0 >= area.y1) {
+        continue;
       }
-      else {
-        overlay_img = *overlay_img_result;
+
+      bool occluded = std::any_of(opaque_areas.begin(), opaque_areas.end(), [&area](const Rect& r) {
+        return r.x0 <= area.x0 && r.y0 <= area.y0 && r.x1 >= area.x1 && r.y1 >= area.y1;
+      });
+
+      if (occluded) {
+        continue;
       }
+
+      if (!imgItem->get_alpha_channel() && !imgItem->has_coded_alpha_channel()) {
+        opaque_areas.push_back(area);
+      }
+
+      visible_layers.push_back(*it);
     }
 
-    int32_t dx, dy;
-    m_overlay_spec.get_offset(i, &dx, &dy);
+    layers.assign(visible_layers.rbegin(), visible_layers.rend());
+  }
+
 
-    err = img->overlay(overlay_img, dx, dy);
+  // --- decode layers and paste them in stacking order
+
+  auto paste_layer = [&img](const Layer& layer, std::shared_ptr<HeifPixelImage> overlay_img) -> Error {
+    Error err = img->overlay(overlay_img, layer.dx, layer.dy);
     if (err) {
       if (err.error_code == heif_error_Invalid_input &&
           err.sub_error_code == heif_suberror_Overlay_image_outside_of_canvas) {
@@ -369,6 +444,66 @@ Result<std::shared_ptr<HeifPixelImage>> ImageItem_Overlay::decode_overlay_image(
         return err;
       }
     }
+
+    return Error::Ok;
+  };
+
+#if ENABLE_PARALLEL_TILE_DECODING
+  int max_threads = get_context()->get_max_decoding_threads();
+  if (max_threads > 0 && layers.size() > 1) {
+    // Layers are decoded in parallel, but composed in order. At most 'max_threads' decoded layers are kept in memory.
+
+    ThreadPool& pool = ThreadPool::global();
+
+    std::deque<std::pair<Layer, ThreadPool::Future<Result<std::shared_ptr<HeifPixelImage>>>>> pending;
+
+    for (size_t i = 0; i < layers.size() || !pending.empty();) {
+      if (i < layers.size() && pending.size() < (size_t) max_threads) {
+        pending.emplace_back(layers[i], pool.async([this, id = layers[i].id, &options, trace = current_trace()]() {
+                                                     TraceBinding trace_binding(trace);
+                                                     return decode_overlay_layer(id, options);
+                                                   }));
+        i++;
+        continue;
+      }
+
+      Result<std::shared_ptr<HeifPixelImage>> decodeResult = pool.get(pending.front().second);
+      Layer layer = pending.front().first;
+      pending.pop_front();
+
+      if (!decodeResult) {
+        // wait for the remaining tasks before returning
+        for (auto& p : pending) {
+          pool.wait(p.second);
+        }
+
+        return decodeResult.error();
+      }
+
+      err = paste_layer(layer, *decodeResult);
+      if (err) {
+        for (auto& p : pending) {
+          pool.wait(p.second);
+        }
+
+        return err;
+      }
+    }
+
+    return img;
+  }
+#endif
+
+  for (const Layer& layer : layers) {
+    auto decodeResult = decode_overlay_layer(layer.id, options);
+    if (!decodeResult) {
+      return decodeResult.error();
+    }
+
+    err = paste_layer(layer, *decodeResult);
+    if (err) {
+      return err;
+    }
   }
 
   return img;
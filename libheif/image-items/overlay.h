@@ -131,6 +131,10 @@ private:
   Error read_overlay_spec();
 
   Result<std::shared_ptr<HeifPixelImage>> decode_overlay_image(const heif_decoding_options& options) const;
+
+  // Decodes a single layer and converts it to the canvas format.
+  Result<std::shared_ptr<HeifPixelImage>> decode_overlay_layer(heif_item_id layer_id,
+                                                               const heif_decoding_options& options) const;
 };
 
 
@@ -683,9 +683,6 @@ Error ImageItem_Tiled::add_image_tile(uint32_t tile_x, uint32_t tile_y,
     return encodeResult.error();
   }
 
-  const int construction_method = 0; // 0=mdat 1=idat
-  get_file()->append_iloc_data(get_id(), encodeResult->bitstream, construction_method);
-
   auto& header = m_tild_header;
 
   if (image->get_width() != header.get_parameters().tile_width ||
@@ -700,6 +697,18 @@ Error ImageItem_Tiled::add_image_tile(uint32_t tile_x, uint32_t tile_y,
   if (dataSize > 0xFFFFFFFF) {
     return {heif_error_Encoding_error, heif_suberror_Unspecified, "Compressed tile size exceeds maximum tile size."};
   }
+
+  const int construction_method = 0; // 0=mdat 1=idat
+  if (get_context()->is_streaming_writing()) {
+    Error err = get_context()->append_streamed_item_data(get_id(), encodeResult->bitstream);
+    if (err) {
+      return err;
+    }
+  }
+  else {
+    get_file()->append_iloc_data(get_id(), encodeResult->bitstream, construction_method);
+  }
+
   header.set_tild_tile_range(tile_x, tile_y, offset, static_cast<uint32_t>(dataSize));
   set_next_tild_position(offset + encodeResult->bitstream.size());
 
@@ -845,6 +854,34 @@ Error ImageItem_Tiled::load_tile_offset_entry(uint32_t idx)
 }
 
 
+Error ImageItem_Tiled::append_tile_file_ranges(uint32_t tile_x, uint32_t tile_y, std::vector<FileRange>& ranges) const
+{
+  const heif_tiled_image_parameters& params = m_tild_header.get_parameters();
+  if (tile_x >= nTiles_h(params) || tile_y >= nTiles_v(params)) {
+    return {heif_error_Usage_error,
+            heif_suberror_Unspecified,
+            "Tile index out of range"};
+  }
+
+  uint32_t idx = (uint32_t) (tile_y * nTiles_h(params) + tile_x);
+
+  // The offset table has to be read before we know where the tile is stored.
+  if (!m_tild_header.is_tile_offset_known(idx)) {
+    Error err = const_cast<ImageItem_Tiled*>(this)->load_tile_offset_entry(idx);
+    if (err) {
+      return err;
+    }
+  }
+
+  uint64_t offset = m_tild_header.get_tile_offset(idx);
+  if (offset == TILD_OFFSET_NOT_AVAILABLE || offset == TILD_OFFSET_SEE_LOWER_RESOLUTION_LAYER) {
+    return Error::Ok;
+  }
+
+  return get_file()->get_file_ranges_from_iloc(get_id(), offset, m_tild_header.get_tile_size(idx), ranges);
+}
+
+
 heif_image_tiling ImageItem_Tiled::get_heif_image_tiling() const
 {
   heif_image_tiling tiling{};
@@ -199,6 +199,8 @@ public:
 
   void get_tile_size(uint32_t& w, uint32_t& h) const override;
 
+  Error append_tile_file_ranges(uint32_t tile_x, uint32_t tile_y, std::vector<FileRange>& ranges) const override;
+
 private:
   TiledHeader m_tild_header;
   uint64_t m_next_tild_position = 0;
@@ -38,6 +38,12 @@
 #include "codecs/uncompressed/unc_enc.h"
 #include "codecs/uncompressed/unc_codec.h"
 #include "image_item.h"
+#include "thread_pool.h"
+
+#if ENABLE_MULTITHREADING_SUPPORT
+#include <deque>
+#include <future>
+#endif
 
 
 
@@ -253,9 +259,11 @@ Result<std::vector<uint8_t>> encode_image_tile(const std::shared_ptr<const HeifP
     {
       size_t src_stride;
       const uint8_t* src_data = src_image->get_plane(channel, &src_stride);
-      uint64_t out_size = static_cast<uint64_t>(src_image->get_height()) * src_stride;
+      uint64_t out_size = static_cast<uint64_t>(src_image->get_height()) * src_image->get_width();
       data.resize(data.size() + out_size);
-      memcpy(data.data() + offset, src_data, out_size);
+      for (uint32_t y = 0; y < src_image->get_height(); y++) {
+        memcpy(data.data() + offset + y * src_image->get_width(), src_data + y * src_stride, src_image->get_width());
+      }
       offset += out_size;
     }
 
@@ -324,6 +332,23 @@ Result<Encoder::CodedImageData> ImageItem_uncompressed::encode_static(const std:
 }
 
 
+static uint32_t get_unci_compression_type(heif_unci_compression compression)
+{
+  switch (compression) {
+    case heif_unci_compression_deflate:
+      return fourcc("defl");
+    case heif_unci_compression_zlib:
+      return fourcc("zlib");
+    case heif_unci_compression_brotli:
+      return fourcc("brot");
+    case heif_unci_compression_zstd:
+      return fourcc("zstd");
+    default:
+      return 0;
+  }
+}
+
+
 Result<std::shared_ptr<ImageItem_uncompressed>> ImageItem_uncompressed::add_unci_item(HeifContext* ctx,
                                                                                       const heif_unci_image_parameters* parameters,
                                                                                       const heif_encoding_options* encoding_options,
@@ -338,6 +363,17 @@ Result<std::shared_ptr<ImageItem_uncompressed>> ImageItem_uncompressed::add_unci
                  "ISO 23001-17 image size must be an integer multiple of the tile size."};
   }
 
+  uint32_t compression_type = 0;
+  if (parameters->compression != heif_unci_compression_off) {
+    compression_type = get_unci_compression_type(parameters->compression);
+
+    if (!is_generic_compression_supported(compression_type)) {
+      return Error{heif_error_Unsupported_feature,
+                   heif_suberror_Unsupported_generic_compression_method,
+                   "The selected 'unci' compression method is not supported by this libheif build."};
+    }
+  }
+
   // Create 'unci' Item
 
   auto file = ctx->get_heif_file();
@@ -379,24 +415,7 @@ Result<std::shared_ptr<ImageItem_uncompressed>> ImageItem_uncompressed::add_unci
     auto cmpC = std::make_shared<Box_cmpC>();
     cmpC->set_compressed_unit_type(heif_cmpC_compressed_unit_type_image_tile);
 
-    if (false) {
-    }
-#if HAVE_ZLIB
-    else if (parameters->compression == heif_unci_compression_deflate) {
-      cmpC->set_compression_type(fourcc("defl"));
-    }
-    else if (parameters->compression == heif_unci_compression_zlib) {
-      cmpC->set_compression_type(fourcc("zlib"));
-    }
-#endif
-#if HAVE_BROTLI
-    else if (parameters->compression == heif_unci_compression_brotli) {
-      cmpC->set_compression_type(fourcc("brot"));
-    }
-#endif
-    else {
-      assert(false);
-    }
+    cmpC->set_compression_type(compression_type);
 
     unci_image->add_property(cmpC, true);
     unci_image->add_property_without_deduplication(icef, true); // icef is empty. A normal add_property() would lead to a wrong deduplication.
@@ -408,15 +427,10 @@ Result<std::shared_ptr<ImageItem_uncompressed>> ImageItem_uncompressed::add_unci
     uint64_t tile_size = headers.uncC->compute_tile_data_size_bytes(parameters->image_width / headers.uncC->get_number_of_tile_columns(),
                                                                     parameters->image_height / headers.uncC->get_number_of_tile_rows());
 
-    std::vector<uint8_t> dummydata;
-    dummydata.resize(tile_size);
-
-    uint32_t nTiles = (parameters->image_width / parameters->tile_width) * (parameters->image_height / parameters->tile_height);
+    uint64_t nTiles = uint64_t{parameters->image_width / parameters->tile_width} * (parameters->image_height / parameters->tile_height);
 
-    for (uint64_t i = 0; i < nTiles; i++) {
-      const int construction_method = 0; // 0=mdat 1=idat
-      file->append_iloc_data(unci_id, dummydata, construction_method);
-    }
+    // The memory is only allocated when the tiles are not streamed into the file (see HeifContext::start_streaming_writing()).
+    file->reserve_iloc_data(unci_id, nTiles * tile_size);
   }
 
   // Set Brands
@@ -426,20 +440,44 @@ Result<std::shared_ptr<ImageItem_uncompressed>> ImageItem_uncompressed::add_unci
 }
 
 
-Error ImageItem_uncompressed::add_image_tile(uint32_t tile_x, uint32_t tile_y, const std::shared_ptr<const HeifPixelImage>& image)
+static Result<std::vector<uint8_t>> encode_and_compress_image_tile(const std::shared_ptr<const HeifPixelImage>& image,
+                                                                  uint32_t compression_type)
+{
+  Result<std::vector<uint8_t>> codedBitstreamResult = encode_image_tile(image);
+  if (!codedBitstreamResult || compression_type == 0) {
+    return codedBitstreamResult;
+  }
+
+  const std::vector<uint8_t>& raw_data = *codedBitstreamResult;
+
+  return compress_generic(compression_type, raw_data.data(), raw_data.size());
+}
+
+
+Error ImageItem_uncompressed::check_tile_position(uint32_t tile_x, uint32_t tile_y) const
 {
   std::shared_ptr<Box_uncC> uncC = get_property<Box_uncC>();
   assert(uncC);
 
-  uint32_t tile_width = image->get_width();
-  uint32_t tile_height = image->get_height();
+  if (tile_x >= uncC->get_number_of_tile_columns() ||
+      tile_y >= uncC->get_number_of_tile_rows()) {
+    return {heif_error_Usage_error,
+            heif_suberror_Invalid_parameter_value,
+            "Tile position is outside of the image"};
+  }
 
-  uint32_t tile_idx = tile_y * uncC->get_number_of_tile_columns() + tile_x;
+  return Error::Ok;
+}
 
-  Result<std::vector<uint8_t>> codedBitstreamResult = encode_image_tile(image);
-  if (!codedBitstreamResult) {
-    return codedBitstreamResult.error();
-  }
+
+Error ImageItem_uncompressed::write_tile_data(uint32_t tile_x, uint32_t tile_y,
+                                              uint32_t tile_width, uint32_t tile_height,
+                                              const std::vector<uint8_t>& data)
+{
+  std::shared_ptr<Box_uncC> uncC = get_property<Box_uncC>();
+  assert(uncC);
+
+  uint32_t tile_idx = tile_y * uncC->get_number_of_tile_columns() + tile_x;
 
   std::shared_ptr<Box_cmpC> cmpC = get_property<Box_cmpC>();
   std::shared_ptr<Box_icef> icef = get_property<Box_icef>();
@@ -452,41 +490,121 @@ Error ImageItem_uncompressed::add_image_tile(uint32_t tile_x, uint32_t tile_y, c
 
     uint64_t tile_data_size = uncC->compute_tile_data_size_bytes(tile_width, tile_height);
 
-    get_file()->replace_iloc_data(get_id(), tile_idx * tile_data_size, *codedBitstreamResult, 0);
+    if (get_context()->is_streaming_writing()) {
+      return get_context()->write_streamed_reserved_item_data(get_id(), tile_idx * tile_data_size, data);
+    }
+
+    get_file()->replace_iloc_data(get_id(), tile_idx * tile_data_size, data, 0);
   }
   else {
-    std::vector<uint8_t> compressed_data;
-    const std::vector<uint8_t>& raw_data = std::move(*codedBitstreamResult);
-    (void)raw_data;
-
-    uint32_t compr = cmpC->get_compression_type();
-    switch (compr) {
-#if HAVE_ZLIB
-      case fourcc("defl"):
-        compressed_data = compress_deflate(raw_data.data(), raw_data.size());
-        break;
-      case fourcc("zlib"):
-        compressed_data = compress_zlib(raw_data.data(), raw_data.size());
-        break;
-#endif
-#if HAVE_BROTLI
-      case fourcc("brot"):
-        compressed_data = compress_brotli(raw_data.data(), raw_data.size());
-        break;
-#endif
-      default:
-        assert(false);
-        break;
+    if (get_context()->is_streaming_writing()) {
+      Error err = get_context()->append_streamed_item_data(get_id(), data);
+      if (err) {
+        return err;
+      }
+    }
+    else {
+      get_file()->append_iloc_data(get_id(), data, 0);
     }
-
-    get_file()->append_iloc_data(get_id(), compressed_data, 0);
 
     Box_icef::CompressedUnitInfo unit_info;
     unit_info.unit_offset = m_next_tile_write_pos;
-    unit_info.unit_size = compressed_data.size();
+    unit_info.unit_size = data.size();
     icef->set_component(tile_idx, unit_info);
 
-    m_next_tile_write_pos += compressed_data.size();
+    m_next_tile_write_pos += data.size();
+  }
+
+  return Error::Ok;
+}
+
+
+uint32_t ImageItem_uncompressed::get_tile_compression_type() const
+{
+  std::shared_ptr<Box_cmpC> cmpC = get_property<Box_cmpC>();
+  return cmpC ? cmpC->get_compression_type() : 0;
+}
+
+
+Error ImageItem_uncompressed::add_image_tile(uint32_t tile_x, uint32_t tile_y, const std::shared_ptr<const HeifPixelImage>& image)
+{
+  if (Error err = check_tile_position(tile_x, tile_y)) {
+    return err;
+  }
+
+  auto tileDataResult = encode_and_compress_image_tile(image, get_tile_compression_type());
+  if (!tileDataResult) {
+    return tileDataResult.error();
+  }
+
+  return write_tile_data(tile_x, tile_y, image->get_width(), image->get_height(), *tileDataResult);
+}
+
+
+Error ImageItem_uncompressed::add_image_tiles(const std::vector<TileInput>& tiles, int max_threads)
+{
+  for (const auto& tile : tiles) {
+    if (Error err = check_tile_position(tile.tile_x, tile.tile_y)) {
+      return err;
+    }
+  }
+
+  uint32_t compression_type = get_tile_compression_type();
+
+#if ENABLE_MULTITHREADING_SUPPORT
+  if (max_threads > 0 && tiles.size() > 1) {
+    // Encode and compress up to 'max_threads' tiles concurrently, but write them to the file in input order.
+    // This keeps the output deterministic and only 'max_threads' encoded tiles in memory at any time.
+
+    ThreadPool& pool = ThreadPool::global();
+
+    std::deque<ThreadPool::Future<Result<std::vector<uint8_t>>>> pending;
+    size_t next_tile_to_start = 0;
+
+    for (const auto& tile : tiles) {
+      while (next_tile_to_start < tiles.size() && pending.size() < (size_t) max_threads) {
+        pending.push_back(pool.async([image = tiles[next_tile_to_start].image, compression_type]() {
+          return encode_and_compress_image_tile(image, compression_type);
+        }));
+        next_tile_to_start++;
+      }
+
+      Result<std::vector<uint8_t>> tileDataResult = pool.get(pending.front());
+      pending.pop_front();
+
+      if (!tileDataResult) {
+        // wait for the remaining tasks before returning, they still reference the input images
+        for (auto& p : pending) {
+          pool.wait(p);
+        }
+
+        return tileDataResult.error();
+      }
+
+      Error err = write_tile_data(tile.tile_x, tile.tile_y, tile.image->get_width(), tile.image->get_height(), *tileDataResult);
+      if (err) {
+        for (auto& p : pending) {
+          pool.wait(p);
+        }
+
+        return err;
+      }
+    }
+
+    return Error::Ok;
+  }
+#endif
+
+  for (const auto& tile : tiles) {
+    auto tileDataResult = encode_and_compress_image_tile(tile.image, compression_type);
+    if (!tileDataResult) {
+      return tileDataResult.error();
+    }
+
+    Error err = write_tile_data(tile.tile_x, tile.tile_y, tile.image->get_width(), tile.image->get_height(), *tileDataResult);
+    if (err) {
+      return err;
+    }
   }
 
   return Error::Ok;
@@ -89,6 +89,16 @@ public:
 
   Error add_image_tile(uint32_t tile_x, uint32_t tile_y, const std::shared_ptr<const HeifPixelImage>& image);
 
+  struct TileInput
+  {
+    uint32_t tile_x, tile_y;
+    std::shared_ptr<const HeifPixelImage> image;
+  };
+
+  // Encodes and compresses the tiles with up to 'max_threads' background threads.
+  // The tile data is written to the file in the order of the 'tiles' vector.
+  Error add_image_tiles(const std::vector<TileInput>& tiles, int max_threads);
+
 protected:
   Result<std::shared_ptr<Decoder>> get_decoder() const override;
 
@@ -105,6 +115,15 @@ private:
                                                      */
 
   uint64_t m_next_tile_write_pos = 0;
+
+  Error check_tile_position(uint32_t tile_x, uint32_t tile_y) const;
+
+  // returns 0 if there is no generic compression
+  uint32_t get_tile_compression_type() const;
+
+  Error write_tile_data(uint32_t tile_x, uint32_t tile_y,
+                        uint32_t tile_width, uint32_t tile_height,
+                        const std::vector<uint8_t>& data);
 };
 
 #endif //LIBHEIF_UNC_IMAGE_H
@@ -24,6 +24,7 @@
 #include "plugin_registry.h"
 #include "common_utils.h"
 #include "color-conversion/colorconversion.h"
+#include "thread_pool.h"
 
 #if ENABLE_MULTITHREADING_SUPPORT
 
@@ -43,6 +44,8 @@ void heif_unload_all_plugins();
 
 #if ENABLE_PLUGIN_LOADING
 
+void heif_unregister_decoder_plugin(const heif_decoder_plugin* plugin);
+
 void heif_unregister_encoder_plugin(const heif_encoder_plugin* plugin);
 
 std::vector<std::string> get_plugin_paths()
@@ -85,7 +88,7 @@ static bool default_plugins_registered = true; // because they are implicitly re
 
 #if ENABLE_MULTITHREADING_SUPPORT
 
-static std::recursive_mutex& heif_init_mutex()
+std::recursive_mutex& heif_init_mutex()
 {
   static std::recursive_mutex init_mutex;
   return init_mutex;
@@ -94,6 +97,11 @@ static std::recursive_mutex& heif_init_mutex()
 #endif
 
 
+#if ENABLE_PLUGIN_LOADING
+static bool load_plugin_manifest(const std::string& directory);
+#endif
+
+
 void load_plugins_if_not_initialized_yet()
 {
   if (heif_library_initialization_count == 0) {
@@ -102,7 +110,7 @@ void load_plugins_if_not_initialized_yet()
 }
 
 
-heif_error heif_init(heif_init_params*)
+heif_error heif_init(heif_init_params* params)
 {
 #if ENABLE_MULTITHREADING_SUPPORT
   std::lock_guard<std::recursive_mutex> lock(heif_init_mutex());
@@ -112,6 +120,8 @@ heif_error heif_init(heif_init_params*)
 
     ColorConversionPipeline::init_ops();
 
+    ThreadPool::set_global_num_threads((params && params->version >= 2) ? params->num_worker_threads : 0);
+
     // --- initialize builtin plugins
 
     if (!default_plugins_registered) {
@@ -119,13 +129,17 @@ heif_error heif_init(heif_init_params*)
     }
 
 #if ENABLE_PLUGIN_LOADING
-    struct heif_error err{};
     std::vector<std::string> plugin_paths = get_plugin_paths();
 
+    // If the directory has an up-to-date manifest (see heif_write_plugin_manifest()), the plugins are only loaded
+    // when their compression format is used. Otherwise, load all plugins now.
+
     for (const auto& dir : plugin_paths) {
-      err = heif_load_plugins(dir.c_str(), nullptr, nullptr, 0);
-      if (err.code != 0) {
-        return err;
+      if (!load_plugin_manifest(dir)) {
+        heif_error err = heif_load_plugins(dir.c_str(), nullptr, nullptr, 0);
+        if (err.code != 0) {
+          return err;
+        }
       }
     }
 #endif
@@ -158,6 +172,8 @@ void heif_deinit()
     heif_unload_all_plugins();
 
     ColorConversionPipeline::release_ops();
+
+    ThreadPool::release_global();
   }
 
   // Note: contrary to heif_init() I think it does not matter whether we decrease the counter before or after deinitialization.
@@ -170,6 +186,17 @@ void heif_deinit()
 #include <vector>
 #include <string>
 #include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <atomic>
+#include <algorithm>
+#include <random>
+#include <sys/stat.h>
+
+#if !defined(_WIN32)
+#include <unistd.h>
+#endif
 
 #if ENABLE_PLUGIN_LOADING
 
@@ -189,9 +216,22 @@ struct loaded_plugin
 
 static std::vector<loaded_plugin> sLoadedPlugins;
 
+
+// A plugin listed in a plugin manifest that is loaded when one of its compression formats is requested.
+struct deferred_plugin
+{
+  std::string filename;
+  std::vector<heif_compression_format> formats;
+  bool loaded = false;
+};
+
+static std::vector<deferred_plugin> sDeferredPlugins;
+static std::atomic<bool> sHaveDeferredPlugins{false};
+
 MAYBE_UNUSED heif_error error_dlopen{heif_error_Plugin_loading_error, heif_suberror_Plugin_loading_error, "Cannot open plugin (dlopen)."};
 MAYBE_UNUSED heif_error error_plugin_not_loaded{heif_error_Plugin_loading_error, heif_suberror_Plugin_is_not_loaded, "Trying to remove a plugin that is not loaded."};
 MAYBE_UNUSED heif_error error_cannot_read_plugin_directory{heif_error_Plugin_loading_error, heif_suberror_Cannot_read_plugin_directory, "Cannot read plugin directory."};
+MAYBE_UNUSED heif_error error_cannot_write_plugin_manifest{heif_error_Plugin_loading_error, heif_suberror_Unspecified, "Cannot write plugin manifest."};
 
 MAYBE_UNUSED static void unregister_plugin(const heif_plugin_info* info)
 {
@@ -202,7 +242,9 @@ MAYBE_UNUSED static void unregister_plugin(const heif_plugin_info* info)
       break;
     }
     case heif_plugin_type_decoder: {
-      // TODO
+      auto* decoder_plugin = static_cast<const heif_decoder_plugin*>(info->plugin);
+      heif_unregister_decoder_plugin(decoder_plugin);
+      break;
     }
   }
 }
@@ -308,6 +350,9 @@ void heif_unload_all_plugins()
   }
 
   sLoadedPlugins.clear();
+
+  sDeferredPlugins.clear();
+  sHaveDeferredPlugins = false;
 }
 
 
@@ -347,6 +392,278 @@ struct heif_error heif_load_plugins(const char* directory,
   return heif_error_ok;
 }
 
+
+// --- plugin manifest
+//
+// The manifest is a text file in the plugin directory with one line per plugin file:
+//   <file name> TAB <file size> TAB <modification time> TAB <comma separated list of compression formats>
+// Files that are no plugins are also listed (without formats) such that the manifest stays valid.
+// The manifest is only used when it lists exactly the plugin files in the directory and
+// their sizes and modification times did not change.
+// libheif never writes the manifest on its own. It is written with heif_write_plugin_manifest(),
+// usually by running 'heif-info --write-plugin-manifest' after installing or updating plugins.
+
+static const char* const kPluginManifestFilename = "libheif-plugins.manifest";
+static const char* const kPluginManifestHeader = "# libheif plugin manifest v1";
+
+static const heif_compression_format kPluginManifestFormats[] = {
+    heif_compression_HEVC, heif_compression_AVC, heif_compression_JPEG, heif_compression_AV1, heif_compression_VVC,
+    heif_compression_EVC, heif_compression_JPEG2000, heif_compression_uncompressed, heif_compression_mask,
+    heif_compression_HTJ2K
+};
+
+
+static std::string get_plugin_file_basename(const std::string& path)
+{
+  size_t pos = path.find_last_of("/\\");
+  return (pos == std::string::npos) ? path : path.substr(pos + 1);
+}
+
+
+static bool get_plugin_file_signature(const std::string& path, int64_t& size, int64_t& mtime)
+{
+  struct stat st{};
+  if (stat(path.c_str(), &st) != 0) {
+    return false;
+  }
+
+  size = (int64_t) st.st_size;
+  mtime = (int64_t) st.st_mtime;
+  return true;
+}
+
+
+static std::vector<heif_compression_format> get_plugin_compression_formats(const heif_plugin_info* info)
+{
+  std::vector<heif_compression_format> formats;
+
+  switch (info->type) {
+    case heif_plugin_type_encoder: {
+      auto* encoder_plugin = static_cast<const heif_encoder_plugin*>(info->plugin);
+      formats.push_back(encoder_plugin->compression_format);
+      break;
+    }
+    case heif_plugin_type_decoder: {
+      auto* decoder_plugin = static_cast<const heif_decoder_plugin*>(info->plugin);
+      for (auto format : kPluginManifestFormats) {
+        if (decoder_plugin->does_support_format(format) > 0) {
+          formats.push_back(format);
+        }
+      }
+      break;
+    }
+  }
+
+  return formats;
+}
+
+
+static bool load_plugin_manifest(const std::string& directory)
+{
+  std::ifstream manifest(directory + "/" + kPluginManifestFilename);
+  if (!manifest) {
+    return false;
+  }
+
+  std::string line;
+  if (!std::getline(manifest, line) || line != kPluginManifestHeader) {
+    return false;
+  }
+
+  std::vector<std::string> plugin_files = list_all_potential_plugins_in_directory(directory.c_str());
+
+  std::vector<deferred_plugin> plugins;
+  size_t nListedFiles = 0;
+
+  while (std::getline(manifest, line)) {
+    if (line.empty()) {
+      continue;
+    }
+
+    std::istringstream fields(line);
+    std::string name, size_str, mtime_str, formats_str;
+    if (!std::getline(fields, name, '\t') ||
+        !std::getline(fields, size_str, '\t') ||
+        !std::getline(fields, mtime_str, '\t')) {
+      return false;
+    }
+    std::getline(fields, formats_str);
+
+    // --- check that the plugin file is unchanged
+
+    auto file_iter = std::find_if(plugin_files.begin(), plugin_files.end(),
+                                  [&name](const std::string& f) { return get_plugin_file_basename(f) == name; });
+    if (file_iter == plugin_files.end()) {
+      return false;
+    }
+
+    int64_t size, mtime;
+    if (!get_plugin_file_signature(*file_iter, size, mtime) ||
+        std::to_string(size) != size_str ||
+        std::to_string(mtime) != mtime_str) {
+      return false;
+    }
+
+    nListedFiles++;
+
+    deferred_plugin plugin;
+    plugin.filename = *file_iter;
+
+    std::istringstream formats(formats_str);
+    std::string format;
+    while (std::getline(formats, format, ',')) {
+      plugin.formats.push_back(static_cast<heif_compression_format>(std::atoi(format.c_str())));
+    }
+
+    if (!plugin.formats.empty()) {
+      plugins.push_back(plugin);
+    }
+  }
+
+  // A new plugin has been added to the directory.
+  if (nListedFiles != plugin_files.size()) {
+    return false;
+  }
+
+  sDeferredPlugins.insert(sDeferredPlugins.end(), plugins.begin(), plugins.end());
+  if (!sDeferredPlugins.empty()) {
+    sHaveDeferredPlugins = true;
+  }
+
+  return true;
+}
+
+
+static long get_process_id()
+{
+#if defined(_WIN32)
+  return (long) GetCurrentProcessId();
+#else
+  return (long) getpid();
+#endif
+}
+
+
+// Replaces 'target' with 'source' in a single step.
+static bool replace_file(const std::string& source, const std::string& target)
+{
+#if defined(_WIN32)
+  return MoveFileExA(source.c_str(), target.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+  return std::rename(source.c_str(), target.c_str()) == 0;
+#endif
+}
+
+
+static std::string get_unique_temporary_filename(const std::string& path)
+{
+  static std::atomic<int> counter{0};
+
+  std::stringstream sstr;
+  sstr << path << ".tmp." << get_process_id() << "." << std::random_device()() << "." << counter++;
+  return sstr.str();
+}
+
+
+struct heif_error heif_write_plugin_manifest(const char* directory)
+{
+  std::stringstream manifest;
+  manifest << kPluginManifestHeader << "\n";
+
+  for (const auto& filename : list_all_potential_plugins_in_directory(directory)) {
+    const struct heif_plugin_info* info = nullptr;
+    auto err = heif_load_plugin(filename.c_str(), &info);
+
+    int64_t size, mtime;
+    if (!get_plugin_file_signature(filename, size, mtime)) {
+      continue;
+    }
+
+    manifest << get_plugin_file_basename(filename) << '\t' << size << '\t' << mtime << '\t';
+
+    if (err.code == 0 && info) {
+      bool first = true;
+      for (auto format : get_plugin_compression_formats(info)) {
+        manifest << (first ? "" : ",") << ((int) format);
+        first = false;
+      }
+    }
+
+    manifest << "\n";
+
+    // Unless it has been loaded before, the plugin is unloaded again. It will be loaded on demand.
+    if (err.code == 0 && info) {
+      heif_unload_plugin(info);
+    }
+  }
+
+  // Write to a temporary file with a unique name first and rename it to the manifest name, such that concurrently
+  // running processes never see an incomplete manifest and do not overwrite each other's temporary file.
+
+  std::string manifest_path = std::string(directory) + "/" + kPluginManifestFilename;
+  std::string tmp_path = get_unique_temporary_filename(manifest_path);
+
+  {
+    std::ofstream out(tmp_path, std::ios::binary);
+    if (!out) {
+      return error_cannot_write_plugin_manifest;
+    }
+
+    out << manifest.str();
+    out.close();
+
+    if (!out) {
+      std::remove(tmp_path.c_str());
+      return error_cannot_write_plugin_manifest;
+    }
+  }
+
+  if (!replace_file(tmp_path, manifest_path)) {
+    std::remove(tmp_path.c_str());
+    return error_cannot_write_plugin_manifest;
+  }
+
+  return heif_error_ok;
+}
+
+
+bool have_deferred_plugins()
+{
+  return sHaveDeferredPlugins;
+}
+
+
+void load_deferred_plugins(heif_compression_format format)
+{
+  if (!sHaveDeferredPlugins) {
+    return;
+  }
+
+#if ENABLE_MULTITHREADING_SUPPORT
+  std::lock_guard<std::recursive_mutex> lock(heif_init_mutex());
+#endif
+
+  bool plugins_pending = false;
+
+  for (auto& plugin : sDeferredPlugins) {
+    if (plugin.loaded) {
+      continue;
+    }
+
+    if (format == heif_compression_undefined ||
+        std::find(plugin.formats.begin(), plugin.formats.end(), format) != plugin.formats.end()) {
+      const struct heif_plugin_info* info = nullptr;
+      heif_load_plugin(plugin.filename.c_str(), &info); // errors are ignored, as in heif_load_plugins()
+      plugin.loaded = true;
+    }
+    else {
+      plugins_pending = true;
+    }
+  }
+
+  sHaveDeferredPlugins = plugins_pending;
+}
+
 #else
 static heif_error heif_error_plugins_unsupported{heif_error_Unsupported_feature, heif_suberror_Unspecified, "Plugins are not supported"};
 
@@ -364,6 +681,15 @@ struct heif_error heif_unload_plugin(const struct heif_plugin_info* plugin)
 
 void heif_unload_all_plugins() {}
 
+bool have_deferred_plugins() { return false; }
+
+void load_deferred_plugins(heif_compression_format) {}
+
+struct heif_error heif_write_plugin_manifest(const char* directory)
+{
+  return heif_error_plugins_unsupported;
+}
+
 struct heif_error heif_load_plugins(const char* directory,
                                     const struct heif_plugin_info** out_plugins,
                                     int* out_nPluginsLoaded,
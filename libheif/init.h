@@ -51,4 +51,20 @@ std::vector<std::string> get_plugin_paths();
 // This is for implicit initialization when heif_init() is not called.
 void load_plugins_if_not_initialized_yet();
 
+// Load the plugins listed in a plugin manifest that support this compression format.
+// Plugins in a directory with a valid manifest are not loaded at heif_init(), but only when they are needed.
+// heif_compression_undefined loads all remaining plugins.
+void load_deferred_plugins(heif_compression_format format);
+
+// Whether there are plugins listed in a manifest that have not been loaded yet.
+// As long as this is false, the plugin registry is not modified by lazy plugin loading.
+bool have_deferred_plugins();
+
+#if ENABLE_MULTITHREADING_SUPPORT
+#include <mutex>
+
+// Guards library initialization and the plugin registry against concurrent (lazy) plugin loading.
+std::recursive_mutex& heif_init_mutex();
+#endif
+
 #endif //LIBHEIF_INIT_H
@@ -22,6 +22,7 @@
 #include "pixelimage.h"
 #include "common_utils.h"
 #include "security_limits.h"
+#include "trace.h"
 
 #include <cassert>
 #include <cstring>
@@ -445,6 +446,8 @@ Error HeifPixelImage::ImagePlane::alloc(uint32_t width, uint32_t height, heif_ch
             sstr.str()};
   }
 
+  trace_allocation(allocation_size);
+
   uint8_t* mem_8 = allocated_mem;
 
   // shift beginning of image data to aligned memory position
@@ -1395,6 +1398,19 @@ uint32_t negate_negative_int32(int32_t x)
 }
 
 
+// Blend 'in' over 'out' with 8-bit alpha. The loop is free of divisions and branches so that it gets auto-vectorized.
+static void blend_row_8bit(uint8_t* __restrict out, const uint8_t* __restrict in, const uint8_t* __restrict alpha, uint32_t width)
+{
+  for (uint32_t x = 0; x < width; x++) {
+    uint32_t a = alpha[x];
+    uint32_t t = in[x] * a + out[x] * (255 - a);
+
+    // exact t/255 for t <= 255*255
+    out[x] = static_cast<uint8_t>((t + 1 + (t >> 8)) >> 8);
+  }
+}
+
+
 Error HeifPixelImage::overlay(std::shared_ptr<HeifPixelImage>& overlay, int32_t dx, int32_t dy)
 {
   std::set<enum heif_channel> channels = overlay->get_channel_set();
@@ -1407,10 +1423,16 @@ Error HeifPixelImage::overlay(std::shared_ptr<HeifPixelImage>& overlay, int32_t
   alpha_p = overlay->get_plane(heif_channel_Alpha, &alpha_stride);
 
   for (heif_channel channel : channels) {
-    if (!has_channel(channel)) {
+    if (!has_channel(channel) || channel == heif_channel_Alpha) {
       continue;
     }
 
+    if (overlay->get_bits_per_pixel(channel) != 8 || get_bits_per_pixel(channel) != 8) {
+      return Error{heif_error_Unsupported_feature,
+                   heif_suberror_Unsupported_bit_depth,
+                   "Overlay images can only be composed with 8 bits per pixel"};
+    }
+
     size_t in_stride = 0;
     const uint8_t* in_p;
 
@@ -1451,69 +1473,27 @@ Error HeifPixelImage::overlay(std::shared_ptr<HeifPixelImage>& overlay, int32_t
     // --- compute overlapping area
 
     // top-left points where to start copying in source and destination
-    uint32_t in_x0;
-    uint32_t in_y0;
-    uint32_t out_x0;
-    uint32_t out_y0;
+    uint32_t in_x0 = (dx < 0) ? negate_negative_int32(dx) : 0;
+    uint32_t in_y0 = (dy < 0) ? negate_negative_int32(dy) : 0;
+    uint32_t out_x0 = (dx < 0) ? 0 : static_cast<uint32_t>(dx);
+    uint32_t out_y0 = (dy < 0) ? 0 : static_cast<uint32_t>(dy);
 
-    // right border
-    if (dx + static_cast<int64_t>(in_w) > out_w) {
-      // overlay image extends partially outside of right border
-      // Notes:
-      // - (out_w-dx) cannot underflow because dx<out_w is ensured above
-      // - (out_w-dx) cannot overflow (for dx<0) because, as just checked, out_w-dx < in_w
-      //              and in_w fits into uint32_t
-      in_w = static_cast<uint32_t>(static_cast<int64_t>(out_w) - dx);
-    }
-
-    // bottom border
-    if (dy + static_cast<int64_t>(in_h) > out_h) {
-      // overlay image extends partially outside of bottom border
-      in_h = static_cast<uint32_t>(static_cast<int64_t>(out_h) - dy);
-    }
-
-    // left border
-    if (dx < 0) {
-      // overlay image starts partially outside of left border
-
-      in_x0 = negate_negative_int32(dx);
-      out_x0 = 0;
-      in_w = in_w - in_x0; // in_x0 < in_w because in_w > -dx = in_x0
-    }
-    else {
-      in_x0 = 0;
-      out_x0 = static_cast<uint32_t>(dx);
-    }
-
-    // top border
-    if (dy < 0) {
-      // overlay image started partially outside of top border
-
-      in_y0 = negate_negative_int32(dy);
-      out_y0 = 0;
-      in_h = in_h - in_y0; // in_y0 < in_h because in_h > -dy = in_y0
-    }
-    else {
-      in_y0 = 0;
-      out_y0 = static_cast<uint32_t>(dy);
-    }
+    // Size of the overlapping area.
+    // in_x0 < in_w and out_x0 < out_w are ensured by the checks above.
+    uint32_t copy_w = std::min(in_w - in_x0, out_w - out_x0);
+    uint32_t copy_h = std::min(in_h - in_y0, out_h - out_y0);
 
     // --- computer overlay in overlapping area
 
-    for (uint32_t y = in_y0; y < in_h; y++) {
+    for (uint32_t y = 0; y < copy_h; y++) {
+      uint8_t* out_row = out_p + out_x0 + (out_y0 + y) * out_stride;
+      const uint8_t* in_row = in_p + in_x0 + (in_y0 + y) * in_stride;
+
       if (!has_alpha) {
-        memcpy(out_p + out_x0 + (out_y0 + y - in_y0) * out_stride,
-               in_p + in_x0 + y * in_stride,
-               in_w - in_x0);
+        memcpy(out_row, in_row, copy_w);
       }
       else {
-        for (uint32_t x = in_x0; x < in_w; x++) {
-          uint8_t* outptr = &out_p[out_x0 + (out_y0 + y - in_y0) * out_stride + x];
-          uint8_t in_val = in_p[in_x0 + y * in_stride + x];
-          uint8_t alpha_val = alpha_p[in_x0 + y * in_stride + x];
-
-          *outptr = (uint8_t) ((in_val * alpha_val + *outptr * (255 - alpha_val)) / 255);
-        }
+        blend_row_8bit(out_row, in_row, alpha_p + in_x0 + (in_y0 + y) * alpha_stride, copy_w);
       }
     }
   }
@@ -1739,6 +1719,42 @@ void HeifPixelImage::forward_all_metadata_from(const std::shared_ptr<const HeifP
 }
 
 
+Result<std::shared_ptr<HeifPixelImage>> HeifPixelImage::clone(const heif_security_limits* limits) const
+{
+  auto out_img = std::make_shared<HeifPixelImage>();
+  out_img->create(get_width(), get_height(), get_colorspace(), get_chroma_format());
+
+  for (heif_channel channel : get_channel_set()) {
+    if (Error err = out_img->copy_new_plane_from(shared_from_this(), channel, channel, limits)) {
+      return err;
+    }
+  }
+
+  out_img->forward_all_metadata_from(shared_from_this());
+
+  if (const auto* tai = get_tai_timestamp()) {
+    if (Error err = out_img->set_tai_timestamp(tai)) {
+      return err;
+    }
+  }
+
+  out_img->add_warnings(get_warnings());
+
+  return out_img;
+}
+
+
+size_t HeifPixelImage::get_memory_size() const
+{
+  size_t size = 0;
+  for (const auto& plane : m_planes) {
+    size += plane.second.allocation_size;
+  }
+
+  return size;
+}
+
+
 void HeifPixelImage::debug_dump() const
 {
   auto channels = get_channel_set();
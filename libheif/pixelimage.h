@@ -304,6 +304,12 @@ public:
 
   Error copy_image_to(const std::shared_ptr<const HeifPixelImage>& source, uint32_t x0, uint32_t y0);
 
+  // Deep copy of all planes, metadata and warnings.
+  Result<std::shared_ptr<HeifPixelImage>> clone(const heif_security_limits* limits) const;
+
+  // Number of bytes allocated for the image planes.
+  size_t get_memory_size() const;
+
   Result<std::shared_ptr<HeifPixelImage>> rotate_ccw(int angle_degrees, const heif_security_limits* limits);
 
   Result<std::shared_ptr<HeifPixelImage>> mirror_inplace(heif_transform_mirror_direction, const heif_security_limits* limits);
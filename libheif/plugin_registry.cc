@@ -110,19 +110,36 @@ std::set<const heif_decoder_plugin*> s_decoder_plugins;
 std::multiset<std::unique_ptr<heif_encoder_descriptor>,
               encoder_descriptor_priority_order> s_encoder_descriptors;
 
-std::set<const heif_decoder_plugin*>& get_decoder_plugins()
+std::vector<const heif_decoder_plugin*> get_decoder_plugins(heif_compression_format format)
 {
   load_plugins_if_not_initialized_yet();
 
-  return s_decoder_plugins;
+#if ENABLE_MULTITHREADING_SUPPORT
+  // Lazy plugin loading may modify the registry concurrently.
+  std::lock_guard<std::recursive_mutex> lock(heif_init_mutex());
+#endif
+
+  load_deferred_plugins(format);
+
+  return {s_decoder_plugins.begin(), s_decoder_plugins.end()};
 }
 
-extern std::multiset<std::unique_ptr<heif_encoder_descriptor>,
-                     encoder_descriptor_priority_order>& get_encoder_descriptors()
+std::vector<const heif_encoder_descriptor*> get_encoder_descriptors(heif_compression_format format)
 {
   load_plugins_if_not_initialized_yet();
 
-  return s_encoder_descriptors;
+#if ENABLE_MULTITHREADING_SUPPORT
+  std::lock_guard<std::recursive_mutex> lock(heif_init_mutex());
+#endif
+
+  load_deferred_plugins(format);
+
+  std::vector<const heif_encoder_descriptor*> descriptors;
+  for (const auto& descr : s_encoder_descriptors) {
+    descriptors.push_back(descr.get());
+  }
+
+  return descriptors;
 }
 
 
@@ -235,6 +252,16 @@ const heif_decoder_plugin* get_decoder(heif_compression_format type, const char*
 {
   load_plugins_if_not_initialized_yet();
 
+#if ENABLE_MULTITHREADING_SUPPORT
+  // Lazy plugin loading may modify the registry concurrently. Once all plugins are loaded, no lock is needed.
+  std::unique_lock<std::recursive_mutex> lock(heif_init_mutex(), std::defer_lock);
+  if (have_deferred_plugins()) {
+    lock.lock();
+  }
+#endif
+
+  load_deferred_plugins(type);
+
   int highest_priority = 0;
   const struct heif_decoder_plugin* best_plugin = nullptr;
 
@@ -289,6 +316,15 @@ get_filtered_encoder_descriptors(heif_compression_format format,
 {
   load_plugins_if_not_initialized_yet();
 
+#if ENABLE_MULTITHREADING_SUPPORT
+  std::unique_lock<std::recursive_mutex> lock(heif_init_mutex(), std::defer_lock);
+  if (have_deferred_plugins()) {
+    lock.lock();
+  }
+#endif
+
+  load_deferred_plugins(format);
+
   std::vector<const heif_encoder_descriptor*> filtered_descriptors;
 
   for (const auto& descr : s_encoder_descriptors) {
@@ -329,6 +365,13 @@ void heif_unregister_encoder_plugins()
 }
 
 #if ENABLE_PLUGIN_LOADING
+void heif_unregister_decoder_plugin(const heif_decoder_plugin* plugin)
+{
+  if (s_decoder_plugins.erase(plugin) && plugin->deinit_plugin) {
+    (*plugin->deinit_plugin)();
+  }
+}
+
 void heif_unregister_encoder_plugin(const heif_encoder_plugin* plugin)
 {
   if (plugin->cleanup_plugin) {
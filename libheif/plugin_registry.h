@@ -53,10 +53,13 @@ struct encoder_descriptor_priority_order
 };
 
 
-extern std::set<const heif_decoder_plugin*>& get_decoder_plugins();
+// Plugins that are listed in a plugin manifest are only loaded for the requested compression format.
+// heif_compression_undefined loads all of them.
+// Both functions return a snapshot of the registry, since other threads may load further plugins.
+extern std::vector<const heif_decoder_plugin*> get_decoder_plugins(heif_compression_format format);
 
-extern std::multiset<std::unique_ptr<heif_encoder_descriptor>,
-                     encoder_descriptor_priority_order>& get_encoder_descriptors();
+// Ordered by priority, highest first.
+extern std::vector<const heif_encoder_descriptor*> get_encoder_descriptors(heif_compression_format format);
 
 void register_default_plugins();
 
@@ -103,6 +103,9 @@ heif_error dav1d_new_decoder(void** dec)
 
   decoder->settings.all_layers = 0;
 
+  // 0 keeps the dav1d default of one thread per CPU core
+  decoder->settings.n_threads = heif_get_recommended_plugin_thread_count();
+
   if (dav1d_open(&decoder->context, &decoder->settings) != 0) {
     delete decoder;
     struct heif_error err = {heif_error_Decoder_plugin_error, heif_suberror_Unspecified, kSuccess};
@@ -248,7 +248,10 @@ static void aom_init_parameters()
   p->integer.have_minimum_maximum = true;
   p->integer.minimum = 1;
   p->integer.maximum = 64;
-  int threads = static_cast<int>(std::thread::hardware_concurrency());
+  int threads = heif_get_recommended_plugin_thread_count();
+  if (threads == 0) {
+    threads = static_cast<int>(std::thread::hardware_concurrency());
+  }
   if (threads == 0) {
     // Could not autodetect, use previous default value.
     threads = 4;
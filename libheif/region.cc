@@ -21,10 +21,17 @@
 #include "region.h"
 #include "error.h"
 #include "file.h"
+#include "context.h"
 #include "box.h"
 #include "libheif/heif_regions.h"
 #include <algorithm>
 #include <utility>
+#include <cmath>
+#include <cstring>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
 
 
 Error RegionItem::parse(const std::vector<uint8_t>& data)
@@ -472,11 +479,13 @@ RegionCoordinateTransform RegionCoordinateTransform::create(std::shared_ptr<Heif
           transform.a = -transform.a;
           transform.b = -transform.b;
           transform.tx = image_width - 1 - transform.tx;
+          transform.area_tx = image_width - transform.area_tx;
         }
         else {
           transform.c = -transform.c;
           transform.d = -transform.d;
           transform.ty = image_height - 1 - transform.ty;
+          transform.area_ty = image_height - transform.area_ty;
         }
         break;
       }
@@ -491,6 +500,8 @@ RegionCoordinateTransform RegionCoordinateTransform::create(std::shared_ptr<Heif
             tmp.d = -transform.b;
             tmp.tx = transform.ty;
             tmp.ty = -transform.tx + image_width - 1;
+            tmp.area_tx = transform.area_ty;
+            tmp.area_ty = -transform.area_tx + image_width;
             transform = tmp;
             std::swap(image_width, image_height);
             break;
@@ -498,9 +509,11 @@ RegionCoordinateTransform RegionCoordinateTransform::create(std::shared_ptr<Heif
             transform.a = -transform.a;
             transform.b = -transform.b;
             transform.tx = image_width - 1 - transform.tx;
+            transform.area_tx = image_width - transform.area_tx;
             transform.c = -transform.c;
             transform.d = -transform.d;
             transform.ty = image_height - 1 - transform.ty;
+            transform.area_ty = image_height - transform.area_ty;
             break;
           case 270:
             tmp.a = -transform.c;
@@ -509,6 +522,8 @@ RegionCoordinateTransform RegionCoordinateTransform::create(std::shared_ptr<Heif
             tmp.d = transform.b;
             tmp.tx = -transform.ty + image_height - 1;
             tmp.ty = transform.tx;
+            tmp.area_tx = -transform.area_ty + image_height;
+            tmp.area_ty = transform.area_tx;
             transform = tmp;
             std::swap(image_width, image_height);
             break;
@@ -523,6 +538,8 @@ RegionCoordinateTransform RegionCoordinateTransform::create(std::shared_ptr<Heif
         int top = clap->top_rounded(image_height);
         transform.tx -= left;
         transform.ty -= top;
+        transform.area_tx -= left;
+        transform.area_ty -= top;
         image_width = clap->get_width_rounded();
         image_height = clap->get_height_rounded();
         break;
@@ -532,20 +549,49 @@ RegionCoordinateTransform RegionCoordinateTransform::create(std::shared_ptr<Heif
     }
   }
 
+  transform.image_width = image_width;
+  transform.image_height = image_height;
+
   return transform;
 }
 
 
-RegionCoordinateTransform::Point RegionCoordinateTransform::transform_point(Point p)
+RegionCoordinateTransform::Point RegionCoordinateTransform::transform_point(Point p) const
 {
   Point newp;
-  newp.x = p.x * a + p.x * b + tx;
+  newp.x = p.x * a + p.y * b + tx;
   newp.y = p.x * c + p.y * d + ty;
   return newp;
 }
 
 
-RegionCoordinateTransform::Extent RegionCoordinateTransform::transform_extent(Extent e)
+RegionCoordinateTransform::Point RegionCoordinateTransform::transform_area_point(Point p) const
+{
+  Point newp;
+  newp.x = p.x * a + p.y * b + area_tx;
+  newp.y = p.x * c + p.y * d + area_ty;
+  return newp;
+}
+
+
+RegionCoordinateTransform::Point RegionCoordinateTransform::inverse_transform_area_point(Point p) const
+{
+  double det = a * d - b * c;
+  if (det == 0.0) {
+    return {-1.0, -1.0};
+  }
+
+  double x = p.x - area_tx;
+  double y = p.y - area_ty;
+
+  Point newp;
+  newp.x = (d * x - b * y) / det;
+  newp.y = (a * y - c * x) / det;
+  return newp;
+}
+
+
+RegionCoordinateTransform::Extent RegionCoordinateTransform::transform_extent(Extent e) const
 {
   Extent newe;
   newe.x = e.x * a + e.y * b;
@@ -555,3 +601,787 @@ RegionCoordinateTransform::Extent RegionCoordinateTransform::transform_extent(Ex
 
 
 
+
+
+// --- rasterization
+
+// Scanline rasterizer that draws regions into an 8-bit monochrome plane.
+//
+// Polygons (and the polygon approximations of rectangles and ellipses) are filled with an
+// edge table and an active edge list using the even-odd rule. In coverage mode, each output
+// row is sampled with several sub-scanlines and the horizontal span coverage is accumulated
+// exactly, which gives anti-aliased edges without a full supersampling buffer.
+class RegionRasterizer
+{
+public:
+  using Point = RegionCoordinateTransform::Point;
+
+  RegionRasterizer(const RegionCoordinateTransform& transform,
+                   uint8_t* plane, size_t stride, uint32_t width, uint32_t height,
+                   heif_region_mask_type type, const RegionItem::MaskLoader& load_mask)
+      : m_transform(transform), m_plane(plane), m_stride(stride),
+        m_width(width), m_height(height), m_type(type), m_load_mask(load_mask)
+  {
+    m_coverage.resize(width, 0.0f);
+  }
+
+  const RegionCoordinateTransform& get_transform() const { return m_transform; }
+
+  bool is_antialiased() const { return m_type == heif_region_mask_type_coverage; }
+
+  void set_label(uint8_t label) { m_label = label; }
+
+  // All input points are continuous reference coordinates (pixel i covers [i, i+1)).
+
+  void fill_polygon(const std::vector<Point>& ref_points);
+
+  void draw_outline(const std::vector<Point>& ref_points, bool closed);
+
+  void draw_pixel(Point ref_point);
+
+  // Draws a mask that covers the reference area [x, x+w) x [y, y+h).
+  // 'sample' returns the mask value (0..255) for the mask-local pixel position.
+  void draw_mask(int32_t x, int32_t y, uint32_t w, uint32_t h,
+                 const std::function<uint8_t(uint32_t, uint32_t)>& sample);
+
+  Result<std::shared_ptr<HeifPixelImage>> load_mask(heif_item_id id) const
+  {
+    if (!m_load_mask) {
+      return Error(heif_error_Usage_error, heif_suberror_Unspecified,
+                   "Referenced mask cannot be loaded");
+    }
+
+    return m_load_mask(id);
+  }
+
+private:
+  const RegionCoordinateTransform& m_transform;
+  uint8_t* m_plane;
+  size_t m_stride;
+  uint32_t m_width, m_height;
+  heif_region_mask_type m_type;
+  const RegionItem::MaskLoader& m_load_mask;
+  uint8_t m_label = 255;
+
+  std::vector<float> m_coverage;
+
+  void put(uint32_t x, uint32_t y, uint8_t value)
+  {
+    uint8_t& out = m_plane[y * m_stride + x];
+
+    if (m_type == heif_region_mask_type_label_map) {
+      if (value >= 128) {
+        out = m_label;
+      }
+    }
+    else if (value > out) {
+      out = value;
+    }
+  }
+
+  void accumulate_span(double xl, double xr, float weight, int& span_min, int& span_max);
+
+  void draw_line(Point a, Point b);
+};
+
+
+void RegionRasterizer::accumulate_span(double xl, double xr, float weight, int& span_min, int& span_max)
+{
+  int first, last; // inclusive pixel range touched by the span
+
+  if (!is_antialiased()) {
+    // pixels whose centers are in [xl, xr)
+    first = std::max(0, (int) std::ceil(xl - 0.5));
+    last = std::min((int) m_width, (int) std::ceil(xr - 0.5)) - 1;
+    if (first > last) {
+      return;
+    }
+
+    for (int x = first; x <= last; x++) {
+      m_coverage[x] = 1.0f;
+    }
+  }
+  else {
+    xl = std::max(xl, 0.0);
+    xr = std::min(xr, (double) m_width);
+    if (xr <= xl) {
+      return;
+    }
+
+    first = (int) xl;
+    last = std::min((int) xr, (int) m_width - 1);
+
+    if (first == last) {
+      m_coverage[first] += (float) (xr - xl) * weight;
+    }
+    else {
+      m_coverage[first] += (float) (first + 1 - xl) * weight;
+      for (int x = first + 1; x < last; x++) {
+        m_coverage[x] += weight;
+      }
+      m_coverage[last] += (float) (xr - last) * weight;
+    }
+  }
+
+  span_min = std::min(span_min, first);
+  span_max = std::max(span_max, last);
+}
+
+
+void RegionRasterizer::fill_polygon(const std::vector<Point>& ref_points)
+{
+  if (ref_points.size() < 3) {
+    return;
+  }
+
+  struct Edge
+  {
+    double y0, y1; // y0 < y1
+    double x0;     // x at y0
+    double dxdy;
+  };
+
+  // --- build edge table, sorted by upper y coordinate
+
+  std::vector<Edge> edges;
+  edges.reserve(ref_points.size());
+
+  double ymax = 0;
+
+  for (size_t i = 0; i < ref_points.size(); i++) {
+    Point p = m_transform.transform_area_point(ref_points[i]);
+    Point q = m_transform.transform_area_point(ref_points[(i + 1) % ref_points.size()]);
+
+    if (p.y == q.y) {
+      continue; // horizontal edges never cross a scanline
+    }
+
+    if (p.y > q.y) {
+      std::swap(p, q);
+    }
+
+    edges.push_back({p.y, q.y, p.x, (q.x - p.x) / (q.y - p.y)});
+    ymax = std::max(ymax, q.y);
+  }
+
+  if (edges.empty()) {
+    return;
+  }
+
+  std::sort(edges.begin(), edges.end(), [](const Edge& e1, const Edge& e2) { return e1.y0 < e2.y0; });
+
+  int row_begin = std::max(0, (int) std::floor(edges.front().y0));
+  int row_end = (int) std::min((double) m_height, std::ceil(ymax));
+
+  const int subsamples = is_antialiased() ? 4 : 1;
+  const float weight = 1.0f / (float) subsamples;
+
+  // --- scan
+
+  std::vector<const Edge*> active;
+  std::vector<double> crossings;
+  size_t next_edge = 0;
+
+  for (int y = row_begin; y < row_end; y++) {
+    int span_min = (int) m_width;
+    int span_max = -1;
+
+    for (int s = 0; s < subsamples; s++) {
+      double sy = y + (s + 0.5) * weight;
+
+      while (next_edge < edges.size() && edges[next_edge].y0 <= sy) {
+        active.push_back(&edges[next_edge++]);
+      }
+
+      active.erase(std::remove_if(active.begin(), active.end(),
+                                  [sy](const Edge* e) { return e->y1 <= sy; }),
+                   active.end());
+
+      crossings.clear();
+      for (const Edge* e : active) {
+        crossings.push_back(e->x0 + (sy - e->y0) * e->dxdy);
+      }
+
+      std::sort(crossings.begin(), crossings.end());
+
+      for (size_t i = 0; i + 1 < crossings.size(); i += 2) {
+        accumulate_span(crossings[i], crossings[i + 1], weight, span_min, span_max);
+      }
+    }
+
+    for (int x = span_min; x <= span_max; x++) {
+      float c = std::min(m_coverage[x], 1.0f);
+      m_coverage[x] = 0.0f;
+
+      if (c > 0.0f) {
+        put(x, y, (uint8_t) (c * 255.0f + 0.5f));
+      }
+    }
+  }
+}
+
+
+void RegionRasterizer::draw_line(Point a, Point b)
+{
+  // Clip the segment to the image area (with one pixel margin) so that far-away
+  // coordinates do not cost any time.
+
+  double t0 = 0.0, t1 = 1.0;
+  double dx = b.x - a.x;
+  double dy = b.y - a.y;
+
+  auto clip = [&](double p, double q) {
+    if (p == 0.0) {
+      return q >= 0.0;
+    }
+
+    double r = q / p;
+    if (p < 0.0) {
+      if (r > t1) return false;
+      if (r > t0) t0 = r;
+    }
+    else {
+      if (r < t0) return false;
+      if (r < t1) t1 = r;
+    }
+    return true;
+  };
+
+  if (!clip(-dx, a.x + 1) || !clip(dx, m_width + 1 - a.x) ||
+      !clip(-dy, a.y + 1) || !clip(dy, m_height + 1 - a.y)) {
+    return;
+  }
+
+  int x0 = (int) std::floor(a.x + t0 * dx);
+  int y0 = (int) std::floor(a.y + t0 * dy);
+  int x1 = (int) std::floor(a.x + t1 * dx);
+  int y1 = (int) std::floor(a.y + t1 * dy);
+
+  // Bresenham
+
+  int sx = x0 < x1 ? 1 : -1;
+  int sy = y0 < y1 ? 1 : -1;
+  int ex = std::abs(x1 - x0);
+  int ey = -std::abs(y1 - y0);
+  int err = ex + ey;
+
+  for (;;) {
+    if (x0 >= 0 && y0 >= 0 && x0 < (int) m_width && y0 < (int) m_height) {
+      put(x0, y0, 255);
+    }
+
+    if (x0 == x1 && y0 == y1) {
+      break;
+    }
+
+    int e2 = 2 * err;
+    if (e2 >= ey) {
+      err += ey;
+      x0 += sx;
+    }
+    if (e2 <= ex) {
+      err += ex;
+      y0 += sy;
+    }
+  }
+}
+
+
+void RegionRasterizer::draw_outline(const std::vector<Point>& ref_points, bool closed)
+{
+  if (ref_points.empty()) {
+    return;
+  }
+
+  if (ref_points.size() == 1) {
+    draw_pixel(ref_points[0]);
+    return;
+  }
+
+  size_t n = closed ? ref_points.size() : ref_points.size() - 1;
+  for (size_t i = 0; i < n; i++) {
+    draw_line(m_transform.transform_area_point(ref_points[i]),
+              m_transform.transform_area_point(ref_points[(i + 1) % ref_points.size()]));
+  }
+}
+
+
+void RegionRasterizer::draw_pixel(Point ref_point)
+{
+  Point p = m_transform.transform_area_point(ref_point);
+  double x = std::floor(p.x);
+  double y = std::floor(p.y);
+
+  if (x >= 0 && y >= 0 && x < m_width && y < m_height) {
+    put((uint32_t) x, (uint32_t) y, 255);
+  }
+}
+
+
+void RegionRasterizer::draw_mask(int32_t x, int32_t y, uint32_t w, uint32_t h,
+                                 const std::function<uint8_t(uint32_t, uint32_t)>& sample)
+{
+  if (w == 0 || h == 0) {
+    return;
+  }
+
+  // --- bounding box of the transformed mask area
+
+  double xmin = m_width, xmax = 0, ymin = m_height, ymax = 0;
+
+  for (int corner = 0; corner < 4; corner++) {
+    Point p = m_transform.transform_area_point({(double) x + ((corner & 1) ? w : 0),
+                                                (double) y + ((corner & 2) ? h : 0)});
+    xmin = std::min(xmin, p.x);
+    xmax = std::max(xmax, p.x);
+    ymin = std::min(ymin, p.y);
+    ymax = std::max(ymax, p.y);
+  }
+
+  int px_begin = std::max(0, (int) std::floor(xmin));
+  int px_end = (int) std::min((double) m_width, std::ceil(xmax));
+  int py_begin = std::max(0, (int) std::floor(ymin));
+  int py_end = (int) std::min((double) m_height, std::ceil(ymax));
+
+  // --- sample the mask at each covered pixel center (nearest neighbor)
+
+  for (int py = py_begin; py < py_end; py++) {
+    for (int px = px_begin; px < px_end; px++) {
+      Point r = m_transform.inverse_transform_area_point({px + 0.5, py + 0.5});
+      double u = std::floor(r.x - x);
+      double v = std::floor(r.y - y);
+
+      if (u >= 0 && v >= 0 && u < w && v < h) {
+        put(px, py, sample((uint32_t) u, (uint32_t) v));
+      }
+    }
+  }
+}
+
+
+Error RegionGeometry_Point::rasterize(RegionRasterizer& r) const
+{
+  r.draw_pixel({x + 0.5, y + 0.5});
+  return Error::Ok;
+}
+
+
+Error RegionGeometry_Rectangle::rasterize(RegionRasterizer& r) const
+{
+  // The rectangle covers the pixels [x, x+width) x [y, y+height) and is exact without an outline.
+  double x0 = x, y0 = y;
+  double x1 = x0 + width, y1 = y0 + height;
+
+  r.fill_polygon({{x0, y0}, {x1, y0}, {x1, y1}, {x0, y1}});
+  return Error::Ok;
+}
+
+
+Error RegionGeometry_Ellipse::rasterize(RegionRasterizer& r) const
+{
+  double cx = x + 0.5;
+  double cy = y + 0.5;
+
+  // Choose the number of polygon vertices such that the deviation from the
+  // true ellipse stays below 1/8 pixel in the output.
+
+  RegionCoordinateTransform::Extent e = r.get_transform().transform_extent({(double) radius_x, (double) radius_y});
+  double radius = std::max(std::abs(e.x), std::abs(e.y));
+
+  int n = 8;
+  if (radius > 0.125) {
+    n = (int) std::ceil(M_PI / std::acos(1.0 - 0.125 / radius));
+    n = std::max(8, std::min(n, 4096));
+  }
+
+  std::vector<RegionRasterizer::Point> points(n);
+  for (int i = 0; i < n; i++) {
+    double angle = 2 * M_PI * i / n;
+    points[i] = {cx + radius_x * std::cos(angle), cy + radius_y * std::sin(angle)};
+  }
+
+  r.fill_polygon(points);
+
+  if (!r.is_antialiased()) {
+    r.draw_outline(points, true);
+  }
+
+  return Error::Ok;
+}
+
+
+Error RegionGeometry_Polygon::rasterize(RegionRasterizer& r) const
+{
+  // Polygon coordinates address pixels. Use the pixel centers as vertices.
+  std::vector<RegionRasterizer::Point> vertices(points.size());
+  for (size_t i = 0; i < points.size(); i++) {
+    vertices[i] = {points[i].x + 0.5, points[i].y + 0.5};
+  }
+
+  if (closed) {
+    r.fill_polygon(vertices);
+
+    // The edge is part of a polygon region. With anti-aliasing, it is represented by the partial coverage instead.
+    if (!r.is_antialiased()) {
+      r.draw_outline(vertices, true);
+    }
+  }
+  else {
+    r.draw_outline(vertices, false);
+  }
+
+  return Error::Ok;
+}
+
+
+Error RegionGeometry_ReferencedMask::rasterize(RegionRasterizer& r) const
+{
+  auto maskResult = r.load_mask(referenced_item);
+  if (!maskResult) {
+    return maskResult.error();
+  }
+
+  std::shared_ptr<HeifPixelImage> mask = *maskResult;
+  if (!mask->has_channel(heif_channel_Y)) {
+    return Error(heif_error_Invalid_input, heif_suberror_Invalid_region_data,
+                 "Referenced mask image has no luma channel");
+  }
+
+  uint32_t mask_width = mask->get_width(heif_channel_Y);
+  uint32_t mask_height = mask->get_height(heif_channel_Y);
+  int bpp = mask->get_bits_per_pixel(heif_channel_Y);
+  if (mask_width == 0 || mask_height == 0 || bpp > 16) {
+    return Error(heif_error_Unsupported_feature, heif_suberror_Unsupported_bit_depth,
+                 "Unsupported referenced mask image format");
+  }
+
+  size_t stride;
+  const uint8_t* p = mask->get_plane(heif_channel_Y, &stride);
+  uint32_t max_value = (1U << bpp) - 1;
+
+  r.draw_mask(x, y, width, height, [&](uint32_t u, uint32_t v) -> uint8_t {
+    // the mask image is stretched over the region
+    uint32_t mx = (uint32_t) (u * (uint64_t) mask_width / width);
+    uint32_t my = (uint32_t) (v * (uint64_t) mask_height / height);
+
+    if (bpp <= 8) {
+      return (uint8_t) (p[my * stride + mx] * 255U / max_value);
+    }
+    else {
+      auto* row = reinterpret_cast<const uint16_t*>(p + my * stride);
+      return (uint8_t) (row[mx] * 255U / max_value);
+    }
+  });
+
+  return Error::Ok;
+}
+
+
+Error RegionGeometry_InlineMask::rasterize(RegionRasterizer& r) const
+{
+  r.draw_mask(x, y, width, height, [&](uint32_t u, uint32_t v) -> uint8_t {
+    uint64_t pixel_index = v * (uint64_t) width + u;
+    uint64_t mask_byte = pixel_index / 8;
+    if (mask_byte >= mask_data.size()) {
+      return 0;
+    }
+
+    return (mask_data[mask_byte] & (0x80U >> (pixel_index % 8))) ? 255 : 0;
+  });
+
+  return Error::Ok;
+}
+
+
+Result<std::shared_ptr<HeifPixelImage>> RegionItem::rasterize(const RegionCoordinateTransform& transform,
+                                                               uint32_t width, uint32_t height,
+                                                               heif_region_mask_type type,
+                                                               const MaskLoader& load_mask,
+                                                               const heif_security_limits* limits) const
+{
+  if (type != heif_region_mask_type_binary &&
+      type != heif_region_mask_type_coverage &&
+      type != heif_region_mask_type_label_map) {
+    return Error(heif_error_Usage_error, heif_suberror_Unspecified,
+                 "Unknown region mask type");
+  }
+
+  // Labels are stored in an 8-bit image. A region item that can be written holds at most 255 regions anyway.
+  if (type == heif_region_mask_type_label_map && mRegions.size() > 255) {
+    return Error(heif_error_Usage_error, heif_suberror_Too_many_regions,
+                 "A label map can hold at most 255 regions");
+  }
+
+  auto img = std::make_shared<HeifPixelImage>();
+  img->create(width, height, heif_colorspace_monochrome, heif_chroma_monochrome);
+
+  Error err = img->add_plane(heif_channel_Y, width, height, 8, limits);
+  if (err) {
+    return err;
+  }
+
+  size_t stride;
+  uint8_t* plane = img->get_plane(heif_channel_Y, &stride);
+  for (uint32_t y = 0; y < height; y++) {
+    memset(plane + y * stride, 0, width);
+  }
+
+  RegionRasterizer rasterizer(transform, plane, stride, width, height, type, load_mask);
+
+  for (size_t i = 0; i < mRegions.size(); i++) {
+    rasterizer.set_label(type == heif_region_mask_type_label_map ? (uint8_t) (i + 1) : 255);
+
+    err = mRegions[i]->rasterize(rasterizer);
+    if (err) {
+      return err;
+    }
+  }
+
+  return img;
+}
+
+
+// --- bounding boxes
+
+RegionBounds RegionGeometry_Point::get_reference_bounds() const
+{
+  return {(double) x, (double) y, x + 1.0, y + 1.0};
+}
+
+
+RegionBounds RegionGeometry_Rectangle::get_reference_bounds() const
+{
+  return {(double) x, (double) y, (double) x + width, (double) y + height};
+}
+
+
+RegionBounds RegionGeometry_Ellipse::get_reference_bounds() const
+{
+  return {(double) x - radius_x, (double) y - radius_y,
+          (double) x + radius_x + 1.0, (double) y + radius_y + 1.0};
+}
+
+
+RegionBounds RegionGeometry_Polygon::get_reference_bounds() const
+{
+  if (points.empty()) {
+    return {0, 0, 0, 0};
+  }
+
+  RegionBounds b{(double) points[0].x, (double) points[0].y, (double) points[0].x, (double) points[0].y};
+  for (const auto& p : points) {
+    b.x0 = std::min(b.x0, (double) p.x);
+    b.y0 = std::min(b.y0, (double) p.y);
+    b.x1 = std::max(b.x1, (double) p.x);
+    b.y1 = std::max(b.y1, (double) p.y);
+  }
+
+  // the points address pixels, which extend one unit to the right and bottom
+  b.x1 += 1.0;
+  b.y1 += 1.0;
+
+  return b;
+}
+
+
+RegionBounds RegionGeometry_ReferencedMask::get_reference_bounds() const
+{
+  return {(double) x, (double) y, (double) x + width, (double) y + height};
+}
+
+
+RegionBounds RegionGeometry_InlineMask::get_reference_bounds() const
+{
+  return {(double) x, (double) y, (double) x + width, (double) y + height};
+}
+
+
+// --- spatial index
+
+static RegionBounds union_bounds(const RegionBounds& a, const RegionBounds& b)
+{
+  return {std::min(a.x0, b.x0), std::min(a.y0, b.y0),
+          std::max(a.x1, b.x1), std::max(a.y1, b.y1)};
+}
+
+
+static bool intersects(const RegionBounds& a, const RegionBounds& b)
+{
+  return a.x0 < b.x1 && b.x0 < a.x1 &&
+         a.y0 < b.y1 && b.y0 < a.y1;
+}
+
+
+std::shared_ptr<RegionSpatialIndex> RegionSpatialIndex::create(const HeifContext* ctx, heif_item_id image_id,
+                                                               const std::vector<heif_item_id>& region_item_ids)
+{
+  auto index = std::make_shared<RegionSpatialIndex>();
+
+  uint32_t order = 0;
+
+  for (heif_item_id region_item_id : region_item_ids) {
+    auto region_item = ctx->get_region_item(region_item_id);
+    if (!region_item) {
+      continue;
+    }
+
+    auto transform = RegionCoordinateTransform::create(ctx->get_heif_file(), image_id,
+                                                       region_item->reference_width,
+                                                       region_item->reference_height);
+
+    auto regions = region_item->get_regions();
+    index->m_source.emplace_back(region_item_id, (int) regions.size());
+
+    for (size_t i = 0; i < regions.size(); i++) {
+      RegionBounds ref = regions[i]->get_reference_bounds();
+
+      // transform all corners, since rotations may swap the axes
+      RegionBounds b{};
+      for (int corner = 0; corner < 4; corner++) {
+        auto p = transform.transform_area_point({(corner & 1) ? ref.x1 : ref.x0,
+                                                 (corner & 2) ? ref.y1 : ref.y0});
+        if (corner == 0) {
+          b = {p.x, p.y, p.x, p.y};
+        }
+        else {
+          b = union_bounds(b, {p.x, p.y, p.x, p.y});
+        }
+      }
+
+      index->m_entries.push_back({b, region_item_id, (int) i, order++});
+    }
+  }
+
+  index->build();
+
+  return index;
+}
+
+
+bool RegionSpatialIndex::is_outdated(const HeifContext* ctx, const std::vector<heif_item_id>& region_item_ids) const
+{
+  size_t n = 0;
+
+  for (heif_item_id region_item_id : region_item_ids) {
+    auto region_item = ctx->get_region_item(region_item_id);
+    if (!region_item) {
+      continue;
+    }
+
+    if (n >= m_source.size() ||
+        m_source[n].first != region_item_id ||
+        m_source[n].second != region_item->get_number_of_regions()) {
+      return true;
+    }
+
+    n++;
+  }
+
+  return n != m_source.size();
+}
+
+
+void RegionSpatialIndex::build()
+{
+  // Sort-Tile-Recursive packing: order the entries into vertical slices by x,
+  // then by y within each slice, and fill the leaves in that order.
+
+  auto center_x = [](const Entry& e) { return e.bounds.x0 + e.bounds.x1; };
+  auto center_y = [](const Entry& e) { return e.bounds.y0 + e.bounds.y1; };
+
+  size_t num_leaves = (m_entries.size() + cNodeCapacity - 1) / cNodeCapacity;
+  size_t num_slices = (size_t) std::ceil(std::sqrt((double) num_leaves));
+  size_t slice_size = num_slices * cNodeCapacity;
+
+  std::sort(m_entries.begin(), m_entries.end(),
+            [&](const Entry& a, const Entry& b) { return center_x(a) < center_x(b); });
+
+  for (size_t start = 0; start < m_entries.size(); start += slice_size) {
+    auto end = m_entries.begin() + std::min(start + slice_size, m_entries.size());
+    std::sort(m_entries.begin() + start, end,
+              [&](const Entry& a, const Entry& b) { return center_y(a) < center_y(b); });
+  }
+
+  // --- leaves
+
+  m_levels.clear();
+  m_levels.emplace_back();
+
+  for (size_t start = 0; start < m_entries.size(); start += cNodeCapacity) {
+    uint32_t count = (uint32_t) std::min<size_t>(cNodeCapacity, m_entries.size() - start);
+
+    RegionBounds b = m_entries[start].bounds;
+    for (uint32_t i = 1; i < count; i++) {
+      b = union_bounds(b, m_entries[start + i].bounds);
+    }
+
+    m_levels[0].push_back({b, (uint32_t) start, count});
+  }
+
+  // --- inner levels, grouping consecutive nodes until a single root remains
+
+  while (m_levels.back().size() > 1) {
+    const std::vector<Node>& children = m_levels.back();
+    std::vector<Node> parents;
+
+    for (size_t start = 0; start < children.size(); start += cNodeCapacity) {
+      uint32_t count = (uint32_t) std::min<size_t>(cNodeCapacity, children.size() - start);
+
+      RegionBounds b = children[start].bounds;
+      for (uint32_t i = 1; i < count; i++) {
+        b = union_bounds(b, children[start + i].bounds);
+      }
+
+      parents.push_back({b, (uint32_t) start, count});
+    }
+
+    m_levels.push_back(std::move(parents));
+  }
+}
+
+
+std::vector<const RegionSpatialIndex::Entry*> RegionSpatialIndex::query(const RegionBounds& rect) const
+{
+  std::vector<const Entry*> hits;
+
+  if (m_levels.empty() || m_levels.back().empty()) {
+    return hits;
+  }
+
+  struct StackItem
+  {
+    size_t level;
+    uint32_t node;
+  };
+
+  std::vector<StackItem> stack;
+  stack.push_back({m_levels.size() - 1, 0});
+
+  while (!stack.empty()) {
+    StackItem item = stack.back();
+    stack.pop_back();
+
+    const Node& node = m_levels[item.level][item.node];
+    if (!intersects(node.bounds, rect)) {
+      continue;
+    }
+
+    if (item.level == 0) {
+      for (uint32_t i = 0; i < node.num_children; i++) {
+        const Entry& e = m_entries[node.first_child + i];
+        if (intersects(e.bounds, rect)) {
+          hits.push_back(&e);
+        }
+      }
+    }
+    else {
+      for (uint32_t i = 0; i < node.num_children; i++) {
+        stack.push_back({item.level - 1, node.first_child + i});
+      }
+    }
+  }
+
+  std::sort(hits.begin(), hits.end(), [](const Entry* a, const Entry* b) { return a->order < b->order; });
+
+  return hits;
+}
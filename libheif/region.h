@@ -24,11 +24,21 @@
 #include <cstdint>
 #include <vector>
 #include <memory>
+#include <functional>
 #include "pixelimage.h"
 #include "libheif/heif_regions.h"
 
 
 class RegionGeometry;
+class RegionCoordinateTransform;
+class RegionRasterizer;
+class HeifContext;
+
+// Axis-aligned bounds in continuous coordinates, where pixel i covers [i, i+1).
+struct RegionBounds
+{
+  double x0, y0, x1, y1;
+};
 
 class RegionItem
 {
@@ -46,11 +56,24 @@ public:
 
   std::vector<std::shared_ptr<RegionGeometry>> get_regions() { return mRegions; }
 
+  std::shared_ptr<RegionGeometry> get_region(int index) const { return mRegions[index]; }
+
   void add_region(const std::shared_ptr<RegionGeometry>& region)
   {
     mRegions.push_back(region);
   }
 
+  // Decodes the image referenced by a referenced-mask region.
+  using MaskLoader = std::function<Result<std::shared_ptr<HeifPixelImage>>(heif_item_id)>;
+
+  // Draws all regions into a new 8-bit monochrome image of size width x height.
+  // The region coordinates are mapped into the output through 'transform'.
+  Result<std::shared_ptr<HeifPixelImage>> rasterize(const RegionCoordinateTransform& transform,
+                                                     uint32_t width, uint32_t height,
+                                                     heif_region_mask_type type,
+                                                     const MaskLoader& load_mask,
+                                                     const heif_security_limits* limits) const;
+
   heif_item_id item_id = 0;
   uint32_t reference_width = 0;
   uint32_t reference_height = 0;
@@ -73,6 +96,11 @@ public:
 
   virtual void encode(StreamWriter&, int field_size_bytes) const {}
 
+  virtual Error rasterize(RegionRasterizer&) const { return Error::Ok; }
+
+  // Bounds in the reference coordinate space of the region item.
+  virtual RegionBounds get_reference_bounds() const = 0;
+
 protected:
   uint32_t parse_unsigned(const std::vector<uint8_t>& data, int field_size, unsigned int* dataOffset);
 
@@ -88,6 +116,10 @@ public:
 
   void encode(StreamWriter&, int field_size_bytes) const override;
 
+  Error rasterize(RegionRasterizer&) const override;
+
+  RegionBounds get_reference_bounds() const override;
+
   heif_region_type getRegionType() override { return heif_region_type_point; }
 
   int32_t x, y;
@@ -102,6 +134,10 @@ public:
 
   void encode(StreamWriter&, int field_size_bytes) const override;
 
+  Error rasterize(RegionRasterizer&) const override;
+
+  RegionBounds get_reference_bounds() const override;
+
   heif_region_type getRegionType() override { return heif_region_type_rectangle; }
 
   int32_t x, y;
@@ -117,6 +153,10 @@ public:
 
   void encode(StreamWriter&, int field_size_bytes) const override;
 
+  Error rasterize(RegionRasterizer&) const override;
+
+  RegionBounds get_reference_bounds() const override;
+
   heif_region_type getRegionType() override { return heif_region_type_ellipse; }
 
   int32_t x, y;
@@ -132,6 +172,10 @@ public:
 
   void encode(StreamWriter&, int field_size_bytes) const override;
 
+  Error rasterize(RegionRasterizer&) const override;
+
+  RegionBounds get_reference_bounds() const override;
+
   heif_region_type getRegionType() override
   {
     return closed ? heif_region_type_polygon : heif_region_type_polyline;
@@ -153,6 +197,10 @@ public:
 
   void encode(StreamWriter&, int field_size_bytes) const override;
 
+  Error rasterize(RegionRasterizer&) const override;
+
+  RegionBounds get_reference_bounds() const override;
+
   heif_region_type getRegionType() override { return heif_region_type_referenced_mask; }
 
   int32_t x,y;
@@ -167,6 +215,10 @@ public:
 
   void encode(StreamWriter&, int field_size_bytes) const override;
 
+  Error rasterize(RegionRasterizer&) const override;
+
+  RegionBounds get_reference_bounds() const override;
+
   int32_t x,y;
   uint32_t width, height;
   std::vector<uint8_t> mask_data;
@@ -193,12 +245,70 @@ public:
     double x, y;
   };
 
-  Point transform_point(Point);
+  Point transform_point(Point) const;
+
+  Extent transform_extent(Extent) const;
+
+  // Like transform_point(), but for continuous coordinates where pixel i covers [i, i+1)
+  // instead of pixel indices. Mirroring and rotation then map onto [0, size] exactly.
+  Point transform_area_point(Point) const;
 
-  Extent transform_extent(Extent);
+  Point inverse_transform_area_point(Point) const;
+
+  // Size of the image after all transformations. Zero if the transform could not be set up.
+  uint32_t get_image_width() const { return image_width; }
+
+  uint32_t get_image_height() const { return image_height; }
 
 private:
   double a = 1.0, b = 0.0, c = 0.0, d = 1.0, tx = 0.0, ty = 0.0;
+  double area_tx = 0.0, area_ty = 0.0;
+  uint32_t image_width = 0, image_height = 0;
+};
+
+
+// Packed R-tree over the bounding boxes of all regions attached to an image.
+// The boxes are stored in the coordinate system of the image after all transformations.
+class RegionSpatialIndex
+{
+public:
+  struct Entry
+  {
+    RegionBounds bounds;
+    heif_item_id region_item_id;
+    int region_index;
+    uint32_t order; // position in the (region item, region) enumeration
+  };
+
+  static std::shared_ptr<RegionSpatialIndex> create(const HeifContext* ctx, heif_item_id image_id,
+                                                    const std::vector<heif_item_id>& region_item_ids);
+
+  // Whether regions were added since the index was built.
+  bool is_outdated(const HeifContext* ctx, const std::vector<heif_item_id>& region_item_ids) const;
+
+  // Returns all entries whose bounds intersect [x0,x1) x [y0,y1), in enumeration order.
+  std::vector<const Entry*> query(const RegionBounds& rect) const;
+
+private:
+  struct Node
+  {
+    RegionBounds bounds;
+    uint32_t first_child;
+    uint32_t num_children;
+  };
+
+  static constexpr uint32_t cNodeCapacity = 16;
+
+  std::vector<Entry> m_entries;
+
+  // m_levels[0] are the leaves, whose children are ranges of m_entries.
+  // The children of nodes in m_levels[k] are ranges of m_levels[k-1].
+  std::vector<std::vector<Node>> m_levels;
+
+  // number of regions per region item when the index was built
+  std::vector<std::pair<heif_item_id, int>> m_source;
+
+  void build();
 };
 
 #endif //LIBHEIF_REGION_H
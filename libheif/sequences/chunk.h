@@ -55,6 +55,11 @@ public:
 
   void set_decoder(std::shared_ptr<class Decoder> dec) { m_decoder = dec; }
 
+  // The sample description is used to create additional decoder instances (for pipelined decoding).
+  void set_sample_description(std::shared_ptr<const Box_VisualSampleEntry> desc) { m_sample_description = std::move(desc); }
+
+  std::shared_ptr<const Box_VisualSampleEntry> get_sample_description() const { return m_sample_description; }
+
 private:
   HeifContext* m_ctx = nullptr;
   uint32_t m_track_id = 0;
@@ -78,6 +83,8 @@ private:
 
   std::shared_ptr<class Decoder> m_decoder;
   std::shared_ptr<class Encoder> m_encoder;
+
+  std::shared_ptr<const Box_VisualSampleEntry> m_sample_description;
 };
 
 
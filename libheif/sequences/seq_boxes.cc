@@ -19,6 +19,7 @@
  */
 
 #include "sequences/seq_boxes.h"
+#include <algorithm>
 #include <iomanip>
 #include <set>
 #include <limits>
@@ -564,12 +565,28 @@ Error Box_stts::parse(BitstreamRange& range, const heif_security_limits* limits)
     entry.sample_count = range.read32();
     entry.sample_delta = range.read32();
     m_entries[i] = entry;
+
+    append_entry_start();
   }
 
   return range.get_error();
 }
 
 
+void Box_stts::append_entry_start()
+{
+  if (m_entry_first_sample.empty()) {
+    m_entry_first_sample.push_back(0);
+    m_entry_start_time.push_back(0);
+  }
+  else {
+    const TimeToSample& prev = m_entries[m_entry_first_sample.size() - 1];
+    m_entry_first_sample.push_back(m_entry_first_sample.back() + prev.sample_count);
+    m_entry_start_time.push_back(m_entry_start_time.back() + prev.sample_count * uint64_t(prev.sample_delta));
+  }
+}
+
+
 std::string Box_stts::dump(Indent& indent) const
 {
   std::ostringstream sstr;
@@ -598,19 +615,59 @@ Error Box_stts::write(StreamWriter& writer) const
 }
 
 
-uint32_t Box_stts::get_sample_duration(uint32_t sample_idx)
+size_t Box_stts::find_entry_for_sample(uint32_t sample_idx) const
 {
-  size_t i = 0;
-  while (i < m_entries.size()) {
-    if (sample_idx < m_entries[i].sample_count) {
-      return m_entries[i].sample_delta;
-    }
-    else {
-      sample_idx -= m_entries[i].sample_count;
-    }
+  // last entry whose first sample is <= sample_idx
+  auto iter = std::upper_bound(m_entry_first_sample.begin(), m_entry_first_sample.end(), uint64_t{sample_idx});
+  return static_cast<size_t>(iter - m_entry_first_sample.begin()) - 1;
+}
+
+
+uint32_t Box_stts::get_sample_duration(uint32_t sample_idx) const
+{
+  if (m_entries.empty()) {
+    return 0;
   }
 
-  return 0;
+  size_t i = find_entry_for_sample(sample_idx);
+  if (sample_idx - m_entry_first_sample[i] >= m_entries[i].sample_count) {
+    return 0;
+  }
+
+  return m_entries[i].sample_delta;
+}
+
+
+uint64_t Box_stts::get_sample_decoding_time(uint32_t sample_idx) const
+{
+  if (m_entries.empty()) {
+    return 0;
+  }
+
+  size_t i = find_entry_for_sample(sample_idx);
+  return m_entry_start_time[i] + (sample_idx - m_entry_first_sample[i]) * uint64_t(m_entries[i].sample_delta);
+}
+
+
+uint32_t Box_stts::get_sample_at_time(uint64_t time) const
+{
+  if (m_entries.empty()) {
+    return 0;
+  }
+
+  // last entry that starts at or before 'time'
+  auto iter = std::upper_bound(m_entry_start_time.begin(), m_entry_start_time.end(), time);
+  size_t i = static_cast<size_t>(iter - m_entry_start_time.begin()) - 1;
+
+  // Entries with zero samples or zero duration have the same start time as the next entry. Skip over them.
+  while (i + 1 < m_entries.size() && m_entry_start_time[i + 1] == m_entry_start_time[i]) {
+    i++;
+  }
+
+  uint64_t offset = m_entries[i].sample_delta ? (time - m_entry_start_time[i]) / m_entries[i].sample_delta : 0;
+  uint64_t sample = m_entry_first_sample[i] + std::min(offset, uint64_t{m_entries[i].sample_count});
+
+  return static_cast<uint32_t>(std::min(sample, uint64_t{std::numeric_limits<uint32_t>::max()}));
 }
 
 
@@ -621,6 +678,7 @@ void Box_stts::append_sample_duration(uint32_t duration)
     entry.sample_delta = duration;
     entry.sample_count = 1;
     m_entries.push_back(entry);
+    append_entry_start();
     return;
   }
 
@@ -718,10 +776,10 @@ const Box_stsc::SampleToChunk* Box_stsc::get_chunk(uint32_t idx) const
 }
 
 
-void Box_stsc::add_chunk(uint32_t description_index)
+void Box_stsc::add_chunk(uint32_t first_chunk, uint32_t description_index)
 {
   SampleToChunk entry{};
-  entry.first_chunk = 1; // TODO
+  entry.first_chunk = first_chunk;
   entry.samples_per_chunk = 0;
   entry.sample_description_index = description_index;
   m_entries.push_back(entry);
@@ -741,21 +799,26 @@ Error Box_stco::parse(BitstreamRange& range, const heif_security_limits* limits)
   parse_full_box_header(range);
 
   if (get_version() > 0) {
-    return unsupported_version_error("stco");
+    return unsupported_version_error(is_co64() ? "co64" : "stco");
   }
 
   uint32_t entry_count = range.read32();
 
   // check required memory
 
-  uint64_t mem_size = entry_count * sizeof(uint32_t);
+  uint64_t mem_size = entry_count * sizeof(uint64_t);
   if (auto err = m_memory_handle.alloc(mem_size,
                                        limits, "the 'stco' table")) {
     return err;
   }
 
   for (uint32_t i = 0; i < entry_count; i++) {
-    m_offsets.push_back(range.read32());
+    if (is_co64()) {
+      m_offsets.push_back(range.read64());
+    }
+    else {
+      m_offsets.push_back(range.read32());
+    }
 
     if (range.error()) {
       return range.get_error();
@@ -778,6 +841,18 @@ std::string Box_stco::dump(Indent& indent) const
 }
 
 
+void Box_stco::derive_box_version()
+{
+  // The offsets are relative to the 'mdat' start and get the position of the 'mdat' added when patched.
+  // Keep some headroom for the header data in front of the 'mdat'.
+
+  bool need_64bit = std::any_of(m_offsets.begin(), m_offsets.end(),
+                                [](uint64_t offset) { return offset >= 0xFF000000; });
+
+  set_short_type(fourcc(need_64bit ? "co64" : "stco"));
+}
+
+
 Error Box_stco::write(StreamWriter& writer) const
 {
   size_t box_start = reserve_box_header_space(writer);
@@ -786,8 +861,13 @@ Error Box_stco::write(StreamWriter& writer) const
 
   m_offset_start_pos = writer.get_position();
 
-  for (uint32_t offset : m_offsets) {
-    writer.write32(offset);
+  for (uint64_t offset : m_offsets) {
+    if (is_co64()) {
+      writer.write64(offset);
+    }
+    else {
+      writer.write32(static_cast<uint32_t>(offset));
+    }
   }
 
   prepend_header(writer, box_start);
@@ -802,8 +882,11 @@ void Box_stco::patch_file_pointers(StreamWriter& writer, size_t offset)
 
   writer.set_position(m_offset_start_pos);
 
-  for (uint32_t chunk_offset : m_offsets) {
-    if (chunk_offset + offset > std::numeric_limits<uint32_t>::max()) {
+  for (uint64_t chunk_offset : m_offsets) {
+    if (is_co64()) {
+      writer.write64(chunk_offset + offset);
+    }
+    else if (chunk_offset + offset > std::numeric_limits<uint32_t>::max()) {
       writer.write32(0); // TODO: error
     }
     else {
@@ -943,6 +1026,20 @@ Error Box_stss::parse(BitstreamRange& range, const heif_security_limits* limits)
 }
 
 
+uint32_t Box_stss::get_sync_sample_at_or_before(uint32_t sample_idx) const
+{
+  // m_sync_samples contains sample numbers starting at 1
+  auto iter = std::upper_bound(m_sync_samples.begin(), m_sync_samples.end(), uint64_t{sample_idx} + 1,
+                               [](uint64_t value, uint32_t sync_sample) { return value < sync_sample; });
+  if (iter == m_sync_samples.begin()) {
+    return 0;
+  }
+
+  uint32_t sync_sample = *(iter - 1);
+  return sync_sample > 0 ? sync_sample - 1 : 0;
+}
+
+
 std::string Box_stss::dump(Indent& indent) const
 {
   std::ostringstream sstr;
@@ -2156,3 +2253,424 @@ void Box_elst::add_entry(const Entry& entry)
 {
   m_entries.push_back(entry);
 }
+
+
+Error Box_trex::parse(BitstreamRange& range, const heif_security_limits* limits)
+{
+  parse_full_box_header(range);
+
+  if (get_version() > 0) {
+    return unsupported_version_error("trex");
+  }
+
+  m_track_id = range.read32();
+  m_default_sample_description_index = range.read32();
+  m_default_sample_duration = range.read32();
+  m_default_sample_size = range.read32();
+  m_default_sample_flags = range.read32();
+
+  return range.get_error();
+}
+
+
+Error Box_trex::write(StreamWriter& writer) const
+{
+  size_t box_start = reserve_box_header_space(writer);
+
+  writer.write32(m_track_id);
+  writer.write32(m_default_sample_description_index);
+  writer.write32(m_default_sample_duration);
+  writer.write32(m_default_sample_size);
+  writer.write32(m_default_sample_flags);
+
+  prepend_header(writer, box_start);
+
+  return Error::Ok;
+}
+
+
+std::string Box_trex::dump(Indent& indent) const
+{
+  std::ostringstream sstr;
+  sstr << FullBox::dump(indent);
+  sstr << indent << "track ID: " << m_track_id << "\n"
+       << indent << "default sample description index: " << m_default_sample_description_index << "\n"
+       << indent << "default sample duration: " << m_default_sample_duration << "\n"
+       << indent << "default sample size: " << m_default_sample_size << "\n"
+       << indent << "default sample flags: 0x" << std::hex << m_default_sample_flags << std::dec << "\n";
+
+  return sstr.str();
+}
+
+
+Error Box_mfhd::parse(BitstreamRange& range, const heif_security_limits* limits)
+{
+  parse_full_box_header(range);
+
+  if (get_version() > 0) {
+    return unsupported_version_error("mfhd");
+  }
+
+  m_sequence_number = range.read32();
+
+  return range.get_error();
+}
+
+
+Error Box_mfhd::write(StreamWriter& writer) const
+{
+  size_t box_start = reserve_box_header_space(writer);
+
+  writer.write32(m_sequence_number);
+
+  prepend_header(writer, box_start);
+
+  return Error::Ok;
+}
+
+
+std::string Box_mfhd::dump(Indent& indent) const
+{
+  std::ostringstream sstr;
+  sstr << FullBox::dump(indent);
+  sstr << indent << "sequence number: " << m_sequence_number << "\n";
+
+  return sstr.str();
+}
+
+
+void Box_tfhd::set_sample_description_index(uint32_t idx)
+{
+  m_sample_description_index = idx;
+  set_flags(get_flags() | Flags::Sample_description_index_present);
+}
+
+
+uint32_t Box_tfhd::get_sample_description_index(uint32_t default_value) const
+{
+  return (get_flags() & Flags::Sample_description_index_present) ? m_sample_description_index : default_value;
+}
+
+
+uint32_t Box_tfhd::get_default_sample_duration(uint32_t default_value) const
+{
+  return (get_flags() & Flags::Default_sample_duration_present) ? m_default_sample_duration : default_value;
+}
+
+
+uint32_t Box_tfhd::get_default_sample_size(uint32_t default_value) const
+{
+  return (get_flags() & Flags::Default_sample_size_present) ? m_default_sample_size : default_value;
+}
+
+
+uint32_t Box_tfhd::get_default_sample_flags(uint32_t default_value) const
+{
+  return (get_flags() & Flags::Default_sample_flags_present) ? m_default_sample_flags : default_value;
+}
+
+
+Error Box_tfhd::parse(BitstreamRange& range, const heif_security_limits* limits)
+{
+  parse_full_box_header(range);
+
+  if (get_version() > 0) {
+    return unsupported_version_error("tfhd");
+  }
+
+  m_track_id = range.read32();
+
+  uint32_t flags = get_flags();
+
+  if (flags & Flags::Base_data_offset_present) {
+    m_base_data_offset = range.read64();
+  }
+  if (flags & Flags::Sample_description_index_present) {
+    m_sample_description_index = range.read32();
+  }
+  if (flags & Flags::Default_sample_duration_present) {
+    m_default_sample_duration = range.read32();
+  }
+  if (flags & Flags::Default_sample_size_present) {
+    m_default_sample_size = range.read32();
+  }
+  if (flags & Flags::Default_sample_flags_present) {
+    m_default_sample_flags = range.read32();
+  }
+
+  return range.get_error();
+}
+
+
+Error Box_tfhd::write(StreamWriter& writer) const
+{
+  size_t box_start = reserve_box_header_space(writer);
+
+  writer.write32(m_track_id);
+
+  uint32_t flags = get_flags();
+
+  if (flags & Flags::Base_data_offset_present) {
+    writer.write64(m_base_data_offset);
+  }
+  if (flags & Flags::Sample_description_index_present) {
+    writer.write32(m_sample_description_index);
+  }
+  if (flags & Flags::Default_sample_duration_present) {
+    writer.write32(m_default_sample_duration);
+  }
+  if (flags & Flags::Default_sample_size_present) {
+    writer.write32(m_default_sample_size);
+  }
+  if (flags & Flags::Default_sample_flags_present) {
+    writer.write32(m_default_sample_flags);
+  }
+
+  prepend_header(writer, box_start);
+
+  return Error::Ok;
+}
+
+
+std::string Box_tfhd::dump(Indent& indent) const
+{
+  std::ostringstream sstr;
+  sstr << FullBox::dump(indent);
+  sstr << indent << "track ID: " << m_track_id << "\n";
+
+  uint32_t flags = get_flags();
+
+  if (flags & Flags::Base_data_offset_present) {
+    sstr << indent << "base data offset: " << m_base_data_offset << "\n";
+  }
+  if (flags & Flags::Sample_description_index_present) {
+    sstr << indent << "sample description index: " << m_sample_description_index << "\n";
+  }
+  if (flags & Flags::Default_sample_duration_present) {
+    sstr << indent << "default sample duration: " << m_default_sample_duration << "\n";
+  }
+  if (flags & Flags::Default_sample_size_present) {
+    sstr << indent << "default sample size: " << m_default_sample_size << "\n";
+  }
+  if (flags & Flags::Default_sample_flags_present) {
+    sstr << indent << "default sample flags: 0x" << std::hex << m_default_sample_flags << std::dec << "\n";
+  }
+
+  sstr << indent << "duration is empty: " << ((flags & Flags::Duration_is_empty) ? "yes" : "no") << "\n"
+       << indent << "default base is moof: " << ((flags & Flags::Default_base_is_moof) ? "yes" : "no") << "\n";
+
+  return sstr.str();
+}
+
+
+Error Box_tfdt::parse(BitstreamRange& range, const heif_security_limits* limits)
+{
+  parse_full_box_header(range);
+
+  if (get_version() > 1) {
+    return unsupported_version_error("tfdt");
+  }
+
+  if (get_version() == 1) {
+    m_base_media_decode_time = range.read64();
+  }
+  else {
+    m_base_media_decode_time = range.read32();
+  }
+
+  return range.get_error();
+}
+
+
+Error Box_tfdt::write(StreamWriter& writer) const
+{
+  size_t box_start = reserve_box_header_space(writer);
+
+  if (get_version() == 1) {
+    writer.write64(m_base_media_decode_time);
+  }
+  else {
+    writer.write32(static_cast<uint32_t>(m_base_media_decode_time));
+  }
+
+  prepend_header(writer, box_start);
+
+  return Error::Ok;
+}
+
+
+void Box_tfdt::derive_box_version()
+{
+  set_version(m_base_media_decode_time > std::numeric_limits<uint32_t>::max() ? 1 : 0);
+}
+
+
+std::string Box_tfdt::dump(Indent& indent) const
+{
+  std::ostringstream sstr;
+  sstr << FullBox::dump(indent);
+  sstr << indent << "base media decode time: " << m_base_media_decode_time << "\n";
+
+  return sstr.str();
+}
+
+
+void Box_trun::set_data_offset(int32_t offset)
+{
+  m_data_offset = offset;
+  set_flags(get_flags() | Flags::Data_offset_present);
+}
+
+
+Error Box_trun::parse(BitstreamRange& range, const heif_security_limits* limits)
+{
+  parse_full_box_header(range);
+
+  if (get_version() > 1) {
+    return unsupported_version_error("trun");
+  }
+
+  uint32_t flags = get_flags();
+
+  uint32_t sample_count = range.read32();
+
+  if (flags & Flags::Data_offset_present) {
+    m_data_offset = range.read32s();
+  }
+  if (flags & Flags::First_sample_flags_present) {
+    m_first_sample_flags = range.read32();
+  }
+
+  // check required memory
+
+  uint64_t mem_size = sample_count * uint64_t(sizeof(Sample));
+  if (auto err = m_memory_handle.alloc(mem_size,
+                                       limits, "the 'trun' table")) {
+    return err;
+  }
+
+  m_samples.resize(sample_count);
+
+  for (Sample& sample : m_samples) {
+    if (flags & Flags::Sample_duration_present) {
+      sample.duration = range.read32();
+    }
+    if (flags & Flags::Sample_size_present) {
+      sample.size = range.read32();
+    }
+    if (flags & Flags::Sample_flags_present) {
+      sample.flags = range.read32();
+    }
+    if (flags & Flags::Sample_composition_time_offsets_present) {
+      if (get_version() == 0) {
+        sample.composition_time_offset = range.read32();
+      }
+      else {
+        sample.composition_time_offset = range.read32s();
+      }
+    }
+
+    if (range.error()) {
+      return range.get_error();
+    }
+  }
+
+  return range.get_error();
+}
+
+
+Error Box_trun::write(StreamWriter& writer) const
+{
+  size_t box_start = reserve_box_header_space(writer);
+
+  uint32_t flags = get_flags();
+
+  if (m_samples.size() > std::numeric_limits<uint32_t>::max()) {
+    return {heif_error_Usage_error,
+            heif_suberror_Invalid_parameter_value,
+            "Too many samples in track fragment run"};
+  }
+
+  writer.write32(static_cast<uint32_t>(m_samples.size()));
+
+  if (flags & Flags::Data_offset_present) {
+    m_data_offset_pos = writer.get_position();
+    writer.write32s(m_data_offset);
+  }
+  if (flags & Flags::First_sample_flags_present) {
+    writer.write32(m_first_sample_flags);
+  }
+
+  for (const Sample& sample : m_samples) {
+    if (flags & Flags::Sample_duration_present) {
+      writer.write32(sample.duration);
+    }
+    if (flags & Flags::Sample_size_present) {
+      writer.write32(sample.size);
+    }
+    if (flags & Flags::Sample_flags_present) {
+      writer.write32(sample.flags);
+    }
+    if (flags & Flags::Sample_composition_time_offsets_present) {
+      writer.write32s(static_cast<int32_t>(sample.composition_time_offset));
+    }
+  }
+
+  prepend_header(writer, box_start);
+
+  return Error::Ok;
+}
+
+
+void Box_trun::patch_file_pointers(StreamWriter& writer, size_t offset)
+{
+  if (!(get_flags() & Flags::Data_offset_present)) {
+    return;
+  }
+
+  size_t oldPosition = writer.get_position();
+
+  writer.set_position(m_data_offset_pos);
+  writer.write32s(static_cast<int32_t>(m_data_offset + offset));
+
+  writer.set_position(oldPosition);
+}
+
+
+std::string Box_trun::dump(Indent& indent) const
+{
+  std::ostringstream sstr;
+  sstr << FullBox::dump(indent);
+
+  uint32_t flags = get_flags();
+
+  sstr << indent << "sample count: " << m_samples.size() << "\n";
+
+  if (flags & Flags::Data_offset_present) {
+    sstr << indent << "data offset: " << m_data_offset << "\n";
+  }
+  if (flags & Flags::First_sample_flags_present) {
+    sstr << indent << "first sample flags: 0x" << std::hex << m_first_sample_flags << std::dec << "\n";
+  }
+
+  for (size_t i = 0; i < m_samples.size(); i++) {
+    const Sample& sample = m_samples[i];
+
+    sstr << indent << "[" << i << "]";
+    if (flags & Flags::Sample_duration_present) {
+      sstr << " duration: " << sample.duration;
+    }
+    if (flags & Flags::Sample_size_present) {
+      sstr << " size: " << sample.size;
+    }
+    if (flags & Flags::Sample_flags_present) {
+      sstr << " flags: 0x" << std::hex << sample.flags << std::dec;
+    }
+    if (flags & Flags::Sample_composition_time_offsets_present) {
+      sstr << " composition time offset: " << sample.composition_time_offset;
+    }
+    sstr << "\n";
+  }
+
+  return sstr.str();
+}
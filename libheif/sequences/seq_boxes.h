@@ -345,7 +345,14 @@ public:
     uint32_t sample_delta;
   };
 
-  uint32_t get_sample_duration(uint32_t sample_idx);
+  uint32_t get_sample_duration(uint32_t sample_idx) const;
+
+  // Decoding time of the sample, relative to the first sample.
+  uint64_t get_sample_decoding_time(uint32_t sample_idx) const;
+
+  // Index of the sample that is displayed at this decoding time.
+  // Times after the end of the track return the number of samples.
+  uint32_t get_sample_at_time(uint64_t time) const;
 
   void append_sample_duration(uint32_t duration);
 
@@ -357,6 +364,15 @@ protected:
 private:
   std::vector<TimeToSample> m_entries;
   MemoryHandle m_memory_handle;
+
+  // Index of the first sample and its decoding time for each entry in m_entries.
+  // These are used for O(log n) lookups of sample times.
+  std::vector<uint64_t> m_entry_first_sample;
+  std::vector<uint64_t> m_entry_start_time;
+
+  void append_entry_start();
+
+  size_t find_entry_for_sample(uint32_t sample_idx) const;
 };
 
 
@@ -385,7 +401,7 @@ public:
   // idx counting starts at 1
   const SampleToChunk* get_chunk(uint32_t idx) const;
 
-  void add_chunk(uint32_t description_index);
+  void add_chunk(uint32_t first_chunk, uint32_t description_index);
 
   void increase_samples_in_chunk(uint32_t nFrames);
 
@@ -404,7 +420,7 @@ private:
 };
 
 
-// Chunk Offset Box
+// Chunk Offset Box ('stco' with 32-bit offsets or 'co64' with 64-bit offsets)
 class Box_stco : public FullBox {
 public:
   Box_stco()
@@ -418,9 +434,12 @@ public:
 
   Error write(StreamWriter& writer) const override;
 
-  void add_chunk_offset(uint32_t offset) { m_offsets.push_back(offset); }
+  // Switches to a 'co64' box when the offsets do not fit into 32 bits.
+  void derive_box_version() override;
+
+  void add_chunk_offset(uint64_t offset) { m_offsets.push_back(offset); }
 
-  const std::vector<uint32_t>& get_offsets() const { return m_offsets; }
+  const std::vector<uint64_t>& get_offsets() const { return m_offsets; }
 
   void patch_file_pointers(StreamWriter&, size_t offset) override;
 
@@ -428,10 +447,12 @@ protected:
   Error parse(BitstreamRange& range, const heif_security_limits*) override;
 
 private:
-  std::vector<uint32_t> m_offsets;
+  std::vector<uint64_t> m_offsets;
   MemoryHandle m_memory_handle;
 
   mutable size_t m_offset_start_pos = 0;
+
+  bool is_co64() const { return get_short_type() == fourcc("co64"); }
 };
 
 
@@ -486,6 +507,13 @@ public:
 
   void add_sync_sample(uint32_t sample_idx) { m_sync_samples.push_back(sample_idx); }
 
+  // Sample numbers (starting at 1) of the sync samples in increasing order.
+  const std::vector<uint32_t>& get_sync_samples() const { return m_sync_samples; }
+
+  // Returns the index (starting at 0) of the last sync sample at or before the given sample index.
+  // If there is no such sync sample, 0 is returned.
+  uint32_t get_sync_sample_at_or_before(uint32_t sample_idx) const;
+
 protected:
   Error parse(BitstreamRange& range, const heif_security_limits*) override;
 
@@ -950,4 +978,250 @@ private:
   std::vector<Entry> m_entries;
 };
 
+
+// --- movie fragments
+
+// Movie Extends Box
+class Box_mvex : public Box_container {
+public:
+  Box_mvex() : Box_container("mvex") {}
+
+  const char* debug_box_name() const override { return "Movie Extends"; }
+};
+
+
+// Track Extends Box
+class Box_trex : public FullBox {
+public:
+  Box_trex()
+  {
+    set_short_type(fourcc("trex"));
+  }
+
+  std::string dump(Indent&) const override;
+
+  const char* debug_box_name() const override { return "Track Extends"; }
+
+  Error write(StreamWriter& writer) const override;
+
+  void set_track_id(uint32_t id) { m_track_id = id; }
+
+  uint32_t get_track_id() const { return m_track_id; }
+
+  void set_default_sample_description_index(uint32_t idx) { m_default_sample_description_index = idx; }
+
+  uint32_t get_default_sample_description_index() const { return m_default_sample_description_index; }
+
+  uint32_t get_default_sample_duration() const { return m_default_sample_duration; }
+
+  uint32_t get_default_sample_size() const { return m_default_sample_size; }
+
+  uint32_t get_default_sample_flags() const { return m_default_sample_flags; }
+
+protected:
+  Error parse(BitstreamRange& range, const heif_security_limits*) override;
+
+private:
+  uint32_t m_track_id = 0;
+  uint32_t m_default_sample_description_index = 1;
+  uint32_t m_default_sample_duration = 0;
+  uint32_t m_default_sample_size = 0;
+  uint32_t m_default_sample_flags = 0;
+};
+
+
+// Movie Fragment Box
+class Box_moof : public Box_container {
+public:
+  Box_moof() : Box_container("moof") {}
+
+  const char* debug_box_name() const override { return "Movie Fragment"; }
+};
+
+
+// Movie Fragment Header Box
+class Box_mfhd : public FullBox {
+public:
+  Box_mfhd()
+  {
+    set_short_type(fourcc("mfhd"));
+  }
+
+  std::string dump(Indent&) const override;
+
+  const char* debug_box_name() const override { return "Movie Fragment Header"; }
+
+  Error write(StreamWriter& writer) const override;
+
+  void set_sequence_number(uint32_t n) { m_sequence_number = n; }
+
+  uint32_t get_sequence_number() const { return m_sequence_number; }
+
+protected:
+  Error parse(BitstreamRange& range, const heif_security_limits*) override;
+
+private:
+  uint32_t m_sequence_number = 0;
+};
+
+
+// Track Fragment Box
+class Box_traf : public Box_container {
+public:
+  Box_traf() : Box_container("traf") {}
+
+  const char* debug_box_name() const override { return "Track Fragment"; }
+};
+
+
+// Sample flags, as used in 'trex', 'tfhd' and 'trun'.
+enum SampleFlags : uint32_t {
+  SampleFlags_is_non_sync_sample = 0x00010000,
+  SampleFlags_depends_on_others = 0x01000000,
+  SampleFlags_depends_on_no_other = 0x02000000
+};
+
+
+// Track Fragment Header Box
+class Box_tfhd : public FullBox {
+public:
+  Box_tfhd()
+  {
+    set_short_type(fourcc("tfhd"));
+  }
+
+  enum Flags {
+    Base_data_offset_present = 0x000001,
+    Sample_description_index_present = 0x000002,
+    Default_sample_duration_present = 0x000008,
+    Default_sample_size_present = 0x000010,
+    Default_sample_flags_present = 0x000020,
+    Duration_is_empty = 0x010000,
+    Default_base_is_moof = 0x020000
+  };
+
+  std::string dump(Indent&) const override;
+
+  const char* debug_box_name() const override { return "Track Fragment Header"; }
+
+  Error write(StreamWriter& writer) const override;
+
+  void set_track_id(uint32_t id) { m_track_id = id; }
+
+  uint32_t get_track_id() const { return m_track_id; }
+
+  void set_sample_description_index(uint32_t idx);
+
+  // The getters for the optional fields return 'default_value' when the field is not present.
+
+  uint64_t get_base_data_offset() const { return m_base_data_offset; }
+
+  uint32_t get_sample_description_index(uint32_t default_value) const;
+
+  uint32_t get_default_sample_duration(uint32_t default_value) const;
+
+  uint32_t get_default_sample_size(uint32_t default_value) const;
+
+  uint32_t get_default_sample_flags(uint32_t default_value) const;
+
+protected:
+  Error parse(BitstreamRange& range, const heif_security_limits*) override;
+
+private:
+  uint32_t m_track_id = 0;
+  uint64_t m_base_data_offset = 0;
+  uint32_t m_sample_description_index = 0;
+  uint32_t m_default_sample_duration = 0;
+  uint32_t m_default_sample_size = 0;
+  uint32_t m_default_sample_flags = 0;
+};
+
+
+// Track Fragment Base Media Decode Time Box
+class Box_tfdt : public FullBox {
+public:
+  Box_tfdt()
+  {
+    set_short_type(fourcc("tfdt"));
+  }
+
+  std::string dump(Indent&) const override;
+
+  const char* debug_box_name() const override { return "Track Fragment Decode Time"; }
+
+  Error write(StreamWriter& writer) const override;
+
+  void derive_box_version() override;
+
+  void set_base_media_decode_time(uint64_t t) { m_base_media_decode_time = t; }
+
+  uint64_t get_base_media_decode_time() const { return m_base_media_decode_time; }
+
+protected:
+  Error parse(BitstreamRange& range, const heif_security_limits*) override;
+
+private:
+  uint64_t m_base_media_decode_time = 0;
+};
+
+
+// Track Fragment Run Box
+class Box_trun : public FullBox {
+public:
+  Box_trun()
+  {
+    set_short_type(fourcc("trun"));
+  }
+
+  enum Flags {
+    Data_offset_present = 0x000001,
+    First_sample_flags_present = 0x000004,
+    Sample_duration_present = 0x000100,
+    Sample_size_present = 0x000200,
+    Sample_flags_present = 0x000400,
+    Sample_composition_time_offsets_present = 0x000800
+  };
+
+  struct Sample {
+    uint32_t duration = 0;
+    uint32_t size = 0;
+    uint32_t flags = 0;
+    int64_t composition_time_offset = 0;
+  };
+
+  std::string dump(Indent&) const override;
+
+  const char* debug_box_name() const override { return "Track Fragment Run"; }
+
+  Error write(StreamWriter& writer) const override;
+
+  // The flags define which sample fields are written. Fields that are not written are taken from the 'tfhd' defaults.
+  void add_sample(const Sample& sample) { m_samples.push_back(sample); }
+
+  const std::vector<Sample>& get_samples() const { return m_samples; }
+
+  bool has_data_offset() const { return get_flags() & Flags::Data_offset_present; }
+
+  int32_t get_data_offset() const { return m_data_offset; }
+
+  void set_data_offset(int32_t offset);
+
+  uint32_t get_first_sample_flags() const { return m_first_sample_flags; }
+
+  // The data offset is written relative to the 'mdat' payload. When the 'moof' is written, it is patched
+  // to be relative to the start of the 'moof' box.
+  void patch_file_pointers(StreamWriter&, size_t offset) override;
+
+protected:
+  Error parse(BitstreamRange& range, const heif_security_limits*) override;
+
+private:
+  int32_t m_data_offset = 0;
+  uint32_t m_first_sample_flags = 0;
+  std::vector<Sample> m_samples;
+  MemoryHandle m_memory_handle;
+
+  mutable size_t m_data_offset_pos = 0;
+};
+
 #endif //SEQ_BOXES_H
@@ -111,50 +111,119 @@ void SampleAuxInfoHelper::write_all(const std::shared_ptr<Box>& parent, const st
 }
 
 
+void SampleAuxInfoHelper::write_fragment(const std::shared_ptr<Box>& traf, std::vector<uint8_t>& mdat_data)
+{
+  uint32_t aux_info_type = m_saiz->get_aux_info_type();
+  uint32_t aux_info_type_parameter = m_saiz->get_aux_info_type_parameter();
+
+  traf->append_child_box(m_saiz);
+
+  auto saio = std::make_shared<Box_saio>();
+  saio->set_aux_info_type(aux_info_type, aux_info_type_parameter);
+  saio->add_sample_offset(mdat_data.size());
+  traf->append_child_box(saio);
+
+  mdat_data.insert(mdat_data.end(), m_data.begin(), m_data.end());
+
+  // start with empty tables for the next fragment
+
+  m_saiz = std::make_shared<Box_saiz>();
+  m_saiz->set_aux_info_type(aux_info_type, aux_info_type_parameter);
+  m_data.clear();
+}
+
+
 SampleAuxInfoReader::SampleAuxInfoReader(std::shared_ptr<Box_saiz> saiz,
                                          std::shared_ptr<Box_saio> saio)
 {
-  m_saiz = saiz;
-  m_saio = saio;
+  m_aux_info_type = saiz->get_aux_info_type();
+  m_aux_info_type_parameter = saiz->get_aux_info_type_parameter();
+
+  bool contiguous = (saio->get_num_samples() == 1);
+  uint64_t offset = saio->get_sample_offset(0);
+  auto nSamples = saiz->get_num_samples();
 
-  m_contiguous = (saio->get_num_samples() == 1);
-  if (m_contiguous) {
-    uint64_t offset = saio->get_sample_offset(0);
-    auto nSamples = saiz->get_num_samples();
+  for (uint32_t i = 0; i < nSamples; i++) {
+    uint8_t size = saiz->get_sample_size(i);
 
-    for (uint32_t i=0;i<nSamples;i++) {
-      m_contiguous_offsets.push_back(offset);
-      offset += saiz->get_sample_size(i);
+    if (contiguous) {
+      m_sample_offsets.push_back(offset);
+      offset += size;
+    }
+    else {
+      m_sample_offsets.push_back(saio->get_sample_offset(i));
     }
 
-    // TODO: we could add a special case for contiguous data with constant size
+    m_sample_sizes.push_back(size);
   }
+
+  // TODO: we could add a special case for contiguous data with constant size
+}
+
+
+SampleAuxInfoReader::SampleAuxInfoReader(uint32_t aux_info_type, uint32_t aux_info_type_parameter)
+    : m_aux_info_type(aux_info_type),
+      m_aux_info_type_parameter(aux_info_type_parameter)
+{
 }
 
 
 heif_sample_aux_info_type SampleAuxInfoReader::get_type() const
 {
   heif_sample_aux_info_type type;
-  type.type = m_saiz->get_aux_info_type();
-  type.parameter = m_saiz->get_aux_info_type_parameter();
+  type.type = m_aux_info_type;
+  type.parameter = m_aux_info_type_parameter;
   return type;
 }
 
 
-Result<std::vector<uint8_t>> SampleAuxInfoReader::get_sample_info(const HeifFile* file, uint32_t idx)
+void SampleAuxInfoReader::append_fragment(const std::shared_ptr<Box_saiz>& saiz, const std::shared_ptr<Box_saio>& saio,
+                                          uint64_t base_offset, uint32_t first_sample_idx,
+                                          const std::vector<uint32_t>& run_sample_counts)
 {
-  uint64_t offset;
-  if (m_contiguous) {
-    offset = m_contiguous_offsets[idx];
-  }
-  else {
-    offset = m_saio->get_sample_offset(idx);
+  // samples before this fragment without sample info
+  m_sample_offsets.resize(first_sample_idx, 0);
+  m_sample_sizes.resize(first_sample_idx, 0);
+
+  bool offset_per_run = (saio->get_num_samples() > 1);
+
+  uint32_t run = 0;
+  uint32_t samples_left_in_run = run_sample_counts.empty() ? 0 : run_sample_counts[0];
+  uint64_t offset = base_offset + saio->get_sample_offset(0);
+
+  auto nSamples = saiz->get_num_samples();
+
+  for (uint32_t i = 0; i < nSamples; i++) {
+    if (offset_per_run) {
+      while (samples_left_in_run == 0 && run + 1 < run_sample_counts.size()) {
+        run++;
+        samples_left_in_run = run_sample_counts[run];
+        offset = base_offset + saio->get_sample_offset(run);
+      }
+
+      if (samples_left_in_run > 0) {
+        samples_left_in_run--;
+      }
+    }
+
+    uint8_t size = saiz->get_sample_size(i);
+
+    m_sample_offsets.push_back(offset);
+    m_sample_sizes.push_back(size);
+    offset += size;
   }
+}
 
-  uint8_t size = m_saiz->get_sample_size(idx);
 
+Result<std::vector<uint8_t>> SampleAuxInfoReader::get_sample_info(const HeifFile* file, uint32_t idx)
+{
   std::vector<uint8_t> data;
-  Error err = file->append_data_from_file_range(data, offset, size);
+
+  if (idx >= m_sample_sizes.size() || m_sample_sizes[idx] == 0) {
+    return data;
+  }
+
+  Error err = file->append_data_from_file_range(data, m_sample_offsets[idx], m_sample_sizes[idx]);
   if (err) {
     return err;
   }
@@ -237,8 +306,44 @@ Track::Track(HeifContext* ctx, const std::shared_ptr<Box_trak>& trak_box)
   }
 
   m_stts = stbl->get_child_box<Box_stts>();
+  m_stss = stbl->get_child_box<Box_stss>();
+
+  // --- read sample auxiliary information boxes
+
+  std::vector<std::shared_ptr<Box_saiz>> saiz_boxes = stbl->get_child_boxes<Box_saiz>();
+  std::vector<std::shared_ptr<Box_saio>> saio_boxes = stbl->get_child_boxes<Box_saio>();
+
+  for (const auto& saiz : saiz_boxes) {
+    uint32_t aux_info_type = saiz->get_aux_info_type();
+    uint32_t aux_info_type_parameter = saiz->get_aux_info_type_parameter();
 
-  const std::vector<uint32_t>& chunk_offsets = m_stco->get_offsets();
+    // find the corresponding saio box
+
+    std::shared_ptr<Box_saio> saio;
+    for (const auto& candidate : saio_boxes) {
+      if (candidate->get_aux_info_type() == aux_info_type &&
+          candidate->get_aux_info_type_parameter() == aux_info_type_parameter) {
+        saio = candidate;
+        break;
+      }
+    }
+
+    if (saio) {
+      if (aux_info_type == fourcc("suid")) {
+        m_aux_reader_content_ids = std::make_unique<SampleAuxInfoReader>(saiz, saio);
+      }
+
+      if (aux_info_type == fourcc("stai")) {
+        m_aux_reader_tai_timestamps = std::make_unique<SampleAuxInfoReader>(saiz, saio);
+      }
+    }
+  }
+
+  // --- samples stored in movie fragments
+
+  read_movie_fragments();
+
+  const std::vector<uint64_t>& chunk_offsets = m_stco->get_offsets();
   assert(chunk_offsets.size() <= (size_t) std::numeric_limits<uint32_t>::max()); // There cannot be more than uint32_t chunks.
 
   uint32_t current_sample_idx = 0;
@@ -282,6 +387,8 @@ Track::Track(HeifContext* ctx, const std::shared_ptr<Box_trak>& trak_box)
         // use a new decoder
         chunk->set_decoder(Decoder::alloc_for_sequence_sample_description_box(visualSampleDescription));
       }
+
+      chunk->set_sample_description(visualSampleDescription);
     }
 
     m_chunks.push_back(chunk);
@@ -290,37 +397,6 @@ Track::Track(HeifContext* ctx, const std::shared_ptr<Box_trak>& trak_box)
     previous_sample_description_index = sampleToChunk.sample_description_index;
   }
 
-  // --- read sample auxiliary information boxes
-
-  std::vector<std::shared_ptr<Box_saiz>> saiz_boxes = stbl->get_child_boxes<Box_saiz>();
-  std::vector<std::shared_ptr<Box_saio>> saio_boxes = stbl->get_child_boxes<Box_saio>();
-
-  for (const auto& saiz : saiz_boxes) {
-    uint32_t aux_info_type = saiz->get_aux_info_type();
-    uint32_t aux_info_type_parameter = saiz->get_aux_info_type_parameter();
-
-    // find the corresponding saio box
-
-    std::shared_ptr<Box_saio> saio;
-    for (const auto& candidate : saio_boxes) {
-      if (candidate->get_aux_info_type() == aux_info_type &&
-          candidate->get_aux_info_type_parameter() == aux_info_type_parameter) {
-        saio = candidate;
-        break;
-      }
-    }
-
-    if (saio) {
-      if (aux_info_type == fourcc("suid")) {
-        m_aux_reader_content_ids = std::make_unique<SampleAuxInfoReader>(saiz, saio);
-      }
-
-      if (aux_info_type == fourcc("stai")) {
-        m_aux_reader_tai_timestamps = std::make_unique<SampleAuxInfoReader>(saiz, saio);
-      }
-    }
-  }
-
   // --- read track properties
 
   if (auto meta = trak_box->get_child_box<Box_meta>()) {
@@ -576,13 +652,77 @@ bool Track::end_of_sequence_reached() const
 }
 
 
-void Track::finalize_track()
+bool Track::all_samples_are_sync_samples() const
+{
+  // Without 'stss' box, every sample is a sync sample.
+  return !m_stss || m_stss->get_sync_samples().size() == m_num_samples;
+}
+
+
+Result<uint64_t> Track::get_output_sample_at_time(uint64_t time) const
+{
+  if (m_presentation_timeline.empty() || !m_stts) {
+    return Error{heif_error_Usage_error,
+                 heif_suberror_Unspecified,
+                 "Track has no samples"};
+  }
+
+  // The presentation timeline is the media timeline, possibly repeated (see init_sample_timing_table()).
+
+  const SampleTiming& last = m_presentation_timeline.back();
+  uint64_t period = last.media_decoding_time + last.sample_duration_media_time;
+
+  uint64_t repetition = 0;
+  if (period > 0) {
+    repetition = time / period;
+    time %= period;
+  }
+
+  uint32_t sample_idx = m_stts->get_sample_at_time(time);
+  if (sample_idx >= m_presentation_timeline.size()) {
+    sample_idx = static_cast<uint32_t>(m_presentation_timeline.size() - 1);
+  }
+
+  uint64_t output_sample_idx = repetition * m_presentation_timeline.size() + sample_idx;
+  if (output_sample_idx >= m_num_output_samples) {
+    return Error{heif_error_End_of_sequence,
+                 heif_suberror_Unspecified,
+                 "Seek position is after the end of the sequence"};
+  }
+
+  return output_sample_idx;
+}
+
+
+Error Track::seek_to_sample(uint64_t output_sample_idx)
 {
+  if (output_sample_idx >= m_num_output_samples) {
+    return {heif_error_End_of_sequence,
+            heif_suberror_Unspecified,
+            "Seek position is after the end of the sequence"};
+  }
+
+  m_next_sample_to_be_processed = static_cast<uint32_t>(output_sample_idx);
+
+  return Error::Ok;
+}
+
+
+Error Track::finalize_track()
+{
+  if (m_fragmented_writing) {
+    // The samples, their durations and their auxiliary information are stored in the movie fragments.
+    m_mdhd->set_duration(0);
+    return Error::Ok;
+  }
+
   if (m_aux_helper_tai_timestamps) m_aux_helper_tai_timestamps->write_all(m_stbl, get_file());
   if (m_aux_helper_content_ids) m_aux_helper_content_ids->write_all(m_stbl, get_file());
 
   uint64_t duration = m_stts->get_total_duration(true);
   m_mdhd->set_duration(duration);
+
+  return Error::Ok;
 }
 
 
@@ -629,13 +769,26 @@ void Track::enable_edit_list_repeat_mode(bool enable)
 }
 
 
-void Track::add_chunk(heif_compression_format format)
+Error Track::add_chunk(heif_compression_format format)
 {
+  // All fragments refer to the sample description that is written into the 'moov' box at the start.
+  if (m_fragmented_writing && !m_chunks.empty()) {
+    return {heif_error_Usage_error,
+            heif_suberror_Unspecified,
+            "The compression format of a track cannot be changed when writing a fragmented file."};
+  }
+
   auto chunk = std::make_shared<Chunk>(m_heif_context, m_id, format);
   m_chunks.push_back(chunk);
 
-  int chunkIdx = (uint32_t) m_chunks.size();
-  m_stsc->add_chunk(chunkIdx);
+  m_num_samples_in_last_chunk = 0;
+
+  if (!m_fragmented_writing) {
+    auto chunkIdx = (uint32_t) m_chunks.size();
+    m_stsc->add_chunk(chunkIdx, chunkIdx);
+  }
+
+  return Error::Ok;
 }
 
 void Track::set_sample_description_box(std::shared_ptr<Box> sample_description_box)
@@ -655,35 +808,43 @@ void Track::set_sample_description_box(std::shared_ptr<Box> sample_description_b
 Error Track::write_sample_data(const std::vector<uint8_t>& raw_data, uint32_t sample_duration, bool is_sync_sample,
                                const heif_tai_timestamp_packet* tai, const std::string& gimi_contentID)
 {
-  size_t data_start = m_heif_context->get_heif_file()->append_mdat_data(raw_data);
+  if (sample_duration == 0) {
+    return {heif_error_Usage_error,
+            heif_suberror_Unspecified,
+            "Sample duration may not be 0"};
+  }
 
-  // first sample in chunk? -> write chunk offset
+  if (m_fragmented_writing) {
+    m_fragment_data.insert(m_fragment_data.end(), raw_data.begin(), raw_data.end());
+    m_fragment_samples.push_back({(uint32_t) raw_data.size(), sample_duration, is_sync_sample});
+    m_fragment_duration += sample_duration;
+  }
+  else {
+    size_t data_start = m_heif_context->get_heif_file()->append_mdat_data(raw_data);
 
-  if (m_stsc->last_chunk_empty()) {
-    // if auxiliary data is interleaved, write it between the chunks
-    if (m_aux_helper_tai_timestamps) m_aux_helper_tai_timestamps->write_interleaved(get_file());
-    if (m_aux_helper_content_ids) m_aux_helper_content_ids->write_interleaved(get_file());
+    // first sample in chunk? -> write chunk offset
 
-    // TODO
-    assert(data_start < 0xFF000000); // add some headroom for header data
-    m_stco->add_chunk_offset(static_cast<uint32_t>(data_start));
-  }
+    if (last_chunk_empty()) {
+      // if auxiliary data is interleaved, write it between the chunks
+      if (m_aux_helper_tai_timestamps) m_aux_helper_tai_timestamps->write_interleaved(get_file());
+      if (m_aux_helper_content_ids) m_aux_helper_content_ids->write_interleaved(get_file());
 
-  m_stsc->increase_samples_in_chunk(1);
+      // Offsets beyond 32 bit are written into a 'co64' box.
+      m_stco->add_chunk_offset(data_start);
+    }
 
-  m_stsz->append_sample_size((uint32_t)raw_data.size());
+    m_stsc->increase_samples_in_chunk(1);
 
-  if (is_sync_sample) {
-    m_stss->add_sync_sample(m_next_sample_to_be_processed + 1);
-  }
+    m_stsz->append_sample_size((uint32_t)raw_data.size());
 
-  if (sample_duration == 0) {
-    return {heif_error_Usage_error,
-            heif_suberror_Unspecified,
-            "Sample duration may not be 0"};
+    if (is_sync_sample) {
+      m_stss->add_sync_sample(m_next_sample_to_be_processed + 1);
+    }
+
+    m_stts->append_sample_duration(sample_duration);
   }
 
-  m_stts->append_sample_duration(sample_duration);
+  m_num_samples_in_last_chunk++;
 
 
   // --- sample timestamp
@@ -729,10 +890,341 @@ Error Track::write_sample_data(const std::vector<uint8_t>& raw_data, uint32_t sa
 
   m_next_sample_to_be_processed++;
 
+  if (m_fragmented_writing && m_fragment_duration >= m_max_fragment_duration) {
+    return m_heif_context->write_track_fragment(this);
+  }
+
   return Error::Ok;
 }
 
 
+bool Track::has_sample_description() const
+{
+  return m_stsd->get_num_sample_entries() > 0;
+}
+
+
+void Track::enable_fragmented_writing(uint64_t max_fragment_duration)
+{
+  m_fragmented_writing = true;
+  m_max_fragment_duration = max_fragment_duration;
+
+  // The sync sample flags are stored in the 'trun' boxes. An empty 'stss' would mark all samples as non-sync.
+  m_stbl->remove_child_box(m_stss);
+
+  // --- announce the movie fragments in the 'moov' box
+
+  auto mvex = m_moov->get_child_box<Box_mvex>();
+  if (!mvex) {
+    mvex = std::make_shared<Box_mvex>();
+    m_moov->append_child_box(mvex);
+  }
+
+  auto trex = std::make_shared<Box_trex>();
+  trex->set_track_id(m_id);
+  mvex->append_child_box(trex);
+}
+
+
+Result<std::vector<uint8_t>> Track::write_fragment(uint32_t sequence_number)
+{
+  auto moof = std::make_shared<Box_moof>();
+
+  auto mfhd = std::make_shared<Box_mfhd>();
+  mfhd->set_sequence_number(sequence_number);
+  moof->append_child_box(mfhd);
+
+  auto traf = std::make_shared<Box_traf>();
+  moof->append_child_box(traf);
+
+  // All data offsets are relative to the start of the 'moof' box.
+  auto tfhd = std::make_shared<Box_tfhd>();
+  tfhd->set_track_id(m_id);
+  tfhd->set_flags(Box_tfhd::Flags::Default_base_is_moof);
+  tfhd->set_sample_description_index(1);
+  traf->append_child_box(tfhd);
+
+  auto tfdt = std::make_shared<Box_tfdt>();
+  tfdt->set_base_media_decode_time(m_fragment_base_media_decode_time);
+  traf->append_child_box(tfdt);
+
+  auto trun = std::make_shared<Box_trun>();
+  trun->set_flags(Box_trun::Flags::Sample_duration_present |
+                  Box_trun::Flags::Sample_size_present |
+                  Box_trun::Flags::Sample_flags_present);
+  trun->set_data_offset(0);
+
+  for (const auto& sample : m_fragment_samples) {
+    Box_trun::Sample trun_sample;
+    trun_sample.duration = sample.duration;
+    trun_sample.size = sample.size;
+    trun_sample.flags = (sample.is_sync_sample ?
+                         SampleFlags_depends_on_no_other :
+                         (SampleFlags_depends_on_others | SampleFlags_is_non_sync_sample));
+    trun->add_sample(trun_sample);
+  }
+
+  traf->append_child_box(trun);
+
+  // --- sample auxiliary information is stored after the sample data
+
+  std::vector<uint8_t> mdat_data = std::move(m_fragment_data);
+
+  if (m_aux_helper_tai_timestamps) m_aux_helper_tai_timestamps->write_fragment(traf, mdat_data);
+  if (m_aux_helper_content_ids) m_aux_helper_content_ids->write_fragment(traf, mdat_data);
+
+  // --- write 'moof' and 'mdat'
+
+  moof->derive_box_version_recursive();
+
+  StreamWriter writer;
+  Error err = moof->write(writer);
+  if (err) {
+    return err;
+  }
+
+  size_t mdat_header_size = (mdat_data.size() <= 0xFFFFFFFF - 8) ? 8 : 16;
+
+  moof->patch_file_pointers_recursively(writer, writer.data_size() + mdat_header_size);
+
+  if (mdat_header_size == 8) {
+    writer.write32((uint32_t) (mdat_data.size() + 8));
+    writer.write32(fourcc("mdat"));
+  }
+  else {
+    writer.write32(1);
+    writer.write32(fourcc("mdat"));
+    writer.write64(mdat_data.size() + 16);
+  }
+
+  writer.write(mdat_data);
+
+  // --- start next fragment
+
+  m_fragment_base_media_decode_time += m_fragment_duration;
+  m_fragment_duration = 0;
+  m_fragment_samples.clear();
+  m_fragment_data.clear();
+
+  return writer.get_data();
+}
+
+
+static std::shared_ptr<Box_trex> find_trex(const std::shared_ptr<Box_moov>& moov, uint32_t track_id)
+{
+  if (moov) {
+    if (auto mvex = moov->get_child_box<Box_mvex>()) {
+      for (const auto& box : mvex->get_child_boxes<Box_trex>()) {
+        if (box->get_track_id() == track_id) {
+          return box;
+        }
+      }
+    }
+  }
+
+  return nullptr;
+}
+
+
+// Returns the file position after the sample data of a track fragment.
+static uint64_t get_end_of_traf_data(const Box_traf& traf, const Box_tfhd& tfhd, uint64_t base_offset,
+                                     const std::shared_ptr<Box_trex>& trex)
+{
+  uint32_t default_size = tfhd.get_default_sample_size(trex ? trex->get_default_sample_size() : 0);
+
+  uint64_t data_offset = base_offset;
+
+  for (const auto& trun : traf.get_child_boxes<Box_trun>()) {
+    if (trun->has_data_offset()) {
+      data_offset = base_offset + trun->get_data_offset();
+    }
+
+    for (const auto& sample : trun->get_samples()) {
+      data_offset += (trun->get_flags() & Box_trun::Flags::Sample_size_present) ? sample.size : default_size;
+    }
+  }
+
+  return data_offset;
+}
+
+
+void Track::read_movie_fragments()
+{
+  const auto& fragments = get_file()->get_movie_fragments();
+  if (fragments.empty()) {
+    return;
+  }
+
+  // --- find the defaults for this track
+
+  auto moov = get_file()->get_moov_box();
+  std::shared_ptr<Box_trex> trex = find_trex(moov, m_id);
+
+  if (!trex) {
+    return;
+  }
+
+  if (!m_stts) {
+    m_stts = std::make_shared<Box_stts>();
+  }
+
+  uint32_t sample_idx = m_stsz->num_samples();
+  uint64_t duration = m_stts->get_total_duration(true);
+
+  for (const auto& fragment : fragments) {
+    if (!fragment.moof) {
+      continue;
+    }
+
+    // Without an explicit base, the data of a track fragment follows the data of the previous track fragment
+    // in the same 'moof' (ISO/IEC 14496-12, 8.8.7.1).
+    uint64_t end_of_previous_traf_data = fragment.file_offset;
+
+    for (const auto& traf : fragment.moof->get_child_boxes<Box_traf>()) {
+      auto tfhd = traf->get_child_box<Box_tfhd>();
+      if (!tfhd) {
+        continue;
+      }
+
+      uint64_t base_offset;
+      if (tfhd->get_flags() & Box_tfhd::Flags::Base_data_offset_present) {
+        base_offset = tfhd->get_base_data_offset();
+      }
+      else if (tfhd->get_flags() & Box_tfhd::Flags::Default_base_is_moof) {
+        base_offset = fragment.file_offset;
+      }
+      else {
+        base_offset = end_of_previous_traf_data;
+      }
+
+      if (tfhd->get_track_id() != m_id) {
+        end_of_previous_traf_data = get_end_of_traf_data(*traf, *tfhd, base_offset, find_trex(moov, tfhd->get_track_id()));
+        continue;
+      }
+
+      uint32_t sample_description_index = tfhd->get_sample_description_index(trex->get_default_sample_description_index());
+      uint32_t default_duration = tfhd->get_default_sample_duration(trex->get_default_sample_duration());
+      uint32_t default_size = tfhd->get_default_sample_size(trex->get_default_sample_size());
+      uint32_t default_flags = tfhd->get_default_sample_flags(trex->get_default_sample_flags());
+
+      uint32_t traf_first_sample_idx = sample_idx;
+      std::vector<uint32_t> run_sample_counts;
+      uint64_t data_offset = base_offset;
+
+      for (const auto& trun : traf->get_child_boxes<Box_trun>()) {
+        uint32_t trun_flags = trun->get_flags();
+
+        // A run without data offset starts directly after the data of the previous run.
+        if (trun->has_data_offset()) {
+          data_offset = base_offset + trun->get_data_offset();
+        }
+
+        const auto& samples = trun->get_samples();
+
+        // each track run is stored as a chunk
+
+        auto chunkIdx = (uint32_t) (m_stco->get_offsets().size() + 1);
+        m_stco->add_chunk_offset(data_offset);
+        m_stsc->add_chunk(chunkIdx, sample_description_index);
+        m_stsc->increase_samples_in_chunk((uint32_t) samples.size());
+
+        for (size_t i = 0; i < samples.size(); i++) {
+          const Box_trun::Sample& sample = samples[i];
+
+          uint32_t size = (trun_flags & Box_trun::Flags::Sample_size_present) ? sample.size : default_size;
+          uint32_t sample_duration = (trun_flags & Box_trun::Flags::Sample_duration_present) ? sample.duration : default_duration;
+
+          uint32_t flags = default_flags;
+          if (i == 0 && (trun_flags & Box_trun::Flags::First_sample_flags_present)) {
+            flags = trun->get_first_sample_flags();
+          }
+          else if (trun_flags & Box_trun::Flags::Sample_flags_present) {
+            flags = sample.flags;
+          }
+
+          m_stsz->append_sample_size(size);
+          m_stts->append_sample_duration(sample_duration);
+
+          bool is_sync_sample = !(flags & SampleFlags_is_non_sync_sample);
+
+          // Without 'stss', all previous samples are sync samples.
+          if (!is_sync_sample && !m_stss) {
+            m_stss = std::make_shared<Box_stss>();
+            for (uint32_t k = 0; k < sample_idx; k++) {
+              m_stss->add_sync_sample(k + 1);
+            }
+          }
+
+          if (is_sync_sample && m_stss) {
+            m_stss->add_sync_sample(sample_idx + 1);
+          }
+
+          data_offset += size;
+          duration += sample_duration;
+          sample_idx++;
+        }
+
+        run_sample_counts.push_back((uint32_t) samples.size());
+      }
+
+      end_of_previous_traf_data = data_offset;
+
+      // --- sample auxiliary information of this fragment
+
+      std::vector<std::shared_ptr<Box_saio>> saio_boxes = traf->get_child_boxes<Box_saio>();
+
+      for (const auto& saiz : traf->get_child_boxes<Box_saiz>()) {
+        uint32_t aux_info_type = saiz->get_aux_info_type();
+        uint32_t aux_info_type_parameter = saiz->get_aux_info_type_parameter();
+
+        std::shared_ptr<Box_saio> saio;
+        for (const auto& candidate : saio_boxes) {
+          if (candidate->get_aux_info_type() == aux_info_type &&
+              candidate->get_aux_info_type_parameter() == aux_info_type_parameter) {
+            saio = candidate;
+            break;
+          }
+        }
+
+        std::unique_ptr<SampleAuxInfoReader>* reader;
+        if (aux_info_type == fourcc("suid")) {
+          reader = &m_aux_reader_content_ids;
+        }
+        else if (aux_info_type == fourcc("stai")) {
+          reader = &m_aux_reader_tai_timestamps;
+        }
+        else {
+          continue;
+        }
+
+        if (!saio) {
+          continue;
+        }
+
+        if (!*reader) {
+          *reader = std::make_unique<SampleAuxInfoReader>(aux_info_type, aux_info_type_parameter);
+        }
+
+        (*reader)->append_fragment(saiz, saio, base_offset, traf_first_sample_idx, run_sample_counts);
+      }
+    }
+  }
+
+  // The 'moov' of a fragmented file usually does not contain the duration.
+  if (duration > m_mdhd->get_duration()) {
+    m_mdhd->set_duration(duration);
+  }
+
+  auto mvhd = get_file()->get_mvhd_box();
+  if (mvhd && m_mdhd->get_timescale() != 0) {
+    uint64_t movie_duration = duration * mvhd->get_time_scale() / m_mdhd->get_timescale();
+    if (movie_duration > mvhd->get_duration()) {
+      mvhd->set_duration(movie_duration);
+    }
+  }
+}
+
+
 void Track::add_reference_to_track(uint32_t referenceType, uint32_t to_track_id)
 {
   if (!m_tref) {
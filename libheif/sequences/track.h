@@ -53,6 +53,10 @@ public:
 
   void write_all(const std::shared_ptr<Box>& parent, const std::shared_ptr<HeifFile>& file);
 
+  // Add the sample infos collected since the last fragment as 'saiz'/'saio' to the track fragment.
+  // The data is appended to `mdat_data`. The 'saio' offset is relative to the start of `mdat_data`.
+  void write_fragment(const std::shared_ptr<Box>& traf, std::vector<uint8_t>& mdat_data);
+
 private:
   std::shared_ptr<Box_saiz> m_saiz;
   std::shared_ptr<Box_saio> m_saio;
@@ -69,16 +73,27 @@ public:
   SampleAuxInfoReader(std::shared_ptr<Box_saiz>,
                       std::shared_ptr<Box_saio>);
 
+  // For sample infos that are only stored in movie fragments.
+  SampleAuxInfoReader(uint32_t aux_info_type, uint32_t aux_info_type_parameter);
+
   heif_sample_aux_info_type get_type() const;
 
+  // Add the sample infos of a track fragment, starting at sample `first_sample_idx`.
+  // The 'saio' offsets are relative to `base_offset`. There is either one offset for the whole fragment
+  // or one offset for each track run, which has `run_sample_counts` samples.
+  void append_fragment(const std::shared_ptr<Box_saiz>&, const std::shared_ptr<Box_saio>&,
+                       uint64_t base_offset, uint32_t first_sample_idx,
+                       const std::vector<uint32_t>& run_sample_counts);
+
   Result<std::vector<uint8_t>> get_sample_info(const HeifFile* file, uint32_t idx);
 
 private:
-  std::shared_ptr<Box_saiz> m_saiz;
-  std::shared_ptr<Box_saio> m_saio;
+  uint32_t m_aux_info_type = 0;
+  uint32_t m_aux_info_type_parameter = 0;
 
-  bool m_contiguous;
-  std::vector<uint64_t> m_contiguous_offsets;
+  // file offset and size of the info for each sample (size 0: no info present)
+  std::vector<uint64_t> m_sample_offsets;
+  std::vector<uint8_t> m_sample_sizes;
 };
 
 
@@ -171,8 +186,36 @@ public:
 
   bool end_of_sequence_reached() const;
 
+  // True if every sample can be decoded independently (intra-only sequence).
+  bool all_samples_are_sync_samples() const;
+
+  // Index of the output sample (in presentation order, including edit-list repetitions)
+  // that is shown at the given time (in track timescale units).
+  Result<uint64_t> get_output_sample_at_time(uint64_t time) const;
+
+  // Set the next sample to be returned. Visual tracks start decoding at the preceding sync sample.
+  virtual Error seek_to_sample(uint64_t output_sample_idx);
+
   // Compute some parameters after all frames have been encoded (for example: track duration).
-  void finalize_track();
+  virtual Error finalize_track();
+
+  // True if the encoder still holds samples that have not been written into the track yet.
+  virtual bool has_buffered_samples() const { return false; }
+
+  // --- fragmented writing
+
+  // Write all samples into movie fragments instead of the sample tables of the 'moov' box.
+  // A fragment is completed when its duration reaches `max_fragment_duration` (in track timescale units).
+  void enable_fragmented_writing(uint64_t max_fragment_duration);
+
+  bool has_chunks() const { return !m_chunks.empty(); }
+
+  bool has_sample_description() const;
+
+  bool has_fragment_data() const { return !m_fragment_samples.empty(); }
+
+  // Serialize the samples collected since the last fragment into a 'moof' and an 'mdat' box.
+  Result<std::vector<uint8_t>> write_fragment(uint32_t sequence_number);
 
   const TrackOptions& get_track_info() const { return m_track_info; }
 
@@ -242,10 +285,35 @@ protected:
   std::shared_ptr<class Box_taic> m_first_taic; // the TAIC of the first chunk
 
 
+  // --- fragmented writing
+
+  bool m_fragmented_writing = false;
+  uint64_t m_max_fragment_duration = 0;
+
+  struct FragmentSample
+  {
+    uint32_t size;
+    uint32_t duration;
+    bool is_sync_sample;
+  };
+
+  std::vector<FragmentSample> m_fragment_samples;
+  std::vector<uint8_t> m_fragment_data;
+  uint64_t m_fragment_duration = 0;
+  uint64_t m_fragment_base_media_decode_time = 0;
+
+  // Append the samples of the movie fragments in the file to the sample tables.
+  void read_movie_fragments();
+
+
   // --- Helper functions for writing samples.
 
+  uint32_t m_num_samples_in_last_chunk = 0;
+
+  bool last_chunk_empty() const { return m_num_samples_in_last_chunk == 0; }
+
   // Call when we begin a new chunk of samples, e.g. because the compression format changed
-  void add_chunk(heif_compression_format format);
+  Error add_chunk(heif_compression_format format);
 
   // Call to set the sample_description_box for the last added chunk.
   // Has to be called when we call add_chunk().
@@ -28,7 +28,7 @@
 Track_Metadata::Track_Metadata(HeifContext* ctx, const std::shared_ptr<Box_trak>& trak)
     : Track(ctx, trak)
 {
-  const std::vector<uint32_t>& chunk_offsets = m_stco->get_offsets();
+  const std::vector<uint64_t>& chunk_offsets = m_stco->get_offsets();
 
   // Metadata tracks are not meant for display
 
@@ -152,7 +152,11 @@ Error Track_Metadata::write_raw_metadata(const heif_raw_sequence_sample* raw_sam
     uri->set_uri(m_uri);
     sample_description_box->append_child_box(uri);
 
-    add_chunk(heif_compression_undefined);
+    Error chunkErr = add_chunk(heif_compression_undefined);
+    if (chunkErr) {
+      return chunkErr;
+    }
+
     set_sample_description_box(sample_description_box);
   }
 
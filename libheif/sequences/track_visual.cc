@@ -26,12 +26,13 @@
 #include "context.h"
 #include "api_structs.h"
 #include "codecs/hevc_boxes.h"
+#include "sequences/seq_boxes.h"
 
 
 Track_Visual::Track_Visual(HeifContext* ctx, const std::shared_ptr<Box_trak>& trak)
     : Track(ctx, trak)
 {
-  const std::vector<uint32_t>& chunk_offsets = m_stco->get_offsets();
+  const std::vector<uint64_t>& chunk_offsets = m_stco->get_offsets();
 
   // Find sequence resolution
 
@@ -117,19 +118,43 @@ Result<std::shared_ptr<HeifPixelImage>> Track_Visual::decode_next_image_sample(c
                  "End of sequence"};
   }
 
+  // --- after seeking: decode the frames between the sync sample and the seek target without returning them
+
+  while (m_next_sample_to_be_processed < m_next_sample_to_be_output) {
+    const auto& skippedTiming = m_presentation_timeline[m_next_sample_to_be_processed % m_presentation_timeline.size()];
+
+    auto skippedResult = decode_sample(skippedTiming.sampleIdx, skippedTiming.chunkIdx, options);
+    m_next_sample_to_be_processed++;
+
+    if (!skippedResult) {
+      return skippedResult.error();
+    }
+  }
+
   const auto& sampleTiming = m_presentation_timeline[m_next_sample_to_be_processed % m_presentation_timeline.size()];
   uint32_t sample_idx = sampleTiming.sampleIdx;
-  uint32_t chunk_idx = sampleTiming.chunkIdx;
 
-  const std::shared_ptr<Chunk>& chunk = m_chunks[chunk_idx];
+  Result<std::shared_ptr<HeifPixelImage>> decodingResult;
 
-  auto decoder = chunk->get_decoder();
-  assert(decoder);
+#if ENABLE_MULTITHREADING_SUPPORT
+  if (use_decoding_pipeline()) {
+    Error err = fill_decoding_pipeline(options, num_output_samples);
+    if (err) {
+      return err;
+    }
 
-  decoder->set_data_extent(chunk->get_data_extent_for_sample(sample_idx));
+    PipelinedFrame frame = std::move(m_pipeline.front());
+    m_pipeline.pop_front();
+
+    decodingResult = frame.image.get();
+    m_idle_pipeline_decoders[frame.sample_description.get()].push_back(frame.decoder);
+  }
+  else
+#endif
+  {
+    decodingResult = decode_sample(sample_idx, sampleTiming.chunkIdx, options);
+  }
 
-  Result<std::shared_ptr<HeifPixelImage>> decodingResult = decoder->decode_single_frame_from_compressed_data(options,
-                                                                                                             m_heif_context->get_security_limits());
   if (!decodingResult) {
     m_next_sample_to_be_processed++;
     return decodingResult.error();
@@ -137,6 +162,35 @@ Result<std::shared_ptr<HeifPixelImage>> Track_Visual::decode_next_image_sample(c
 
   auto image = *decodingResult;
 
+  Error err = add_sample_properties(image, sample_idx, options);
+  if (err) {
+    return err;
+  }
+
+  m_next_sample_to_be_processed++;
+
+  return image;
+}
+
+
+Result<std::shared_ptr<HeifPixelImage>> Track_Visual::decode_sample(uint32_t sample_idx, uint32_t chunk_idx,
+                                                                    const heif_decoding_options& options)
+{
+  const std::shared_ptr<Chunk>& chunk = m_chunks[chunk_idx];
+
+  auto decoder = chunk->get_decoder();
+  assert(decoder);
+
+  decoder->set_data_extent(chunk->get_data_extent_for_sample(sample_idx));
+
+  return decoder->decode_single_frame_from_compressed_data(options,
+                                                           m_heif_context->get_security_limits());
+}
+
+
+Error Track_Visual::add_sample_properties(const std::shared_ptr<HeifPixelImage>& image, uint32_t sample_idx,
+                                          const heif_decoding_options& options)
+{
   if (m_stts) {
     image->set_sample_duration(m_stts->get_sample_duration(sample_idx));
   }
@@ -184,15 +238,206 @@ Result<std::shared_ptr<HeifPixelImage>> Track_Visual::decode_next_image_sample(c
     image->set_tai_timestamp(&*resultTai);
   }
 
-  m_next_sample_to_be_processed++;
+  return Error::Ok;
+}
 
-  return image;
+
+Error Track_Visual::seek_to_sample(uint64_t output_sample_idx)
+{
+  if (output_sample_idx >= m_num_output_samples) {
+    return {heif_error_End_of_sequence,
+            heif_suberror_Unspecified,
+            "Seek position is after the end of the sequence"};
+  }
+
+#if ENABLE_MULTITHREADING_SUPPORT
+  clear_decoding_pipeline();
+#endif
+
+  // --- start decoding at the preceding sync sample (in the same repetition of the sequence)
+
+  uint64_t timeline_size = m_presentation_timeline.size();
+  uint64_t repetition_start = output_sample_idx - output_sample_idx % timeline_size;
+  uint32_t sample_idx = m_presentation_timeline[output_sample_idx % timeline_size].sampleIdx;
+
+  uint32_t sync_sample_idx = sample_idx;
+  if (m_stss) {
+    sync_sample_idx = m_stss->get_sync_sample_at_or_before(sample_idx);
+  }
+
+  // The presentation timeline is in decoding order. Hence, the sample index equals the timeline index.
+  m_next_sample_to_be_processed = static_cast<uint32_t>(repetition_start + sync_sample_idx);
+  m_next_sample_to_be_output = output_sample_idx;
+
+  if (m_aux_alpha_track) {
+    Error err = m_aux_alpha_track->seek_to_sample(output_sample_idx);
+    if (err) {
+      return err;
+    }
+  }
+
+  return Error::Ok;
+}
+
+
+void Track_Visual::set_decoding_pipeline_depth(int depth)
+{
+  m_decoding_pipeline_depth = depth;
+
+  if (m_aux_alpha_track) {
+    m_aux_alpha_track->set_decoding_pipeline_depth(depth);
+  }
+
+#if ENABLE_MULTITHREADING_SUPPORT
+  if (!use_decoding_pipeline()) {
+    clear_decoding_pipeline();
+    m_idle_pipeline_decoders.clear();
+  }
+#endif
+}
+
+
+#if ENABLE_MULTITHREADING_SUPPORT
+
+// A copy of the decoding options that owns all data referenced by them.
+struct PipelineDecodingOptions
+{
+  std::unique_ptr<heif_decoding_options, void (*)(heif_decoding_options*)> options{heif_decoding_options_alloc(),
+                                                                                   heif_decoding_options_free};
+  std::string decoder_id;
+  std::unique_ptr<heif_color_conversion_options_ext, void (*)(heif_color_conversion_options_ext*)> color_conversion_options_ext{
+    nullptr, heif_color_conversion_options_ext_free};
+  heif_color_profile_nclx output_image_nclx_profile{};
+};
+
+
+static std::shared_ptr<const PipelineDecodingOptions> copy_decoding_options_for_pipeline(const heif_decoding_options& src)
+{
+  auto copy = std::make_shared<PipelineDecodingOptions>();
+
+  heif_decoding_options* options = copy->options.get();
+  heif_decoding_options_copy(options, &src);
+
+  if (options->decoder_id) {
+    copy->decoder_id = options->decoder_id;
+    options->decoder_id = copy->decoder_id.c_str();
+  }
+
+  if (options->color_conversion_options_ext) {
+    copy->color_conversion_options_ext.reset(heif_color_conversion_options_ext_alloc());
+    heif_color_conversion_options_ext_copy(copy->color_conversion_options_ext.get(), options->color_conversion_options_ext);
+    options->color_conversion_options_ext = copy->color_conversion_options_ext.get();
+  }
+
+  if (options->output_image_nclx_profile) {
+    copy->output_image_nclx_profile = *options->output_image_nclx_profile;
+    options->output_image_nclx_profile = &copy->output_image_nclx_profile;
+  }
+
+  // The callbacks and their user data are only valid during the API call that passed them,
+  // but pipelined frames are decoded after it has returned.
+  options->start_progress = nullptr;
+  options->on_progress = nullptr;
+  options->end_progress = nullptr;
+  options->cancel_decoding = nullptr;
+  options->progress_user_data = nullptr;
+
+  return copy;
+}
+
+
+bool Track_Visual::use_decoding_pipeline() const
+{
+  return m_decoding_pipeline_depth > 1 && all_samples_are_sync_samples();
 }
 
 
+Error Track_Visual::fill_decoding_pipeline(const heif_decoding_options& options, uint64_t num_output_samples)
+{
+  // The pipeline may be behind when the track was switched to pipelined decoding in the middle of the sequence.
+  if (m_pipeline.empty()) {
+    m_next_sample_to_be_pipelined = m_next_sample_to_be_processed;
+  }
+
+  // The options may be released by the caller before the frame has been decoded.
+  std::shared_ptr<const PipelineDecodingOptions> pipeline_options = copy_decoding_options_for_pipeline(options);
+  const heif_security_limits* limits = m_heif_context->get_security_limits();
+
+  while (m_pipeline.size() < (size_t) m_decoding_pipeline_depth &&
+         m_next_sample_to_be_pipelined < num_output_samples) {
+    const auto& sampleTiming = m_presentation_timeline[m_next_sample_to_be_pipelined % m_presentation_timeline.size()];
+    const std::shared_ptr<Chunk>& chunk = m_chunks[sampleTiming.chunkIdx];
+
+    PipelinedFrame frame;
+    frame.sample_idx = sampleTiming.sampleIdx;
+    frame.sample_description = chunk->get_sample_description();
+
+    // --- get an idle decoder for this sample description or create a new one
+
+    auto& idle_decoders = m_idle_pipeline_decoders[frame.sample_description.get()];
+    if (!idle_decoders.empty()) {
+      frame.decoder = idle_decoders.back();
+      idle_decoders.pop_back();
+    }
+    else if (frame.sample_description) {
+      frame.decoder = Decoder::alloc_for_sequence_sample_description_box(frame.sample_description);
+    }
+
+    if (!frame.decoder) {
+      return {heif_error_Unsupported_feature,
+              heif_suberror_Unsupported_codec,
+              "Cannot create decoder for sequence sample"};
+    }
+
+    // --- read the sample data in this thread, because file access is not thread-safe
+
+    DataExtent extent = chunk->get_data_extent_for_sample(frame.sample_idx);
+    auto readResult = extent.read_data();
+    if (!readResult) {
+      return readResult.error();
+    }
+
+    DataExtent memoryExtent;
+    memoryExtent.m_raw = std::move(**readResult);
+    frame.decoder->set_data_extent(std::move(memoryExtent));
+
+    frame.image = std::async(std::launch::async,
+                             [decoder = frame.decoder, pipeline_options, limits]() {
+                               return decoder->decode_single_frame_from_compressed_data(*pipeline_options->options, limits);
+                             });
+
+    m_pipeline.push_back(std::move(frame));
+    m_next_sample_to_be_pipelined++;
+  }
+
+  if (m_pipeline.empty()) {
+    return {heif_error_End_of_sequence,
+            heif_suberror_Unspecified,
+            "End of sequence"};
+  }
+
+  return Error::Ok;
+}
+
+
+void Track_Visual::clear_decoding_pipeline()
+{
+  // Wait for the frames in flight and keep their decoders for later reuse.
+  for (auto& frame : m_pipeline) {
+    frame.image.wait();
+    m_idle_pipeline_decoders[frame.sample_description.get()].push_back(frame.decoder);
+  }
+
+  m_pipeline.clear();
+}
+
+#endif
+
+
 Error Track_Visual::encode_image(std::shared_ptr<HeifPixelImage> image,
                                  heif_encoder* h_encoder,
                                  const heif_encoding_options& in_options,
+                                 const heif_sequence_encoding_options& sequence_options,
                                  heif_image_input_class input_class)
 {
   if (image->get_width() > 0xFFFF ||
@@ -206,11 +451,25 @@ Error Track_Visual::encode_image(std::shared_ptr<HeifPixelImage> image,
 
   // generate new chunk for first image or when compression formats don't match
 
-  bool add_sample_description = false;
+  if (m_chunks.empty() ||
+      m_chunks.back()->get_compression_format() != h_encoder->plugin->compression_format ||
+      m_chunk_sequence_ended) {
+
+    if (!m_chunks.empty() &&
+        m_chunks.back()->get_encoder() &&
+        m_chunks.back()->get_encoder()->is_sequence_encoding_active()) {
+      return {heif_error_Usage_error,
+              heif_suberror_Unspecified,
+              "The sequence has to be ended with heif_track_encode_end_of_sequence() before changing the compression format."};
+    }
+
+    Error err = add_chunk(h_encoder->plugin->compression_format);
+    if (err) {
+      return err;
+    }
 
-  if (m_chunks.empty() || m_chunks.back()->get_compression_format() != h_encoder->plugin->compression_format) {
-    add_chunk(h_encoder->plugin->compression_format);
-    add_sample_description = true;
+    m_chunk_needs_sample_description = true;
+    m_chunk_sequence_ended = false;
   }
 
   // --- check whether we have to convert the image color space
@@ -236,7 +495,49 @@ Error Track_Visual::encode_image(std::shared_ptr<HeifPixelImage> image,
 
   std::shared_ptr<HeifPixelImage> colorConvertedImage = *srcImageResult;
 
-  // --- encode image
+  // --- encode image with inter-frame prediction
+
+  // Once a chunk has been started with intra-only frames, we keep coding it that way, because all frames
+  // of a chunk share the same sample description.
+  bool use_sequence_encoding = encoder->is_sequence_encoding_active() ||
+                               (last_chunk_empty() &&
+                                sequence_options.gop_structure != heif_sequence_gop_structure_intra_only &&
+                                Encoder::plugin_supports_sequence_encoding(h_encoder));
+
+  if (use_sequence_encoding) {
+    PendingSequenceFrame frame;
+    frame.frame_nr = m_next_sequence_frame_nr++;
+    frame.duration = colorConvertedImage->get_sample_duration();
+    if (const auto* tai = image->get_tai_timestamp()) {
+      frame.has_tai = true;
+      frame.tai = *tai;
+    }
+    if (image->has_gimi_sample_content_id()) {
+      frame.content_id = image->get_gimi_sample_content_id();
+    }
+    frame.width = static_cast<uint16_t>(colorConvertedImage->get_width());
+    frame.height = static_cast<uint16_t>(colorConvertedImage->get_height());
+
+    if (frame.duration == 0) {
+      return {heif_error_Usage_error,
+              heif_suberror_Unspecified,
+              "Sample duration may not be 0"};
+    }
+
+    m_pending_sequence_frames.push_back(frame);
+
+    // The frame rate is only a hint for the encoder rate control. We take it from the first frame.
+    Error err = encoder->encode_sequence_frame(colorConvertedImage, h_encoder, sequence_options, input_class,
+                                               get_timescale(), frame.duration,
+                                               frame.frame_nr);
+    if (err) {
+      return err;
+    }
+
+    return write_coded_sequence_frames(*encoder);
+  }
+
+  // --- encode image as independent intra frame
 
   Result<Encoder::CodedImageData> encodeResult = encoder->encode(colorConvertedImage, h_encoder, options, input_class);
   if (!encodeResult) {
@@ -245,36 +546,112 @@ Error Track_Visual::encode_image(std::shared_ptr<HeifPixelImage> image,
 
   const Encoder::CodedImageData& data = *encodeResult;
 
+  return write_coded_frame(*encoder, data,
+                           static_cast<uint16_t>(colorConvertedImage->get_width()),
+                           static_cast<uint16_t>(colorConvertedImage->get_height()),
+                           colorConvertedImage->get_sample_duration(),
+                           image->get_tai_timestamp(),
+                           image->has_gimi_sample_content_id() ? image->get_gimi_sample_content_id() : std::string{});
+}
 
+
+Error Track_Visual::write_coded_frame(const Encoder& encoder, const Encoder::CodedImageData& data,
+                                      uint16_t width, uint16_t height, uint32_t duration,
+                                      const heif_tai_timestamp_packet* tai, const std::string& content_id)
+{
   // --- generate SampleDescriptionBox
 
-  if (add_sample_description) {
-    auto sample_description_box = encoder->get_sample_description_box(data);
+  if (m_chunk_needs_sample_description) {
+    auto sample_description_box = encoder.get_sample_description_box(data);
     VisualSampleEntry& visualSampleEntry = sample_description_box->get_VisualSampleEntry();
-    visualSampleEntry.width = static_cast<uint16_t>(colorConvertedImage->get_width());
-    visualSampleEntry.height = static_cast<uint16_t>(colorConvertedImage->get_height());
+    visualSampleEntry.width = width;
+    visualSampleEntry.height = height;
 
     auto ccst = std::make_shared<Box_ccst>();
     ccst->set_coding_constraints(data.codingConstraints);
     sample_description_box->append_child_box(ccst);
 
     set_sample_description_box(sample_description_box);
+
+    m_chunk_needs_sample_description = false;
+  }
+
+  return write_sample_data(data.bitstream, duration, data.is_sync_frame, tai, content_id);
+}
+
+
+Error Track_Visual::write_coded_sequence_frames(Encoder& encoder)
+{
+  while (std::optional<Encoder::CodedImageData> data = encoder.get_next_coded_sequence_frame()) {
+    if (m_pending_sequence_frames.empty() ||
+        m_pending_sequence_frames.front().frame_nr != data->frame_nr) {
+      return {heif_error_Encoder_plugin_error,
+              heif_suberror_Unspecified,
+              "Encoder plugin returned frames in wrong order."};
+    }
+
+    PendingSequenceFrame frame = std::move(m_pending_sequence_frames.front());
+    m_pending_sequence_frames.pop_front();
+
+    Error err = write_coded_frame(encoder, *data, frame.width, frame.height, frame.duration,
+                                  frame.has_tai ? &frame.tai : nullptr,
+                                  frame.content_id);
+    if (err) {
+      return err;
+    }
   }
 
-  Error err = write_sample_data(data.bitstream,
-                                colorConvertedImage->get_sample_duration(),
-                                data.is_sync_frame,
-                                image->get_tai_timestamp(),
-                                image->has_gimi_sample_content_id() ? image->get_gimi_sample_content_id() : std::string{});
+  return Error::Ok;
+}
+
 
+Error Track_Visual::encode_end_of_sequence(heif_encoder* h_encoder)
+{
+  if (m_chunks.empty()) {
+    return Error::Ok;
+  }
+
+  auto encoder = m_chunks.back()->get_encoder();
+  if (!encoder || !encoder->is_sequence_encoding_active()) {
+    return Error::Ok;
+  }
+
+  Error err = encoder->encode_sequence_flush(h_encoder);
   if (err) {
     return err;
   }
 
+  err = write_coded_sequence_frames(*encoder);
+  if (err) {
+    return err;
+  }
+
+  if (!m_pending_sequence_frames.empty()) {
+    return {heif_error_Encoder_plugin_error,
+            heif_suberror_Unspecified,
+            "Encoder plugin did not return all frames."};
+  }
+
+  m_chunk_sequence_ended = true;
+
   return Error::Ok;
 }
 
 
+Error Track_Visual::finalize_track()
+{
+  // When writing fragments, the header is written while the encoder may still hold frames.
+  // These are checked in HeifContext::end_fragmented_writing().
+  if (!m_fragmented_writing && !m_pending_sequence_frames.empty()) {
+    return {heif_error_Usage_error,
+            heif_suberror_Unspecified,
+            "Frames are still buffered in the encoder. Call heif_track_encode_end_of_sequence() before writing the file."};
+  }
+
+  return Track::finalize_track();
+}
+
+
 heif_brand2 Track_Visual::get_compatible_brand() const
 {
   if (m_stsd->get_num_sample_entries() == 0) {
@@ -22,9 +22,16 @@
 #define LIBHEIF_TRACK_VISUAL_H
 
 #include "track.h"
+#include "codecs/encoder.h"
 #include <string>
 #include <memory>
 #include <vector>
+#include <map>
+#include <deque>
+
+#if ENABLE_MULTITHREADING_SUPPORT
+#include <future>
+#endif
 
 
 class Track_Visual : public Track {
@@ -48,11 +55,32 @@ public:
 
   Result<std::shared_ptr<HeifPixelImage>> decode_next_image_sample(const heif_decoding_options& options);
 
+  // Decoding restarts at the sync sample preceding the requested sample. The frames in between are decoded,
+  // but not returned.
+  Error seek_to_sample(uint64_t output_sample_idx) override;
+
+  // Number of frames that are decoded ahead in parallel. Values <= 1 switch off pipelining.
+  // Pipelining is only used for sequences that consist of sync samples only, because each frame
+  // in flight is decoded with a separate decoder instance.
+  void set_decoding_pipeline_depth(int depth);
+
+  int get_decoding_pipeline_depth() const { return m_decoding_pipeline_depth; }
+
+  // When the encoder plugin supports sequence encoding and the GOP structure is not intra-only, frames are
+  // coded with inter-frame prediction. The coded frames are then written with a delay (encoder lookahead)
+  // and encode_end_of_sequence() has to be called to write the remaining frames.
   Error encode_image(std::shared_ptr<HeifPixelImage> image,
                      heif_encoder* encoder,
                      const heif_encoding_options& options,
+                     const heif_sequence_encoding_options& sequence_options,
                      heif_image_input_class image_class);
 
+  Error encode_end_of_sequence(heif_encoder* encoder);
+
+  Error finalize_track() override;
+
+  bool has_buffered_samples() const override { return !m_pending_sequence_frames.empty(); }
+
   heif_brand2 get_compatible_brand() const;
 
 private:
@@ -61,6 +89,71 @@ private:
 
   // If there is an alpha-channel track associated with this color track, we reference it from here
   std::shared_ptr<Track_Visual> m_aux_alpha_track;
+
+  int m_decoding_pipeline_depth = 0;
+
+  // After seeking, the samples before this one are decoded (as references), but not returned.
+  uint64_t m_next_sample_to_be_output = 0;
+
+  Result<std::shared_ptr<HeifPixelImage>> decode_sample(uint32_t sample_idx, uint32_t chunk_idx,
+                                                        const heif_decoding_options& options);
+
+  Error add_sample_properties(const std::shared_ptr<HeifPixelImage>& image, uint32_t sample_idx,
+                              const heif_decoding_options& options);
+
+  // --- encoding
+
+  // The last chunk has no sample description yet. It is generated from the first coded frame of the chunk.
+  bool m_chunk_needs_sample_description = false;
+
+  // The sequence in the last chunk was ended. Further images are coded into a new chunk.
+  bool m_chunk_sequence_ended = false;
+
+  // Sample data of frames that are still in the encoder.
+  struct PendingSequenceFrame
+  {
+    uintptr_t frame_nr = 0;
+    uint32_t duration = 0;
+    bool has_tai = false;
+    heif_tai_timestamp_packet tai{};
+    std::string content_id;
+    uint16_t width = 0;
+    uint16_t height = 0;
+  };
+
+  std::deque<PendingSequenceFrame> m_pending_sequence_frames;
+  uintptr_t m_next_sequence_frame_nr = 0;
+
+  Error write_coded_frame(const Encoder& encoder, const Encoder::CodedImageData& data,
+                          uint16_t width, uint16_t height, uint32_t duration,
+                          const heif_tai_timestamp_packet* tai, const std::string& content_id);
+
+  Error write_coded_sequence_frames(Encoder& encoder);
+
+#if ENABLE_MULTITHREADING_SUPPORT
+  struct PipelinedFrame
+  {
+    uint32_t sample_idx = 0;
+    std::shared_ptr<const class Box_VisualSampleEntry> sample_description;
+    std::shared_ptr<class Decoder> decoder;
+    std::future<Result<std::shared_ptr<HeifPixelImage>>> image;
+  };
+
+  // Frames in flight, in presentation order.
+  std::deque<PipelinedFrame> m_pipeline;
+
+  // Index into the SampleTiming table of the next sample to be pushed into the pipeline.
+  uint64_t m_next_sample_to_be_pipelined = 0;
+
+  // Decoders that are not used by a frame in flight, per sample description.
+  std::map<const class Box_VisualSampleEntry*, std::vector<std::shared_ptr<class Decoder>>> m_idle_pipeline_decoders;
+
+  bool use_decoding_pipeline() const;
+
+  Error fill_decoding_pipeline(const heif_decoding_options& options, uint64_t num_output_samples);
+
+  void clear_decoding_pipeline();
+#endif
 };
 
 
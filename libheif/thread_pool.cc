@@ -0,0 +1,249 @@
+/*
+ * HEIF codec.
+ * Copyright (c) 2025 Dirk Farin <dirk.farin@gmail.com>
+ *
+ * This file is part of libheif.
+ *
+ * libheif is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * libheif is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libheif.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "thread_pool.h"
+#include <algorithm>
+
+
+static std::mutex& global_pool_mutex()
+{
+  static std::mutex mutex;
+  return mutex;
+}
+
+// Not a smart pointer: the pool must not be joined during static destruction (see ThreadPool::global()).
+static ThreadPool* global_pool = nullptr;
+static int global_num_threads = 0;
+
+static thread_local int running_task_depth = 0;
+
+
+static int resolve_num_threads(int num_threads)
+{
+  if (num_threads > 0) {
+    return num_threads;
+  }
+
+  return std::max(1, (int) std::thread::hardware_concurrency());
+}
+
+
+ThreadPool::ThreadPool(int num_threads)
+{
+#if ENABLE_MULTITHREADING_SUPPORT
+  for (int i = 0; i < num_threads; i++) {
+    m_threads.emplace_back(&ThreadPool::worker_main, this);
+  }
+#else
+  (void) num_threads;
+#endif
+}
+
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+
+  m_queue_cond.notify_all();
+
+  for (auto& thread : m_threads) {
+    thread.join();
+  }
+}
+
+
+ThreadPool& ThreadPool::global()
+{
+  std::lock_guard<std::mutex> lock(global_pool_mutex());
+
+  if (!global_pool) {
+    global_pool = new ThreadPool(resolve_num_threads(global_num_threads));
+  }
+
+  return *global_pool;
+}
+
+
+void ThreadPool::set_global_num_threads(int num_threads)
+{
+  ThreadPool* old_pool = nullptr;
+
+  {
+    std::lock_guard<std::mutex> lock(global_pool_mutex());
+
+    global_num_threads = num_threads;
+
+    if (global_pool && global_pool->get_num_threads() != resolve_num_threads(num_threads)) {
+      old_pool = global_pool;
+      global_pool = nullptr;
+    }
+  }
+
+  // the old pool finishes its queued tasks before the threads are joined
+  delete old_pool;
+}
+
+
+int ThreadPool::get_global_num_threads()
+{
+  std::lock_guard<std::mutex> lock(global_pool_mutex());
+  return global_num_threads;
+}
+
+
+void ThreadPool::release_global()
+{
+  ThreadPool* old_pool;
+
+  {
+    std::lock_guard<std::mutex> lock(global_pool_mutex());
+    old_pool = global_pool;
+    global_pool = nullptr;
+  }
+
+  delete old_pool;
+}
+
+
+bool ThreadPool::is_running_task()
+{
+  return running_task_depth > 0;
+}
+
+
+int ThreadPool::get_num_busy_threads() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_num_busy_threads;
+}
+
+
+size_t ThreadPool::get_num_queued_tasks() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return std::count_if(m_queue.begin(), m_queue.end(), [](const std::shared_ptr<Task>& task) { return !task->claimed; });
+}
+
+
+std::shared_ptr<ThreadPool::Task> ThreadPool::submit_task(std::function<void()> function)
+{
+  auto task = std::make_shared<Task>();
+  task->function = [function = std::move(function)]() {
+    running_task_depth++;
+    function();
+    running_task_depth--;
+  };
+
+  if (m_threads.empty()) {
+    task->run_if_not_claimed();
+    return task;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_queue.push_back(task);
+  }
+
+  m_queue_cond.notify_one();
+
+  return task;
+}
+
+
+void ThreadPool::worker_main()
+{
+  std::unique_lock<std::mutex> lock(m_mutex);
+
+  for (;;) {
+    m_queue_cond.wait(lock, [this]() { return m_stop || !m_queue.empty(); });
+
+    if (m_queue.empty()) {
+      return; // stopped
+    }
+
+    std::shared_ptr<Task> task = std::move(m_queue.front());
+    m_queue.pop_front();
+
+    // The task may have been run already by a thread that waited for it.
+    if (!task->claim()) {
+      continue;
+    }
+
+    m_num_busy_threads++;
+
+    lock.unlock();
+    task->function();
+    task.reset();
+    lock.lock();
+
+    m_num_busy_threads--;
+  }
+}
+
+
+void TaskGroup::submit(std::function<void()> task)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_num_pending++;
+  }
+
+  auto pool_task = m_pool.submit_task([this, task = std::move(task)]() {
+    task();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (--m_num_pending == 0) {
+      m_done_cond.notify_all();
+    }
+  });
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_tasks.push_back(std::move(pool_task));
+}
+
+
+void TaskGroup::wait()
+{
+  // Run the tasks of this group that have not been started yet on this thread.
+
+  for (;;) {
+    std::shared_ptr<ThreadPool::Task> task;
+
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (m_tasks.empty()) {
+        break;
+      }
+
+      task = std::move(m_tasks.front());
+      m_tasks.pop_front();
+    }
+
+    task->run_if_not_claimed();
+  }
+
+  // All remaining tasks of this group are running on other threads.
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_done_cond.wait(lock, [this]() { return m_num_pending == 0; });
+}
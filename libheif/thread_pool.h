@@ -0,0 +1,190 @@
+/*
+ * HEIF codec.
+ * Copyright (c) 2025 Dirk Farin <dirk.farin@gmail.com>
+ *
+ * This file is part of libheif.
+ *
+ * libheif is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * libheif is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libheif.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBHEIF_THREAD_POOL_H
+#define LIBHEIF_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+// Pool of worker threads that is shared by all contexts and by the codec plugins.
+//
+// A thread that waits for a task that has not been started yet runs this task itself (see wait()).
+// Hence, tasks may submit further tasks and wait for them without blocking the pool.
+// Waiting threads never run unrelated tasks.
+// Without ENABLE_MULTITHREADING_SUPPORT, the pool has no worker threads and each task runs
+// when it is submitted.
+class ThreadPool
+{
+  struct Task
+  {
+    std::function<void()> function;
+    std::atomic<bool> claimed{false};
+
+    // Returns true exactly once, for the thread that runs the task.
+    bool claim() { return !claimed.exchange(true); }
+
+    void run_if_not_claimed()
+    {
+      if (claim()) {
+        function();
+      }
+    }
+  };
+
+public:
+  explicit ThreadPool(int num_threads);
+
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  // The pool used by libheif. It is started on first use with the number of threads set with
+  // set_global_num_threads(), or with one thread per CPU core.
+  // It is stopped by heif_deinit(). If heif_deinit() is never called, the pool is intentionally not destroyed
+  // at static destruction, because joining threads while a DLL is being unloaded can deadlock on Windows.
+  static ThreadPool& global();
+
+  // 0 selects one thread per CPU core. A running global pool is restarted with the new size.
+  static void set_global_num_threads(int num_threads);
+
+  // The value set with set_global_num_threads(). 0 if the pool size was not configured.
+  static int get_global_num_threads();
+
+  // Stops the worker threads of the global pool. It is restarted when it is used again.
+  static void release_global();
+
+  // Whether the calling thread is currently running a task of any pool, either as a worker thread
+  // or while waiting for the task.
+  static bool is_running_task();
+
+  int get_num_threads() const { return (int) m_threads.size(); }
+
+  // Number of worker threads that are currently running a task.
+  int get_num_busy_threads() const;
+
+  // Number of tasks that have been submitted but not started yet.
+  size_t get_num_queued_tasks() const;
+
+
+  template<typename T>
+  class Future
+  {
+  public:
+    Future() = default;
+
+  private:
+    friend class ThreadPool;
+
+    std::future<T> m_future;
+    std::shared_ptr<Task> m_task;
+  };
+
+  void submit(std::function<void()> task) { submit_task(std::move(task)); }
+
+  template<typename F>
+  Future<std::invoke_result_t<F>> async(F&& f)
+  {
+    using R = std::invoke_result_t<F>;
+
+    auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(f));
+
+    Future<R> result;
+    result.m_future = task->get_future();
+    result.m_task = submit_task([task]() { (*task)(); });
+    return result;
+  }
+
+  // Waits until the task has finished. If it has not been started yet, it is run on the calling thread.
+  template<typename T>
+  void wait(Future<T>& f)
+  {
+    if (f.m_task) {
+      f.m_task->run_if_not_claimed();
+    }
+
+    f.m_future.wait();
+  }
+
+  template<typename T>
+  T get(Future<T>& f)
+  {
+    wait(f);
+    return f.m_future.get();
+  }
+
+private:
+  friend class TaskGroup;
+
+  std::vector<std::thread> m_threads;
+  std::deque<std::shared_ptr<Task>> m_queue;
+
+  mutable std::mutex m_mutex;
+  std::condition_variable m_queue_cond;
+  bool m_stop = false;
+  int m_num_busy_threads = 0;
+
+  std::shared_ptr<Task> submit_task(std::function<void()> function);
+
+  void worker_main();
+};
+
+
+// A set of tasks that can be waited for together.
+class TaskGroup
+{
+public:
+  explicit TaskGroup(ThreadPool& pool = ThreadPool::global()) : m_pool(pool) {}
+
+  ~TaskGroup() { wait(); }
+
+  TaskGroup(const TaskGroup&) = delete;
+
+  TaskGroup& operator=(const TaskGroup&) = delete;
+
+  void submit(std::function<void()> task);
+
+  // Waits until all submitted tasks have finished.
+  // The tasks of this group that have not been started yet are run on the calling thread.
+  void wait();
+
+private:
+  ThreadPool& m_pool;
+
+  std::mutex m_mutex;
+  std::condition_variable m_done_cond;
+  size_t m_num_pending = 0;
+  std::deque<std::shared_ptr<ThreadPool::Task>> m_tasks;
+};
+
+#endif
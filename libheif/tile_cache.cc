@@ -0,0 +1,180 @@
+/*
+ * HEIF codec.
+ * Copyright (c) 2025 Dirk Farin <dirk.farin@gmail.com>
+ *
+ * This file is part of libheif.
+ *
+ * libheif is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * libheif is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libheif.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tile_cache.h"
+#include "pixelimage.h"
+#include <tuple>
+
+
+bool DecodedTileCache::Key::operator<(const Key& b) const
+{
+  return std::tie(item_id, tile_x, tile_y, colorspace, chroma, options, decoder_id) <
+         std::tie(b.item_id, b.tile_x, b.tile_y, b.colorspace, b.chroma, b.options, b.decoder_id);
+}
+
+
+DecodedTileCache::Key DecodedTileCache::make_key(heif_item_id item_id, uint32_t tile_x, uint32_t tile_y,
+                                                 heif_colorspace colorspace, heif_chroma chroma,
+                                                 const heif_decoding_options& options)
+{
+  Key key;
+  key.item_id = item_id;
+  key.tile_x = tile_x;
+  key.tile_y = tile_y;
+  key.colorspace = colorspace;
+  key.chroma = chroma;
+
+  std::vector<int>& o = key.options;
+  o.push_back(options.ignore_transformations);
+  o.push_back(options.convert_hdr_to_8bit);
+  o.push_back(options.strict_decoding);
+  o.push_back(options.color_conversion_options.preferred_chroma_downsampling_algorithm);
+  o.push_back(options.color_conversion_options.preferred_chroma_upsampling_algorithm);
+  o.push_back(options.color_conversion_options.only_use_preferred_chroma_algorithm);
+
+  if (const auto* ext = options.color_conversion_options_ext) {
+    o.push_back(1);
+    o.push_back(ext->alpha_composition_mode);
+    o.push_back(ext->background_red);
+    o.push_back(ext->background_green);
+    o.push_back(ext->background_blue);
+    o.push_back(ext->secondary_background_red);
+    o.push_back(ext->secondary_background_green);
+    o.push_back(ext->secondary_background_blue);
+    o.push_back(ext->checkerboard_square_size);
+    o.push_back(ext->version >= 2 ? ext->bit_depth_reduction_mode : heif_bit_depth_reduction_mode_truncate);
+  }
+  else {
+    o.push_back(0);
+  }
+
+  if (const auto* nclx = options.output_image_nclx_profile) {
+    o.push_back(1);
+    o.push_back(nclx->color_primaries);
+    o.push_back(nclx->transfer_characteristics);
+    o.push_back(nclx->matrix_coefficients);
+    o.push_back(nclx->full_range_flag);
+  }
+  else {
+    o.push_back(0);
+  }
+
+  if (options.decoder_id) {
+    key.decoder_id = options.decoder_id;
+  }
+
+  return key;
+}
+
+
+void DecodedTileCache::set_max_size(size_t max_bytes)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  m_max_size = max_bytes;
+  evict_to_size(m_max_size);
+}
+
+
+size_t DecodedTileCache::get_max_size() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_max_size;
+}
+
+
+std::shared_ptr<const HeifPixelImage> DecodedTileCache::get(const Key& key)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  if (m_max_size == 0) {
+    return nullptr;
+  }
+
+  auto iter = m_index.find(key);
+  if (iter == m_index.end()) {
+    m_misses++;
+    return nullptr;
+  }
+
+  m_hits++;
+  m_entries.splice(m_entries.begin(), m_entries, iter->second);
+
+  return iter->second->image;
+}
+
+
+void DecodedTileCache::put(const Key& key, const std::shared_ptr<const HeifPixelImage>& image)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  size_t size = image->get_memory_size();
+  if (size > m_max_size) {
+    return;
+  }
+
+  auto iter = m_index.find(key);
+  if (iter != m_index.end()) {
+    // another thread decoded the same tile concurrently
+    m_entries.splice(m_entries.begin(), m_entries, iter->second);
+    return;
+  }
+
+  evict_to_size(m_max_size - size);
+
+  m_entries.push_front(Entry{key, image, size});
+  m_index[key] = m_entries.begin();
+  m_size += size;
+}
+
+
+bool DecodedTileCache::clear()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  bool released = !m_entries.empty();
+  evict_to_size(0);
+
+  return released;
+}
+
+
+void DecodedTileCache::get_statistics(heif_tile_cache_statistics* stats) const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  stats->hits = m_hits;
+  stats->misses = m_misses;
+  stats->evictions = m_evictions;
+  stats->cached_bytes = m_size;
+  stats->cached_tiles = (uint32_t) m_entries.size();
+}
+
+
+void DecodedTileCache::evict_to_size(size_t max_size)
+{
+  while (m_size > max_size) {
+    const Entry& entry = m_entries.back();
+    m_size -= entry.size;
+    m_index.erase(entry.key);
+    m_entries.pop_back();
+    m_evictions++;
+  }
+}
@@ -0,0 +1,98 @@
+/*
+ * HEIF codec.
+ * Copyright (c) 2025 Dirk Farin <dirk.farin@gmail.com>
+ *
+ * This file is part of libheif.
+ *
+ * libheif is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * libheif is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libheif.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBHEIF_TILE_CACHE_H
+#define LIBHEIF_TILE_CACHE_H
+
+#include "libheif/heif.h"
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class HeifPixelImage;
+
+
+// LRU cache of decoded and color-converted tiles, bounded by the number of bytes of the cached image planes.
+// The tile images stay allocated in the memory accounting of the owning context.
+class DecodedTileCache
+{
+public:
+  struct Key
+  {
+    heif_item_id item_id = 0;
+    uint32_t tile_x = 0, tile_y = 0;
+
+    heif_colorspace colorspace = heif_colorspace_undefined;
+    heif_chroma chroma = heif_chroma_undefined;
+
+    // All decoding options that influence the output image.
+    std::vector<int> options;
+    std::string decoder_id;
+
+    bool operator<(const Key&) const;
+  };
+
+  static Key make_key(heif_item_id item_id, uint32_t tile_x, uint32_t tile_y,
+                      heif_colorspace colorspace, heif_chroma chroma,
+                      const heif_decoding_options& options);
+
+  // A size of 0 disables the cache and releases all cached tiles.
+  void set_max_size(size_t max_bytes);
+
+  size_t get_max_size() const;
+
+  std::shared_ptr<const HeifPixelImage> get(const Key& key);
+
+  void put(const Key& key, const std::shared_ptr<const HeifPixelImage>& image);
+
+  // Returns whether any tile has been released.
+  bool clear();
+
+  void get_statistics(heif_tile_cache_statistics* stats) const;
+
+private:
+  struct Entry
+  {
+    Key key;
+    std::shared_ptr<const HeifPixelImage> image;
+    size_t size;
+  };
+
+  mutable std::mutex m_mutex;
+
+  size_t m_max_size = 0;
+  size_t m_size = 0;
+
+  // most recently used first
+  std::list<Entry> m_entries;
+  std::map<Key, std::list<Entry>::iterator> m_index;
+
+  uint64_t m_hits = 0;
+  uint64_t m_misses = 0;
+  uint64_t m_evictions = 0;
+
+  void evict_to_size(size_t max_size);
+};
+
+#endif
@@ -0,0 +1,197 @@
+/*
+ * HEIF codec.
+ * Copyright (c) 2025 Dirk Farin <dirk.farin@gmail.com>
+ *
+ * This file is part of libheif.
+ *
+ * libheif is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * libheif is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libheif.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "trace.h"
+#include <algorithm>
+
+
+using trace_clock = std::chrono::steady_clock;
+
+// Per-thread state of the active trace. 'stage_start' is the time at which the current stage
+// was entered or resumed; the time since then is charged to 'stage' on the next stage switch.
+static thread_local OperationTrace* tl_trace = nullptr;
+static thread_local TraceStage tl_stage = TraceStage::other;
+static thread_local trace_clock::time_point tl_stage_start;
+
+
+static void charge_current_stage(trace_clock::time_point now)
+{
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - tl_stage_start).count();
+  tl_trace->add_stage_time(tl_stage, ns);
+  tl_stage_start = now;
+}
+
+
+void OperationTrace::add_conversion_pipeline(const std::string& pipeline)
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  if (std::find(m_conversion_pipelines.begin(), m_conversion_pipelines.end(), pipeline) == m_conversion_pipelines.end()) {
+    m_conversion_pipelines.push_back(pipeline);
+  }
+}
+
+
+void OperationTrace::fill_record(heif_trace_record& record, std::string& pipeline_storage) const
+{
+  auto stage_ns = [this](TraceStage stage) {
+    return (uint64_t) std::max<int64_t>(0, m_stage_ns[(int) stage].load(std::memory_order_relaxed));
+  };
+
+  record.io_ns = stage_ns(TraceStage::io);
+  record.codec_ns = stage_ns(TraceStage::codec);
+  record.color_conversion_ns = stage_ns(TraceStage::color_conversion);
+  record.transform_ns = stage_ns(TraceStage::transform);
+  record.alpha_ns = stage_ns(TraceStage::alpha);
+  record.other_ns = stage_ns(TraceStage::other);
+
+  record.bytes_read = m_bytes_read.load(std::memory_order_relaxed);
+  record.num_allocations = m_num_allocations.load(std::memory_order_relaxed);
+  record.bytes_allocated = m_bytes_allocated.load(std::memory_order_relaxed);
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  pipeline_storage.clear();
+  for (const auto& pipeline : m_conversion_pipelines) {
+    if (!pipeline_storage.empty()) {
+      pipeline_storage += '\n';
+    }
+    pipeline_storage += pipeline;
+  }
+
+  record.color_conversion_pipeline = pipeline_storage.c_str();
+}
+
+
+OperationTrace* current_trace()
+{
+  return tl_trace;
+}
+
+
+TraceScope::TraceScope(TraceStage stage)
+{
+  m_active = (tl_trace != nullptr);
+  if (!m_active) {
+    return;
+  }
+
+  charge_current_stage(trace_clock::now());
+
+  m_previous_stage = tl_stage;
+  tl_stage = stage;
+}
+
+
+TraceScope::~TraceScope()
+{
+  if (!m_active) {
+    return;
+  }
+
+  charge_current_stage(trace_clock::now());
+
+  tl_stage = m_previous_stage;
+}
+
+
+TraceBinding::TraceBinding(OperationTrace* trace)
+    : m_previous_trace(tl_trace),
+      m_previous_stage(tl_stage),
+      m_previous_start(tl_stage_start)
+{
+  tl_trace = trace;
+  tl_stage = TraceStage::other;
+  tl_stage_start = trace_clock::now();
+}
+
+
+TraceBinding::~TraceBinding()
+{
+  if (tl_trace) {
+    charge_current_stage(trace_clock::now());
+  }
+
+  tl_trace = m_previous_trace;
+  tl_stage = m_previous_stage;
+  tl_stage_start = m_previous_start;
+}
+
+
+OperationTraceScope::OperationTraceScope(heif_trace_callback callback, void* userdata,
+                                         heif_trace_operation operation, uint32_t item_id)
+    : m_operation(operation),
+      m_item_id(item_id)
+{
+  if (callback == nullptr || tl_trace != nullptr) {
+    return;
+  }
+
+  m_callback = callback;
+  m_userdata = userdata;
+  m_start = trace_clock::now();
+  m_binding.emplace(&m_trace);
+}
+
+
+OperationTraceScope::~OperationTraceScope()
+{
+  if (!m_callback) {
+    return;
+  }
+
+  // unbind first so that the remaining time of the calling thread is accounted for
+  m_binding.reset();
+
+  heif_trace_record record{};
+  record.version = 1;
+  record.operation = m_operation;
+  record.item_id = m_item_id;
+  record.total_ns = (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(trace_clock::now() - m_start).count();
+
+  std::string pipeline_storage;
+  m_trace.fill_record(record, pipeline_storage);
+
+  m_callback(&record, m_userdata);
+}
+
+
+void trace_bytes_read(uint64_t n)
+{
+  if (tl_trace) {
+    tl_trace->add_bytes_read(n);
+  }
+}
+
+
+void trace_allocation(uint64_t bytes)
+{
+  if (tl_trace) {
+    tl_trace->add_allocation(bytes);
+  }
+}
+
+
+void trace_conversion_pipeline(const std::string& pipeline)
+{
+  if (tl_trace) {
+    tl_trace->add_conversion_pipeline(pipeline);
+  }
+}
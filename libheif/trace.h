@@ -0,0 +1,164 @@
+/*
+ * HEIF codec.
+ * Copyright (c) 2025 Dirk Farin <dirk.farin@gmail.com>
+ *
+ * This file is part of libheif.
+ *
+ * libheif is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * libheif is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with libheif.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIBHEIF_TRACE_H
+#define LIBHEIF_TRACE_H
+
+#include "libheif/heif_tracing.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+
+// Per-operation instrumentation for heif_context_set_trace_callback().
+//
+// An OperationTrace collects the time spent in each processing stage of one decode or encode call.
+// The trace is bound to the calling thread with a thread_local pointer. Worker threads that
+// take part in the operation (grid tiles, overlay layers, ...) have to bind it themselves with
+// a TraceBinding. When no trace is bound, all instrumentation points reduce to a single
+// thread_local load and compare.
+
+enum class TraceStage : int
+{
+  other = 0,
+  io,
+  codec,
+  color_conversion,
+  transform,
+  alpha,
+  num_stages
+};
+
+
+class OperationTrace
+{
+public:
+  void add_stage_time(TraceStage stage, int64_t ns)
+  {
+    m_stage_ns[(int) stage].fetch_add(ns, std::memory_order_relaxed);
+  }
+
+  void add_bytes_read(uint64_t n) { m_bytes_read.fetch_add(n, std::memory_order_relaxed); }
+
+  void add_allocation(uint64_t bytes)
+  {
+    m_num_allocations.fetch_add(1, std::memory_order_relaxed);
+    m_bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+  }
+
+  // Remembers each distinct pipeline description once, in the order of first use.
+  void add_conversion_pipeline(const std::string& pipeline);
+
+  void fill_record(heif_trace_record& record, std::string& pipeline_storage) const;
+
+private:
+  std::atomic<int64_t> m_stage_ns[(int) TraceStage::num_stages]{};
+  std::atomic<uint64_t> m_bytes_read{0};
+  std::atomic<uint64_t> m_num_allocations{0};
+  std::atomic<uint64_t> m_bytes_allocated{0};
+
+  mutable std::mutex m_mutex;
+  std::vector<std::string> m_conversion_pipelines;
+};
+
+
+OperationTrace* current_trace();
+
+
+// Charges the time spent inside the scope to 'stage'. Scopes nest exclusively: while an inner
+// scope is active, its time is not counted for the enclosing stage.
+class TraceScope
+{
+public:
+  explicit TraceScope(TraceStage stage);
+
+  ~TraceScope();
+
+  TraceScope(const TraceScope&) = delete;
+
+  TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+  bool m_active;
+  TraceStage m_previous_stage = TraceStage::other;
+};
+
+
+// Binds a trace to the current thread for the lifetime of the object.
+// Used to attach worker threads to the operation that spawned them.
+class TraceBinding
+{
+public:
+  explicit TraceBinding(OperationTrace* trace);
+
+  ~TraceBinding();
+
+  TraceBinding(const TraceBinding&) = delete;
+
+  TraceBinding& operator=(const TraceBinding&) = delete;
+
+private:
+  OperationTrace* m_previous_trace;
+  TraceStage m_previous_stage;
+  std::chrono::steady_clock::time_point m_previous_start;
+};
+
+
+// Top-level scope for one API call. Does nothing if 'callback' is NULL or if another
+// operation is already traced on this thread (e.g. the alpha image of an encode).
+class OperationTraceScope
+{
+public:
+  OperationTraceScope(heif_trace_callback callback, void* userdata,
+                      heif_trace_operation operation, uint32_t item_id);
+
+  ~OperationTraceScope();
+
+  // For encoding, the item ID is only known after the item has been created.
+  void set_item_id(uint32_t id) { m_item_id = id; }
+
+  OperationTraceScope(const OperationTraceScope&) = delete;
+
+  OperationTraceScope& operator=(const OperationTraceScope&) = delete;
+
+private:
+  heif_trace_callback m_callback = nullptr;
+  void* m_userdata = nullptr;
+  heif_trace_operation m_operation;
+  uint32_t m_item_id;
+
+  OperationTrace m_trace;
+  std::chrono::steady_clock::time_point m_start;
+  std::optional<TraceBinding> m_binding;
+};
+
+
+void trace_bytes_read(uint64_t n);
+
+void trace_allocation(uint64_t bytes);
+
+void trace_conversion_pipeline(const std::string& pipeline);
+
+#endif
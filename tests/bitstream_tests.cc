@@ -29,6 +29,7 @@
 #include <cstdint>
 #include <iostream>
 #include <memory>
+#include <sstream>
 #include <bitstream.h>
 
 
@@ -84,3 +85,54 @@ TEST_CASE("read float") {
   float f = uut.read_float32();
   REQUIRE(f == 2.0);
 }
+
+
+static void check_range_reads(const std::shared_ptr<StreamReader>& reader, uint64_t start)
+{
+  BitstreamRange outer(reader, start, start + 16);
+  REQUIRE(outer.read8() == 0x01);
+  REQUIRE(outer.read16() == 0x0203);
+  REQUIRE(outer.read24() == 0x040506);
+
+  BitstreamRange inner(reader, 6, &outer);
+  REQUIRE(inner.read32() == 0x0708090a);
+  REQUIRE(inner.read_string() == "A");
+  REQUIRE(inner.eof());
+  REQUIRE(outer.get_remaining_bytes() == 4);
+
+  // reading beyond the end of the inner range fails without consuming data of the outer range
+  REQUIRE(inner.read8() == 0);
+  REQUIRE(inner.error());
+  REQUIRE(outer.get_remaining_bytes() == 4);
+
+  REQUIRE(reader->get_position() == start + 12);
+
+  uint8_t buf[4];
+  REQUIRE(outer.read(buf, 4));
+  REQUIRE(buf[0] == 0xf0);
+  REQUIRE(buf[3] == 0xf3);
+  REQUIRE(outer.eof());
+  REQUIRE_FALSE(outer.error());
+}
+
+TEST_CASE("read ranges from memory and stream") {
+  std::vector<uint8_t> box{0x01, 0x02, 0x03, 0x04, 0x05, 0x06,
+                           0x07, 0x08, 0x09, 0x0a, 'A', 0x00,
+                           0xf0, 0xf1, 0xf2, 0xf3};
+
+  auto memory_reader = std::make_shared<StreamReader_memory>(box.data(), box.size(), false);
+  check_range_reads(memory_reader, 0);
+
+  std::string file_data(100, 'x');
+  file_data.append((const char*) box.data(), box.size());
+  auto istream_reader = std::make_shared<StreamReader_istream>(std::make_unique<std::istringstream>(file_data));
+  check_range_reads(istream_reader, 100);
+
+  // box data held in memory, but addressed with its file position
+
+  auto offset_reader = std::make_shared<StreamReader_memory>(box.data(), box.size(), false, 100);
+  check_range_reads(offset_reader, 100);
+  REQUIRE(offset_reader->request_range(0, 1000) == 116);
+  REQUIRE_FALSE(offset_reader->seek(99));
+  REQUIRE(offset_reader->seek(116));
+}
@@ -27,6 +27,11 @@
 #include <iomanip>
 #include "catch_amalgamated.hpp"
 #include "color-conversion/colorconversion.h"
+#include "color-conversion/chroma_sampling.h"
+#include "color-conversion/hdr_sdr.h"
+#include "color-conversion/rgb2rgb.h"
+#include "color-conversion/simd.h"
+#include "color-conversion/yuv2rgb.h"
 #include "pixelimage.h"
 #include <cmath>
 
@@ -697,6 +702,61 @@ TEST_CASE("Bilinear upsampling", "[heif_image]")
                });
 }
 
+
+TEST_CASE("Bilinear upsampling borders", "[heif_image]")
+{
+  heif_color_conversion_options options = {
+      .preferred_chroma_upsampling_algorithm = heif_chroma_upsampling_bilinear,
+      .only_use_preferred_chroma_algorithm = true};
+
+  // With 4x4 chroma samples, the border rows and columns use more than the first two chroma samples.
+  std::shared_ptr<HeifPixelImage> img = std::make_shared<HeifPixelImage>();
+  img->create(8, 8, heif_colorspace_YCbCr, heif_chroma_420);
+
+  auto error = img->fill_new_plane(heif_channel_Y, 128, 8, 8, 8, nullptr);
+  REQUIRE(!error);
+
+  fill_plane(img, heif_channel_Cb, 4, 4,
+             {10, 40, 200, 60,
+              100, 240, 30, 180,
+              0, 120, 250, 90,
+              220, 70, 150, 20});
+  fill_plane(img, heif_channel_Cr, 4, 4,
+             {255, 200, 20, 140,
+              50, 0, 170, 80,
+              130, 230, 10, 60,
+              40, 190, 100, 245});
+
+  auto conversionResult = convert_colorspace(img, heif_colorspace_YCbCr, heif_chroma_444,
+                                             nclx_profile::defaults(), 8, options, nullptr, heif_get_disabled_security_limits());
+  REQUIRE(conversionResult);
+  std::shared_ptr<HeifPixelImage> out = *conversionResult;
+
+  assert_plane(out, heif_channel_Cb,
+               {
+                   10, 18, 33, 80, 160, 165, 95, 60,
+                   33, 47, 76, 107, 141, 141, 107, 90,
+                   78, 106, 162, 161, 102, 92, 131, 150,
+                   75, 109, 176, 179, 116, 103, 139, 158,
+                   25, 56, 119, 161, 184, 174, 133, 113,
+                   55, 68, 94, 137, 196, 187, 111, 73,
+                   165, 144, 103, 106, 152, 141, 72, 38,
+                   220, 183, 108, 90, 130, 118, 53, 20
+               });
+
+  assert_plane(out, heif_channel_Cr,
+               {
+                   255, 241, 214, 155, 65, 50, 110, 140,
+                   204, 190, 163, 127, 81, 74, 108, 125,
+                   101, 88, 63, 71, 112, 123, 104, 95,
+                   70, 67, 61, 76, 112, 116, 89, 75,
+                   110, 126, 157, 142, 81, 54, 61, 65,
+                   108, 136, 192, 173, 79, 51, 88, 106,
+                   63, 97, 166, 169, 108, 108, 168, 199,
+                   40, 78, 153, 168, 123, 136, 209, 245
+               });
+}
+
 TEST_CASE("RGB 5-6-5 to RGB")
 {
   heif_color_conversion_options options = {};
@@ -737,3 +797,434 @@ TEST_CASE("RGB 5-6-5 to RGB")
   assert_plane(out, heif_channel_G, {28, 32, 36, 40, 44, 48});
   assert_plane(out, heif_channel_B, {107, 115, 123, 132, 140, 148});
 }
+
+
+TEST_CASE("Alpha composition")
+{
+  heif_color_conversion_options options = {};
+
+  heif_color_conversion_options_ext options_ext{};
+  options_ext.version = 1;
+  options_ext.alpha_composition_mode = heif_alpha_composition_mode_solid_color;
+  options_ext.background_red = options_ext.background_green = options_ext.background_blue = 0xFFFF;
+  options_ext.secondary_background_red = options_ext.secondary_background_green = options_ext.secondary_background_blue = 0;
+  options_ext.checkerboard_square_size = 1;
+
+  // --- planar RGB with alpha plane
+
+  std::shared_ptr<HeifPixelImage> img = std::make_shared<HeifPixelImage>();
+  img->create(4, 2, heif_colorspace_RGB, heif_chroma_444);
+  for (heif_channel channel : {heif_channel_R, heif_channel_G, heif_channel_B}) {
+    fill_plane(img, channel, 4, 2, {200, 200, 200, 200,
+                                    10, 10, 10, 10});
+  }
+  fill_plane(img, heif_channel_Alpha, 4, 2, {255, 0, 128, 64,
+                                             255, 0, 128, 64});
+
+  auto conversionResult = convert_colorspace(img, heif_colorspace_RGB, heif_chroma_444,
+                                             nclx_profile::undefined(), 8, options, &options_ext, heif_get_disabled_security_limits());
+  REQUIRE(conversionResult);
+  std::shared_ptr<HeifPixelImage> out = *conversionResult;
+  REQUIRE(!out->has_channel(heif_channel_Alpha));
+
+  assert_plane(out, heif_channel_R, {200, 255, 227, 241,
+                                     10, 255, 132, 193});
+
+  options_ext.alpha_composition_mode = heif_alpha_composition_mode_checkerboard;
+
+  conversionResult = convert_colorspace(img, heif_colorspace_RGB, heif_chroma_444,
+                                        nclx_profile::undefined(), 8, options, &options_ext, heif_get_disabled_security_limits());
+  REQUIRE(conversionResult);
+  out = *conversionResult;
+
+  assert_plane(out, heif_channel_G, {200, 255, 100, 241,
+                                     10, 0, 132, 2});
+
+  // --- interleaved RGBA
+
+  options_ext.alpha_composition_mode = heif_alpha_composition_mode_solid_color;
+
+  img = std::make_shared<HeifPixelImage>();
+  img->create(1, 1, heif_colorspace_RGB, heif_chroma_interleaved_RGBA);
+  auto error = img->add_plane(heif_channel_interleaved, 1, 1, 8, nullptr);
+  REQUIRE(!error);
+
+  size_t stride;
+  uint8_t* p = img->get_plane(heif_channel_interleaved, &stride);
+  p[0] = 200;
+  p[1] = 100;
+  p[2] = 0;
+  p[3] = 128;
+
+  for (bool premultiplied : {false, true}) {
+    img->set_premultiplied_alpha(premultiplied);
+
+    conversionResult = convert_colorspace(img, heif_colorspace_RGB, heif_chroma_interleaved_RGB,
+                                          nclx_profile::undefined(), 8, options, &options_ext, heif_get_disabled_security_limits());
+    REQUIRE(conversionResult);
+    out = *conversionResult;
+
+    const uint8_t* q = out->get_plane(heif_channel_interleaved, &stride);
+    if (premultiplied) {
+      REQUIRE((int) q[0] == 255); // clipped
+      REQUIRE((int) q[1] == 227);
+      REQUIRE((int) q[2] == 127);
+    }
+    else {
+      REQUIRE((int) q[0] == 227);
+      REQUIRE((int) q[1] == 177);
+      REQUIRE((int) q[2] == 127);
+    }
+  }
+}
+
+
+// Creates an image with pseudo-random samples in the value range of each plane's bit depth.
+static std::shared_ptr<HeifPixelImage> create_random_image(uint32_t w, uint32_t h, heif_colorspace colorspace, heif_chroma chroma,
+                                                           const std::vector<heif_channel>& channels, int bpp)
+{
+  auto img = std::make_shared<HeifPixelImage>();
+  img->create(w, h, colorspace, chroma);
+
+  uint32_t state = 12345;
+
+  for (heif_channel channel : channels) {
+    REQUIRE(!img->add_plane(channel, w, h, bpp, heif_get_disabled_security_limits()));
+
+    size_t stride;
+    uint8_t* p = img->get_plane(channel, &stride);
+    uint32_t row_bytes = (img->get_width(channel) * img->get_storage_bits_per_pixel(channel) + 7) / 8;
+
+    for (uint32_t y = 0; y < img->get_height(channel); y++) {
+      for (uint32_t x = 0; x < row_bytes; x++) {
+        state = state * 1103515245 + 12345;
+        p[y * stride + x] = (uint8_t) (state >> 16);
+      }
+
+      if (bpp > 8 && bpp < 16 && chroma != heif_chroma_interleaved_RRGGBB_BE && chroma != heif_chroma_interleaved_RRGGBBAA_BE) {
+        auto* p16 = (uint16_t*) (p + y * stride);
+        for (uint32_t x = 0; x < row_bytes / 2; x++) {
+          p16[x] &= (uint16_t) ((1 << bpp) - 1);
+        }
+      }
+    }
+  }
+
+  return img;
+}
+
+
+static void require_identical_images(const std::shared_ptr<HeifPixelImage>& a, const std::shared_ptr<HeifPixelImage>& b)
+{
+  REQUIRE(a->get_chroma_format() == b->get_chroma_format());
+
+  for (heif_channel channel : {heif_channel_Y, heif_channel_Cb, heif_channel_Cr, heif_channel_R, heif_channel_G,
+                               heif_channel_B, heif_channel_Alpha, heif_channel_interleaved}) {
+    REQUIRE(a->has_channel(channel) == b->has_channel(channel));
+    if (!a->has_channel(channel)) {
+      continue;
+    }
+
+    INFO("channel: " << channel);
+    REQUIRE(a->get_bits_per_pixel(channel) == b->get_bits_per_pixel(channel));
+
+    size_t stride_a, stride_b;
+    const uint8_t* pa = a->get_plane(channel, &stride_a);
+    const uint8_t* pb = b->get_plane(channel, &stride_b);
+    uint32_t row_bytes = (a->get_width(channel) * a->get_storage_bits_per_pixel(channel) + 7) / 8;
+
+    for (uint32_t y = 0; y < a->get_height(channel); y++) {
+      INFO("row: " << y);
+      REQUIRE(memcmp(pa + y * stride_a, pb + y * stride_b, row_bytes) == 0);
+    }
+  }
+}
+
+
+static void require_same_output(const ColorConversionOperation& scalar_op, const ColorConversionOperation& simd_op,
+                                const std::shared_ptr<HeifPixelImage>& input,
+                                const ColorState& input_state, const ColorState& target_state,
+                                const heif_color_conversion_options_ext& options_ext)
+{
+  heif_color_conversion_options options{};
+  heif_color_conversion_options_set_defaults(&options);
+
+  REQUIRE(!scalar_op.state_after_conversion(input_state, target_state, options, options_ext).empty());
+  REQUIRE(!simd_op.state_after_conversion(input_state, target_state, options, options_ext).empty());
+
+  auto scalar_result = scalar_op.convert_colorspace(input, input_state, target_state, options, options_ext, heif_get_disabled_security_limits());
+  auto simd_result = simd_op.convert_colorspace(input, input_state, target_state, options, options_ext, heif_get_disabled_security_limits());
+  REQUIRE(scalar_result);
+  REQUIRE(simd_result);
+
+  require_identical_images(*scalar_result, *simd_result);
+}
+
+
+TEST_CASE("SIMD bit depth and endianness conversions")
+{
+  if (!simd::available()) {
+    SKIP("no SIMD support on this platform");
+  }
+
+  std::unique_ptr<heif_color_conversion_options_ext, void (*)(heif_color_conversion_options_ext*)>
+      options_ext(heif_color_conversion_options_ext_alloc(), heif_color_conversion_options_ext_free);
+
+  // odd sizes, such that the scalar code for the end of the rows is also used
+  const uint32_t w = 45, h = 5;
+
+  const std::vector<heif_channel> rgba = {heif_channel_R, heif_channel_G, heif_channel_B, heif_channel_Alpha};
+  const std::vector<heif_channel> rgb = {heif_channel_R, heif_channel_G, heif_channel_B};
+
+  SECTION("to SDR") {
+    for (int bpp : {9, 10, 12, 16}) {
+      for (auto mode : {heif_bit_depth_reduction_mode_truncate,
+                        heif_bit_depth_reduction_mode_round,
+                        heif_bit_depth_reduction_mode_dither}) {
+        INFO("bpp: " << bpp << " mode: " << mode);
+        options_ext->bit_depth_reduction_mode = mode;
+
+        auto img = create_random_image(w, h, heif_colorspace_RGB, heif_chroma_444, rgba, bpp);
+        require_same_output(Op_to_sdr_planes(), Op_to_sdr_planes_simd(), img,
+                            ColorState(heif_colorspace_RGB, heif_chroma_444, true, bpp),
+                            ColorState(heif_colorspace_RGB, heif_chroma_444, true, 8), *options_ext);
+      }
+    }
+  }
+
+  SECTION("to HDR") {
+    for (int bpp : {10, 12, 16}) {
+      INFO("bpp: " << bpp);
+      auto img = create_random_image(w, h, heif_colorspace_RGB, heif_chroma_444, rgba, 8);
+      require_same_output(Op_to_hdr_planes(), Op_to_hdr_planes_simd(), img,
+                          ColorState(heif_colorspace_RGB, heif_chroma_444, true, 8),
+                          ColorState(heif_colorspace_RGB, heif_chroma_444, true, bpp), *options_ext);
+    }
+  }
+
+  SECTION("planar HDR to RRGGBB(AA)_BE") {
+    for (bool input_alpha : {false, true}) {
+      for (bool output_alpha : {false, true}) {
+        if (input_alpha && !output_alpha) {
+          continue;
+        }
+
+        INFO("input alpha: " << input_alpha << " output alpha: " << output_alpha);
+        auto img = create_random_image(w, h, heif_colorspace_RGB, heif_chroma_444, input_alpha ? rgba : rgb, 10);
+        heif_chroma out_chroma = output_alpha ? heif_chroma_interleaved_RRGGBBAA_BE : heif_chroma_interleaved_RRGGBB_BE;
+        require_same_output(Op_RGB_HDR_to_RRGGBBaa_BE(), Op_RGB_HDR_to_RRGGBBaa_BE_simd(), img,
+                            ColorState(heif_colorspace_RGB, heif_chroma_444, input_alpha, 10),
+                            ColorState(heif_colorspace_RGB, out_chroma, output_alpha, 10), *options_ext);
+      }
+    }
+  }
+
+  SECTION("swap endianness") {
+    for (heif_chroma chroma : {heif_chroma_interleaved_RRGGBB_LE, heif_chroma_interleaved_RRGGBBAA_BE}) {
+      INFO("chroma: " << chroma);
+      bool alpha = (chroma == heif_chroma_interleaved_RRGGBBAA_BE);
+      heif_chroma out_chroma = alpha ? heif_chroma_interleaved_RRGGBBAA_LE : heif_chroma_interleaved_RRGGBB_BE;
+
+      auto img = create_random_image(w, h, heif_colorspace_RGB, chroma, {heif_channel_interleaved}, 12);
+      require_same_output(Op_RRGGBBaa_swap_endianness(), Op_RRGGBBaa_swap_endianness_simd(), img,
+                          ColorState(heif_colorspace_RGB, chroma, alpha, 12),
+                          ColorState(heif_colorspace_RGB, out_chroma, alpha, 12), *options_ext);
+    }
+  }
+
+  SECTION("pipeline prefers SIMD operations") {
+    heif_color_conversion_options options{};
+    heif_color_conversion_options_set_defaults(&options);
+
+    auto pipeline = ColorConversionPipeline::get_pipeline(ColorState(heif_colorspace_monochrome, heif_chroma_monochrome, false, 10),
+                                                          ColorState(heif_colorspace_monochrome, heif_chroma_monochrome, false, 8),
+                                                          options, *options_ext);
+    REQUIRE(pipeline);
+    REQUIRE(pipeline->get_number_of_steps() == 1);
+    REQUIRE(pipeline->get_step_name(0) == "Op_to_sdr_planes_simd");
+  }
+}
+
+
+TEST_CASE("Fused bilinear upsampling and YCbCr to RGB")
+{
+  std::unique_ptr<heif_color_conversion_options_ext, void (*)(heif_color_conversion_options_ext*)>
+      options_ext(heif_color_conversion_options_ext_alloc(), heif_color_conversion_options_ext_free);
+
+  heif_color_conversion_options options{};
+  heif_color_conversion_options_set_defaults(&options);
+  REQUIRE(options.preferred_chroma_upsampling_algorithm == heif_chroma_upsampling_bilinear);
+
+  const heif_security_limits* limits = heif_get_disabled_security_limits();
+
+  auto create_input = [](uint32_t w, uint32_t h, heif_chroma chroma, bool alpha, bool full_range) {
+    auto img = create_random_image(w, h, heif_colorspace_YCbCr, chroma, {heif_channel_Y, heif_channel_Cb, heif_channel_Cr}, 8);
+    if (alpha) {
+      REQUIRE(!img->fill_new_plane(heif_channel_Alpha, 200, w, h, 8, heif_get_disabled_security_limits()));
+    }
+
+    nclx_profile nclx = nclx_profile::defaults();
+    nclx.set_full_range_flag(full_range);
+    img->set_color_profile_nclx(nclx);
+    return img;
+  };
+
+  // sizes with odd and even width/height, and rows that are long enough for the SIMD code
+  const std::vector<std::pair<uint32_t, uint32_t>> sizes = {{1, 1}, {2, 3}, {7, 6}, {45, 5}, {46, 6}};
+
+  SECTION("same result as the separate upsampling and floating-point conversion") {
+    for (auto size : sizes) {
+      for (heif_chroma chroma : {heif_chroma_420, heif_chroma_422}) {
+        for (bool alpha : {false, true}) {
+          for (bool full_range : {false, true}) {
+            INFO("size: " << size.first << "x" << size.second << " chroma: " << chroma << " alpha: " << alpha
+                          << " full range: " << full_range);
+
+            auto img = create_input(size.first, size.second, chroma, alpha, full_range);
+            ColorState input_state(heif_colorspace_YCbCr, chroma, alpha, 8);
+            input_state.nclx = img->get_color_profile_nclx();
+            ColorState output_state(heif_colorspace_RGB, alpha ? heif_chroma_interleaved_RGBA : heif_chroma_interleaved_RGB, alpha, 8);
+
+            Result<std::shared_ptr<HeifPixelImage>> upsampled;
+            if (chroma == heif_chroma_420) {
+              upsampled = Op_YCbCr420_bilinear_to_YCbCr444<uint8_t>().convert_colorspace(img, input_state, input_state, options, *options_ext, limits);
+            }
+            else {
+              upsampled = Op_YCbCr422_bilinear_to_YCbCr444<uint8_t>().convert_colorspace(img, input_state, input_state, options, *options_ext, limits);
+            }
+            REQUIRE(upsampled);
+
+            // The pipeline passes the color profile from step to step.
+            (*upsampled)->set_color_profile_nclx(img->get_color_profile_nclx());
+
+            auto planar = Op_YCbCr_to_RGB<uint8_t>().convert_colorspace(*upsampled, input_state, input_state, options, *options_ext, limits);
+            REQUIRE(planar);
+
+            auto fused = Op_YCbCr_bilinear_to_RGB24_32().convert_colorspace(img, input_state, output_state, options, *options_ext, limits);
+            REQUIRE(fused);
+
+            // The fixed-point matrix of the fused op may differ from the floating-point one by one because of rounding.
+            // Alpha is copied unchanged.
+            const int nComponents = alpha ? 4 : 3;
+            const heif_channel channels[4] = {heif_channel_R, heif_channel_G, heif_channel_B, heif_channel_Alpha};
+
+            size_t fused_stride;
+            const uint8_t* p = (*fused)->get_plane(heif_channel_interleaved, &fused_stride);
+            for (uint32_t y = 0; y < size.second; y++) {
+              for (uint32_t x = 0; x < size.first; x++) {
+                for (int c = 0; c < nComponents; c++) {
+                  size_t stride;
+                  const uint8_t* q = (*planar)->get_plane(channels[c], &stride);
+                  INFO("x: " << x << " y: " << y << " c: " << c);
+                  REQUIRE(std::abs(p[y * fused_stride + nComponents * x + c] - q[y * stride + x]) <= (c == 3 ? 0 : 1));
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  SECTION("SIMD") {
+    if (!simd::available()) {
+      SKIP("no SIMD support on this platform");
+    }
+
+    for (auto size : sizes) {
+      for (heif_chroma chroma : {heif_chroma_420, heif_chroma_422}) {
+        for (bool input_alpha : {false, true}) {
+          for (bool output_alpha : {false, true}) {
+            for (bool full_range : {false, true}) {
+              if (input_alpha && !output_alpha) {
+                continue;
+              }
+
+              INFO("size: " << size.first << "x" << size.second << " chroma: " << chroma << " input alpha: " << input_alpha
+                            << " output alpha: " << output_alpha << " full range: " << full_range);
+
+              auto img = create_input(size.first, size.second, chroma, input_alpha, full_range);
+              heif_chroma out_chroma = output_alpha ? heif_chroma_interleaved_RGBA : heif_chroma_interleaved_RGB;
+              require_same_output(Op_YCbCr_bilinear_to_RGB24_32(), Op_YCbCr_bilinear_to_RGB24_32_simd(), img,
+                                  ColorState(heif_colorspace_YCbCr, chroma, input_alpha, 8),
+                                  ColorState(heif_colorspace_RGB, out_chroma, output_alpha, 8), *options_ext);
+            }
+          }
+        }
+      }
+    }
+  }
+
+  SECTION("pipeline uses a single step") {
+    for (heif_chroma chroma : {heif_chroma_420, heif_chroma_422}) {
+      auto pipeline = ColorConversionPipeline::get_pipeline(ColorState(heif_colorspace_YCbCr, chroma, false, 8),
+                                                            ColorState(heif_colorspace_RGB, heif_chroma_interleaved_RGBA, true, 8),
+                                                            options, *options_ext);
+      REQUIRE(pipeline);
+      REQUIRE(pipeline->get_number_of_steps() == 1);
+      REQUIRE(pipeline->get_step_name(0) == (simd::available() ? "Op_YCbCr_bilinear_to_RGB24_32_simd" : "Op_YCbCr_bilinear_to_RGB24_32"));
+    }
+  }
+}
+
+
+TEST_CASE("Bit depth reduction modes")
+{
+  heif_color_conversion_options options{};
+  heif_color_conversion_options_set_defaults(&options);
+
+  std::unique_ptr<heif_color_conversion_options_ext, void (*)(heif_color_conversion_options_ext*)>
+      options_ext(heif_color_conversion_options_ext_alloc(), heif_color_conversion_options_ext_free);
+
+  // Converts a 10-bit image with 4 identical rows to 8 bits.
+  auto convert = [&](const std::vector<uint16_t>& row, heif_bit_depth_reduction_mode mode) {
+    const uint32_t w = (uint32_t) row.size(), h = 4;
+
+    auto img = std::make_shared<HeifPixelImage>();
+    img->create(w, h, heif_colorspace_monochrome, heif_chroma_monochrome);
+    REQUIRE(!img->add_plane(heif_channel_Y, w, h, 10, heif_get_disabled_security_limits()));
+
+    size_t stride;
+    auto* p = (uint16_t*) img->get_plane(heif_channel_Y, &stride);
+    for (uint32_t y = 0; y < h; y++) {
+      memcpy(p + y * stride / 2, row.data(), w * 2);
+    }
+
+    options_ext->bit_depth_reduction_mode = mode;
+    auto result = convert_colorspace(img, heif_colorspace_monochrome, heif_chroma_monochrome, nclx_profile::undefined(), 8,
+                                     options, options_ext.get(), heif_get_disabled_security_limits());
+    REQUIRE(result);
+    return *result;
+  };
+
+  const std::vector<uint16_t> row = {0, 1, 2, 3, 513, 514, 1021, 1023};
+
+  auto out = convert(row, heif_bit_depth_reduction_mode_truncate);
+  assert_plane(out, heif_channel_Y, {0, 0, 0, 0, 128, 128, 255, 255,
+                                     0, 0, 0, 0, 128, 128, 255, 255,
+                                     0, 0, 0, 0, 128, 128, 255, 255,
+                                     0, 0, 0, 0, 128, 128, 255, 255});
+
+  out = convert(row, heif_bit_depth_reduction_mode_round);
+  assert_plane(out, heif_channel_Y, {0, 0, 1, 1, 128, 129, 255, 255,
+                                     0, 0, 1, 1, 128, 129, 255, 255,
+                                     0, 0, 1, 1, 128, 129, 255, 255,
+                                     0, 0, 1, 1, 128, 129, 255, 255});
+
+  // Dithering preserves the mean value over each 4x4 block.
+  for (int value : {513, 514, 1018}) {
+    INFO("value: " << value);
+    out = convert(std::vector<uint16_t>(4, (uint16_t) value), heif_bit_depth_reduction_mode_dither);
+
+    size_t stride;
+    const uint8_t* p = out->get_plane(heif_channel_Y, &stride);
+    int sum = 0;
+    for (uint32_t y = 0; y < 4; y++) {
+      for (uint32_t x = 0; x < 4; x++) {
+        sum += p[y * stride + x];
+      }
+    }
+
+    REQUIRE(sum == 4 * value);
+  }
+}
@@ -0,0 +1,157 @@
+/*
+  libheif tests for loading plugins on demand
+
+  MIT License
+
+  Copyright (c) 2025 Dirk Farin <dirk.farin@gmail.com>
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#include "catch_amalgamated.hpp"
+#include "libheif/heif.h"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// The test plugin (test_decoder_plugin.cc) is a decoder for heif_compression_EVC.
+// It counts its initializations in the environment variable HEIF_TEST_PLUGIN_INIT_COUNT.
+
+static int get_plugin_init_count()
+{
+  const char* count = getenv("HEIF_TEST_PLUGIN_INIT_COUNT");
+  return count ? atoi(count) : 0;
+}
+
+static void reset_plugin_init_count()
+{
+  setenv("HEIF_TEST_PLUGIN_INIT_COUNT", "0", 1);
+}
+
+static int count_decoders(heif_compression_format format)
+{
+  return heif_get_decoder_descriptors(format, nullptr, 0);
+}
+
+
+TEST_CASE("Plugins are loaded on demand when a manifest is present")
+{
+  std::filesystem::path plugin_dir = std::filesystem::temp_directory_path() / "libheif-test-plugins";
+  std::filesystem::remove_all(plugin_dir);
+  std::filesystem::create_directories(plugin_dir);
+  std::filesystem::copy_file(TEST_PLUGIN_FILE, plugin_dir / "libheif-test-plugin.so");
+
+  setenv("LIBHEIF_PLUGIN_PATH", plugin_dir.string().c_str(), 1);
+
+  std::filesystem::path manifest_path = plugin_dir / "libheif-plugins.manifest";
+
+  SECTION("without manifest, all plugins are loaded at initialization") {
+    reset_plugin_init_count();
+
+    REQUIRE(heif_init(nullptr).code == heif_error_Ok);
+    REQUIRE(get_plugin_init_count() == 1);
+    REQUIRE(count_decoders(heif_compression_EVC) == 1);
+    heif_deinit();
+
+    // libheif never writes the manifest on its own
+    REQUIRE(!std::filesystem::exists(manifest_path));
+  }
+
+  SECTION("with manifest, plugins are only loaded for their format") {
+    REQUIRE(heif_write_plugin_manifest(plugin_dir.string().c_str()).code == heif_error_Ok);
+    REQUIRE(std::filesystem::exists(manifest_path));
+
+    // no temporary files are left behind
+    int nFiles = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(plugin_dir)) {
+      (void) entry;
+      nFiles++;
+    }
+    REQUIRE(nFiles == 2);
+
+    reset_plugin_init_count();
+
+    REQUIRE(heif_init(nullptr).code == heif_error_Ok);
+    REQUIRE(get_plugin_init_count() == 0);
+
+    // querying another format does not load the plugin
+    count_decoders(heif_compression_HEVC);
+    REQUIRE(get_plugin_init_count() == 0);
+
+    REQUIRE(count_decoders(heif_compression_EVC) == 1);
+    REQUIRE(get_plugin_init_count() == 1);
+
+    // the plugin is loaded only once
+    REQUIRE(count_decoders(heif_compression_EVC) == 1);
+    REQUIRE(count_decoders(heif_compression_undefined) >= 0);
+    REQUIRE(get_plugin_init_count() == 1);
+
+    heif_deinit();
+  }
+
+  SECTION("deferred plugins can be loaded from several threads at once") {
+    REQUIRE(heif_write_plugin_manifest(plugin_dir.string().c_str()).code == heif_error_Ok);
+
+    reset_plugin_init_count();
+
+    REQUIRE(heif_init(nullptr).code == heif_error_Ok);
+
+    const int nThreads = 8;
+    std::vector<int> evc_decoders(nThreads);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < nThreads; i++) {
+      threads.emplace_back([&evc_decoders, i]() {
+        // alternate between queries that load the plugin and queries that iterate over all plugins
+        count_decoders(i % 2 ? heif_compression_undefined : heif_compression_HEVC);
+        evc_decoders[i] = count_decoders(heif_compression_EVC);
+      });
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    for (int n : evc_decoders) {
+      REQUIRE(n == 1);
+    }
+
+    REQUIRE(get_plugin_init_count() == 1);
+
+    heif_deinit();
+  }
+
+  SECTION("a stale manifest is ignored") {
+    REQUIRE(heif_write_plugin_manifest(plugin_dir.string().c_str()).code == heif_error_Ok);
+
+    // a new plugin file in the directory
+    std::filesystem::copy_file(TEST_PLUGIN_FILE, plugin_dir / "libheif-test-plugin-2.so");
+
+    reset_plugin_init_count();
+
+    REQUIRE(heif_init(nullptr).code == heif_error_Ok);
+    REQUIRE(get_plugin_init_count() == 2);
+    heif_deinit();
+  }
+
+  std::filesystem::remove_all(plugin_dir);
+}
@@ -0,0 +1,187 @@
+/*
+  libheif tests for heif_probe()
+
+  MIT License
+
+  Copyright (c) 2025 Dirk Farin <dirk.farin@gmail.com>
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#include "catch_amalgamated.hpp"
+#include "libheif/heif.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+// In-memory file that records the byte ranges that libheif reads.
+struct probe_test_file
+{
+  std::vector<uint8_t> data;
+  uint64_t pos = 0;
+  uint64_t max_read_end = 0;
+};
+
+static heif_error write_to_vector(heif_context*, const void* data, size_t size, void* userdata)
+{
+  auto* out = (std::vector<uint8_t>*) userdata;
+  out->insert(out->end(), (const uint8_t*) data, (const uint8_t*) data + size);
+  return heif_error_success;
+}
+
+static heif_reader get_probe_test_reader()
+{
+  heif_reader reader{};
+  reader.reader_api_version = 1;
+  reader.get_position = [](void* userdata) { return (int64_t) ((probe_test_file*) userdata)->pos; };
+  reader.read = [](void* data, size_t size, void* userdata) {
+    auto* f = (probe_test_file*) userdata;
+    if (f->pos + size > f->data.size()) {
+      return 1;
+    }
+    memcpy(data, f->data.data() + f->pos, size);
+    f->pos += size;
+    f->max_read_end = std::max(f->max_read_end, f->pos);
+    return 0;
+  };
+  reader.seek = [](int64_t position, void* userdata) {
+    ((probe_test_file*) userdata)->pos = (uint64_t) position;
+    return 0;
+  };
+  reader.wait_for_file_size = [](int64_t target_size, void* userdata) {
+    return (uint64_t) target_size <= ((probe_test_file*) userdata)->data.size() ?
+           heif_reader_grow_status_size_reached : heif_reader_grow_status_size_beyond_eof;
+  };
+
+  return reader;
+}
+
+
+static heif_image* create_rgba_image(int w, int h)
+{
+  heif_image* image;
+  heif_error err = heif_image_create(w, h, heif_colorspace_RGB, heif_chroma_interleaved_RGBA, &image);
+  REQUIRE(err.code == heif_error_Ok);
+
+  err = heif_image_add_plane(image, heif_channel_interleaved, w, h, 8);
+  REQUIRE(err.code == heif_error_Ok);
+
+  int stride;
+  uint8_t* p = heif_image_get_plane(image, heif_channel_interleaved, &stride);
+  for (int y = 0; y < h; y++) {
+    for (int x = 0; x < w * 4; x++) {
+      p[y * stride + x] = (uint8_t) (x + y);
+    }
+  }
+
+  return image;
+}
+
+
+TEST_CASE("Probe file without reading image data")
+{
+  heif_context* ctx = heif_context_alloc();
+
+  heif_encoder* encoder;
+  heif_error err = heif_context_get_encoder_for_format(ctx, heif_compression_uncompressed, &encoder);
+  REQUIRE(err.code == heif_error_Ok);
+
+  heif_encoding_options* options = heif_encoding_options_alloc();
+  options->image_orientation = heif_orientation_rotate_90_cw_then_flip_vertically;
+
+  heif_image* input_image = create_rgba_image(1024, 768);
+  heif_image_handle* handle;
+  err = heif_context_encode_image(ctx, input_image, encoder, options, &handle);
+  REQUIRE(err.code == heif_error_Ok);
+
+  const uint8_t exif[] = {'M', 'M', 0, 0x2a, 0, 0, 0, 8, 0, 0};
+  err = heif_context_add_exif_metadata(ctx, handle, exif, sizeof(exif));
+  REQUIRE(err.code == heif_error_Ok);
+
+  const std::string xmp = "<x:xmpmeta xmlns:x=\"adobe:ns:meta/\"></x:xmpmeta>";
+  err = heif_context_add_XMP_metadata(ctx, handle, xmp.data(), (int) xmp.size());
+  REQUIRE(err.code == heif_error_Ok);
+
+  probe_test_file file;
+  heif_writer writer{1, write_to_vector};
+  err = heif_context_write(ctx, &writer, &file.data);
+  REQUIRE(err.code == heif_error_Ok);
+
+  heif_image_handle_release(handle);
+  heif_image_release(input_image);
+  heif_encoding_options_free(options);
+  heif_encoder_release(encoder);
+  heif_context_free(ctx);
+
+  heif_reader reader = get_probe_test_reader();
+
+  heif_probe_info info{};
+  info.version = 1;
+  err = heif_probe(&reader, &file, &info);
+  REQUIRE(err.code == heif_error_Ok);
+
+  REQUIRE(info.primary_item_type == heif_fourcc('u', 'n', 'c', 'i'));
+  REQUIRE(info.width == 1024);
+  REQUIRE(info.height == 768);
+  REQUIRE(info.orientation == heif_orientation_rotate_90_cw_then_flip_vertically);
+  REQUIRE(info.luma_bits_per_pixel == 8);
+  REQUIRE(info.has_alpha);
+
+  // the Exif item data starts with the offset to the TIFF header
+  REQUIRE(info.exif_size == 4 + sizeof(exif));
+  REQUIRE(memcmp(file.data.data() + info.exif_offset + 4, exif, sizeof(exif)) == 0);
+
+  REQUIRE(info.xmp_size == xmp.size());
+  REQUIRE(memcmp(file.data.data() + info.xmp_offset, xmp.data(), xmp.size()) == 0);
+
+  // nothing after the 'meta' box has been read
+  REQUIRE(info.bytes_end <= std::min(info.exif_offset, info.xmp_offset));
+  REQUIRE(info.bytes_read < 1024);
+  REQUIRE(file.max_read_end == info.bytes_end);
+
+  // --- the full open path reads more data
+
+  ctx = heif_context_alloc();
+  file.pos = 0;
+  file.max_read_end = 0;
+  err = heif_context_read_from_reader(ctx, &reader, &file, nullptr);
+  REQUIRE(err.code == heif_error_Ok);
+  heif_context_free(ctx);
+
+  REQUIRE(file.max_read_end > info.bytes_end);
+}
+
+
+TEST_CASE("Probe rejects non-HEIF data")
+{
+  probe_test_file file;
+  file.data = {0, 0, 0, 16, 'f', 'r', 'e', 'e', 0, 0, 0, 0, 0, 0, 0, 0};
+
+  heif_reader reader = get_probe_test_reader();
+
+  heif_probe_info info{};
+  info.version = 1;
+  heif_error err = heif_probe(&reader, &file, &info);
+  REQUIRE(err.code != heif_error_Ok);
+}
@@ -586,3 +586,326 @@ TEST_CASE("create inline mask region from image") {
   heif_image_handle_release(readbackHandle);
   heif_context_free(readbackCtx);
 }
+
+
+TEST_CASE("rasterize regions to mask") {
+  heif_encoder* enc = get_encoder_or_skip_test(heif_compression_uncompressed);
+
+  const uint32_t width = 64;
+  const uint32_t height = 48;
+
+  heif_image* img;
+  heif_error err = heif_image_create(width, height, heif_colorspace_monochrome, heif_chroma_monochrome, &img);
+  REQUIRE(err.code == heif_error_Ok);
+  fill_new_plane(img, heif_channel_Y, width, height);
+
+  heif_context* ctx = heif_context_alloc();
+  heif_image_handle* handle;
+  err = heif_context_encode_image(ctx, img, enc, nullptr, &handle);
+  REQUIRE(err.code == heif_error_Ok);
+
+  // reference space is half the image size
+  heif_region_item* region_item;
+  err = heif_image_handle_add_region_item(handle, width / 2, height / 2, &region_item);
+  REQUIRE(err.code == heif_error_Ok);
+
+  int32_t triangle[] = {16, 2, 24, 2, 16, 10};
+  int32_t line[] = {20, 16, 28, 16};
+  uint8_t mask_data[] = {0xF0};
+
+  REQUIRE(heif_region_item_add_region_rectangle(region_item, 2, 2, 4, 3, nullptr).code == heif_error_Ok);
+  REQUIRE(heif_region_item_add_region_polygon(region_item, triangle, 3, nullptr).code == heif_error_Ok);
+  REQUIRE(heif_region_item_add_region_ellipse(region_item, 8, 16, 3, 2, nullptr).code == heif_error_Ok);
+  REQUIRE(heif_region_item_add_region_point(region_item, 30, 22, nullptr).code == heif_error_Ok);
+  REQUIRE(heif_region_item_add_region_polyline(region_item, line, 2, nullptr).code == heif_error_Ok);
+  REQUIRE(heif_region_item_add_region_inline_mask_data(region_item, 0, 20, 8, 1, mask_data, 1, nullptr).code == heif_error_Ok);
+
+  heif_item_id image_id = heif_image_handle_get_item_id(handle);
+
+  auto rasterize = [&](heif_item_id id, heif_region_mask_type type, uint32_t expected_width, uint32_t expected_height) {
+    heif_image* mask;
+    heif_error e = heif_region_item_rasterize_to_mask(region_item, id, type, &mask);
+    REQUIRE(e.code == heif_error_Ok);
+    REQUIRE(heif_image_get_colorspace(mask) == heif_colorspace_monochrome);
+    REQUIRE(heif_image_get_primary_width(mask) == (int) expected_width);
+    REQUIRE(heif_image_get_primary_height(mask) == (int) expected_height);
+    return mask;
+  };
+
+  auto pixel = [](heif_image* mask, int x, int y) {
+    size_t stride;
+    const uint8_t* p = heif_image_get_plane_readonly2(mask, heif_channel_Y, &stride);
+    return (int) p[y * stride + x];
+  };
+
+  SECTION("binary in image coordinates") {
+    heif_image* mask = rasterize(image_id, heif_region_mask_type_binary, width, height);
+
+    // rectangle covers [4,12) x [4,10)
+    REQUIRE(pixel(mask, 4, 4) == 255);
+    REQUIRE(pixel(mask, 11, 9) == 255);
+    REQUIRE(pixel(mask, 12, 9) == 0);
+    REQUIRE(pixel(mask, 3, 4) == 0);
+
+    // triangle, including its vertices
+    REQUIRE(pixel(mask, 33, 5) == 255);
+    REQUIRE(pixel(mask, 34, 6) == 255);
+    REQUIRE(pixel(mask, 47, 19) == 0);
+
+    // ellipse centered at (17,33) with radii (6,4)
+    REQUIRE(pixel(mask, 17, 33) == 255);
+    REQUIRE(pixel(mask, 22, 33) == 255);
+    REQUIRE(pixel(mask, 24, 33) == 0);
+    REQUIRE(pixel(mask, 17, 38) == 0);
+
+    // point
+    REQUIRE(pixel(mask, 61, 45) == 255);
+    REQUIRE(pixel(mask, 60, 45) == 0);
+
+    // polyline
+    for (int x = 41; x <= 57; x++) {
+      REQUIRE(pixel(mask, x, 33) == 255);
+    }
+    REQUIRE(pixel(mask, 45, 34) == 0);
+
+    // inline mask, scaled to [0,8) x [40,42)
+    REQUIRE(pixel(mask, 7, 41) == 255);
+    REQUIRE(pixel(mask, 8, 41) == 0);
+
+    heif_image_release(mask);
+  }
+
+  SECTION("binary in reference coordinates") {
+    heif_image* mask = rasterize(0, heif_region_mask_type_binary, width / 2, height / 2);
+
+    REQUIRE(pixel(mask, 2, 2) == 255);
+    REQUIRE(pixel(mask, 5, 4) == 255);
+    REQUIRE(pixel(mask, 6, 4) == 0);
+    REQUIRE(pixel(mask, 24, 2) == 255);
+    REQUIRE(pixel(mask, 16, 10) == 255);
+    REQUIRE(pixel(mask, 30, 22) == 255);
+
+    heif_image_release(mask);
+  }
+
+  SECTION("anti-aliased coverage") {
+    heif_image* mask = rasterize(image_id, heif_region_mask_type_coverage, width, height);
+
+    // pixel-aligned rectangle edges stay sharp
+    REQUIRE(pixel(mask, 4, 4) == 255);
+    REQUIRE(pixel(mask, 12, 4) == 0);
+
+    // the triangle hypotenuse x+y=54 cuts this pixel in half
+    REQUIRE(pixel(mask, 40, 13) == 128);
+
+    heif_image_release(mask);
+  }
+
+  SECTION("label map") {
+    heif_image* mask = rasterize(image_id, heif_region_mask_type_label_map, width, height);
+
+    REQUIRE(pixel(mask, 4, 4) == 1);
+    REQUIRE(pixel(mask, 34, 6) == 2);
+    REQUIRE(pixel(mask, 17, 33) == 3);
+    REQUIRE(pixel(mask, 61, 45) == 4);
+    REQUIRE(pixel(mask, 45, 33) == 5);
+    REQUIRE(pixel(mask, 7, 41) == 6);
+    REQUIRE(pixel(mask, 0, 0) == 0);
+
+    heif_image_release(mask);
+  }
+
+  SECTION("label map with more than 255 regions") {
+    for (int i = 0; i < 249; i++) {
+      REQUIRE(heif_region_item_add_region_point(region_item, i % 32, 23, nullptr).code == heif_error_Ok);
+    }
+
+    // 255 regions: the last label is still representable
+    heif_image* mask = rasterize(0, heif_region_mask_type_label_map, width / 2, height / 2);
+    REQUIRE(pixel(mask, 24, 23) == 255);
+    REQUIRE(pixel(mask, 25, 23) == 224);
+    heif_image_release(mask);
+
+    REQUIRE(heif_region_item_add_region_point(region_item, 0, 0, nullptr).code == heif_error_Ok);
+
+    heif_error e = heif_region_item_rasterize_to_mask(region_item, 0, heif_region_mask_type_label_map, &mask);
+    REQUIRE(e.code == heif_error_Usage_error);
+    REQUIRE(e.subcode == heif_suberror_Too_many_regions);
+
+    // other mask types have no limit
+    mask = rasterize(0, heif_region_mask_type_binary, width / 2, height / 2);
+    REQUIRE(pixel(mask, 0, 0) == 255);
+    heif_image_release(mask);
+  }
+
+  heif_region_item_release(region_item);
+  heif_image_handle_release(handle);
+  heif_encoder_release(enc);
+  heif_context_free(ctx);
+  heif_image_release(img);
+}
+
+
+TEST_CASE("transformed point of rotated image") {
+  heif_encoder* enc = get_encoder_or_skip_test(heif_compression_uncompressed);
+
+  const int width = 64;
+  const int height = 48;
+  const int px = 5;
+  const int py = 20;
+
+  heif_image* img;
+  heif_error err = heif_image_create(width, height, heif_colorspace_monochrome, heif_chroma_monochrome, &img);
+  REQUIRE(err.code == heif_error_Ok);
+  fill_new_plane(img, heif_channel_Y, width, height);
+
+  // rotations are the only transforms that mix the x and y coordinates
+  struct {
+    heif_orientation orientation;
+    int expected_x, expected_y;
+  } rotations[] = {
+      {heif_orientation_rotate_90_cw, height - 1 - py, px},
+      {heif_orientation_rotate_270_cw, py, width - 1 - px},
+  };
+
+  for (const auto& rotation : rotations) {
+    heif_encoding_options* options = heif_encoding_options_alloc();
+    options->image_orientation = rotation.orientation;
+
+    heif_context* ctx = heif_context_alloc();
+    heif_image_handle* handle;
+    err = heif_context_encode_image(ctx, img, enc, options, &handle);
+    REQUIRE(err.code == heif_error_Ok);
+    heif_encoding_options_free(options);
+
+    heif_region_item* region_item;
+    err = heif_image_handle_add_region_item(handle, width, height, &region_item);
+    REQUIRE(err.code == heif_error_Ok);
+
+    heif_region* region;
+    REQUIRE(heif_region_item_add_region_point(region_item, px, py, &region).code == heif_error_Ok);
+
+    heif_item_id image_id = heif_image_handle_get_item_id(handle);
+
+    double x, y;
+    err = heif_region_get_point_transformed(region, image_id, &x, &y);
+    REQUIRE(err.code == heif_error_Ok);
+    REQUIRE(x == rotation.expected_x);
+    REQUIRE(y == rotation.expected_y);
+
+    // the rasterizer has to draw the point at the same position
+    heif_image* mask;
+    err = heif_region_item_rasterize_to_mask(region_item, image_id, heif_region_mask_type_binary, &mask);
+    REQUIRE(err.code == heif_error_Ok);
+    REQUIRE(heif_image_get_primary_width(mask) == height);
+    REQUIRE(heif_image_get_primary_height(mask) == width);
+
+    size_t stride;
+    const uint8_t* p = heif_image_get_plane_readonly2(mask, heif_channel_Y, &stride);
+    REQUIRE(p[(int) y * stride + (int) x] == 255);
+
+    heif_image_release(mask);
+    heif_region_release(region);
+    heif_region_item_release(region_item);
+    heif_image_handle_release(handle);
+    heif_context_free(ctx);
+  }
+
+  heif_encoder_release(enc);
+  heif_image_release(img);
+}
+
+
+TEST_CASE("query regions in rectangle") {
+  heif_encoder* enc = get_encoder_or_skip_test(heif_compression_uncompressed);
+
+  const uint32_t width = 64;
+  const uint32_t height = 48;
+
+  heif_image* img;
+  heif_error err = heif_image_create(width, height, heif_colorspace_monochrome, heif_chroma_monochrome, &img);
+  REQUIRE(err.code == heif_error_Ok);
+  fill_new_plane(img, heif_channel_Y, width, height);
+
+  heif_context* ctx = heif_context_alloc();
+  heif_image_handle* handle;
+  err = heif_context_encode_image(ctx, img, enc, nullptr, &handle);
+  REQUIRE(err.code == heif_error_Ok);
+
+  // a grid of points at even coordinates, with reference space at half the image size
+
+  heif_region_item* points_item;
+  err = heif_image_handle_add_region_item(handle, width / 2, height / 2, &points_item);
+  REQUIRE(err.code == heif_error_Ok);
+
+  for (int32_t y = 0; y < 24; y += 2) {
+    for (int32_t x = 0; x < 32; x += 2) {
+      REQUIRE(heif_region_item_add_region_point(points_item, x, y, nullptr).code == heif_error_Ok);
+    }
+  }
+
+  heif_region_item* area_item;
+  err = heif_image_handle_add_region_item(handle, width, height, &area_item);
+  REQUIRE(err.code == heif_error_Ok);
+  REQUIRE(heif_region_item_add_region_rectangle(area_item, 40, 30, 10, 10, nullptr).code == heif_error_Ok);
+
+  heif_item_id points_item_id = heif_region_item_get_id(points_item);
+  heif_item_id area_item_id = heif_region_item_get_id(area_item);
+
+  auto query = [&](int32_t x, int32_t y, uint32_t w, uint32_t h) {
+    int num = heif_image_handle_query_regions_in_rect(handle, x, y, w, h, nullptr, nullptr, 0);
+    std::vector<heif_item_id> ids(num);
+    std::vector<int> indices(num);
+    REQUIRE(heif_image_handle_query_regions_in_rect(handle, x, y, w, h, ids.data(), indices.data(), num) == num);
+
+    std::vector<std::pair<heif_item_id, int>> hits;
+    for (int i = 0; i < num; i++) {
+      hits.emplace_back(ids[i], indices[i]);
+    }
+    return hits;
+  };
+
+  // point (px,py) covers the image pixels [2px, 2px+2) x [2py, 2py+2)
+  auto hits = query(10, 8, 10, 4);
+  REQUIRE(hits.size() == 2);
+
+  for (auto& hit : hits) {
+    REQUIRE(hit.first == points_item_id);
+
+    heif_region* region;
+    REQUIRE(heif_region_item_get_region(points_item, hit.second, &region).code == heif_error_Ok);
+    int32_t px, py;
+    REQUIRE(heif_region_get_point(region, &px, &py).code == heif_error_Ok);
+    REQUIRE(py == 4);
+    REQUIRE((px == 6 || px == 8));
+    heif_region_release(region);
+  }
+
+  // single pixel query hitting a point and the rectangle
+  hits = query(44, 32, 1, 1);
+  REQUIRE(hits.size() == 2);
+  REQUIRE(hits[0].first == points_item_id);
+  REQUIRE(hits[1] == std::make_pair(area_item_id, 0));
+
+  // a full row of points, and the empty rows between them
+  REQUIRE(query(0, 0, 64, 2).size() == 16);
+  REQUIRE(query(0, 2, 64, 2).empty());
+  REQUIRE(query(-10, -10, 5, 5).empty());
+  REQUIRE(query(0, 0, width, height).size() == 16 * 12 + 1);
+
+  // the index picks up regions that are added later
+  REQUIRE(heif_region_item_add_region_ellipse(area_item, 5, 5, 2, 2, nullptr).code == heif_error_Ok);
+  hits = query(4, 4, 1, 1);
+  REQUIRE(hits.size() == 2);
+  REQUIRE(hits[1] == std::make_pair(area_item_id, 1));
+
+  heif_region* region;
+  REQUIRE(heif_region_item_get_region(area_item, 2, &region).code != heif_error_Ok);
+
+  heif_region_item_release(points_item);
+  heif_region_item_release(area_item);
+  heif_image_handle_release(handle);
+  heif_encoder_release(enc);
+  heif_context_free(ctx);
+  heif_image_release(img);
+}
@@ -0,0 +1,289 @@
+/*
+  libheif tests for sequence encoding with the codec plugins that are compiled into the library
+
+  MIT License
+
+  Copyright (c) 2025 Dirk Farin <dirk.farin@gmail.com>
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#include "catch_amalgamated.hpp"
+#include "libheif/heif.h"
+#include "libheif/heif_sequences.h"
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+
+static const int kWidth = 64;
+static const int kHeight = 64;
+static const int kNumFrames = 8;
+static const int kKeyframeDistance = 4;
+
+// Each frame has a different uniform luma value, so that the frame order can be checked after lossy coding.
+static int frame_luma(int frame)
+{
+  return 40 + 20 * frame;
+}
+
+
+static heif_image* create_frame(int frame)
+{
+  heif_image* img = nullptr;
+  heif_error err = heif_image_create(kWidth, kHeight, heif_colorspace_YCbCr, heif_chroma_420, &img);
+  REQUIRE(err.code == heif_error_Ok);
+
+  for (heif_channel channel : {heif_channel_Y, heif_channel_Cb, heif_channel_Cr}) {
+    int w = (channel == heif_channel_Y) ? kWidth : kWidth / 2;
+    int h = (channel == heif_channel_Y) ? kHeight : kHeight / 2;
+    err = heif_image_add_plane(img, channel, w, h, 8);
+    REQUIRE(err.code == heif_error_Ok);
+
+    size_t stride;
+    uint8_t* p = heif_image_get_plane2(img, channel, &stride);
+    for (int y = 0; y < h; y++) {
+      memset(p + y * stride, channel == heif_channel_Y ? frame_luma(frame) : 128, w);
+    }
+  }
+
+  heif_image_set_duration(img, 1);
+
+  return img;
+}
+
+
+static int mean_luma(const heif_image* img)
+{
+  size_t stride;
+  const uint8_t* p = heif_image_get_plane_readonly2(img, heif_channel_Y, &stride);
+  REQUIRE(p != nullptr);
+
+  long sum = 0;
+  for (int y = 0; y < kHeight; y++) {
+    for (int x = 0; x < kWidth; x++) {
+      sum += p[y * stride + x];
+    }
+  }
+
+  return (int) (sum / (kWidth * kHeight));
+}
+
+
+static uint32_t read32(const uint8_t* p)
+{
+  return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+}
+
+
+// Returns the payload range of the box at the end of 'path' (e.g. "moov/trak/mdia/minf/stbl/stss").
+static bool find_box(const std::vector<uint8_t>& file, size_t begin, size_t end, const std::string& path,
+                     size_t& out_begin, size_t& out_end)
+{
+  std::string type = path.substr(0, 4);
+
+  size_t pos = begin;
+  while (pos + 8 <= end) {
+    uint64_t size = read32(&file[pos]);
+    size_t header_size = 8;
+    if (size == 1) {
+      size = (uint64_t(read32(&file[pos + 8])) << 32) | read32(&file[pos + 12]);
+      header_size = 16;
+    }
+    else if (size == 0) {
+      size = end - pos;
+    }
+
+    if (size < header_size || pos + size > end) {
+      return false;
+    }
+
+    if (memcmp(&file[pos + 4], type.data(), 4) == 0) {
+      if (path.size() == 4) {
+        out_begin = pos + header_size;
+        out_end = pos + size;
+        return true;
+      }
+
+      return find_box(file, pos + header_size, pos + size, path.substr(5), out_begin, out_end);
+    }
+
+    pos += size;
+  }
+
+  return false;
+}
+
+
+// Sample indices (0-based) of the sync samples. Without 'stss' box, all samples are sync samples.
+static std::vector<uint32_t> get_sync_samples(const std::vector<uint8_t>& file, uint32_t num_samples)
+{
+  std::vector<uint32_t> sync_samples;
+
+  size_t begin, end;
+  if (!find_box(file, 0, file.size(), "moov/trak/mdia/minf/stbl/stss", begin, end)) {
+    for (uint32_t i = 0; i < num_samples; i++) {
+      sync_samples.push_back(i);
+    }
+
+    return sync_samples;
+  }
+
+  REQUIRE(end - begin >= 8);
+  uint32_t entry_count = read32(&file[begin + 4]); // skip version and flags
+  REQUIRE(end - begin >= 8 + 4 * size_t{entry_count});
+
+  for (uint32_t i = 0; i < entry_count; i++) {
+    sync_samples.push_back(read32(&file[begin + 8 + 4 * i]) - 1);
+  }
+
+  return sync_samples;
+}
+
+
+static void encode_and_check_sequence(const heif_encoder_descriptor* descriptor)
+{
+  heif_compression_format format = heif_encoder_descriptor_get_compression_format(descriptor);
+
+  // --- encode
+
+  heif_context* ctx = heif_context_alloc();
+
+  heif_encoder* encoder = nullptr;
+  heif_error err = heif_context_get_encoder(ctx, descriptor, &encoder);
+  REQUIRE(err.code == heif_error_Ok);
+  heif_encoder_set_lossy_quality(encoder, 90);
+
+  heif_track_options* track_options = heif_track_options_alloc();
+  heif_track_options_set_timescale(track_options, 25);
+
+  heif_track* track = nullptr;
+  err = heif_context_add_visual_sequence_track(ctx, kWidth, kHeight, heif_track_type_video,
+                                               track_options, nullptr, &track);
+  REQUIRE(err.code == heif_error_Ok);
+
+  heif_sequence_encoding_options* seq_options = heif_sequence_encoding_options_alloc();
+  seq_options->gop_structure = heif_sequence_gop_structure_lowdelay;
+  seq_options->keyframe_distance_max = kKeyframeDistance;
+
+  for (int i = 0; i < kNumFrames; i++) {
+    heif_image* img = create_frame(i);
+    err = heif_track_encode_sequence_image(track, img, encoder, seq_options);
+    heif_image_release(img);
+    REQUIRE(err.code == heif_error_Ok);
+  }
+
+  err = heif_track_encode_end_of_sequence(track, encoder);
+  REQUIRE(err.code == heif_error_Ok);
+
+  std::vector<uint8_t> file;
+  heif_writer writer{};
+  writer.writer_api_version = 1;
+  writer.write = [](heif_context*, const void* data, size_t size, void* userdata) {
+    auto* out = static_cast<std::vector<uint8_t>*>(userdata);
+    out->insert(out->end(), static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+    return heif_error_success;
+  };
+
+  err = heif_context_write(ctx, &writer, &file);
+  REQUIRE(err.code == heif_error_Ok);
+
+  heif_sequence_encoding_options_release(seq_options);
+  heif_track_options_release(track_options);
+  heif_track_release(track);
+  heif_encoder_release(encoder);
+  heif_context_free(ctx);
+
+  // --- keyframe flags
+
+  std::vector<uint32_t> sync_samples = get_sync_samples(file, kNumFrames);
+  REQUIRE(!sync_samples.empty());
+  REQUIRE(sync_samples[0] == 0);
+  for (size_t i = 1; i < sync_samples.size(); i++) {
+    REQUIRE(sync_samples[i] > sync_samples[i - 1]);
+    REQUIRE(sync_samples[i] - sync_samples[i - 1] <= kKeyframeDistance);
+  }
+  REQUIRE(kNumFrames - 1 - sync_samples.back() < kKeyframeDistance);
+
+  if (!heif_have_decoder_for_format(format)) {
+    return;
+  }
+
+  // --- decode all frames in order
+
+  ctx = heif_context_alloc();
+  err = heif_context_read_from_memory_without_copy(ctx, file.data(), file.size(), nullptr);
+  REQUIRE(err.code == heif_error_Ok);
+
+  track = heif_context_get_track(ctx, 0);
+  REQUIRE(track != nullptr);
+
+  for (int i = 0; i < kNumFrames; i++) {
+    heif_image* img = nullptr;
+    err = heif_track_decode_next_image(track, &img, heif_colorspace_YCbCr, heif_chroma_420, nullptr);
+    REQUIRE(err.code == heif_error_Ok);
+    REQUIRE(std::abs(mean_luma(img) - frame_luma(i)) <= 6);
+    heif_image_release(img);
+  }
+
+  heif_image* img = nullptr;
+  err = heif_track_decode_next_image(track, &img, heif_colorspace_YCbCr, heif_chroma_420, nullptr);
+  REQUIRE(err.code == heif_error_End_of_sequence);
+
+  // --- Decoding has to start at a sync sample. A P-frame that is wrongly marked as sync sample cannot be
+  //     decoded on its own.
+
+  for (uint32_t sample : sync_samples) {
+    err = heif_track_seek_to_sample(track, sample);
+    REQUIRE(err.code == heif_error_Ok);
+
+    err = heif_track_decode_next_image(track, &img, heif_colorspace_YCbCr, heif_chroma_420, nullptr);
+    REQUIRE(err.code == heif_error_Ok);
+    REQUIRE(std::abs(mean_luma(img) - frame_luma((int) sample)) <= 6);
+    heif_image_release(img);
+  }
+
+  heif_track_release(track);
+  heif_context_free(ctx);
+}
+
+
+TEST_CASE("Low-delay sequence with each available encoder")
+{
+  int num_tested = 0;
+
+  for (heif_compression_format format : {heif_compression_HEVC, heif_compression_AV1}) {
+    const int max_encoders = 10;
+    const heif_encoder_descriptor* descriptors[max_encoders];
+    int n = heif_get_encoder_descriptors(format, nullptr, descriptors, max_encoders);
+
+    for (int i = 0; i < n; i++) {
+      SECTION(heif_encoder_descriptor_get_id_name(descriptors[i])) {
+        encode_and_check_sequence(descriptors[i]);
+      }
+
+      num_tested++;
+    }
+  }
+
+  if (num_tested == 0) {
+    SKIP("No HEVC or AV1 encoder available");
+  }
+}
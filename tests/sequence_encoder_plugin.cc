@@ -0,0 +1,518 @@
+/*
+  libheif tests for sequence encoding with encoder plugins that support inter-frame coding (plugin API v4)
+
+  MIT License
+
+  Copyright (c) 2025 Dirk Farin <dirk.farin@gmail.com>
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#include "catch_amalgamated.hpp"
+#include "libheif/heif.h"
+#include "libheif/heif_plugin.h"
+#include "libheif/heif_sequences.h"
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+
+// --- Mock AV1 encoder plugin
+//
+// It does not compress anything. Each frame is coded as an AV1 padding OBU that contains the frame number, so that
+// the frame order can be checked in the written file. Like real encoders with lookahead, it holds back
+// 'mock_lookahead' frames until more frames are pushed or the sequence is ended.
+
+static const int mock_lookahead = 2;
+
+// heif_error_ok is not exported from the library. External plugins have to define their own.
+static const heif_error mock_ok = {heif_error_Ok, heif_suberror_Unspecified, "Success"};
+
+// When set, the plugin outputs the buffered frames in reverse order, which is not allowed.
+static bool mock_reorder_frames = false;
+
+static int mock_num_intra_images = 0;
+static int mock_num_sequence_frames = 0;
+
+
+struct MockPacket
+{
+  std::vector<uint8_t> data;
+  uintptr_t frame_nr = 0;
+  bool keyframe = false;
+};
+
+struct MockEncoder
+{
+  std::deque<uintptr_t> buffered_frames;
+  int num_coded_frames = 0;
+
+  std::deque<MockPacket> packets;
+  MockPacket current_packet; // the data of the packet returned last must stay valid until the next call
+};
+
+
+static std::vector<uint8_t> mock_frame_payload(uintptr_t frame_nr, bool keyframe)
+{
+  // OBU header: type 15 (padding), has_size_field, followed by the leb128 size
+  return {0x7A, 0x02, static_cast<uint8_t>(frame_nr), static_cast<uint8_t>(keyframe ? 1 : 0)};
+}
+
+
+static void mock_code_frames(MockEncoder* enc, size_t num_frames_to_keep)
+{
+  std::vector<uintptr_t> frames;
+  while (enc->buffered_frames.size() > num_frames_to_keep) {
+    frames.push_back(enc->buffered_frames.front());
+    enc->buffered_frames.pop_front();
+  }
+
+  if (mock_reorder_frames) {
+    std::reverse(frames.begin(), frames.end());
+  }
+
+  for (uintptr_t frame_nr : frames) {
+    MockPacket packet;
+    packet.keyframe = (enc->num_coded_frames % 3 == 0);
+    packet.frame_nr = frame_nr;
+    packet.data = mock_frame_payload(frame_nr, packet.keyframe);
+    enc->packets.push_back(packet);
+
+    enc->num_coded_frames++;
+  }
+}
+
+
+static const char* mock_get_plugin_name() { return "mock sequence encoder"; }
+
+static heif_error mock_new_encoder(void** encoder)
+{
+  *encoder = new MockEncoder();
+  return mock_ok;
+}
+
+static void mock_free_encoder(void* encoder) { delete static_cast<MockEncoder*>(encoder); }
+
+static heif_error mock_set_int(void*, int) { return mock_ok; }
+
+static heif_error mock_get_int(void*, int* value)
+{
+  *value = 0;
+  return mock_ok;
+}
+
+static const heif_encoder_parameter** mock_list_parameters(void*)
+{
+  static const heif_encoder_parameter* parameters[] = {nullptr};
+  return parameters;
+}
+
+static heif_error mock_set_named_int(void*, const char*, int) { return mock_ok; }
+
+static heif_error mock_get_named_int(void*, const char*, int* value)
+{
+  *value = 0;
+  return mock_ok;
+}
+
+static heif_error mock_set_named_string(void*, const char*, const char*) { return mock_ok; }
+
+static heif_error mock_get_named_string(void*, const char*, char* value, int value_size)
+{
+  if (value_size > 0) {
+    value[0] = 0;
+  }
+  return mock_ok;
+}
+
+static void mock_query_input_colorspace(heif_colorspace* colorspace, heif_chroma* chroma)
+{
+  *colorspace = heif_colorspace_YCbCr;
+  *chroma = heif_chroma_420;
+}
+
+static void mock_query_input_colorspace2(void*, heif_colorspace* colorspace, heif_chroma* chroma)
+{
+  mock_query_input_colorspace(colorspace, chroma);
+}
+
+static heif_error mock_encode_image(void* encoder, const heif_image*, heif_image_input_class)
+{
+  auto* enc = static_cast<MockEncoder*>(encoder);
+
+  MockPacket packet;
+  packet.keyframe = true;
+  packet.data = mock_frame_payload(static_cast<uintptr_t>(mock_num_intra_images), true);
+  enc->packets.push_back(packet);
+
+  mock_num_intra_images++;
+
+  return mock_ok;
+}
+
+static heif_error mock_get_compressed_data(void* encoder, uint8_t** data, int* size, heif_encoded_data_type*)
+{
+  auto* enc = static_cast<MockEncoder*>(encoder);
+
+  if (enc->packets.empty()) {
+    *data = nullptr;
+    *size = 0;
+    return mock_ok;
+  }
+
+  enc->current_packet = enc->packets.front();
+  enc->packets.pop_front();
+
+  *data = enc->current_packet.data.data();
+  *size = static_cast<int>(enc->current_packet.data.size());
+  return mock_ok;
+}
+
+static heif_error mock_start_sequence_encoding(void* encoder, const heif_image*, heif_image_input_class,
+                                               uint32_t, uint32_t, const heif_sequence_encoding_options*)
+{
+  auto* enc = static_cast<MockEncoder*>(encoder);
+  enc->buffered_frames.clear();
+  enc->num_coded_frames = 0;
+  return mock_ok;
+}
+
+static heif_error mock_encode_sequence_frame(void* encoder, const heif_image*, uintptr_t frame_nr)
+{
+  auto* enc = static_cast<MockEncoder*>(encoder);
+
+  enc->buffered_frames.push_back(frame_nr);
+  mock_code_frames(enc, mock_lookahead);
+
+  mock_num_sequence_frames++;
+
+  return mock_ok;
+}
+
+static heif_error mock_end_sequence_encoding(void* encoder)
+{
+  mock_code_frames(static_cast<MockEncoder*>(encoder), 0);
+  return mock_ok;
+}
+
+static heif_error mock_get_compressed_data2(void* encoder, uint8_t** data, int* size,
+                                            uintptr_t* out_frame_nr, int* out_is_keyframe, int* out_more_frame_packets)
+{
+  auto* enc = static_cast<MockEncoder*>(encoder);
+
+  if (enc->packets.empty()) {
+    *data = nullptr;
+    *size = 0;
+    return mock_ok;
+  }
+
+  enc->current_packet = enc->packets.front();
+  enc->packets.pop_front();
+
+  *data = enc->current_packet.data.data();
+  *size = static_cast<int>(enc->current_packet.data.size());
+  *out_frame_nr = enc->current_packet.frame_nr;
+  *out_is_keyframe = enc->current_packet.keyframe;
+  *out_more_frame_packets = 0;
+  return mock_ok;
+}
+
+
+static heif_encoder_plugin mock_encoder_plugin = {
+    4,
+    heif_compression_AV1,
+    "test-sequence-encoder",
+    1, // lowest priority, never selected by default
+    1,
+    0,
+    mock_get_plugin_name,
+    nullptr,
+    nullptr,
+    mock_new_encoder,
+    mock_free_encoder,
+    mock_set_int,
+    mock_get_int,
+    mock_set_int,
+    mock_get_int,
+    mock_set_int,
+    mock_get_int,
+    mock_list_parameters,
+    mock_set_named_int,
+    mock_get_named_int,
+    mock_set_named_int,
+    mock_get_named_int,
+    mock_set_named_string,
+    mock_get_named_string,
+    mock_query_input_colorspace,
+    mock_encode_image,
+    mock_get_compressed_data,
+    mock_query_input_colorspace2,
+    nullptr,
+    mock_start_sequence_encoding,
+    mock_encode_sequence_frame,
+    mock_end_sequence_encoding,
+    mock_get_compressed_data2
+};
+
+
+// --- helpers
+
+static heif_encoder* get_mock_encoder(heif_context* ctx)
+{
+  static bool registered = false;
+  if (!registered) {
+    heif_error err = heif_register_encoder_plugin(&mock_encoder_plugin);
+    REQUIRE(err.code == heif_error_Ok);
+    registered = true;
+  }
+
+  const heif_encoder_descriptor* descriptor = nullptr;
+  int n = heif_get_encoder_descriptors(heif_compression_AV1, "test-sequence-encoder", &descriptor, 1);
+  REQUIRE(n == 1);
+
+  heif_encoder* encoder = nullptr;
+  heif_error err = heif_context_get_encoder(ctx, descriptor, &encoder);
+  REQUIRE(err.code == heif_error_Ok);
+
+  return encoder;
+}
+
+
+static heif_image* create_frame(uint32_t duration)
+{
+  heif_image* img = nullptr;
+  heif_error err = heif_image_create(8, 8, heif_colorspace_YCbCr, heif_chroma_420, &img);
+  REQUIRE(err.code == heif_error_Ok);
+
+  for (heif_channel channel : {heif_channel_Y, heif_channel_Cb, heif_channel_Cr}) {
+    int size = (channel == heif_channel_Y) ? 8 : 4;
+    err = heif_image_add_plane(img, channel, size, size, 8);
+    REQUIRE(err.code == heif_error_Ok);
+
+    size_t stride;
+    uint8_t* p = heif_image_get_plane2(img, channel, &stride);
+    for (int y = 0; y < size; y++) {
+      memset(p + y * stride, 128, size);
+    }
+  }
+
+  heif_image_set_duration(img, duration);
+
+  return img;
+}
+
+
+static heif_track* add_track(heif_context* ctx)
+{
+  heif_track_options* track_options = heif_track_options_alloc();
+  heif_track_options_set_timescale(track_options, 100);
+
+  heif_track* track = nullptr;
+  heif_error err = heif_context_add_visual_sequence_track(ctx, 8, 8, heif_track_type_image_sequence,
+                                                          track_options, nullptr, &track);
+  REQUIRE(err.code == heif_error_Ok);
+
+  heif_track_options_release(track_options);
+
+  return track;
+}
+
+
+static heif_error encode_frames(heif_track* track, heif_encoder* encoder, int nFrames,
+                                const heif_sequence_encoding_options* seq_options)
+{
+  for (int i = 0; i < nFrames; i++) {
+    heif_image* img = create_frame(10 + i);
+    heif_error err = heif_track_encode_sequence_image(track, img, encoder, seq_options);
+    heif_image_release(img);
+
+    if (err.code) {
+      return err;
+    }
+  }
+
+  return mock_ok;
+}
+
+
+static heif_error write_to_memory(heif_context* ctx, std::vector<uint8_t>& out_data)
+{
+  heif_writer writer{};
+  writer.writer_api_version = 1;
+  writer.write = [](heif_context*, const void* data, size_t size, void* userdata) {
+    auto* out = static_cast<std::vector<uint8_t>*>(userdata);
+    out->insert(out->end(), static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + size);
+    return mock_ok;
+  };
+
+  out_data.clear();
+  return heif_context_write(ctx, &writer, &out_data);
+}
+
+
+struct RawSample
+{
+  std::vector<uint8_t> data;
+  uint32_t duration;
+};
+
+static std::vector<RawSample> read_raw_samples(const std::vector<uint8_t>& file)
+{
+  heif_context* ctx = heif_context_alloc();
+  heif_error err = heif_context_read_from_memory_without_copy(ctx, file.data(), file.size(), nullptr);
+  REQUIRE(err.code == heif_error_Ok);
+
+  heif_track* track = heif_context_get_track(ctx, 0);
+  REQUIRE(track != nullptr);
+
+  std::vector<RawSample> samples;
+
+  for (;;) {
+    heif_raw_sequence_sample* sample = nullptr;
+    err = heif_track_get_next_raw_sequence_sample(track, &sample);
+    if (err.code == heif_error_End_of_sequence) {
+      break;
+    }
+    REQUIRE(err.code == heif_error_Ok);
+
+    size_t size;
+    const uint8_t* data = heif_raw_sequence_sample_get_data(sample, &size);
+    samples.push_back({std::vector<uint8_t>(data, data + size), heif_raw_sequence_sample_get_duration(sample)});
+
+    heif_raw_sequence_sample_release(sample);
+  }
+
+  heif_track_release(track);
+  heif_context_free(ctx);
+
+  return samples;
+}
+
+
+// --- tests
+
+TEST_CASE("Intra-only sequence encoding is the default")
+{
+  mock_num_intra_images = 0;
+  mock_num_sequence_frames = 0;
+
+  heif_context* ctx = heif_context_alloc();
+  heif_encoder* encoder = get_mock_encoder(ctx);
+  heif_track* track = add_track(ctx);
+
+  heif_error err = encode_frames(track, encoder, 5, nullptr);
+  REQUIRE(err.code == heif_error_Ok);
+
+  REQUIRE(mock_num_intra_images == 5);
+  REQUIRE(mock_num_sequence_frames == 0);
+
+  // no heif_track_encode_end_of_sequence() needed
+  std::vector<uint8_t> file;
+  err = write_to_memory(ctx, file);
+  REQUIRE(err.code == heif_error_Ok);
+
+  heif_track_release(track);
+  heif_encoder_release(encoder);
+  heif_context_free(ctx);
+
+  auto samples = read_raw_samples(file);
+  REQUIRE(samples.size() == 5);
+  for (size_t i = 0; i < samples.size(); i++) {
+    REQUIRE(samples[i].data == mock_frame_payload(i, true));
+    REQUIRE(samples[i].duration == 10 + i);
+  }
+}
+
+
+TEST_CASE("Low-delay sequence encoding with lookahead")
+{
+  const int nFrames = 7;
+
+  mock_num_intra_images = 0;
+  mock_num_sequence_frames = 0;
+
+  heif_context* ctx = heif_context_alloc();
+  heif_encoder* encoder = get_mock_encoder(ctx);
+  heif_track* track = add_track(ctx);
+
+  heif_sequence_encoding_options* seq_options = heif_sequence_encoding_options_alloc();
+  REQUIRE(seq_options->gop_structure == heif_sequence_gop_structure_intra_only);
+  seq_options->gop_structure = heif_sequence_gop_structure_lowdelay;
+
+  heif_error err = encode_frames(track, encoder, nFrames, seq_options);
+  REQUIRE(err.code == heif_error_Ok);
+
+  REQUIRE(mock_num_intra_images == 0);
+  REQUIRE(mock_num_sequence_frames == nFrames);
+
+  std::vector<uint8_t> file;
+
+  SECTION("Writing fails while frames are buffered in the encoder") {
+    err = write_to_memory(ctx, file);
+    REQUIRE(err.code == heif_error_Usage_error);
+  }
+
+  SECTION("Buffered frames are written after the end of the sequence") {
+    err = heif_track_encode_end_of_sequence(track, encoder);
+    REQUIRE(err.code == heif_error_Ok);
+
+    err = write_to_memory(ctx, file);
+    REQUIRE(err.code == heif_error_Ok);
+
+    auto samples = read_raw_samples(file);
+    REQUIRE(samples.size() == nFrames);
+    for (size_t i = 0; i < samples.size(); i++) {
+      REQUIRE(samples[i].data == mock_frame_payload(i, i % 3 == 0));
+      REQUIRE(samples[i].duration == 10 + i);
+    }
+  }
+
+  heif_sequence_encoding_options_release(seq_options);
+  heif_track_release(track);
+  heif_encoder_release(encoder);
+  heif_context_free(ctx);
+}
+
+
+TEST_CASE("Encoder plugin returning frames out of order")
+{
+  mock_reorder_frames = true;
+
+  heif_context* ctx = heif_context_alloc();
+  heif_encoder* encoder = get_mock_encoder(ctx);
+  heif_track* track = add_track(ctx);
+
+  heif_sequence_encoding_options* seq_options = heif_sequence_encoding_options_alloc();
+  seq_options->gop_structure = heif_sequence_gop_structure_lowdelay;
+
+  heif_error err = encode_frames(track, encoder, 4, seq_options);
+  if (err.code == heif_error_Ok) {
+    err = heif_track_encode_end_of_sequence(track, encoder);
+  }
+
+  REQUIRE(err.code == heif_error_Encoder_plugin_error);
+
+  mock_reorder_frames = false;
+
+  heif_sequence_encoding_options_release(seq_options);
+  heif_track_release(track);
+  heif_encoder_release(encoder);
+  heif_context_free(ctx);
+}
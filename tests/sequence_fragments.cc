@@ -0,0 +1,595 @@
+/*
+  libheif unit tests for reading fragmented sequences and 'co64' chunk offsets
+
+  MIT License
+
+  Copyright (c) 2025 Dirk Farin <dirk.farin@gmail.com>
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#include "catch_amalgamated.hpp"
+#include "libheif/heif.h"
+#include "libheif/heif_sequences.h"
+#include "bitstream.h"
+#include "box.h"
+#include "sequences/seq_boxes.h"
+#include <cstring>
+#include <memory>
+#include <vector>
+
+
+static const int kNumFrames = 7;
+static const int kFrameSize = 16;
+static const uint32_t kFrameDuration = 10;
+
+
+static heif_error write_to_vector(heif_context*, const void* data, size_t size, void* userdata)
+{
+  auto* out = (std::vector<uint8_t>*) userdata;
+  out->insert(out->end(), (const uint8_t*) data, (const uint8_t*) data + size);
+  return heif_error_success;
+}
+
+
+// Writes a fragmented 'unci' sequence with one frame per fragment. Frame i is filled with the value 17*i.
+static std::vector<uint8_t> encode_fragmented_sequence()
+{
+  heif_context* ctx = heif_context_alloc();
+
+  heif_encoder* encoder;
+  heif_error err = heif_context_get_encoder_for_format(ctx, heif_compression_uncompressed, &encoder);
+  REQUIRE(err.code == heif_error_Ok);
+
+  heif_track_options* track_options = heif_track_options_alloc();
+  heif_track_options_set_timescale(track_options, 100);
+
+  heif_track* track = nullptr;
+  err = heif_context_add_visual_sequence_track(ctx, kFrameSize, kFrameSize, heif_track_type_image_sequence,
+                                               track_options, nullptr, &track);
+  REQUIRE(err.code == heif_error_Ok);
+  heif_track_options_release(track_options);
+
+  std::vector<uint8_t> data;
+  heif_writer writer{};
+  writer.writer_api_version = 1;
+  writer.write = write_to_vector;
+
+  err = heif_context_start_fragmented_writing(ctx, &writer, &data, 1);
+  REQUIRE(err.code == heif_error_Ok);
+
+  for (int i = 0; i < kNumFrames; i++) {
+    heif_image* img;
+    err = heif_image_create(kFrameSize, kFrameSize, heif_colorspace_monochrome, heif_chroma_monochrome, &img);
+    REQUIRE(err.code == heif_error_Ok);
+    err = heif_image_add_plane(img, heif_channel_Y, kFrameSize, kFrameSize, 8);
+    REQUIRE(err.code == heif_error_Ok);
+
+    size_t stride;
+    uint8_t* p = heif_image_get_plane2(img, heif_channel_Y, &stride);
+    for (int y = 0; y < kFrameSize; y++) {
+      memset(p + y * stride, 17 * i, kFrameSize);
+    }
+
+    heif_image_set_duration(img, kFrameDuration);
+
+    err = heif_track_encode_sequence_image(track, img, encoder, nullptr);
+    REQUIRE(err.code == heif_error_Ok);
+    heif_image_release(img);
+  }
+
+  heif_track_release(track);
+  heif_encoder_release(encoder);
+
+  err = heif_context_end_fragmented_writing(ctx);
+  REQUIRE(err.code == heif_error_Ok);
+  heif_context_free(ctx);
+
+  return data;
+}
+
+
+static uint32_t read32(const std::vector<uint8_t>& data, size_t pos)
+{
+  return (uint32_t(data[pos]) << 24) | (uint32_t(data[pos + 1]) << 16) | (uint32_t(data[pos + 2]) << 8) | data[pos + 3];
+}
+
+static void write32(std::vector<uint8_t>& data, size_t pos, uint32_t value)
+{
+  data[pos] = (uint8_t) (value >> 24);
+  data[pos + 1] = (uint8_t) (value >> 16);
+  data[pos + 2] = (uint8_t) (value >> 8);
+  data[pos + 3] = (uint8_t) value;
+}
+
+
+struct GeneratedFile
+{
+  std::vector<uint8_t> header;   // everything before the first 'moof'
+  size_t trex_pos = 0;           // position of the 'trex' box type in 'header'
+  uint32_t track_id = 0;
+
+  struct Fragment
+  {
+    std::vector<uint32_t> sample_sizes;
+    std::vector<uint8_t> mdat_payload;
+  };
+
+  std::vector<Fragment> fragments;
+};
+
+
+static GeneratedFile split_fragmented_file(const std::vector<uint8_t>& data)
+{
+  GeneratedFile file;
+
+  for (size_t pos = 0; pos + 8 <= data.size();) {
+    uint32_t size = read32(data, pos);
+    REQUIRE(size >= 8);
+    REQUIRE(pos + size <= data.size());
+    std::string type((const char*) &data[pos + 4], 4);
+
+    if (type == "moof") {
+      auto reader = std::make_shared<StreamReader_memory>(data.data() + pos, size, false);
+      BitstreamRange range(reader, size);
+      std::shared_ptr<Box> box;
+      REQUIRE(Box::read(range, &box, heif_get_global_security_limits()) == Error::Ok);
+
+      GeneratedFile::Fragment fragment;
+      auto moof = std::dynamic_pointer_cast<Box_moof>(box);
+      REQUIRE(moof);
+      for (const auto& traf : moof->get_child_boxes<Box_traf>()) {
+        for (const auto& trun : traf->get_child_boxes<Box_trun>()) {
+          for (const auto& sample : trun->get_samples()) {
+            REQUIRE(sample.duration == kFrameDuration);
+            fragment.sample_sizes.push_back(sample.size);
+          }
+        }
+      }
+
+      file.fragments.push_back(fragment);
+    }
+    else if (type == "mdat") {
+      REQUIRE(!file.fragments.empty());
+      file.fragments.back().mdat_payload.assign(data.begin() + pos + 8, data.begin() + pos + size);
+    }
+    else {
+      REQUIRE(file.fragments.empty());
+      file.header.insert(file.header.end(), data.begin() + pos, data.begin() + pos + size);
+    }
+
+    pos += size;
+  }
+
+  for (size_t pos = 0; pos + 4 <= file.header.size(); pos++) {
+    if (memcmp(&file.header[pos], "trex", 4) == 0) {
+      file.trex_pos = pos;
+    }
+  }
+
+  REQUIRE(file.trex_pos != 0);
+  file.track_id = read32(file.header, file.trex_pos + 8);
+
+  return file;
+}
+
+
+// Minimal box writer for building 'moof' boxes with field combinations that libheif does not write itself.
+class BoxBuilder
+{
+public:
+  std::vector<uint8_t> data;
+
+  void u32(uint32_t v)
+  {
+    data.resize(data.size() + 4);
+    write32(data, data.size() - 4, v);
+  }
+
+  size_t begin_box(const char* type)
+  {
+    size_t start = data.size();
+    u32(0);
+    data.insert(data.end(), type, type + 4);
+    return start;
+  }
+
+  size_t begin_full_box(const char* type, uint32_t flags)
+  {
+    size_t start = begin_box(type);
+    u32(flags); // version 0
+    return start;
+  }
+
+  void end_box(size_t start) { write32(data, start, (uint32_t) (data.size() - start)); }
+};
+
+
+struct Run
+{
+  uint32_t flags;
+  std::vector<uint32_t> sample_sizes;
+  std::vector<uint32_t> sample_flags; // only with Box_trun::Flags::Sample_flags_present
+};
+
+// Writes a 'traf' with the given 'tfhd' fields. Returns the positions of the trun data offsets that have to be patched.
+static std::vector<size_t> write_traf(BoxBuilder& moof, uint32_t track_id, uint32_t tfhd_flags,
+                                      uint32_t default_duration, uint32_t default_size,
+                                      const std::vector<Run>& runs)
+{
+  std::vector<size_t> data_offset_positions;
+
+  size_t traf = moof.begin_box("traf");
+
+  size_t tfhd = moof.begin_full_box("tfhd", tfhd_flags);
+  moof.u32(track_id);
+  if (tfhd_flags & Box_tfhd::Flags::Default_sample_duration_present) {
+    moof.u32(default_duration);
+  }
+  if (tfhd_flags & Box_tfhd::Flags::Default_sample_size_present) {
+    moof.u32(default_size);
+  }
+  moof.end_box(tfhd);
+
+  for (const auto& run : runs) {
+    size_t trun = moof.begin_full_box("trun", run.flags);
+    moof.u32((uint32_t) run.sample_sizes.size());
+    if (run.flags & Box_trun::Flags::Data_offset_present) {
+      data_offset_positions.push_back(moof.data.size());
+      moof.u32(0);
+    }
+    for (size_t i = 0; i < run.sample_sizes.size(); i++) {
+      if (run.flags & Box_trun::Flags::Sample_duration_present) {
+        moof.u32(kFrameDuration);
+      }
+      if (run.flags & Box_trun::Flags::Sample_size_present) {
+        moof.u32(run.sample_sizes[i]);
+      }
+      if (run.flags & Box_trun::Flags::Sample_flags_present) {
+        moof.u32(run.sample_flags[i]);
+      }
+    }
+    moof.end_box(trun);
+  }
+
+  moof.end_box(traf);
+
+  return data_offset_positions;
+}
+
+
+// Appends 'moof' + 'mdat'. The patched data offsets point to the start of the 'mdat' payload plus the given offsets.
+static void append_fragment(std::vector<uint8_t>& out, BoxBuilder& moof, size_t moof_start,
+                            const std::vector<std::pair<size_t, uint32_t>>& data_offsets,
+                            const std::vector<uint8_t>& mdat_payload)
+{
+  moof.end_box(moof_start);
+
+  for (const auto& offset : data_offsets) {
+    write32(moof.data, offset.first, (uint32_t) (moof.data.size() + 8 + offset.second));
+  }
+
+  out.insert(out.end(), moof.data.begin(), moof.data.end());
+
+  BoxBuilder mdat;
+  size_t mdat_start = mdat.begin_box("mdat");
+  mdat.data.insert(mdat.data.end(), mdat_payload.begin(), mdat_payload.end());
+  mdat.end_box(mdat_start);
+  out.insert(out.end(), mdat.data.begin(), mdat.data.end());
+}
+
+
+static void check_decoded_sequence(const std::vector<uint8_t>& data)
+{
+  heif_context* ctx = heif_context_alloc();
+  heif_error err = heif_context_read_from_memory_without_copy(ctx, data.data(), data.size(), nullptr);
+  REQUIRE(err.code == heif_error_Ok);
+
+  heif_track* track = heif_context_get_track(ctx, 0);
+  REQUIRE(track != nullptr);
+
+  for (int seek_to : {0, 4}) {
+    err = heif_track_seek_to_sample(track, (uint64_t) seek_to);
+    REQUIRE(err.code == heif_error_Ok);
+
+    int frame_nr = seek_to;
+    for (;; frame_nr++) {
+      heif_image* img = nullptr;
+      err = heif_track_decode_next_image(track, &img, heif_colorspace_monochrome, heif_chroma_monochrome, nullptr);
+      if (err.code == heif_error_End_of_sequence) {
+        break;
+      }
+      REQUIRE(err.code == heif_error_Ok);
+      REQUIRE(heif_image_get_duration(img) == kFrameDuration);
+
+      size_t stride;
+      const uint8_t* p = heif_image_get_plane_readonly2(img, heif_channel_Y, &stride);
+      REQUIRE(p[0] == (uint8_t) (17 * frame_nr));
+      REQUIRE(p[(kFrameSize - 1) * stride + kFrameSize - 1] == (uint8_t) (17 * frame_nr));
+      heif_image_release(img);
+    }
+
+    REQUIRE(frame_nr == kNumFrames);
+  }
+
+  heif_track_release(track);
+  heif_context_free(ctx);
+}
+
+
+TEST_CASE("Fragment sample fields from trex and tfhd defaults")
+{
+  GeneratedFile file = split_fragmented_file(encode_fragmented_sequence());
+  REQUIRE(file.fragments.size() == kNumFrames);
+
+  uint32_t sample_size = file.fragments[0].sample_sizes[0];
+
+  SECTION("trex defaults") {
+    std::vector<uint8_t> out = file.header;
+    write32(out, file.trex_pos + 16, kFrameDuration);
+    write32(out, file.trex_pos + 20, sample_size);
+    write32(out, file.trex_pos + 24, SampleFlags_depends_on_no_other);
+
+    for (const auto& fragment : file.fragments) {
+      BoxBuilder moof;
+      size_t moof_start = moof.begin_box("moof");
+      auto offsets = write_traf(moof, file.track_id, Box_tfhd::Flags::Default_base_is_moof, 0, 0,
+                                {{Box_trun::Flags::Data_offset_present, fragment.sample_sizes}});
+      append_fragment(out, moof, moof_start, {{offsets[0], 0}}, fragment.mdat_payload);
+    }
+
+    check_decoded_sequence(out);
+  }
+
+  SECTION("tfhd defaults override trex") {
+    std::vector<uint8_t> out = file.header;
+    write32(out, file.trex_pos + 16, 1);
+    write32(out, file.trex_pos + 20, 1);
+
+    for (const auto& fragment : file.fragments) {
+      BoxBuilder moof;
+      size_t moof_start = moof.begin_box("moof");
+      auto offsets = write_traf(moof, file.track_id,
+                                Box_tfhd::Flags::Default_base_is_moof |
+                                Box_tfhd::Flags::Default_sample_duration_present |
+                                Box_tfhd::Flags::Default_sample_size_present,
+                                kFrameDuration, sample_size,
+                                {{Box_trun::Flags::Data_offset_present, fragment.sample_sizes}});
+      append_fragment(out, moof, moof_start, {{offsets[0], 0}}, fragment.mdat_payload);
+    }
+
+    check_decoded_sequence(out);
+  }
+}
+
+
+TEST_CASE("Fragments with multiple track runs")
+{
+  // Merge all samples into two fragments, each with one 'trun' per sample.
+
+  GeneratedFile file = split_fragmented_file(encode_fragmented_sequence());
+
+  std::vector<uint8_t> out = file.header;
+
+  const uint32_t sample_fields = Box_trun::Flags::Sample_duration_present | Box_trun::Flags::Sample_size_present;
+
+  for (size_t first : {size_t{0}, size_t{3}}) {
+    size_t end = (first == 0 ? 3 : file.fragments.size());
+
+    std::vector<Run> runs;
+    std::vector<uint8_t> payload;
+    for (size_t i = first; i < end; i++) {
+      // Only the first run has a data offset. The other runs continue after the previous run.
+      runs.push_back({(i == first ? Box_trun::Flags::Data_offset_present : 0) | sample_fields,
+                      file.fragments[i].sample_sizes});
+      payload.insert(payload.end(), file.fragments[i].mdat_payload.begin(), file.fragments[i].mdat_payload.end());
+    }
+
+    BoxBuilder moof;
+    size_t moof_start = moof.begin_box("moof");
+    auto offsets = write_traf(moof, file.track_id, Box_tfhd::Flags::Default_base_is_moof, 0, 0, runs);
+    REQUIRE(offsets.size() == 1);
+    append_fragment(out, moof, moof_start, {{offsets[0], 0}}, payload);
+  }
+
+  check_decoded_sequence(out);
+}
+
+
+TEST_CASE("Track fragment data follows the previous track fragment")
+{
+  // Each 'moof' starts with a 'traf' of another track. Our 'traf' has neither a base offset nor a data offset,
+  // hence its data starts at the end of the data of the other track.
+
+  GeneratedFile file = split_fragmented_file(encode_fragmented_sequence());
+
+  const uint32_t other_track_data_size = 37;
+  const uint32_t other_track_id = file.track_id + 100;
+
+  std::vector<uint8_t> out = file.header;
+
+  for (const auto& fragment : file.fragments) {
+    BoxBuilder moof;
+    size_t moof_start = moof.begin_box("moof");
+
+    auto offsets = write_traf(moof, other_track_id, 0, 0, 0,
+                              {{Box_trun::Flags::Data_offset_present | Box_trun::Flags::Sample_size_present,
+                                {other_track_data_size}}});
+
+    write_traf(moof, file.track_id,
+               Box_tfhd::Flags::Default_sample_duration_present | Box_tfhd::Flags::Default_sample_size_present,
+               kFrameDuration, fragment.sample_sizes[0],
+               {{0, fragment.sample_sizes}});
+
+    std::vector<uint8_t> payload(other_track_data_size, 0xEE);
+    payload.insert(payload.end(), fragment.mdat_payload.begin(), fragment.mdat_payload.end());
+
+    append_fragment(out, moof, moof_start, {{offsets[0], 0}}, payload);
+  }
+
+  check_decoded_sequence(out);
+}
+
+
+// Decodes the frame after seeking to 'sample'. Returns the error of heif_track_decode_next_image().
+static heif_error_code decode_after_seek(heif_track* track, int sample)
+{
+  heif_error err = heif_track_seek_to_sample(track, (uint64_t) sample);
+  REQUIRE(err.code == heif_error_Ok);
+
+  heif_image* img = nullptr;
+  err = heif_track_decode_next_image(track, &img, heif_colorspace_monochrome, heif_chroma_monochrome, nullptr);
+  if (err.code != heif_error_Ok) {
+    return err.code;
+  }
+
+  size_t stride;
+  const uint8_t* p = heif_image_get_plane_readonly2(img, heif_channel_Y, &stride);
+  REQUIRE(p[0] == (uint8_t) (17 * sample));
+  heif_image_release(img);
+
+  return heif_error_Ok;
+}
+
+
+TEST_CASE("Seek to non-sync samples")
+{
+  // All samples in one fragment. Only samples 0, 3 and 6 are sync samples.
+
+  GeneratedFile file = split_fragmented_file(encode_fragmented_sequence());
+
+  const uint32_t sync = SampleFlags_depends_on_no_other;
+  const uint32_t non_sync = SampleFlags_depends_on_others | SampleFlags_is_non_sync_sample;
+  const std::vector<uint32_t> sample_flags{sync, non_sync, non_sync, sync, non_sync, non_sync, sync};
+  REQUIRE(sample_flags.size() == kNumFrames);
+
+  const uint32_t run_flags = Box_trun::Flags::Data_offset_present | Box_trun::Flags::Sample_size_present |
+                             Box_trun::Flags::Sample_flags_present;
+
+  // With 'corrupt_sync_sample', the data of sync sample 3 is truncated such that it cannot be decoded.
+  auto build_file = [&](bool corrupt_sync_sample) {
+    Run run{run_flags, {}, sample_flags};
+    std::vector<uint8_t> payload;
+    for (int i = 0; i < kNumFrames; i++) {
+      const auto& fragment = file.fragments[i];
+      size_t size = (corrupt_sync_sample && i == 3) ? fragment.mdat_payload.size() / 2 : fragment.mdat_payload.size();
+      run.sample_sizes.push_back((uint32_t) size);
+      payload.insert(payload.end(), fragment.mdat_payload.begin(), fragment.mdat_payload.begin() + size);
+    }
+
+    std::vector<uint8_t> out = file.header;
+    BoxBuilder moof;
+    size_t moof_start = moof.begin_box("moof");
+    auto offsets = write_traf(moof, file.track_id,
+                              Box_tfhd::Flags::Default_base_is_moof | Box_tfhd::Flags::Default_sample_duration_present,
+                              kFrameDuration, 0, {run});
+    append_fragment(out, moof, moof_start, {{offsets[0], 0}}, payload);
+    return out;
+  };
+
+  SECTION("every sample can be reached") {
+    std::vector<uint8_t> data = build_file(false);
+    check_decoded_sequence(data);
+
+    heif_context* ctx = heif_context_alloc();
+    heif_error err = heif_context_read_from_memory_without_copy(ctx, data.data(), data.size(), nullptr);
+    REQUIRE(err.code == heif_error_Ok);
+    heif_track* track = heif_context_get_track(ctx, 0);
+    REQUIRE(track != nullptr);
+
+    // also seek backwards, into the middle of a group of pictures
+    for (int sample : {5, 1, 4, 2, 6, 0}) {
+      REQUIRE(decode_after_seek(track, sample) == heif_error_Ok);
+    }
+
+    heif_track_release(track);
+    heif_context_free(ctx);
+  }
+
+  SECTION("decoding starts at the preceding sync sample") {
+    std::vector<uint8_t> data = build_file(true);
+
+    heif_context* ctx = heif_context_alloc();
+    heif_error err = heif_context_read_from_memory_without_copy(ctx, data.data(), data.size(), nullptr);
+    REQUIRE(err.code == heif_error_Ok);
+    heif_track* track = heif_context_get_track(ctx, 0);
+    REQUIRE(track != nullptr);
+
+    // Samples 4 and 5 depend on the broken sync sample 3. The other samples do not need it.
+    REQUIRE(decode_after_seek(track, 3) != heif_error_Ok);
+    REQUIRE(decode_after_seek(track, 2) == heif_error_Ok);
+    REQUIRE(decode_after_seek(track, 4) != heif_error_Ok);
+    REQUIRE(decode_after_seek(track, 5) != heif_error_Ok);
+    REQUIRE(decode_after_seek(track, 6) == heif_error_Ok);
+
+    heif_track_release(track);
+    heif_context_free(ctx);
+  }
+}
+
+
+TEST_CASE("co64 chunk offsets")
+{
+  for (uint64_t large_offset : {uint64_t{0x1000}, uint64_t{0x123456789}}) {
+    Box_stco stco;
+    stco.add_chunk_offset(0x10);
+    stco.add_chunk_offset(large_offset);
+    stco.derive_box_version();
+
+    bool expect_co64 = large_offset > 0xFFFFFFFF;
+    REQUIRE(stco.get_short_type() == fourcc(expect_co64 ? "co64" : "stco"));
+
+    StreamWriter writer;
+    REQUIRE(stco.write(writer) == Error::Ok);
+
+    // the offsets are relative to the 'mdat' and are patched when its position is known
+    stco.patch_file_pointers(writer, 100);
+
+    std::vector<uint8_t> data = writer.get_data();
+    REQUIRE(std::string((const char*) &data[4], 4) == (expect_co64 ? "co64" : "stco"));
+
+    auto reader = std::make_shared<StreamReader_memory>(data.data(), data.size(), false);
+    BitstreamRange range(reader, data.size());
+    std::shared_ptr<Box> box;
+    REQUIRE(Box::read(range, &box, heif_get_global_security_limits()) == Error::Ok);
+
+    auto parsed = std::dynamic_pointer_cast<Box_stco>(box);
+    REQUIRE(parsed);
+    REQUIRE(parsed->get_short_type() == fourcc(expect_co64 ? "co64" : "stco"));
+    REQUIRE(parsed->get_offsets() == std::vector<uint64_t>{0x10 + 100, large_offset + 100});
+  }
+}
+
+
+TEST_CASE("Fragmented writing with null arguments")
+{
+  heif_writer writer{};
+  writer.writer_api_version = 1;
+  writer.write = write_to_vector;
+  std::vector<uint8_t> data;
+
+  REQUIRE(heif_context_start_fragmented_writing(nullptr, &writer, &data, 1).code == heif_error_Usage_error);
+  REQUIRE(heif_context_start_fragmented_writing_to_file(nullptr, "fragmented.heif", 1).code == heif_error_Usage_error);
+  REQUIRE(heif_context_end_fragmented_writing(nullptr).code == heif_error_Usage_error);
+
+  heif_context* ctx = heif_context_alloc();
+  REQUIRE(heif_context_start_fragmented_writing(ctx, nullptr, nullptr, 1).code == heif_error_Usage_error);
+  REQUIRE(heif_context_start_fragmented_writing_to_file(ctx, nullptr, 1).code == heif_error_Usage_error);
+  heif_context_free(ctx);
+}
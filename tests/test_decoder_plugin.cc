@@ -0,0 +1,97 @@
+/*
+  Minimal decoder plugin for the plugin loading tests
+
+  MIT License
+
+  Copyright (c) 2025 Dirk Farin <dirk.farin@gmail.com>
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+
+#include "libheif/heif.h"
+#include "libheif/heif_plugin.h"
+#include <cstdlib>
+#include <string>
+
+// Counts its initializations in the environment variable HEIF_TEST_PLUGIN_INIT_COUNT,
+// because the plugin state is lost when the plugin is unloaded.
+
+static const char* test_plugin_name()
+{
+  return "libheif test plugin";
+}
+
+static void test_init_plugin()
+{
+  const char* count = getenv("HEIF_TEST_PLUGIN_INIT_COUNT");
+  std::string new_count = std::to_string((count ? atoi(count) : 0) + 1);
+  setenv("HEIF_TEST_PLUGIN_INIT_COUNT", new_count.c_str(), 1);
+}
+
+static void test_deinit_plugin()
+{
+}
+
+static int test_does_support_format(heif_compression_format format)
+{
+  return format == heif_compression_EVC ? 100 : 0;
+}
+
+static heif_error test_new_decoder(void** decoder)
+{
+  *decoder = nullptr;
+  return {heif_error_Unsupported_feature, heif_suberror_Unspecified, "test plugin cannot decode"};
+}
+
+static void test_free_decoder(void*)
+{
+}
+
+static heif_error test_push_data(void*, const void*, size_t)
+{
+  return {heif_error_Unsupported_feature, heif_suberror_Unspecified, "test plugin cannot decode"};
+}
+
+static heif_error test_decode_image(void*, heif_image**)
+{
+  return {heif_error_Unsupported_feature, heif_suberror_Unspecified, "test plugin cannot decode"};
+}
+
+static const heif_decoder_plugin test_decoder_plugin{
+    1,
+    test_plugin_name,
+    test_init_plugin,
+    test_deinit_plugin,
+    test_does_support_format,
+    test_new_decoder,
+    test_free_decoder,
+    test_push_data,
+    test_decode_image
+};
+
+extern "C" {
+LIBHEIF_API extern heif_plugin_info plugin_info;
+}
+
+heif_plugin_info plugin_info{
+    1,
+    heif_plugin_type_decoder,
+    &test_decoder_plugin
+};
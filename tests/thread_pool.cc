@@ -0,0 +1,221 @@
+/*
+  libheif tests for the shared thread pool
+
+  MIT License
+
+  Copyright (c) 2025 Dirk Farin <dirk.farin@gmail.com>
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+*/
+
+#include "catch_amalgamated.hpp"
+#include "libheif/heif.h"
+#include "libheif/heif_plugin.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+
+static void init_with_worker_threads(int num_worker_threads)
+{
+  heif_init_params params{};
+  params.version = 2;
+  params.num_worker_threads = num_worker_threads;
+
+  heif_error err = heif_init(&params);
+  REQUIRE(err.code == heif_error_Ok);
+}
+
+
+static void increment(void* data)
+{
+  (*(std::atomic<int>*) data)++;
+}
+
+
+TEST_CASE("Task group runs all tasks")
+{
+  init_with_worker_threads(3);
+
+  std::atomic<int> counter{0};
+
+  heif_task_group* group = heif_task_group_alloc();
+  for (int i = 0; i < 100; i++) {
+    heif_task_group_submit(group, increment, &counter);
+  }
+
+  heif_task_group_wait(group);
+  REQUIRE(counter == 100);
+
+  // the group can be reused after waiting
+
+  heif_task_group_submit(group, increment, &counter);
+  heif_task_group_free(group);
+  REQUIRE(counter == 101);
+
+  heif_deinit();
+}
+
+
+struct nested_task
+{
+  std::atomic<int>* counter;
+};
+
+static void submit_and_wait_for_subtasks(void* data)
+{
+  auto* task = (nested_task*) data;
+
+  heif_task_group* group = heif_task_group_alloc();
+  for (int i = 0; i < 10; i++) {
+    heif_task_group_submit(group, increment, task->counter);
+  }
+
+  heif_task_group_wait(group);
+  heif_task_group_free(group);
+}
+
+
+TEST_CASE("Tasks can wait for their own subtasks")
+{
+  // More waiting tasks than worker threads. The waiting threads have to run the queued subtasks.
+  init_with_worker_threads(2);
+
+  std::atomic<int> counter{0};
+  nested_task task{&counter};
+
+  heif_task_group* group = heif_task_group_alloc();
+  for (int i = 0; i < 8; i++) {
+    heif_task_group_submit(group, submit_and_wait_for_subtasks, &task);
+  }
+
+  heif_task_group_wait(group);
+  heif_task_group_free(group);
+
+  REQUIRE(counter == 80);
+
+  heif_deinit();
+}
+
+
+struct blocking_task
+{
+  std::atomic<int> started{0};
+  std::atomic<bool> release{false};
+};
+
+static void block_until_released(void* data)
+{
+  auto* task = (blocking_task*) data;
+  task->started++;
+
+  while (!task->release) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+
+TEST_CASE("Recommended plugin thread count")
+{
+  // without configured pool size, the codec libraries keep their own default
+
+  heif_init(nullptr);
+  REQUIRE(heif_get_recommended_plugin_thread_count() == 0);
+  heif_deinit();
+
+  init_with_worker_threads(3);
+  REQUIRE(heif_get_recommended_plugin_thread_count() == 3);
+
+  // A busy pool does not reduce the count for callers outside of the pool.
+
+  blocking_task task;
+
+  heif_task_group* group = heif_task_group_alloc();
+  heif_task_group_submit(group, block_until_released, &task);
+  heif_task_group_submit(group, block_until_released, &task);
+
+  while (task.started < 2) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  REQUIRE(heif_get_recommended_plugin_thread_count() == 3);
+
+  task.release = true;
+  heif_task_group_free(group);
+
+  heif_deinit();
+}
+
+
+static void query_recommended_thread_count(void* data)
+{
+  *(int*) data = heif_get_recommended_plugin_thread_count();
+}
+
+
+TEST_CASE("Plugins called from pool tasks run single-threaded")
+{
+  init_with_worker_threads(3);
+
+  int thread_count = 0;
+
+  heif_task_group* group = heif_task_group_alloc();
+  heif_task_group_submit(group, query_recommended_thread_count, &thread_count);
+  heif_task_group_free(group);
+
+  REQUIRE(thread_count == 1);
+
+  heif_deinit();
+}
+
+
+TEST_CASE("Waiting does not run tasks of other groups")
+{
+  init_with_worker_threads(1);
+
+  blocking_task task;
+  std::atomic<int> other_counter{0};
+  std::atomic<int> own_counter{0};
+
+  // occupy the only worker thread and queue a task behind it
+
+  heif_task_group* other_group = heif_task_group_alloc();
+  heif_task_group_submit(other_group, block_until_released, &task);
+
+  while (task.started < 1) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  heif_task_group_submit(other_group, increment, &other_counter);
+
+  heif_task_group* own_group = heif_task_group_alloc();
+  heif_task_group_submit(own_group, increment, &own_counter);
+  heif_task_group_wait(own_group);
+
+  REQUIRE(own_counter == 1);
+  REQUIRE(other_counter == 0);
+
+  task.release = true;
+  heif_task_group_free(other_group);
+  heif_task_group_free(own_group);
+
+  REQUIRE(other_counter == 1);
+
+  heif_deinit();
+}
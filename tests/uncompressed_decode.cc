@@ -25,11 +25,14 @@
 */
 #include "catch_amalgamated.hpp"
 #include "libheif/heif.h"
+#include "libheif/heif_tracing.h"
 #include "api_structs.h"
 #include <cstdint>
 #include <stdio.h>
 #include "test_utils.h"
 #include <string.h>
+#include <string>
+#include <vector>
 
 #include "uncompressed_decode.h"
 
@@ -167,3 +170,295 @@ TEST_CASE("check uncompressed is advertised") {
   REQUIRE(heif_have_decoder_for_format(heif_compression_uncompressed));
 }
 
+
+static heif_image* decode_primary_image_with_threads(const std::string& file, int max_threads)
+{
+  auto context = get_context_for_test_file(file);
+  heif_context_set_max_decoding_threads(context, max_threads);
+
+  heif_image_handle *handle = get_primary_image_handle(context);
+  heif_image* img;
+  heif_error err = heif_decode_image(handle, &img, heif_colorspace_undefined, heif_chroma_undefined, NULL);
+  REQUIRE(err.code == heif_error_Ok);
+
+  heif_image_handle_release(handle);
+  heif_context_free(context);
+  return img;
+}
+
+TEST_CASE("check parallel tile decoding matches sequential decoding") {
+  auto file = GENERATE(FILES, MONO_FILES, YUV_FILES);
+  INFO("file name: " << file);
+
+  heif_image* img_sequential = decode_primary_image_with_threads(file, 0);
+  heif_image* img_parallel = decode_primary_image_with_threads(file, 8);
+
+  for (heif_channel channel : {heif_channel_Y, heif_channel_Cb, heif_channel_Cr,
+                               heif_channel_R, heif_channel_G, heif_channel_B,
+                               heif_channel_Alpha, heif_channel_interleaved}) {
+    REQUIRE(heif_image_has_channel(img_sequential, channel) == heif_image_has_channel(img_parallel, channel));
+    if (!heif_image_has_channel(img_sequential, channel)) {
+      continue;
+    }
+
+    size_t stride_sequential, stride_parallel;
+    const uint8_t* p_sequential = heif_image_get_plane_readonly2(img_sequential, channel, &stride_sequential);
+    const uint8_t* p_parallel = heif_image_get_plane_readonly2(img_parallel, channel, &stride_parallel);
+
+    int width = heif_image_get_width(img_sequential, channel);
+    int height = heif_image_get_height(img_sequential, channel);
+    int bytes_per_sample = (heif_image_get_bits_per_pixel(img_sequential, channel) + 7) / 8;
+
+    for (int y = 0; y < height; y++) {
+      REQUIRE(memcmp(p_sequential + y * stride_sequential,
+                     p_parallel + y * stride_parallel,
+                     width * bytes_per_sample) == 0);
+    }
+  }
+
+  heif_image_release(img_sequential);
+  heif_image_release(img_parallel);
+}
+
+
+struct trace_result
+{
+  int num_calls = 0;
+  heif_trace_record record{};
+  std::string pipeline;
+};
+
+static void store_trace_record(const heif_trace_record* record, void* userdata)
+{
+  auto* result = static_cast<trace_result*>(userdata);
+  result->num_calls++;
+  result->record = *record;
+  result->pipeline = record->color_conversion_pipeline;
+  result->record.color_conversion_pipeline = nullptr;
+}
+
+TEST_CASE("check decoding trace callback") {
+  auto file = GENERATE(YUV_FILES);
+  INFO("file name: " << file);
+
+  auto context = get_context_for_test_file(file);
+  heif_context_set_max_decoding_threads(context, 4);
+
+  trace_result result;
+  heif_context_set_trace_callback(context, store_trace_record, &result);
+
+  heif_image_handle* handle = get_primary_image_handle(context);
+  heif_image* img;
+  heif_error err = heif_decode_image(handle, &img, heif_colorspace_RGB, heif_chroma_interleaved_RGB, NULL);
+  REQUIRE(err.code == heif_error_Ok);
+
+  REQUIRE(result.num_calls == 1);
+  REQUIRE(result.record.version == 1);
+  REQUIRE(result.record.operation == heif_trace_operation_decode);
+  REQUIRE(result.record.item_id == heif_image_handle_get_item_id(handle));
+  REQUIRE(result.record.total_ns > 0);
+  REQUIRE(result.record.codec_ns > 0);
+  REQUIRE(result.record.color_conversion_ns > 0);
+  REQUIRE(result.record.bytes_read > 0);
+  REQUIRE(result.record.num_allocations >= 2);
+  REQUIRE(result.record.bytes_allocated >= 30 * 20 * 3);
+  REQUIRE(!result.pipeline.empty());
+
+  heif_image_release(img);
+
+  // tracing switched off: no more callbacks
+
+  heif_context_set_trace_callback(context, nullptr, nullptr);
+  err = heif_decode_image(handle, &img, heif_colorspace_RGB, heif_chroma_interleaved_RGB, NULL);
+  REQUIRE(err.code == heif_error_Ok);
+  REQUIRE(result.num_calls == 1);
+
+  heif_image_release(img);
+  heif_image_handle_release(handle);
+  heif_context_free(context);
+}
+
+
+struct batch_result
+{
+  std::vector<heif_image*> images;
+  std::vector<int> num_calls;
+};
+
+static void store_batch_image(size_t index, heif_error err, heif_image* img, void* userdata)
+{
+  auto* result = static_cast<batch_result*>(userdata);
+  REQUIRE(err.code == heif_error_Ok);
+  result->images[index] = img;
+  result->num_calls[index]++;
+}
+
+static void require_equal_images(heif_image* a, heif_image* b)
+{
+  REQUIRE(heif_image_get_width(a, heif_channel_interleaved) == heif_image_get_width(b, heif_channel_interleaved));
+  REQUIRE(heif_image_get_height(a, heif_channel_interleaved) == heif_image_get_height(b, heif_channel_interleaved));
+
+  size_t stride_a, stride_b;
+  const uint8_t* p_a = heif_image_get_plane_readonly2(a, heif_channel_interleaved, &stride_a);
+  const uint8_t* p_b = heif_image_get_plane_readonly2(b, heif_channel_interleaved, &stride_b);
+
+  int width = heif_image_get_width(a, heif_channel_interleaved);
+  int height = heif_image_get_height(a, heif_channel_interleaved);
+  for (int y = 0; y < height; y++) {
+    REQUIRE(memcmp(p_a + y * stride_a, p_b + y * stride_b, width * 3) == 0);
+  }
+}
+
+TEST_CASE("check batch decoding matches single decoding") {
+  std::vector<std::string> files{YUV_FILES};
+  std::string tiled_file = "uncompressed_comp_RGB_tiled.heif";
+
+  std::vector<heif_context*> contexts;
+  std::vector<heif_image_handle*> handles;
+  std::vector<heif_decode_batch_item> items;
+
+  for (const auto& file : files) {
+    contexts.push_back(get_context_for_test_file(file));
+    handles.push_back(get_primary_image_handle(contexts.back()));
+
+    heif_decode_batch_item item{};
+    item.handle = handles.back();
+    item.colorspace = heif_colorspace_RGB;
+    item.chroma = heif_chroma_interleaved_RGB;
+    items.push_back(item);
+  }
+
+  // all tiles of one image
+
+  contexts.push_back(get_context_for_test_file(tiled_file));
+  handles.push_back(get_primary_image_handle(contexts.back()));
+
+  heif_image_tiling tiling;
+  heif_error err = heif_image_handle_get_image_tiling(handles.back(), 1, &tiling);
+  REQUIRE(err.code == heif_error_Ok);
+  REQUIRE(tiling.num_columns * tiling.num_rows > 1);
+
+  for (uint32_t ty = 0; ty < tiling.num_rows; ty++) {
+    for (uint32_t tx = 0; tx < tiling.num_columns; tx++) {
+      heif_decode_batch_item item{};
+      item.handle = handles.back();
+      item.colorspace = heif_colorspace_RGB;
+      item.chroma = heif_chroma_interleaved_RGB;
+      item.decode_tile = 1;
+      item.tile_x = tx;
+      item.tile_y = ty;
+      items.push_back(item);
+    }
+  }
+
+  for (int max_threads : {0, 4}) {
+    batch_result result;
+    result.images.resize(items.size(), nullptr);
+    result.num_calls.resize(items.size(), 0);
+
+    err = heif_decode_images_batch(items.data(), items.size(), nullptr, max_threads, store_batch_image, &result);
+    REQUIRE(err.code == heif_error_Ok);
+
+    for (size_t i = 0; i < items.size(); i++) {
+      REQUIRE(result.num_calls[i] == 1);
+      REQUIRE(result.images[i] != nullptr);
+
+      heif_image* img;
+      if (items[i].decode_tile) {
+        err = heif_image_handle_decode_image_tile(items[i].handle, &img, heif_colorspace_RGB, heif_chroma_interleaved_RGB,
+                                                  nullptr, items[i].tile_x, items[i].tile_y);
+      }
+      else {
+        err = heif_decode_image(items[i].handle, &img, heif_colorspace_RGB, heif_chroma_interleaved_RGB, nullptr);
+      }
+      REQUIRE(err.code == heif_error_Ok);
+
+      require_equal_images(result.images[i], img);
+
+      heif_image_release(img);
+      heif_image_release(result.images[i]);
+    }
+  }
+
+  for (auto* handle : handles) {
+    heif_image_handle_release(handle);
+  }
+
+  for (auto* context : contexts) {
+    heif_context_free(context);
+  }
+}
+
+
+TEST_CASE("check decoded tile cache") {
+  heif_context* context = get_context_for_test_file("uncompressed_comp_RGB_tiled.heif");
+  heif_image_handle* handle = get_primary_image_handle(context);
+
+  heif_image_tiling tiling;
+  heif_error err = heif_image_handle_get_image_tiling(handle, 1, &tiling);
+  REQUIRE(err.code == heif_error_Ok);
+  REQUIRE(tiling.num_columns * tiling.num_rows > 1);
+
+  heif_image* reference;
+  err = heif_image_handle_decode_image_tile(handle, &reference, heif_colorspace_RGB, heif_chroma_interleaved_RGB,
+                                            nullptr, 1, 0);
+  REQUIRE(err.code == heif_error_Ok);
+
+  heif_context_set_tile_cache_size(context, 64 * 1024 * 1024);
+
+  heif_tile_cache_statistics stats{};
+  stats.version = 1;
+
+  for (int i = 0; i < 2; i++) {
+    heif_image* img;
+    err = heif_image_handle_decode_image_tile(handle, &img, heif_colorspace_RGB, heif_chroma_interleaved_RGB,
+                                              nullptr, 1, 0);
+    REQUIRE(err.code == heif_error_Ok);
+    require_equal_images(reference, img);
+
+    // modifying the returned image must not change the cached tile
+    size_t stride;
+    uint8_t* p = heif_image_get_plane2(img, heif_channel_interleaved, &stride);
+    p[0] = (uint8_t) (p[0] + 1);
+
+    heif_image_release(img);
+  }
+
+  err = heif_context_get_tile_cache_statistics(context, &stats);
+  REQUIRE(err.code == heif_error_Ok);
+  REQUIRE(stats.misses == 1);
+  REQUIRE(stats.hits == 1);
+  REQUIRE(stats.cached_tiles == 1);
+  REQUIRE(stats.cached_bytes > 0);
+
+  // different output format is a separate entry
+
+  heif_image* img;
+  err = heif_image_handle_decode_image_tile(handle, &img, heif_colorspace_RGB, heif_chroma_interleaved_RGBA,
+                                            nullptr, 1, 0);
+  REQUIRE(err.code == heif_error_Ok);
+  heif_image_release(img);
+
+  err = heif_context_get_tile_cache_statistics(context, &stats);
+  REQUIRE(err.code == heif_error_Ok);
+  REQUIRE(stats.misses == 2);
+  REQUIRE(stats.cached_tiles == 2);
+
+  // a cache too small for two tiles evicts the least recently used one
+
+  heif_context_set_tile_cache_size(context, stats.cached_bytes - 1);
+  err = heif_context_get_tile_cache_statistics(context, &stats);
+  REQUIRE(err.code == heif_error_Ok);
+  REQUIRE(stats.cached_tiles == 1);
+  REQUIRE(stats.evictions == 1);
+
+  heif_context_clear_tile_cache(context);
+  err = heif_context_get_tile_cache_statistics(context, &stats);
+  REQUIRE(err.code == heif_error_Ok);
+  REQUIRE(stats.cached_tiles == 0);
+  REQUIRE(stats.cached_bytes == 0);
+
+  heif_image_release(reference);
+  heif_image_handle_release(handle);
+  heif_context_free(context);
+}
@@ -27,8 +27,12 @@
 #include "catch_amalgamated.hpp"
 #include "api_structs.h"
 #include "libheif/heif.h"
+#include "libheif/heif_uncompressed.h"
+#include "libheif/heif_sequences.h"
+#include <algorithm>
 #include <cstdint>
 #include <string.h>
+#include <vector>
 #include "test_utils.h"
 
 TEST_CASE("check have uncompressed")
@@ -776,3 +780,1255 @@ TEST_CASE("Encode RGBA planar")
   heif_image *input_image = createImage_RGBA_planar();
   do_encode(input_image, "encode_rgba_planar.heif", true);
 }
+
+
+static heif_image* create_mono_tile(int w, int h, int seed)
+{
+  heif_image* image;
+  heif_error err = heif_image_create(w, h, heif_colorspace_monochrome, heif_chroma_monochrome, &image);
+  REQUIRE(err.code == heif_error_Ok);
+
+  err = heif_image_add_plane(image, heif_channel_Y, w, h, 8);
+  REQUIRE(err.code == heif_error_Ok);
+
+  size_t stride;
+  uint8_t* p = heif_image_get_plane2(image, heif_channel_Y, &stride);
+  for (int y = 0; y < h; y++) {
+    for (int x = 0; x < w; x++) {
+      p[y * stride + x] = (uint8_t) ((x + 3 * y + 17 * seed) % 256);
+    }
+  }
+
+  return image;
+}
+
+static heif_item_id encode_overlay_layer(heif_context* ctx, heif_encoder* encoder, heif_image* img)
+{
+  heif_image_handle* handle = nullptr;
+  heif_error err = heif_context_encode_image(ctx, img, encoder, nullptr, &handle);
+  REQUIRE(err.code == heif_error_Ok);
+  heif_item_id id = heif_image_handle_get_item_id(handle);
+  heif_image_handle_release(handle);
+  heif_image_release(img);
+  return id;
+}
+
+
+TEST_CASE("Decode overlay image")
+{
+  heif_context* ctx = heif_context_alloc();
+
+  heif_encoder* encoder;
+  heif_error err = heif_context_get_encoder_for_format(ctx, heif_compression_uncompressed, &encoder);
+  REQUIRE(err.code == heif_error_Ok);
+
+  // semi-transparent layer with constant value
+  heif_image* alpha_img;
+  err = heif_image_create(8, 8, heif_colorspace_monochrome, heif_chroma_monochrome, &alpha_img);
+  REQUIRE(err.code == heif_error_Ok);
+  for (heif_channel channel : {heif_channel_Y, heif_channel_Alpha}) {
+    err = heif_image_add_plane(alpha_img, channel, 8, 8, 8);
+    REQUIRE(err.code == heif_error_Ok);
+    size_t stride;
+    uint8_t* p = heif_image_get_plane2(alpha_img, channel, &stride);
+    for (int y = 0; y < 8; y++) {
+      memset(p + y * stride, channel == heif_channel_Y ? 200 : 128, 8);
+    }
+  }
+
+  std::vector<heif_item_id> ids;
+  ids.push_back(encode_overlay_layer(ctx, encoder, create_mono_tile(16, 16, 2))); // hidden by the next layer
+  ids.push_back(encode_overlay_layer(ctx, encoder, create_mono_tile(24, 24, 0)));
+  ids.push_back(encode_overlay_layer(ctx, encoder, create_mono_tile(16, 16, 1)));
+  ids.push_back(encode_overlay_layer(ctx, encoder, alpha_img));
+  heif_encoder_release(encoder);
+
+  int32_t offsets[] = {0, 0, -4, -4, 20, 20, 24, 0};
+  uint16_t background[4] = {0, 0, 0, 0xFFFF};
+
+  heif_image_handle* overlay_handle = nullptr;
+  err = heif_context_add_overlay_image(ctx, 32, 32, (uint16_t) ids.size(), ids.data(), offsets, background, &overlay_handle);
+  REQUIRE(err.code == heif_error_Ok);
+  err = heif_context_set_primary_image(ctx, overlay_handle);
+  REQUIRE(err.code == heif_error_Ok);
+  heif_image_handle_release(overlay_handle);
+
+  std::string filename = get_tests_output_file_path("encode_unci_overlay.heif");
+  err = heif_context_write_to_file(ctx, filename.c_str());
+  REQUIRE(err.code == heif_error_Ok);
+  heif_context_free(ctx);
+
+  // Returns the decoded G value of the item at (x;y) and its alpha value (or 255 if there is none).
+  auto get_pixel = [](heif_context* ctx, heif_item_id id, int x, int y) {
+    heif_image_handle* handle = nullptr;
+    heif_error err = heif_context_get_image_handle(ctx, id, &handle);
+    REQUIRE(err.code == heif_error_Ok);
+
+    heif_image* img = nullptr;
+    err = heif_decode_image(handle, &img, heif_colorspace_RGB, heif_chroma_444, nullptr);
+    REQUIRE(err.code == heif_error_Ok);
+
+    size_t stride;
+    const uint8_t* p = heif_image_get_plane_readonly2(img, heif_channel_G, &stride);
+    std::pair<int, int> value{p[y * stride + x], 255};
+    if (heif_image_has_channel(img, heif_channel_Alpha)) {
+      p = heif_image_get_plane_readonly2(img, heif_channel_Alpha, &stride);
+      value.second = p[y * stride + x];
+    }
+
+    heif_image_release(img);
+    heif_image_handle_release(handle);
+    return value;
+  };
+
+  for (int threads : {0, 4}) {
+    ctx = heif_context_alloc();
+    heif_context_set_max_decoding_threads(ctx, threads);
+    err = heif_context_read_from_file(ctx, filename.c_str(), nullptr);
+    REQUIRE(err.code == heif_error_Ok);
+
+    heif_image_handle* handle = nullptr;
+    err = heif_context_get_primary_image_handle(ctx, &handle);
+    REQUIRE(err.code == heif_error_Ok);
+
+    heif_image* img = nullptr;
+    err = heif_decode_image(handle, &img, heif_colorspace_RGB, heif_chroma_444, nullptr);
+    REQUIRE(err.code == heif_error_Ok);
+
+    auto blended = get_pixel(ctx, ids[3], 0, 0);
+    int blended_value = blended.first * blended.second / 255;
+
+    size_t stride;
+    const uint8_t* p = heif_image_get_plane_readonly2(img, heif_channel_G, &stride);
+    REQUIRE(p[0] == get_pixel(ctx, ids[1], 4, 4).first);
+    REQUIRE(p[19 * stride + 19] == get_pixel(ctx, ids[1], 23, 23).first);
+    REQUIRE(p[20 * stride + 20] == get_pixel(ctx, ids[2], 0, 0).first);
+    REQUIRE(p[31 * stride + 31] == get_pixel(ctx, ids[2], 11, 11).first);
+    REQUIRE(p[20] == 0); // background
+    REQUIRE(p[24] == blended_value);
+    REQUIRE(p[7 * stride + 31] == blended_value);
+
+    heif_image_release(img);
+    heif_image_handle_release(handle);
+    heif_context_free(ctx);
+  }
+}
+
+
+TEST_CASE("Decode overlay with negative offsets")
+{
+  heif_context* ctx = heif_context_alloc();
+
+  heif_encoder* encoder;
+  heif_error err = heif_context_get_encoder_for_format(ctx, heif_compression_uncompressed, &encoder);
+  REQUIRE(err.code == heif_error_Ok);
+
+  heif_item_id id = encode_overlay_layer(ctx, encoder, create_mono_tile(32, 32, 0));
+  heif_encoder_release(encoder);
+
+  // small offsets are stored as 16-bit values
+  int32_t offsets[] = {-8, -5};
+  uint16_t background[4] = {0, 0, 0, 0xFFFF};
+
+  heif_image_handle* overlay_handle = nullptr;
+  err = heif_context_add_overlay_image(ctx, 16, 16, 1, &id, offsets, background, &overlay_handle);
+  REQUIRE(err.code == heif_error_Ok);
+  err = heif_context_set_primary_image(ctx, overlay_handle);
+  REQUIRE(err.code == heif_error_Ok);
+  heif_image_handle_release(overlay_handle);
+
+  std::string filename = get_tests_output_file_path("encode_unci_overlay_negative_offsets.heif");
+  err = heif_context_write_to_file(ctx, filename.c_str());
+  REQUIRE(err.code == heif_error_Ok);
+  heif_context_free(ctx);
+
+  ctx = heif_context_alloc();
+  err = heif_context_read_from_file(ctx, filename.c_str(), nullptr);
+  REQUIRE(err.code == heif_error_Ok);
+
+  heif_image_handle* handle = nullptr;
+  err = heif_context_get_primary_image_handle(ctx, &handle);
+  REQUIRE(err.code == heif_error_Ok);
+
+  heif_image* img = nullptr;
+  err = heif_decode_image(handle, &img, heif_colorspace_RGB, heif_chroma_444, nullptr);
+  REQUIRE(err.code == heif_error_Ok);
+
+  // the canvas shows the layer area starting at (8;5)
+  size_t stride;
+  const uint8_t* p = heif_image_get_plane_readonly2(img, heif_channel_G, &stride);
+  for (int y = 0; y < 16; y++) {
+    for (int x = 0; x < 16; x++) {
+      REQUIRE(p[y * stride + x] == (x + 8) + 3 * (y + 5));
+    }
+  }
+
+  heif_image_release(img);
+  heif_image_handle_release(handle);
+  heif_context_free(ctx);
+}
+
+
+TEST_CASE("Encode mono image with row padding")
+{
+  // 13 pixels wide, so that the rows in memory are padded
+  const int width = 13;
+  const int height = 7;
+
+  heif_image* input_image = create_mono_tile(width, height, 1);
+
+  size_t stride;
+  heif_image_get_plane_readonly2(input_image, heif_channel_Y, &stride);
+  REQUIRE(stride > (size_t) width);
+
+  heif_context* ctx = heif_context_alloc();
+
+  heif_encoder* encoder;
+  heif_error err = heif_context_get_encoder_for_format(ctx, heif_compression_uncompressed, &encoder);
+  REQUIRE(err.code == heif_error_Ok);
+
+  heif_image_handle* handle = nullptr;
+  err = heif_context_encode_image(ctx, input_image, encoder, nullptr, &handle);
+  REQUIRE(err.code == heif_error_Ok);
+  heif_image_handle_release(handle);
+  heif_encoder_release(encoder);
+
+  std::string filename = get_tests_output_file_path("encode_unci_mono_padded.heif");
+  err = heif_context_write_to_file(ctx, filename.c_str());
+  REQUIRE(err.code == heif_error_Ok);
+  heif_context_free(ctx);
+
+  ctx = heif_context_alloc();
+  err = heif_context_read_from_file(ctx, filename.c_str(), nullptr);
+  REQUIRE(err.code == heif_error_Ok);
+
+  err = heif_context_get_primary_image_handle(ctx, &handle);
+  REQUIRE(err.code == heif_error_Ok);
+
+  heif_image* img = nullptr;
+  err = heif_decode_image(handle, &img, heif_colorspace_monochrome, heif_chroma_monochrome, nullptr);
+  REQUIRE(err.code == heif_error_Ok);
+
+  const uint8_t* p_in = heif_image_get_plane_readonly2(input_image, heif_channel_Y, &stride);
+  size_t out_stride;
+  const uint8_t* p_out = heif_image_get_plane_readonly2(img, heif_channel_Y, &out_stride);
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      REQUIRE(p_out[y * out_stride + x] == p_in[y * stride + x]);
+    }
+  }
+
+  heif_image_release(img);
+  heif_image_handle_release(handle);
+  heif_context_free(ctx);
+  heif_image_release(input_image);
+}
+
+
+static void do_encode_tiles_batched(heif_unci_compression compression)
+{
+  const uint32_t tile_size = 64;
+  const uint32_t columns = 4, rows = 3;
+
+  heif_context* ctx = heif_context_alloc();
+  heif_context_set_max_encoding_threads(ctx, 4);
+
+  heif_unci_image_parameters* params = heif_unci_image_parameters_alloc();
+  params->image_width = tile_size * columns;
+  params->image_height = tile_size * rows;
+  params->tile_width = tile_size;
+  params->tile_height = tile_size;
+  params->compression = compression;
+
+  std::vector<heif_image*> tiles;
+  std::vector<uint32_t> tile_x, tile_y;
+  for (uint32_t y = 0; y < rows; y++) {
+    for (uint32_t x = 0; x < columns; x++) {
+      tiles.push_back(create_mono_tile(tile_size, tile_size, (int) (y * columns + x)));
+      tile_x.push_back(x);
+      tile_y.push_back(y);
+    }
+  }
+
+  heif_image_handle* handle;
+  heif_error err = heif_context_add_empty_unci_image(ctx, params, nullptr, tiles[0], &handle);
+  REQUIRE(err.code == heif_error_Ok);
+
+  err = heif_context_add_image_tiles(ctx, handle, (uint32_t) tiles.size(), tile_x.data(), tile_y.data(), tiles.data(), nullptr);
+  REQUIRE(err.code == heif_error_Ok);
+
+  err = heif_context_set_primary_image(ctx, handle);
+  REQUIRE(err.code == heif_error_Ok);
+
+  uint32_t invalid_x = columns;
+  uint32_t zero = 0;
+  err = heif_context_add_image_tiles(ctx, handle, 1, &invalid_x, &zero, tiles.data(), nullptr);
+  REQUIRE(err.code == heif_error_Usage_error);
+
+  std::string filename = get_tests_output_file_path("encode_unci_tiles_batched.heif");
+  err = heif_context_write_to_file(ctx, filename.c_str());
+  REQUIRE(err.code == heif_error_Ok);
+
+  heif_image_handle_release(handle);
+  heif_unci_image_parameters_release(params);
+  heif_context_free(ctx);
+
+  // --- read back and compare all tiles
+
+  heif_context* decode_context = get_context_for_local_file(filename);
+  heif_image_handle* decode_handle = get_primary_image_handle(decode_context);
+
+  heif_image* decoded;
+  err = heif_decode_image(decode_handle, &decoded, heif_colorspace_monochrome, heif_chroma_monochrome, nullptr);
+  REQUIRE(err.code == heif_error_Ok);
+
+  size_t decoded_stride;
+  const uint8_t* decoded_plane = heif_image_get_plane_readonly2(decoded, heif_channel_Y, &decoded_stride);
+
+  for (size_t i = 0; i < tiles.size(); i++) {
+    size_t tile_stride;
+    const uint8_t* tile_plane = heif_image_get_plane_readonly2(tiles[i], heif_channel_Y, &tile_stride);
+
+    for (uint32_t y = 0; y < tile_size; y++) {
+      REQUIRE(memcmp(decoded_plane + (tile_y[i] * tile_size + y) * decoded_stride + tile_x[i] * tile_size,
+                     tile_plane + y * tile_stride, tile_size) == 0);
+    }
+
+    heif_image_release(tiles[i]);
+  }
+
+  heif_image_release(decoded);
+  heif_image_handle_release(decode_handle);
+  heif_context_free(decode_context);
+}
+
+
+TEST_CASE("Encode tiles batched")
+{
+  do_encode_tiles_batched(heif_unci_compression_off);
+}
+
+
+#if HAVE_BROTLI
+TEST_CASE("Encode tiles batched with brotli compression")
+{
+  do_encode_tiles_batched(heif_unci_compression_brotli);
+}
+#endif
+
+
+#if HAVE_ZSTD
+TEST_CASE("Encode tiles batched with zstd compression")
+{
+  do_encode_tiles_batched(heif_unci_compression_zstd);
+}
+#else
+TEST_CASE("Encode with disabled zstd compression")
+{
+  heif_context* ctx = heif_context_alloc();
+
+  heif_unci_image_parameters* params = heif_unci_image_parameters_alloc();
+  params->image_width = 64;
+  params->image_height = 64;
+  params->tile_width = 64;
+  params->tile_height = 64;
+  params->compression = heif_unci_compression_zstd;
+
+  heif_image* prototype = create_mono_tile(64, 64, 0);
+
+  heif_image_handle* handle = nullptr;
+  heif_error err = heif_context_add_empty_unci_image(ctx, params, nullptr, prototype, &handle);
+  REQUIRE(err.code == heif_error_Unsupported_feature);
+  REQUIRE(err.subcode == heif_suberror_Unsupported_generic_compression_method);
+
+  heif_image_release(prototype);
+  heif_unci_image_parameters_release(params);
+  heif_context_free(ctx);
+}
+#endif
+
+
+static heif_writer get_vector_writer()
+{
+  heif_writer writer{};
+  writer.writer_api_version = 1;
+  writer.write = [](heif_context*, const void* data, size_t size, void* userdata) {
+    auto* out = (std::vector<uint8_t>*) userdata;
+    out->insert(out->end(), (const uint8_t*) data, (const uint8_t*) data + size);
+    return heif_error_success;
+  };
+
+  return writer;
+}
+
+
+static void do_encode_tiles_streamed(heif_unci_compression compression)
+{
+  const uint32_t tile_size = 64;
+  const uint32_t columns = 4, rows = 3;
+
+  // Missing tiles are only supported without compression. They are stored as zeros.
+  const bool skip_tile = (compression == heif_unci_compression_off);
+  const uint32_t skipped_x = 1, skipped_y = 1;
+
+  heif_context* ctx = heif_context_alloc();
+  heif_context_set_max_encoding_threads(ctx, 4);
+
+  heif_unci_image_parameters* params = heif_unci_image_parameters_alloc();
+  params->image_width = tile_size * columns;
+  params->image_height = tile_size * rows;
+  params->tile_width = tile_size;
+  params->tile_height = tile_size;
+  params->compression = compression;
+
+  std::vector<heif_image*> tiles;
+  for (uint32_t i = 0; i < columns * rows; i++) {
+    tiles.push_back(create_mono_tile(tile_size, tile_size, (int) i));
+  }
+
+  heif_image_handle* handle;
+  heif_error err = heif_context_add_empty_unci_image(ctx, params, nullptr, tiles[0], &handle);
+  REQUIRE(err.code == heif_error_Ok);
+
+  err = heif_context_set_primary_image(ctx, handle);
+  REQUIRE(err.code == heif_error_Ok);
+
+  std::vector<uint8_t> file_data;
+  heif_writer writer = get_vector_writer();
+
+  err = heif_context_start_streaming_writing(ctx, &writer, &file_data);
+  REQUIRE(err.code == heif_error_Ok);
+  REQUIRE(!file_data.empty()); // 'ftyp'
+
+  // add the rows out of order
+  const uint32_t row_order[rows] = {2, 0, 1};
+  size_t tile_data_size = 0;
+
+  for (uint32_t y : row_order) {
+    std::vector<const heif_image*> row_tiles;
+    std::vector<uint32_t> tile_x, tile_y;
+    for (uint32_t x = 0; x < columns; x++) {
+      if (skip_tile && x == skipped_x && y == skipped_y) {
+        continue;
+      }
+
+      row_tiles.push_back(tiles[y * columns + x]);
+      tile_x.push_back(x);
+      tile_y.push_back(y);
+    }
+
+    err = heif_context_add_image_tiles(ctx, handle, (uint32_t) row_tiles.size(), tile_x.data(), tile_y.data(), row_tiles.data(), nullptr);
+    REQUIRE(err.code == heif_error_Ok);
+
+    tile_data_size += row_tiles.size() * tile_size * tile_size;
+  }
+
+  if (compression == heif_unci_compression_off) {
+    // The first two rows are not adjacent in the item data and have been written already.
+    REQUIRE(file_data.size() > 2 * columns * tile_size * tile_size);
+  }
+
+  err = heif_context_write(ctx, &writer, &file_data);
+  REQUIRE(err.code == heif_error_Usage_error);
+
+  err = heif_context_end_streaming_writing(ctx);
+  REQUIRE(err.code == heif_error_Ok);
+
+  err = heif_context_end_streaming_writing(ctx);
+  REQUIRE(err.code == heif_error_Usage_error);
+
+  if (compression == heif_unci_compression_off) {
+    // the missing tile is not stored in memory and written as zeros
+    REQUIRE(file_data.size() > tile_data_size + tile_size * tile_size);
+  }
+
+  heif_image_handle_release(handle);
+  heif_unci_image_parameters_release(params);
+  heif_context_free(ctx);
+
+  // --- read back and compare all tiles
+
+  heif_context* decode_context = heif_context_alloc();
+  err = heif_context_read_from_memory_without_copy(decode_context, file_data.data(), file_data.size(), nullptr);
+  REQUIRE(err.code == heif_error_Ok);
+
+  heif_image_handle* decode_handle = get_primary_image_handle(decode_context);
+
+  heif_image* decoded;
+  err = heif_decode_image(decode_handle, &decoded, heif_colorspace_monochrome, heif_chroma_monochrome, nullptr);
+  REQUIRE(err.code == heif_error_Ok);
+
+  size_t decoded_stride;
+  const uint8_t* decoded_plane = heif_image_get_plane_readonly2(decoded, heif_channel_Y, &decoded_stride);
+
+  std::vector<uint8_t> zeros(tile_size, 0);
+
+  for (uint32_t ty = 0; ty < rows; ty++) {
+    for (uint32_t tx = 0; tx < columns; tx++) {
+      heif_image* tile = tiles[ty * columns + tx];
+
+      size_t tile_stride;
+      const uint8_t* tile_plane = heif_image_get_plane_readonly2(tile, heif_channel_Y, &tile_stride);
+
+      bool skipped = (skip_tile && tx == skipped_x && ty == skipped_y);
+
+      for (uint32_t y = 0; y < tile_size; y++) {
+        REQUIRE(memcmp(decoded_plane + (ty * tile_size + y) * decoded_stride + tx * tile_size,
+                       skipped ? zeros.data() : tile_plane + y * tile_stride, tile_size) == 0);
+      }
+
+      heif_image_release(tile);
+    }
+  }
+
+  heif_image_release(decoded);
+  heif_image_handle_release(decode_handle);
+  heif_context_free(decode_context);
+}
+
+
+TEST_CASE("Encode tiles streamed")
+{
+  do_encode_tiles_streamed(heif_unci_compression_off);
+}
+
+
+#if HAVE_ZSTD
+TEST_CASE("Encode tiles streamed with zstd compression")
+{
+  do_encode_tiles_streamed(heif_unci_compression_zstd);
+}
+#endif
+
+
+TEST_CASE("Streamed tile cannot be written twice")
+{
+  heif_context* ctx = heif_context_alloc();
+
+  heif_unci_image_parameters* params = heif_unci_image_parameters_alloc();
+  params->image_width = 128;
+  params->image_height = 64;
+  params->tile_width = 64;
+  params->tile_height = 64;
+
+  heif_image* tile = create_mono_tile(64, 64, 0);
+
+  heif_image_handle* handle;
+  heif_error err = heif_context_add_empty_unci_image(ctx, params, nullptr, tile, &handle);
+  REQUIRE(err.code == heif_error_Ok);
+
+  std::vector<uint8_t> file_data;
+  heif_writer writer = get_vector_writer();
+
+  err = heif_context_start_streaming_writing(ctx, &writer, &file_data);
+  REQUIRE(err.code == heif_error_Ok);
+
+  err = heif_context_start_streaming_writing(ctx, &writer, &file_data);
+  REQUIRE(err.code == heif_error_Usage_error);
+
+  const uint32_t tile_x = 1, tile_y = 0;
+  const heif_image* tile_list[] = {tile};
+
+  err = heif_context_add_image_tiles(ctx, handle, 1, &tile_x, &tile_y, tile_list, nullptr);
+  REQUIRE(err.code == heif_error_Ok);
+
+  err = heif_context_add_image_tiles(ctx, handle, 1, &tile_x, &tile_y, tile_list, nullptr);
+  REQUIRE(err.code == heif_error_Ok); // only detected when the data is written
+
+  err = heif_context_end_streaming_writing(ctx);
+  REQUIRE(err.code == heif_error_Usage_error);
+
+  heif_image_release(tile);
+  heif_image_handle_release(handle);
+  heif_unci_image_parameters_release(params);
+  heif_context_free(ctx);
+}
+
+
+static uint32_t get_test_frame_duration(int frame)
+{
+  return 10 + 5 * (frame % 3);
+}
+
+
+// If 'max_fragment_duration_ms' is non-zero, the sequence is written as a fragmented file.
+static std::string encode_mono_sequence(int nFrames, int size, uint32_t max_fragment_duration_ms = 0)
+{
+  heif_context* ctx = heif_context_alloc();
+
+  heif_encoder* encoder;
+  heif_error err = heif_context_get_encoder_for_format(ctx, heif_compression_uncompressed, &encoder);
+  REQUIRE(err.code == heif_error_Ok);
+
+  heif_track_options* track_options = heif_track_options_alloc();
+  heif_track_options_set_timescale(track_options, 100);
+
+  heif_track* track = nullptr;
+  err = heif_context_add_visual_sequence_track(ctx, (uint16_t) size, (uint16_t) size, heif_track_type_image_sequence,
+                                               track_options, nullptr, &track);
+  REQUIRE(err.code == heif_error_Ok);
+  heif_track_options_release(track_options);
+
+  std::string filename = get_tests_output_file_path(max_fragment_duration_ms ?
+                                                    "encode_unci_sequence_fragmented.heif" :
+                                                    "encode_unci_sequence.heif");
+
+  if (max_fragment_duration_ms) {
+    err = heif_context_start_fragmented_writing_to_file(ctx, filename.c_str(), max_fragment_duration_ms);
+    REQUIRE(err.code == heif_error_Ok);
+  }
+
+  for (int i = 0; i < nFrames; i++) {
+    heif_image* img = create_mono_tile(size, size, i);
+    heif_image_set_duration(img, get_test_frame_duration(i));
+
+    err = heif_track_encode_sequence_image(track, img, encoder, nullptr);
+    REQUIRE(err.code == heif_error_Ok);
+
+    heif_image_release(img);
+  }
+
+  // a no-op for intra-only encoders like 'unci'
+  err = heif_track_encode_end_of_sequence(track, encoder);
+  REQUIRE(err.code == heif_error_Ok);
+
+  heif_track_release(track);
+  heif_encoder_release(encoder);
+
+  if (max_fragment_duration_ms) {
+    err = heif_context_write_to_file(ctx, filename.c_str());
+    REQUIRE(err.code == heif_error_Usage_error);
+
+    err = heif_context_end_fragmented_writing(ctx);
+  }
+  else {
+    err = heif_context_write_to_file(ctx, filename.c_str());
+  }
+  REQUIRE(err.code == heif_error_Ok);
+  heif_context_free(ctx);
+
+  return filename;
+}
+
+
+// Returns the luma samples of each decoded frame (row by row, without padding), starting at 'seek_to_sample' (if >= 0).
+static std::vector<std::vector<uint8_t>> decode_mono_sequence(const std::string& filename, int pipeline_depth,
+                                                              int seek_to_sample = -1)
+{
+  heif_context* ctx = heif_context_alloc();
+  heif_error err = heif_context_read_from_file(ctx, filename.c_str(), nullptr);
+  REQUIRE(err.code == heif_error_Ok);
+
+  heif_track* track = heif_context_get_track(ctx, 0);
+  REQUIRE(track != nullptr);
+
+  err = heif_track_set_decoding_pipeline_depth(track, pipeline_depth);
+  REQUIRE(err.code == heif_error_Ok);
+
+  if (seek_to_sample >= 0) {
+    err = heif_track_seek_to_sample(track, (uint64_t) seek_to_sample);
+    REQUIRE(err.code == heif_error_Ok);
+  }
+
+  std::vector<std::vector<uint8_t>> frames;
+
+  for (int frame_nr = std::max(seek_to_sample, 0);; frame_nr++) {
+    heif_image* img = nullptr;
+    err = heif_track_decode_next_image(track, &img, heif_colorspace_monochrome, heif_chroma_monochrome, nullptr);
+    if (err.code == heif_error_End_of_sequence) {
+      break;
+    }
+    REQUIRE(err.code == heif_error_Ok);
+    REQUIRE(heif_image_get_duration(img) == get_test_frame_duration(frame_nr));
+
+    int w = heif_image_get_primary_width(img);
+    int h = heif_image_get_primary_height(img);
+    size_t stride;
+    const uint8_t* p = heif_image_get_plane_readonly2(img, heif_channel_Y, &stride);
+
+    std::vector<uint8_t> frame;
+    for (int y = 0; y < h; y++) {
+      frame.insert(frame.end(), p + y * stride, p + y * stride + w);
+    }
+    frames.push_back(std::move(frame));
+
+    heif_image_release(img);
+  }
+
+  heif_track_release(track);
+  heif_context_free(ctx);
+
+  return frames;
+}
+
+
+TEST_CASE("Decode sequence pipelined")
+{
+  const int nFrames = 7;
+
+  std::string filename = encode_mono_sequence(nFrames, 32);
+
+  auto sequential_frames = decode_mono_sequence(filename, 0);
+  REQUIRE(sequential_frames.size() == nFrames);
+
+  for (int depth : {2, 3, 16}) {
+    auto pipelined_frames = decode_mono_sequence(filename, depth);
+    REQUIRE(pipelined_frames == sequential_frames);
+  }
+
+  for (int i = 0; i < nFrames; i++) {
+    REQUIRE(sequential_frames[i][0] == (uint8_t) (17 * i));
+  }
+}
+
+
+TEST_CASE("Seek in sequence")
+{
+  const int nFrames = 7;
+
+  std::string filename = encode_mono_sequence(nFrames, 16);
+
+  for (int depth : {0, 3}) {
+    auto frames = decode_mono_sequence(filename, depth, 4);
+    REQUIRE(frames.size() == nFrames - 4);
+    REQUIRE(frames[0][0] == (uint8_t) (17 * 4));
+  }
+
+  heif_context* ctx = heif_context_alloc();
+  heif_error err = heif_context_read_from_file(ctx, filename.c_str(), nullptr);
+  REQUIRE(err.code == heif_error_Ok);
+
+  heif_track* track = heif_context_get_track(ctx, 0);
+  REQUIRE(track != nullptr);
+
+  // frame durations are 10, 15, 20, 10, 15, 20, 10 -> frame 3 starts at time 45
+  for (uint64_t t : {45, 50, 54}) {
+    err = heif_track_seek_to_time(track, t);
+    REQUIRE(err.code == heif_error_Ok);
+
+    heif_image* img = nullptr;
+    err = heif_track_decode_next_image(track, &img, heif_colorspace_monochrome, heif_chroma_monochrome, nullptr);
+    REQUIRE(err.code == heif_error_Ok);
+
+    size_t stride;
+    const uint8_t* p = heif_image_get_plane_readonly2(img, heif_channel_Y, &stride);
+    REQUIRE(p[0] == (uint8_t) (17 * 3));
+    heif_image_release(img);
+  }
+
+  err = heif_track_seek_to_sample(track, nFrames);
+  REQUIRE(err.code == heif_error_End_of_sequence);
+
+  err = heif_track_seek_to_time(track, 1000);
+  REQUIRE(err.code == heif_error_End_of_sequence);
+
+  heif_track_release(track);
+  heif_context_free(ctx);
+}
+
+
+TEST_CASE("Fragmented sequence")
+{
+  const int nFrames = 8;
+
+  // frame durations are 10, 15, 20, ... in 1/100 s -> two or three frames per fragment
+  std::string filename = encode_mono_sequence(nFrames, 16, 300);
+
+  // --- check top-level box structure
+
+  std::vector<uint8_t> data;
+  FILE* fh = fopen(filename.c_str(), "rb");
+  REQUIRE(fh != nullptr);
+  uint8_t buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), fh)) > 0) {
+    data.insert(data.end(), buf, buf + n);
+  }
+  fclose(fh);
+
+  std::vector<std::string> boxes;
+  for (size_t pos = 0; pos + 8 <= data.size();) {
+    uint32_t size = (uint32_t(data[pos]) << 24) | (data[pos + 1] << 16) | (data[pos + 2] << 8) | data[pos + 3];
+    REQUIRE(size >= 8);
+    boxes.emplace_back((const char*) &data[pos + 4], 4);
+    pos += size;
+  }
+
+  REQUIRE(std::find(boxes.begin(), boxes.end(), "moov") != boxes.end());
+  REQUIRE(std::count(boxes.begin(), boxes.end(), "moof") == 3);
+  REQUIRE(boxes.back() == "mdat");
+
+  // --- decode
+
+  auto frames = decode_mono_sequence(filename, 0);
+  REQUIRE(frames.size() == nFrames);
+  for (int i = 0; i < nFrames; i++) {
+    REQUIRE(frames[i][0] == (uint8_t) (17 * i));
+  }
+
+  auto seek_frames = decode_mono_sequence(filename, 2, 5);
+  REQUIRE(seek_frames.size() == nFrames - 5);
+  REQUIRE(seek_frames[0][0] == (uint8_t) (17 * 5));
+}
+
+
+// In-memory file that records the range requests and preload hints of libheif.
+struct recording_test_reader
+{
+  std::vector<uint8_t> data;
+  uint64_t pos = 0;
+  std::vector<std::pair<uint64_t, uint64_t>> hints;
+  std::vector<std::pair<uint64_t, uint64_t>> range_requests;
+};
+
+static heif_error write_to_vector(heif_context*, const void* data, size_t size, void* userdata)
+{
+  auto* out = (std::vector<uint8_t>*) userdata;
+  out->insert(out->end(), (const uint8_t*) data, (const uint8_t*) data + size);
+  return heif_error_success;
+}
+
+static heif_reader get_recording_test_reader()
+{
+  heif_reader reader{};
+  reader.reader_api_version = 2;
+  reader.get_position = [](void* userdata) { return (int64_t) ((recording_test_reader*) userdata)->pos; };
+  reader.read = [](void* data, size_t size, void* userdata) {
+    auto* f = (recording_test_reader*) userdata;
+    if (f->pos + size > f->data.size()) {
+      return 1;
+    }
+    memcpy(data, f->data.data() + f->pos, size);
+    f->pos += size;
+    return 0;
+  };
+  reader.seek = [](int64_t position, void* userdata) {
+    ((recording_test_reader*) userdata)->pos = (uint64_t) position;
+    return 0;
+  };
+  reader.wait_for_file_size = [](int64_t target_size, void* userdata) {
+    return (uint64_t) target_size <= ((recording_test_reader*) userdata)->data.size() ?
+           heif_reader_grow_status_size_reached : heif_reader_grow_status_size_beyond_eof;
+  };
+  reader.request_range = [](uint64_t start, uint64_t end, void* userdata) {
+    auto* f = (recording_test_reader*) userdata;
+    f->range_requests.emplace_back(start, end);
+    heif_reader_range_request_result result{};
+    result.status = end <= f->data.size() ? heif_reader_grow_status_size_reached : heif_reader_grow_status_size_beyond_eof;
+    result.range_end = std::min<uint64_t>(end, f->data.size());
+    return result;
+  };
+  reader.preload_range_hint = [](uint64_t start, uint64_t end, void* userdata) {
+    ((recording_test_reader*) userdata)->hints.emplace_back(start, end);
+  };
+  reader.release_file_range = [](uint64_t, uint64_t, void*) {};
+
+  return reader;
+}
+
+// Encodes the tiles into an uncompressed grid image.
+static std::vector<uint8_t> encode_uncompressed_grid(const std::vector<heif_image*>& tiles, uint16_t columns, uint16_t rows)
+{
+  heif_context* ctx = heif_context_alloc();
+
+  heif_encoder* encoder;
+  heif_error err = heif_context_get_encoder_for_format(ctx, heif_compression_uncompressed, &encoder);
+  REQUIRE(err.code == heif_error_Ok);
+
+  heif_image_handle* grid_handle;
+  err = heif_context_encode_grid(ctx, const_cast<heif_image**>(tiles.data()), rows, columns, encoder, nullptr, &grid_handle);
+  REQUIRE(err.code == heif_error_Ok);
+  heif_image_handle_release(grid_handle);
+  heif_encoder_release(encoder);
+
+  std::vector<uint8_t> data;
+  heif_writer writer{1, write_to_vector};
+  err = heif_context_write(ctx, &writer, &data);
+  REQUIRE(err.code == heif_error_Ok);
+  heif_context_free(ctx);
+
+  return data;
+}
+
+
+TEST_CASE("Encode grid of planar tiles")
+{
+  // The grid size has to be computed from the image size, not from the (missing) interleaved channel.
+  const int tile_width = 32, tile_height = 16;
+  const uint16_t columns = 2, rows = 2;
+
+  std::vector<heif_image*> tiles;
+  for (int i = 0; i < columns * rows; i++) {
+    tiles.push_back(create_mono_tile(tile_width, tile_height, i));
+  }
+
+  std::vector<uint8_t> data = encode_uncompressed_grid(tiles, columns, rows);
+
+  heif_context* ctx = heif_context_alloc();
+  heif_error err = heif_context_read_from_memory_without_copy(ctx, data.data(), data.size(), nullptr);
+  REQUIRE(err.code == heif_error_Ok);
+
+  heif_image_handle* handle = get_primary_image_handle(ctx);
+  REQUIRE(heif_image_handle_get_width(handle) == columns * tile_width);
+  REQUIRE(heif_image_handle_get_height(handle) == rows * tile_height);
+
+  heif_image* img;
+  err = heif_decode_image(handle, &img, heif_colorspace_monochrome, heif_chroma_monochrome, nullptr);
+  REQUIRE(err.code == heif_error_Ok);
+
+  size_t stride;
+  const uint8_t* p = heif_image_get_plane_readonly2(img, heif_channel_Y, &stride);
+  for (int ty = 0; ty < rows; ty++) {
+    for (int tx = 0; tx < columns; tx++) {
+      size_t tile_stride;
+      const uint8_t* t = heif_image_get_plane_readonly2(tiles[ty * columns + tx], heif_channel_Y, &tile_stride);
+      for (int y = 0; y < tile_height; y++) {
+        REQUIRE(memcmp(p + (ty * tile_height + y) * stride + tx * tile_width, t + y * tile_stride, tile_width) == 0);
+      }
+    }
+  }
+
+  heif_image_release(img);
+  heif_image_handle_release(handle);
+  heif_context_free(ctx);
+
+  for (auto* tile : tiles) {
+    heif_image_release(tile);
+  }
+}
+
+
+TEST_CASE("Decode single tiles of a grid")
+{
+  // Each grid tile is an image item of its own. Its position in the grid must not be used as a tile
+  // position within this item.
+  const int tile_size = 16;
+  const uint16_t columns = 3, rows = 3;
+
+  std::vector<heif_image*> tiles;
+  for (int i = 0; i < columns * rows; i++) {
+    tiles.push_back(create_mono_tile(tile_size, tile_size, i));
+  }
+
+  std::vector<uint8_t> data = encode_uncompressed_grid(tiles, columns, rows);
+
+  heif_context* ctx = heif_context_alloc();
+  heif_error err = heif_context_read_from_memory_without_copy(ctx, data.data(), data.size(), nullptr);
+  REQUIRE(err.code == heif_error_Ok);
+
+  heif_image_handle* handle = get_primary_image_handle(ctx);
+
+  for (uint32_t ty = 0; ty < rows; ty++) {
+    for (uint32_t tx = 0; tx < columns; tx++) {
+      heif_image* tile;
+      err = heif_image_handle_decode_image_tile(handle, &tile, heif_colorspace_monochrome, heif_chroma_monochrome,
+                                                nullptr, tx, ty);
+      REQUIRE(err.code == heif_error_Ok);
+      REQUIRE(heif_image_get_primary_width(tile) == tile_size);
+      REQUIRE(heif_image_get_primary_height(tile) == tile_size);
+
+      size_t stride, expected_stride;
+      const uint8_t* p = heif_image_get_plane_readonly2(tile, heif_channel_Y, &stride);
+      const uint8_t* expected = heif_image_get_plane_readonly2(tiles[ty * columns + tx], heif_channel_Y, &expected_stride);
+      for (int y = 0; y < tile_size; y++) {
+        REQUIRE(memcmp(p + y * stride, expected + y * expected_stride, tile_size) == 0);
+      }
+
+      heif_image_release(tile);
+    }
+  }
+
+  heif_image_handle_release(handle);
+  heif_context_free(ctx);
+
+  for (auto* tile : tiles) {
+    heif_image_release(tile);
+  }
+}
+
+
+TEST_CASE("Prefetch grid tiles of viewport")
+{
+  const int tile_size = 64;
+  const uint16_t columns = 3, rows = 3;
+
+  std::vector<heif_image*> tiles;
+  for (int i = 0; i < columns * rows; i++) {
+    tiles.push_back(create_mono_tile(tile_size, tile_size, i));
+  }
+
+  recording_test_reader file;
+  file.data = encode_uncompressed_grid(tiles, columns, rows);
+
+  heif_reader reader = get_recording_test_reader();
+
+  heif_context* ctx = heif_context_alloc();
+  heif_error err = heif_context_read_from_reader(ctx, &reader, &file, nullptr);
+  REQUIRE(err.code == heif_error_Ok);
+
+  heif_image_handle* handle = get_primary_image_handle(ctx);
+
+  // Checks that the hinted range holds exactly the pixels of the tile.
+  auto require_tile_range = [&](const std::pair<uint64_t, uint64_t>& range, uint32_t tx, uint32_t ty) {
+    REQUIRE(range.second - range.first == tile_size * tile_size);
+
+    size_t stride;
+    const uint8_t* p = heif_image_get_plane_readonly2(tiles[ty * columns + tx], heif_channel_Y, &stride);
+    for (int y = 0; y < tile_size; y++) {
+      REQUIRE(memcmp(file.data.data() + range.first + y * tile_size, p + y * stride, tile_size) == 0);
+    }
+  };
+
+  // viewport within tile (1;1), no motion
+
+  file.hints.clear();
+  err = heif_image_handle_prefetch_tiles(handle, 1, 70, 70, 50, 50, 0, 0, 1);
+  REQUIRE(err.code == heif_error_Ok);
+  REQUIRE(file.hints.size() == 1);
+  require_tile_range(file.hints[0], 1, 1);
+
+  // panning to the right: the next tile column is hinted after the viewport
+
+  file.hints.clear();
+  err = heif_image_handle_prefetch_tiles(handle, 1, 70, 70, 50, 50, 1, 0, 1);
+  REQUIRE(err.code == heif_error_Ok);
+  REQUIRE(file.hints.size() == 2);
+  require_tile_range(file.hints[0], 1, 1);
+  require_tile_range(file.hints[1], 2, 1);
+
+  // viewport spanning a whole tile row: the adjacent tiles are merged into one range
+
+  file.hints.clear();
+  err = heif_image_handle_prefetch_tiles(handle, 1, 0, 0, columns * tile_size, 1, 0, -1, 2);
+  REQUIRE(err.code == heif_error_Ok);
+  REQUIRE(file.hints.size() == 1);
+  REQUIRE(file.hints[0].second - file.hints[0].first == columns * tile_size * tile_size);
+
+  // viewport outside of the image
+
+  file.hints.clear();
+  err = heif_image_handle_prefetch_tiles(handle, 1, columns * tile_size, 0, 10, 10, 1, 1, 1);
+  REQUIRE(err.code == heif_error_Ok);
+  REQUIRE(file.hints.empty());
+
+  heif_image_handle_release(handle);
+  heif_context_free(ctx);
+
+  for (auto* tile : tiles) {
+    heif_image_release(tile);
+  }
+}
+
+
+TEST_CASE("Decode grid with coalesced reads")
+{
+  const int tile_size = 64;
+  const uint16_t columns = 3, rows = 3;
+  const uint64_t tile_bytes = tile_size * tile_size;
+
+  std::vector<heif_image*> tiles;
+  for (int i = 0; i < columns * rows; i++) {
+    tiles.push_back(create_mono_tile(tile_size, tile_size, i));
+  }
+
+  recording_test_reader file;
+  file.data = encode_uncompressed_grid(tiles, columns, rows);
+
+  heif_reader reader = get_recording_test_reader();
+
+  std::vector<heif_image*> decoded;
+
+  for (int coalescing : {1, 0}) {
+    heif_context* ctx = heif_context_alloc();
+    heif_context_set_read_coalescing(ctx, coalescing, 1024);
+
+    file.pos = 0;
+    heif_error err = heif_context_read_from_reader(ctx, &reader, &file, nullptr);
+    REQUIRE(err.code == heif_error_Ok);
+
+    heif_image_handle* handle = get_primary_image_handle(ctx);
+
+    file.range_requests.clear();
+    heif_image* img;
+    err = heif_decode_image(handle, &img, heif_colorspace_monochrome, heif_chroma_monochrome, nullptr);
+    REQUIRE(err.code == heif_error_Ok);
+    decoded.push_back(img);
+
+    uint64_t largest_request = 0;
+    for (const auto& request : file.range_requests) {
+      largest_request = std::max(largest_request, request.second - request.first);
+    }
+
+    if (coalescing) {
+      // the tiles are stored back to back
+      REQUIRE(largest_request == columns * rows * tile_bytes);
+    }
+    else {
+      REQUIRE(largest_request == tile_bytes);
+      REQUIRE(file.range_requests.size() >= size_t{columns} * rows);
+    }
+
+    heif_image_handle_release(handle);
+    heif_context_free(ctx);
+  }
+
+  size_t stride_a, stride_b;
+  const uint8_t* a = heif_image_get_plane_readonly2(decoded[0], heif_channel_Y, &stride_a);
+  const uint8_t* b = heif_image_get_plane_readonly2(decoded[1], heif_channel_Y, &stride_b);
+  for (int y = 0; y < rows * tile_size; y++) {
+    REQUIRE(memcmp(a + y * stride_a, b + y * stride_b, columns * tile_size) == 0);
+  }
+
+  for (auto* img : decoded) {
+    heif_image_release(img);
+  }
+
+  for (auto* tile : tiles) {
+    heif_image_release(tile);
+  }
+}
+
+
+static heif_image* create_ycbcr420_tile(int w, int h, int seed)
+{
+  heif_image* image;
+  heif_error err = heif_image_create(w, h, heif_colorspace_YCbCr, heif_chroma_420, &image);
+  REQUIRE(err.code == heif_error_Ok);
+
+  err = heif_image_add_plane(image, heif_channel_Y, w, h, 8);
+  REQUIRE(err.code == heif_error_Ok);
+  err = heif_image_add_plane(image, heif_channel_Cb, w / 2, h / 2, 8);
+  REQUIRE(err.code == heif_error_Ok);
+  err = heif_image_add_plane(image, heif_channel_Cr, w / 2, h / 2, 8);
+  REQUIRE(err.code == heif_error_Ok);
+
+  size_t stride;
+  uint8_t* p = heif_image_get_plane2(image, heif_channel_Y, &stride);
+  for (int y = 0; y < h; y++) {
+    for (int x = 0; x < w; x++) {
+      p[y * stride + x] = (uint8_t) (64 + (x + 2 * y + 31 * seed) % 128);
+    }
+  }
+
+  uint8_t* cb = heif_image_get_plane2(image, heif_channel_Cb, &stride);
+  uint8_t* cr = heif_image_get_plane2(image, heif_channel_Cr, &stride);
+  for (int y = 0; y < h / 2; y++) {
+    for (int x = 0; x < w / 2; x++) {
+      cb[y * stride + x] = (uint8_t) (96 + (3 * x + y + 23 * seed) % 64);
+      cr[y * stride + x] = (uint8_t) (96 + (x + 3 * y + 41 * seed) % 64);
+    }
+  }
+
+  return image;
+}
+
+
+TEST_CASE("Decode grid with individually converted tiles")
+{
+  const int tile_size = 32;
+  const uint16_t columns = 3, rows = 3;
+  const int width = columns * tile_size;
+  const int height = rows * tile_size;
+
+  std::vector<heif_image*> tiles;
+  for (int i = 0; i < columns * rows; i++) {
+    tiles.push_back(create_ycbcr420_tile(tile_size, tile_size, i));
+  }
+
+  std::vector<uint8_t> data = encode_uncompressed_grid(tiles, columns, rows);
+
+  heif_context* ctx = heif_context_alloc();
+  heif_error err = heif_context_read_from_memory_without_copy(ctx, data.data(), data.size(), nullptr);
+  REQUIRE(err.code == heif_error_Ok);
+
+  heif_image_handle* handle = get_primary_image_handle(ctx);
+
+  heif_decoding_options* options = heif_decoding_options_alloc();
+
+  auto decode = [&](bool individually) {
+    options->convert_grid_tiles_individually = individually;
+
+    heif_image* img;
+    heif_error err = heif_decode_image(handle, &img, heif_colorspace_RGB, heif_chroma_interleaved_RGB, options);
+    REQUIRE(err.code == heif_error_Ok);
+    REQUIRE(heif_image_get_primary_width(img) == width);
+    REQUIRE(heif_image_get_primary_height(img) == height);
+    return img;
+  };
+
+  auto pixel = [](const heif_image* img, int x, int y) {
+    size_t stride;
+    const uint8_t* p = heif_image_get_plane_readonly2(img, heif_channel_interleaved, &stride);
+    return p + y * stride + 3 * x;
+  };
+
+  SECTION("nearest-neighbor upsampling has no dependencies across tile borders") {
+    options->color_conversion_options.preferred_chroma_upsampling_algorithm = heif_chroma_upsampling_nearest_neighbor;
+    options->color_conversion_options.only_use_preferred_chroma_algorithm = true;
+
+    heif_image* a = decode(false);
+    heif_image* b = decode(true);
+
+    for (int y = 0; y < height; y++) {
+      REQUIRE(memcmp(pixel(a, 0, y), pixel(b, 0, y), 3 * width) == 0);
+    }
+
+    heif_image_release(a);
+    heif_image_release(b);
+  }
+
+  SECTION("bilinear upsampling replicates the chroma at tile borders") {
+    heif_image* a = decode(false);
+    heif_image* b = decode(true);
+
+    // Each tile in the output equals the separately decoded tile.
+
+    for (uint32_t ty = 0; ty < rows; ty++) {
+      for (uint32_t tx = 0; tx < columns; tx++) {
+        heif_image* tile;
+        err = heif_image_handle_decode_image_tile(handle, &tile, heif_colorspace_RGB, heif_chroma_interleaved_RGB, options, tx, ty);
+        REQUIRE(err.code == heif_error_Ok);
+
+        for (int y = 0; y < tile_size; y++) {
+          REQUIRE(memcmp(pixel(tile, 0, y), pixel(b, tx * tile_size, ty * tile_size + y), 3 * tile_size) == 0);
+        }
+
+        heif_image_release(tile);
+      }
+    }
+
+    // Only the pixels next to the interior tile borders differ from the upsampling of the whole image.
+
+    auto near_interior_border = [&](int v, int size) {
+      int d = v % tile_size;
+      return (v >= tile_size && d == 0) || (v < size - tile_size && d == tile_size - 1);
+    };
+
+    bool border_differs = false;
+    for (int y = 0; y < height; y++) {
+      for (int x = 0; x < width; x++) {
+        bool equal = memcmp(pixel(a, x, y), pixel(b, x, y), 3) == 0;
+        if (!near_interior_border(x, width) && !near_interior_border(y, height)) {
+          REQUIRE(equal);
+        }
+        else if (!equal) {
+          border_differs = true;
+        }
+      }
+    }
+
+    REQUIRE(border_differs);
+
+    heif_image_release(a);
+    heif_image_release(b);
+  }
+
+  heif_decoding_options_free(options);
+  heif_image_handle_release(handle);
+  heif_context_free(ctx);
+
+  for (auto* tile : tiles) {
+    heif_image_release(tile);
+  }
+}
+